@@ -218,7 +218,7 @@ static size_t modaudio_stream_update(ALLEGRO_AUDIO_STREAM *stream, void *data,
 static void modaudio_stream_close(ALLEGRO_AUDIO_STREAM *stream)
 {
    MOD_FILE *const df = stream->extra;
-   _al_acodec_stop_feed_thread(stream);
+   _al_acodec_stop_feeder(stream);
 
    lib.duh_end_sigrenderer(df->sig);
    lib.unload_duh(df->duh);
@@ -353,7 +353,7 @@ static ALLEGRO_AUDIO_STREAM *modaudio_stream_init(ALLEGRO_FILE* f,
       stream->get_feeder_position = modaudio_stream_get_position;
       stream->get_feeder_length = modaudio_stream_get_length;
       stream->set_feeder_loop = modaudio_stream_set_loop;
-      _al_acodec_start_feed_thread(stream);
+      _al_acodec_start_feeder(stream);
    }
    else {
       ALLEGRO_ERROR("Failed to create stream.\n");
@@ -418,7 +418,7 @@ static size_t flac_stream_update(ALLEGRO_AUDIO_STREAM *stream, void *data,
 static void flac_stream_close(ALLEGRO_AUDIO_STREAM *stream)
 {
    FLACFILE *ff = stream->extra;
-   _al_acodec_stop_feed_thread(stream);
+   _al_acodec_stop_feeder(stream);
 
    al_fclose(ff->fh);
    al_free(ff->buffer);
@@ -626,7 +626,7 @@ ALLEGRO_AUDIO_STREAM *_al_load_flac_audio_stream_f(ALLEGRO_FILE* f,
       stream->get_feeder_position = flac_stream_get_position;
       stream->get_feeder_length = flac_stream_get_length;
       stream->set_feeder_loop = flac_stream_set_loop;
-      _al_acodec_start_feed_thread(stream);
+      _al_acodec_start_feeder(stream);
    }
    else {
       ALLEGRO_ERROR("Failed to create stream.\n");
@@ -243,13 +243,12 @@ static void mp3_stream_close(ALLEGRO_AUDIO_STREAM *stream)
 {
    MP3FILE *mp3file = (MP3FILE *) stream->extra;
 
-   _al_acodec_stop_feed_thread(stream);
+   _al_acodec_stop_feeder(stream);
 
    al_free(mp3file->frame_offsets);
    al_free(mp3file->file_buffer);
    al_free(mp3file);
    stream->extra = NULL;
-   stream->feed_thread = NULL;
 }
 
 ALLEGRO_AUDIO_STREAM *_al_load_mp3_audio_stream_f(ALLEGRO_FILE* f, size_t buffer_count, unsigned int samples)
@@ -330,7 +329,7 @@ ALLEGRO_AUDIO_STREAM *_al_load_mp3_audio_stream_f(ALLEGRO_FILE* f, size_t buffer
 
    mp3_stream_rewind(stream);
 
-   _al_acodec_start_feed_thread(stream);
+   _al_acodec_start_feeder(stream);
 
    return stream;
 failure:
@@ -140,7 +140,7 @@ static size_t openmpt_stream_update(ALLEGRO_AUDIO_STREAM *stream, void *data,
 static void openmpt_stream_close(ALLEGRO_AUDIO_STREAM *stream)
 {
    MOD_FILE *const modf = stream->extra;
-   _al_acodec_stop_feed_thread(stream);
+   _al_acodec_stop_feeder(stream);
 
    openmpt_module_destroy(modf->mod);
 
@@ -255,7 +255,7 @@ static ALLEGRO_AUDIO_STREAM *openmpt_stream_init(ALLEGRO_FILE* f,
       stream->get_feeder_position = openmpt_stream_get_position;
       stream->get_feeder_length = openmpt_stream_get_length;
       stream->set_feeder_loop = openmpt_stream_set_loop;
-      _al_acodec_start_feed_thread(stream);
+      _al_acodec_start_feeder(stream);
    }
    else {
       ALLEGRO_ERROR("Failed to create stream.\n");
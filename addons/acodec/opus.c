@@ -316,7 +316,7 @@ static void ogg_stream_close(ALLEGRO_AUDIO_STREAM *stream)
 {
    AL_OP_DATA *extra = (AL_OP_DATA *) stream->extra;
 
-   _al_acodec_stop_feed_thread(stream);
+   _al_acodec_stop_feeder(stream);
 
    al_fclose(extra->file);
 
@@ -451,7 +451,6 @@ ALLEGRO_AUDIO_STREAM *_al_load_ogg_opus_audio_stream_f(ALLEGRO_FILE *file,
 
    extra->loop_start = 0.0;
    extra->loop_end = ogg_stream_get_length(stream);
-   stream->quit_feed_thread = false;
    stream->feeder = ogg_stream_update;
    stream->rewind_feeder = ogg_stream_rewind;
    stream->seek_feeder = ogg_stream_seek;
@@ -459,7 +458,7 @@ ALLEGRO_AUDIO_STREAM *_al_load_ogg_opus_audio_stream_f(ALLEGRO_FILE *file,
    stream->get_feeder_length = ogg_stream_get_length;
    stream->set_feeder_loop = ogg_stream_set_loop;
    stream->unload_feeder = ogg_stream_close;
-   _al_acodec_start_feed_thread(stream);
+   _al_acodec_start_feeder(stream);
 
    return stream;
 }
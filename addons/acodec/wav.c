@@ -285,12 +285,11 @@ static void wav_stream_close(ALLEGRO_AUDIO_STREAM *stream)
 {
    WAVFILE *wavfile = (WAVFILE *) stream->extra;
 
-   _al_acodec_stop_feed_thread(stream);
+   _al_acodec_stop_feeder(stream);
 
    al_fclose(wavfile->f);
    wav_close(wavfile);
    stream->extra = NULL;
-   stream->feed_thread = NULL;
 }
 
 
@@ -332,8 +331,10 @@ ALLEGRO_SAMPLE *_al_load_wav_f(ALLEGRO_FILE *fp)
             _al_count_to_channel_conf(wavfile->channels), true);
 
          if (spl) {
-            memset(data, 0, n);
-            wav_read(wavfile, data, wavfile->samples);
+            /* Only clear what a truncated file leaves unread. */
+            size_t got = wav_read(wavfile, data, wavfile->samples)
+               * wavfile->sample_size;
+            memset(data + got, 0, n - got);
          }
          else {
             al_free(data);
@@ -400,7 +401,7 @@ ALLEGRO_AUDIO_STREAM *_al_load_wav_audio_stream_f(ALLEGRO_FILE* f,
       stream->get_feeder_position = wav_stream_get_position;
       stream->get_feeder_length = wav_stream_get_length;
       stream->set_feeder_loop = wav_stream_set_loop;
-      _al_acodec_start_feed_thread(stream);
+      _al_acodec_start_feeder(stream);
    }
    else {
       ALLEGRO_ERROR("Failed to load wav stream.\n");
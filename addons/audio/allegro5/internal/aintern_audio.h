@@ -57,7 +57,8 @@ typedef enum ALLEGRO_AUDIO_DRIVER_ENUM
    ALLEGRO_AUDIO_DRIVER_AQUEUE     = 0x20005,
    ALLEGRO_AUDIO_DRIVER_PULSEAUDIO = 0x20006,
    ALLEGRO_AUDIO_DRIVER_OPENSL     = 0x20007,
-   ALLEGRO_AUDIO_DRIVER_SDL        = 0x20008
+   ALLEGRO_AUDIO_DRIVER_SDL        = 0x20008,
+   ALLEGRO_AUDIO_DRIVER_OFFLINE    = 0x20009
 } ALLEGRO_AUDIO_DRIVER_ENUM;
 
 typedef struct ALLEGRO_AUDIO_DRIVER ALLEGRO_AUDIO_DRIVER;
@@ -89,6 +90,7 @@ struct ALLEGRO_AUDIO_DRIVER {
 };
 
 extern ALLEGRO_AUDIO_DRIVER *_al_kcm_driver;
+extern ALLEGRO_AUDIO_DRIVER _al_kcm_offline_driver;
 
 const void *_al_voice_update(ALLEGRO_VOICE *voice, ALLEGRO_MUTEX *mutex,
    unsigned int *samples);
@@ -295,11 +297,18 @@ struct ALLEGRO_AUDIO_STREAM {
                           * the stream was started.
                           */
 
-   ALLEGRO_THREAD        *feed_thread;
-   ALLEGRO_MUTEX         *feed_thread_started_mutex;
-   ALLEGRO_COND          *feed_thread_started_cond;
-   bool                  feed_thread_started;
-   volatile bool         quit_feed_thread;
+   bool                  feeding;
+                         /* Set while the stream is refilled by the stream
+                          * feeder pool.
+                          */
+   bool                  feed_pending;
+   bool                  feed_busy;
+   double                feed_deadline;
+                         /* Scheduling state, protected by the feeder pool's
+                          * mutex.  'feed_deadline' is when the stream is
+                          * expected to run out of queued data.
+                          */
+   bool                  finished_event_sent;
    unload_feeder_t       unload_feeder;
    rewind_feeder_t       rewind_feeder;
    seek_feeder_t         seek_feeder;
@@ -344,6 +353,12 @@ struct ALLEGRO_MIXER {
                            /* Vector of ALLEGRO_SAMPLE_INSTANCE*.  Holds the list of
                             * streams being mixed together.
                             */
+   bool                    parallel;
+                           /* Render attached mixers on the mixer thread pool. */
+   bool                    rendered;
+                           /* The buffer already holds this period's output,
+                            * rendered by a parallel parent mixer.
+                            */
    _AL_LIST_ITEM           *dtor_item;
 };
 
@@ -368,13 +383,20 @@ struct ALLEGRO_AUDIO_DEVICE {
 };
 
 /* Supposedly internal */
-ALLEGRO_KCM_AUDIO_FUNC(void*, _al_kcm_feed_stream, (ALLEGRO_THREAD *self, void *vstream));
+bool _al_kcm_feed_stream_fragment(ALLEGRO_AUDIO_STREAM *stream);
+void _al_kcm_init_stream_feeder(void);
+void _al_kcm_shutdown_stream_feeder(void);
+ALLEGRO_KCM_AUDIO_FUNC(void, _al_kcm_start_stream_feeder, (ALLEGRO_AUDIO_STREAM *stream));
+ALLEGRO_KCM_AUDIO_FUNC(void, _al_kcm_stop_stream_feeder, (ALLEGRO_AUDIO_STREAM *stream));
+void _al_kcm_wake_stream_feeder(ALLEGRO_AUDIO_STREAM *stream);
 
 /* Helper to emit an event that the stream has got a buffer ready to be refilled. */
 void _al_kcm_emit_stream_events(ALLEGRO_AUDIO_STREAM *stream);
 
 void _al_kcm_init_destructors(void);
 void _al_kcm_shutdown_destructors(void);
+void _al_kcm_init_mixer_pool(void);
+void _al_kcm_shutdown_mixer_pool(void);
 _AL_LIST_ITEM *_al_kcm_register_destructor(char const *name, void *object,
    void (*func)(void*));
 void _al_kcm_unregister_destructor(_AL_LIST_ITEM *dtor_item);
@@ -0,0 +1,273 @@
+/*
+ * Allegro audio stream feeders
+ *
+ * Streams loaded from files are refilled by a fixed pool of worker threads
+ * shared by all streams.  Whenever a stream has free fragments, the mixer
+ * wakes the pool with an estimate of when the stream will run dry, and the
+ * workers always refill the stream with the earliest such deadline first.
+ * A worker fills one fragment at a time and then puts the stream back with
+ * a new deadline, so a stream with many free fragments can't hold up one
+ * which is about to underrun.
+ */
+
+#include "allegro5/allegro_audio.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_audio.h"
+#include "allegro5/internal/aintern_audio_cfg.h"
+#include "allegro5/internal/aintern_vector.h"
+
+ALLEGRO_DEBUG_CHANNEL("audio")
+
+#define MAX_FEEDER_THREADS    16
+
+static struct {
+   ALLEGRO_MUTEX *mutex;
+   ALLEGRO_COND *work_cond;
+   ALLEGRO_COND *idle_cond;
+   ALLEGRO_THREAD *threads[MAX_FEEDER_THREADS];
+   int num_threads;
+   _AL_VECTOR streams;
+   bool quit;
+} feeder;
+
+
+/* stream_deadline:
+ *  Returns the time at which the stream will have played everything it
+ *  has queued.  The stream's mutex must be held.
+ */
+static double stream_deadline(const ALLEGRO_AUDIO_STREAM *stream)
+{
+   double rate = stream->spl.spl_data.frequency * stream->spl.speed;
+   double frames = 0;
+   unsigned int i;
+
+   for (i = 0; i < stream->buf_count && stream->pending_bufs[i]; i++)
+      frames += stream->spl.spl_data.len;
+   if (frames > 0)
+      frames -= _ALLEGRO_MIN(stream->spl.pos, stream->spl.spl_data.len);
+
+   if (rate <= 0)
+      return al_get_time() + 3600.0;
+   return al_get_time() + frames / rate;
+}
+
+
+/* next_stream:
+ *  Returns the waiting stream with the earliest deadline, or NULL.  A
+ *  linear scan is plenty for the number of streams a game plays at once.
+ */
+static ALLEGRO_AUDIO_STREAM *next_stream(void)
+{
+   ALLEGRO_AUDIO_STREAM *best = NULL;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&feeder.streams); i++) {
+      ALLEGRO_AUDIO_STREAM **slot = _al_vector_ref(&feeder.streams, i);
+      ALLEGRO_AUDIO_STREAM *stream = *slot;
+
+      if (!stream->feed_pending || stream->feed_busy)
+         continue;
+      if (!best || stream->feed_deadline < best->feed_deadline)
+         best = stream;
+   }
+
+   return best;
+}
+
+
+static void *feeder_worker(ALLEGRO_THREAD *thread, void *arg)
+{
+   (void)thread;
+   (void)arg;
+
+   al_lock_mutex(feeder.mutex);
+   for (;;) {
+      ALLEGRO_AUDIO_STREAM *stream;
+      ALLEGRO_MUTEX *stream_mutex;
+      bool more;
+      double deadline = 0;
+
+      while (!feeder.quit && !(stream = next_stream()))
+         al_wait_cond(feeder.work_cond, feeder.mutex);
+      if (feeder.quit)
+         break;
+
+      stream->feed_pending = false;
+      stream->feed_busy = true;
+      al_unlock_mutex(feeder.mutex);
+
+      more = _al_kcm_feed_stream_fragment(stream);
+      if (more) {
+         stream_mutex = stream->spl.mutex;
+         if (stream_mutex)
+            al_lock_mutex(stream_mutex);
+         more = al_get_available_audio_stream_fragments(stream) > 0;
+         deadline = stream_deadline(stream);
+         if (stream_mutex)
+            al_unlock_mutex(stream_mutex);
+      }
+
+      al_lock_mutex(feeder.mutex);
+      stream->feed_busy = false;
+      if (more && !stream->feed_pending) {
+         stream->feed_pending = true;
+         stream->feed_deadline = deadline;
+      }
+      al_broadcast_cond(feeder.idle_cond);
+   }
+   al_unlock_mutex(feeder.mutex);
+
+   return NULL;
+}
+
+
+/* The number of workers comes from the stream_feeder_threads option in
+ * the [audio] section of the system config and defaults to the number of
+ * CPUs, up to 4.
+ */
+static void start_feeder_workers(void)
+{
+   const char *value = al_get_config_value(al_get_system_config(),
+      "audio", "stream_feeder_threads");
+   int n = value ? atoi(value) : _ALLEGRO_MIN(al_get_cpu_count(), 4);
+   int i;
+
+   n = _ALLEGRO_CLAMP(1, n, MAX_FEEDER_THREADS);
+
+   for (i = 0; i < n; i++) {
+      feeder.threads[i] = al_create_thread(feeder_worker, NULL);
+      if (!feeder.threads[i])
+         break;
+      al_start_thread(feeder.threads[i]);
+   }
+   feeder.num_threads = i;
+   ALLEGRO_INFO("Started %d stream feeder threads.\n", feeder.num_threads);
+}
+
+
+static void stop_feeder_workers(void)
+{
+   int i;
+
+   al_lock_mutex(feeder.mutex);
+   feeder.quit = true;
+   al_broadcast_cond(feeder.work_cond);
+   al_unlock_mutex(feeder.mutex);
+
+   for (i = 0; i < feeder.num_threads; i++)
+      al_destroy_thread(feeder.threads[i]);
+
+   feeder.num_threads = 0;
+   feeder.quit = false;
+}
+
+
+/* _al_kcm_init_stream_feeder:
+ *  Sets up the stream feeder pool.  The threads are only started when the
+ *  first stream is added.
+ */
+void _al_kcm_init_stream_feeder(void)
+{
+   if (feeder.mutex)
+      return;
+
+   feeder.mutex = al_create_mutex();
+   feeder.work_cond = al_create_cond();
+   feeder.idle_cond = al_create_cond();
+   _al_vector_init(&feeder.streams, sizeof(ALLEGRO_AUDIO_STREAM *));
+}
+
+
+/* _al_kcm_shutdown_stream_feeder:
+ *  Stops the stream feeder threads.  Does nothing if streams still need
+ *  them, since streams outlive the audio subsystem.
+ */
+void _al_kcm_shutdown_stream_feeder(void)
+{
+   if (!feeder.mutex)
+      return;
+
+   if (!_al_vector_is_empty(&feeder.streams)) {
+      ALLEGRO_WARN("Streams still being fed, keeping the feeder threads.\n");
+      return;
+   }
+
+   if (feeder.num_threads > 0)
+      stop_feeder_workers();
+
+   _al_vector_free(&feeder.streams);
+   al_destroy_cond(feeder.idle_cond);
+   al_destroy_cond(feeder.work_cond);
+   al_destroy_mutex(feeder.mutex);
+   feeder.mutex = NULL;
+}
+
+
+/* _al_kcm_start_stream_feeder:
+ *  Fills the first fragment of the stream on the calling thread, then
+ *  hands the stream over to the feeder pool.
+ */
+void _al_kcm_start_stream_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ALLEGRO_AUDIO_STREAM **slot;
+
+   _al_kcm_init_stream_feeder();
+
+   stream->finished_event_sent = false;
+   _al_kcm_feed_stream_fragment(stream);
+
+   al_lock_mutex(feeder.mutex);
+   if (feeder.num_threads == 0)
+      start_feeder_workers();
+   slot = _al_vector_alloc_back(&feeder.streams);
+   *slot = stream;
+   stream->feed_pending = false;
+   stream->feed_busy = false;
+   stream->feeding = true;
+   al_unlock_mutex(feeder.mutex);
+}
+
+
+/* _al_kcm_stop_stream_feeder:
+ *  Removes the stream from the feeder pool, waiting for any fragment being
+ *  filled to finish, and emits ALLEGRO_EVENT_AUDIO_STREAM_FINISHED.
+ */
+void _al_kcm_stop_stream_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ALLEGRO_EVENT fin_event;
+
+   if (!stream->feeding)
+      return;
+
+   al_lock_mutex(feeder.mutex);
+   _al_vector_find_and_delete(&feeder.streams, &stream);
+   while (stream->feed_busy)
+      al_wait_cond(feeder.idle_cond, feeder.mutex);
+   stream->feed_pending = false;
+   stream->feeding = false;
+   al_unlock_mutex(feeder.mutex);
+
+   fin_event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FINISHED;
+   fin_event.user.timestamp = al_get_time();
+   al_emit_user_event(&stream->spl.es, &fin_event, NULL);
+}
+
+
+/* _al_kcm_wake_stream_feeder:
+ *  Tells the feeder pool that the stream has free fragments.  The stream's
+ *  mutex must be held.
+ */
+void _al_kcm_wake_stream_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   double deadline = stream_deadline(stream);
+
+   al_lock_mutex(feeder.mutex);
+   if (stream->feeding && !stream->feed_pending) {
+      stream->feed_pending = true;
+      stream->feed_deadline = deadline;
+      al_signal_cond(feeder.work_cond);
+   }
+   al_unlock_mutex(feeder.mutex);
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -15,9 +15,34 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_audio.h"
 #include "allegro5/internal/aintern_audio_cfg.h"
+#include "allegro5/internal/aintern_cpu.h"
 
 ALLEGRO_DEBUG_CHANNEL("audio")
 
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define ALLEGRO_KCM_SSE2
+      #include <emmintrin.h>
+   #endif
+   #if (defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__)) && \
+         (defined(__x86_64__) || defined(__i386__))) || \
+      (defined(_MSC_VER) && _MSC_VER >= 1700 && \
+         (defined(_M_X64) || defined(_M_IX86)))
+      #define ALLEGRO_KCM_AVX2
+      #include <immintrin.h>
+      #ifdef __GNUC__
+         #define _AL_TARGET_AVX2 __attribute__((target("avx2")))
+      #else
+         #define _AL_TARGET_AVX2
+      #endif
+   #endif
+   #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+      #define ALLEGRO_KCM_NEON
+      #include <arm_neon.h>
+   #endif
+#endif
+
 
 typedef union {
    float f32[ALLEGRO_MAX_CHANNELS]; /* max: 7.1 */
@@ -278,11 +303,497 @@ static INLINE int32_t clamp(int32_t val, int32_t min, int32_t max)
 }
 
 
+/* Block mixing for float32 mixers.
+ *
+ * Away from the loop points and the end of the sample data, the per-frame
+ * mixers below spend most of their time switching on the sample depth and
+ * the channel count.  For those stretches we instead convert a run of
+ * source frames to float32 in one go, resample them into one plane per
+ * channel, and apply the channel matrix to a whole block of output frames,
+ * with SIMD where available.  The arithmetic is done in the same order as
+ * in the per-frame path so both produce the same output.
+ */
+#define BLOCK_FRAMES       128
+#define BLOCK_SRC_FRAMES   256
+
+typedef void (*MATRIX_KERNEL)(float *buf, float (*planes)[BLOCK_FRAMES],
+   int n, const float *matrix, int maxc, int dest_maxc);
+
+static MATRIX_KERNEL apply_matrix_block;
+
+
+/* convert_block:
+ *  Converts count frames starting at frame first to float32.
+ */
+static void convert_block(const ALLEGRO_SAMPLE_INSTANCE *spl, int first,
+   int count, int maxc, float *out)
+{
+   int i0 = first * maxc;
+   int n = count * maxc;
+   int i = 0;
+
+   switch (spl->spl_data.depth) {
+      case ALLEGRO_AUDIO_DEPTH_FLOAT32:
+         memcpy(out, spl->spl_data.buffer.f32 + i0, n * sizeof(float));
+         break;
+
+      case ALLEGRO_AUDIO_DEPTH_INT24:
+         for (; i < n; i++)
+            out[i] = (float) spl->spl_data.buffer.s24[i0 + i] / ((float) 0x7FFFFF + 0.5f);
+         break;
+
+      case ALLEGRO_AUDIO_DEPTH_UINT24:
+         for (; i < n; i++)
+            out[i] = (float) spl->spl_data.buffer.u24[i0 + i] / ((float) 0x7FFFFF + 0.5f) - 1.0f;
+         break;
+
+      case ALLEGRO_AUDIO_DEPTH_INT16: {
+         const int16_t *src = spl->spl_data.buffer.s16 + i0;
+#ifdef ALLEGRO_KCM_SSE2
+         if (_al_get_cpu_capabilities() & _AL_CPU_SSE2) {
+            const __m128 scale = _mm_set1_ps((float) 0x7FFF + 0.5f);
+            for (; i + 8 <= n; i += 8) {
+               __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+               __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+               __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+               _mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(lo), scale));
+               _mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale));
+            }
+         }
+#endif
+         for (; i < n; i++)
+            out[i] = (float) src[i] / ((float) 0x7FFF + 0.5f);
+         break;
+      }
+
+      case ALLEGRO_AUDIO_DEPTH_UINT16:
+         for (; i < n; i++)
+            out[i] = (float) spl->spl_data.buffer.u16[i0 + i] / ((float) 0x7FFF + 0.5f) - 1.0f;
+         break;
+
+      case ALLEGRO_AUDIO_DEPTH_INT8:
+         for (; i < n; i++)
+            out[i] = (float) spl->spl_data.buffer.s8[i0 + i] / ((float) 0x7F + 0.5f);
+         break;
+
+      case ALLEGRO_AUDIO_DEPTH_UINT8:
+         for (; i < n; i++)
+            out[i] = (float) spl->spl_data.buffer.u8[i0 + i] / ((float) 0x7F + 0.5f) - 1.0f;
+         break;
+   }
+}
+
+
+/* resample_block:
+ *  Resamples n output frames from the float32 frames in src into one plane
+ *  per channel, advancing the sample position as it goes.  src starts at
+ *  the first frame that is read, i.e. p0 of the first output frame.
+ */
+static void resample_block(ALLEGRO_SAMPLE_INSTANCE *spl, const float *src,
+   int n, int maxc, bool linear, float (*planes)[BLOCK_FRAMES])
+{
+   int delta = spl->step / spl->step_denom;
+   int delta_error = spl->step - delta * spl->step_denom;
+   int err = spl->pos_bresenham_error;
+   int p = 0;
+   int i, k;
+
+   for (k = 0; k < n; k++) {
+      const float *x0 = src + p * maxc;
+
+      if (linear) {
+         const float *x1 = x0 + maxc;
+         const float t = (float) err / spl->step_denom;
+         for (i = 0; i < maxc; i++)
+            planes[i][k] = (x0[i] * (1.0f - t)) + (x1[i] * t);
+      }
+      else {
+         for (i = 0; i < maxc; i++)
+            planes[i][k] = x0[i];
+      }
+
+      p += delta;
+      err += delta_error;
+      if (err >= spl->step_denom) {
+         p++;
+         err -= spl->step_denom;
+      }
+   }
+
+   spl->pos += p;
+   spl->pos_bresenham_error = err;
+}
+
+
+/* The matrix kernels add n frames of matrix * planes to buf.  The terms
+ * are summed from the last source channel down to the first, like the
+ * fall-through switch in MAKE_MIXER.
+ */
+static void apply_matrix_frames(float *buf, float (*planes)[BLOCK_FRAMES],
+   int k0, int n, const float *matrix, int maxc, int dest_maxc)
+{
+   int i, k, c;
+
+   for (k = k0; k < n; k++) {
+      for (c = 0; c < dest_maxc; c++) {
+         const float *m = matrix + c * maxc;
+         float acc = *buf;
+         for (i = maxc - 1; i >= 0; i--)
+            acc += planes[i][k] * m[i];
+         *buf++ = acc;
+      }
+   }
+}
+
+
+static void apply_matrix_block_c(float *buf, float (*planes)[BLOCK_FRAMES],
+   int n, const float *matrix, int maxc, int dest_maxc)
+{
+   apply_matrix_frames(buf, planes, 0, n, matrix, maxc, dest_maxc);
+}
+
+
+/* The vector kernels only handle dest_maxc of 1, 2, 4 or 8, so that every
+ * vector starts at a frame boundary.  Lane l of coef[i] holds the
+ * coefficient of source channel i for destination channel l % dest_maxc.
+ */
+static bool spread_matrix(const float *matrix, int maxc, int dest_maxc,
+   float coef[ALLEGRO_MAX_CHANNELS][8])
+{
+   int i, l;
+
+   if (dest_maxc != 1 && dest_maxc != 2 && dest_maxc != 4 && dest_maxc != 8)
+      return false;
+
+   for (i = 0; i < maxc; i++) {
+      for (l = 0; l < 8; l++)
+         coef[i][l] = matrix[(l % dest_maxc) * maxc + i];
+   }
+   return true;
+}
+
+
+#ifdef ALLEGRO_KCM_SSE2
+static void apply_matrix_block_sse2(float *buf, float (*planes)[BLOCK_FRAMES],
+   int n, const float *matrix, int maxc, int dest_maxc)
+{
+   float coef[ALLEGRO_MAX_CHANNELS][8];
+   int i, j, k;
+
+   if (!spread_matrix(matrix, maxc, dest_maxc, coef)) {
+      apply_matrix_frames(buf, planes, 0, n, matrix, maxc, dest_maxc);
+      return;
+   }
+
+   /* Four frames, i.e. dest_maxc vectors, per iteration. */
+   for (k = 0; k + 4 <= n; k += 4) {
+      __m128 acc[8];
+
+      for (j = 0; j < dest_maxc; j++)
+         acc[j] = _mm_loadu_ps(buf + 4 * j);
+
+      for (i = maxc - 1; i >= 0; i--) {
+         const float *p = planes[i] + k;
+         const __m128 c0 = _mm_loadu_ps(coef[i]);
+         const __m128 v = _mm_loadu_ps(p);
+
+         switch (dest_maxc) {
+            case 1:
+               acc[0] = _mm_add_ps(acc[0], _mm_mul_ps(v, c0));
+               break;
+            case 2:
+               acc[0] = _mm_add_ps(acc[0], _mm_mul_ps(_mm_unpacklo_ps(v, v), c0));
+               acc[1] = _mm_add_ps(acc[1], _mm_mul_ps(_mm_unpackhi_ps(v, v), c0));
+               break;
+            case 4:
+               for (j = 0; j < 4; j++)
+                  acc[j] = _mm_add_ps(acc[j], _mm_mul_ps(_mm_set1_ps(p[j]), c0));
+               break;
+            case 8: {
+               const __m128 c1 = _mm_loadu_ps(coef[i] + 4);
+               for (j = 0; j < 4; j++) {
+                  const __m128 x = _mm_set1_ps(p[j]);
+                  acc[2 * j] = _mm_add_ps(acc[2 * j], _mm_mul_ps(x, c0));
+                  acc[2 * j + 1] = _mm_add_ps(acc[2 * j + 1], _mm_mul_ps(x, c1));
+               }
+               break;
+            }
+         }
+      }
+
+      for (j = 0; j < dest_maxc; j++)
+         _mm_storeu_ps(buf + 4 * j, acc[j]);
+      buf += 4 * dest_maxc;
+   }
+
+   apply_matrix_frames(buf, planes, k, n, matrix, maxc, dest_maxc);
+}
+#endif
+
+
+#ifdef ALLEGRO_KCM_AVX2
+static INLINE _AL_TARGET_AVX2 __m256 avx2_combine(__m128 lo, __m128 hi)
+{
+   return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+
+static _AL_TARGET_AVX2 void apply_matrix_block_avx2(float *buf,
+   float (*planes)[BLOCK_FRAMES], int n, const float *matrix, int maxc,
+   int dest_maxc)
+{
+   float coef[ALLEGRO_MAX_CHANNELS][8];
+   int i, j, k;
+
+   if (!spread_matrix(matrix, maxc, dest_maxc, coef)) {
+      apply_matrix_frames(buf, planes, 0, n, matrix, maxc, dest_maxc);
+      return;
+   }
+
+   /* Eight frames, i.e. dest_maxc vectors, per iteration. */
+   for (k = 0; k + 8 <= n; k += 8) {
+      __m256 acc[8];
+
+      for (j = 0; j < dest_maxc; j++)
+         acc[j] = _mm256_loadu_ps(buf + 8 * j);
+
+      for (i = maxc - 1; i >= 0; i--) {
+         const float *p = planes[i] + k;
+         const __m256 c = _mm256_loadu_ps(coef[i]);
+
+         switch (dest_maxc) {
+            case 1:
+               acc[0] = _mm256_add_ps(acc[0],
+                  _mm256_mul_ps(_mm256_loadu_ps(p), c));
+               break;
+            case 2:
+               for (j = 0; j < 2; j++) {
+                  const __m128 v = _mm_loadu_ps(p + 4 * j);
+                  const __m256 x = avx2_combine(_mm_unpacklo_ps(v, v),
+                     _mm_unpackhi_ps(v, v));
+                  acc[j] = _mm256_add_ps(acc[j], _mm256_mul_ps(x, c));
+               }
+               break;
+            case 4:
+               for (j = 0; j < 4; j++) {
+                  const __m256 x = avx2_combine(_mm_set1_ps(p[2 * j]),
+                     _mm_set1_ps(p[2 * j + 1]));
+                  acc[j] = _mm256_add_ps(acc[j], _mm256_mul_ps(x, c));
+               }
+               break;
+            case 8:
+               for (j = 0; j < 8; j++) {
+                  acc[j] = _mm256_add_ps(acc[j],
+                     _mm256_mul_ps(_mm256_set1_ps(p[j]), c));
+               }
+               break;
+         }
+      }
+
+      for (j = 0; j < dest_maxc; j++)
+         _mm256_storeu_ps(buf + 8 * j, acc[j]);
+      buf += 8 * dest_maxc;
+   }
+
+   apply_matrix_frames(buf, planes, k, n, matrix, maxc, dest_maxc);
+}
+#endif
+
+
+#ifdef ALLEGRO_KCM_NEON
+static void apply_matrix_block_neon(float *buf, float (*planes)[BLOCK_FRAMES],
+   int n, const float *matrix, int maxc, int dest_maxc)
+{
+   float coef[ALLEGRO_MAX_CHANNELS][8];
+   int i, j, k;
+
+   if (!spread_matrix(matrix, maxc, dest_maxc, coef)) {
+      apply_matrix_frames(buf, planes, 0, n, matrix, maxc, dest_maxc);
+      return;
+   }
+
+   /* Four frames, i.e. dest_maxc vectors, per iteration.  Multiplies and
+    * adds are kept separate so the rounding matches the C code.
+    */
+   for (k = 0; k + 4 <= n; k += 4) {
+      float32x4_t acc[8];
+
+      for (j = 0; j < dest_maxc; j++)
+         acc[j] = vld1q_f32(buf + 4 * j);
+
+      for (i = maxc - 1; i >= 0; i--) {
+         const float *p = planes[i] + k;
+         const float32x4_t c0 = vld1q_f32(coef[i]);
+         const float32x4_t v = vld1q_f32(p);
+
+         switch (dest_maxc) {
+            case 1:
+               acc[0] = vaddq_f32(acc[0], vmulq_f32(v, c0));
+               break;
+            case 2: {
+               const float32x4x2_t z = vzipq_f32(v, v);
+               acc[0] = vaddq_f32(acc[0], vmulq_f32(z.val[0], c0));
+               acc[1] = vaddq_f32(acc[1], vmulq_f32(z.val[1], c0));
+               break;
+            }
+            case 4:
+               for (j = 0; j < 4; j++)
+                  acc[j] = vaddq_f32(acc[j], vmulq_f32(vdupq_n_f32(p[j]), c0));
+               break;
+            case 8: {
+               const float32x4_t c1 = vld1q_f32(coef[i] + 4);
+               for (j = 0; j < 4; j++) {
+                  const float32x4_t x = vdupq_n_f32(p[j]);
+                  acc[2 * j] = vaddq_f32(acc[2 * j], vmulq_f32(x, c0));
+                  acc[2 * j + 1] = vaddq_f32(acc[2 * j + 1], vmulq_f32(x, c1));
+               }
+               break;
+            }
+         }
+      }
+
+      for (j = 0; j < dest_maxc; j++)
+         vst1q_f32(buf + 4 * j, acc[j]);
+      buf += 4 * dest_maxc;
+   }
+
+   apply_matrix_frames(buf, planes, k, n, matrix, maxc, dest_maxc);
+}
+#endif
+
+
+/* init_block_kernels:
+ *  Picks the matrix kernel for the instruction sets the CPU supports.
+ */
+static void init_block_kernels(void)
+{
+   int caps = _al_get_cpu_capabilities();
+   (void)caps;
+
+   apply_matrix_block = apply_matrix_block_c;
+#ifdef ALLEGRO_KCM_SSE2
+   if (caps & _AL_CPU_SSE2)
+      apply_matrix_block = apply_matrix_block_sse2;
+#endif
+#ifdef ALLEGRO_KCM_AVX2
+   if (caps & _AL_CPU_AVX2)
+      apply_matrix_block = apply_matrix_block_avx2;
+#endif
+#ifdef ALLEGRO_KCM_NEON
+   if (caps & _AL_CPU_NEON)
+      apply_matrix_block = apply_matrix_block_neon;
+#endif
+}
+
+
+/* mix_block_float_32:
+ *  Mixes as many frames as possible, up to samples_l, without reaching a
+ *  loop point or the end of the sample data.  Returns the number of frames
+ *  mixed, which may be zero.
+ */
+static size_t mix_block_float_32(ALLEGRO_SAMPLE_INSTANCE *spl, float *buf,
+   size_t samples_l, int maxc, int dest_maxc, bool linear)
+{
+   /* Linear interpolation reads one more frame than point sampling.
+    * Streams keep the previous frame before the start of the buffer, so
+    * there the extra frame is the one before spl->pos.
+    */
+   const int lin = linear ? 1 : 0;
+   int first = 0;
+   int limit;
+   int64_t avail;
+   size_t n, done;
+
+   if (spl->step <= 0 || spl->pos < 0)
+      return 0;
+
+   switch (spl->loop) {
+      case ALLEGRO_PLAYMODE_ONCE:
+         limit = spl->spl_data.len - lin;
+         break;
+      case ALLEGRO_PLAYMODE_LOOP:
+      case ALLEGRO_PLAYMODE_LOOP_ONCE:
+      case ALLEGRO_PLAYMODE_BIDIR:
+         limit = spl->loop_end - lin;
+         break;
+      case _ALLEGRO_PLAYMODE_STREAM_ONCE:
+      case _ALLEGRO_PLAYMODE_STREAM_LOOP_ONCE:
+      case _ALLEGRO_PLAYMODE_STREAM_ONEDIR:
+         limit = spl->spl_data.len;
+         first = -lin;
+         break;
+      default:
+         return 0;
+   }
+
+   /* The position after k frames is
+    * pos + (k * step + pos_bresenham_error) / step_denom.
+    */
+   avail = (int64_t)(limit - spl->pos) * spl->step_denom
+      - spl->pos_bresenham_error;
+   if (avail <= 0)
+      return 0;
+   n = (avail + spl->step - 1) / spl->step;
+   if (n > samples_l)
+      n = samples_l;
+
+   for (done = 0; done < n; ) {
+      float planes[ALLEGRO_MAX_CHANNELS][BLOCK_FRAMES];
+      float tmp[BLOCK_SRC_FRAMES * ALLEGRO_MAX_CHANNELS];
+      const float *src;
+      int count = _ALLEGRO_MIN(n - done, BLOCK_FRAMES);
+
+      if (spl->spl_data.depth == ALLEGRO_AUDIO_DEPTH_FLOAT32) {
+         src = spl->spl_data.buffer.f32 + (spl->pos + first) * maxc;
+      }
+      else {
+         /* Limit the block to what fits in the conversion buffer. */
+         int64_t room = (int64_t)(BLOCK_SRC_FRAMES - lin) * spl->step_denom
+            - spl->pos_bresenham_error - 1;
+         int frames;
+
+         if (room / spl->step + 1 < count)
+            count = room / spl->step + 1;
+         frames = ((int64_t)(count - 1) * spl->step
+            + spl->pos_bresenham_error) / spl->step_denom + 1 + lin;
+         convert_block(spl, spl->pos + first, frames, maxc, tmp);
+         src = tmp;
+      }
+
+      resample_block(spl, src, count, maxc, linear, planes);
+      apply_matrix_block(buf, planes, count, spl->matrix, maxc, dest_maxc);
+      buf += count * dest_maxc;
+      done += count;
+   }
+
+   return n;
+}
+
+
+static size_t mix_block_point_float_32(ALLEGRO_SAMPLE_INSTANCE *spl,
+   float *buf, size_t samples_l, int maxc, int dest_maxc)
+{
+   return mix_block_float_32(spl, buf, samples_l, maxc, dest_maxc, false);
+}
+
+
+static size_t mix_block_linear_float_32(ALLEGRO_SAMPLE_INSTANCE *spl,
+   float *buf, size_t samples_l, int maxc, int dest_maxc)
+{
+   return mix_block_float_32(spl, buf, samples_l, maxc, dest_maxc, true);
+}
+
+
+#define NO_BLOCK(spl, buf, samples_l, maxc, dest_maxc)   0
+
+
 /* Mix as many sample values as possible from the source sample into a mixer
  * buffer.  Implements stream_reader_t.
  *
  * TYPE is the type of the sample values in the mixer buffer, and
- * NEXT_SAMPLE_VALUE must return a buffer of the same type.
+ * NEXT_SAMPLE_VALUE must return a buffer of the same type.  BLOCK_MIXER
+ * is tried first at each position and mixes a run of frames at once, or
+ * returns 0 to fall back to NEXT_SAMPLE_VALUE for the next frame.
  *
  * Note: Uses Bresenham to keep the precise sample position.
  */
@@ -293,7 +804,7 @@ static INLINE int32_t clamp(int32_t val, int32_t min, int32_t max)
       delta_error = spl->step - delta * spl->step_denom;                      \
    } while (0)
 
-#define MAKE_MIXER(NAME, NEXT_SAMPLE_VALUE, TYPE)                             \
+#define MAKE_MIXER(NAME, NEXT_SAMPLE_VALUE, BLOCK_MIXER, TYPE)                \
 static void NAME(void *source, void **vbuf, unsigned int *samples,            \
    ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)                        \
 {                                                                             \
@@ -301,7 +812,7 @@ static void NAME(void *source, void **vbuf, unsigned int *samples,            \
    TYPE *buf = *vbuf;                                                         \
    size_t maxc = al_get_channel_count(spl->spl_data.chan_conf);               \
    size_t samples_l = *samples;                                               \
-   size_t c;                                                                  \
+   size_t c, n;                                                               \
    int delta, delta_error;                                                    \
    SAMP_BUF samp_buf;                                                         \
                                                                               \
@@ -320,7 +831,13 @@ static void NAME(void *source, void **vbuf, unsigned int *samples,            \
          BRESENHAM;                                                           \
       }                                                                       \
                                                                               \
-      /* It might be worth preparing multiple sample values at once. */       \
+      n = BLOCK_MIXER(spl, buf, samples_l, maxc, dest_maxc);                  \
+      if (n > 0) {                                                            \
+         buf += n * dest_maxc;                                                \
+         samples_l -= n;                                                      \
+         continue;                                                            \
+      }                                                                       \
+                                                                              \
       s = (TYPE *) NEXT_SAMPLE_VALUE(&samp_buf, spl, maxc);                   \
                                                                               \
       for (c = 0; c < dest_maxc; c++) {                                       \
@@ -359,32 +876,240 @@ static void NAME(void *source, void **vbuf, unsigned int *samples,            \
    (void)buffer_depth;                                                        \
 }
 
-MAKE_MIXER(read_to_mixer_point_float_32, point_spl32, float)
-MAKE_MIXER(read_to_mixer_linear_float_32, linear_spl32, float)
-MAKE_MIXER(read_to_mixer_cubic_float_32, cubic_spl32, float)
-MAKE_MIXER(read_to_mixer_point_int16_t_16, point_spl16, int16_t)
-MAKE_MIXER(read_to_mixer_linear_int16_t_16, linear_spl16, int16_t)
+MAKE_MIXER(read_to_mixer_point_float_32, point_spl32,
+   mix_block_point_float_32, float)
+MAKE_MIXER(read_to_mixer_linear_float_32, linear_spl32,
+   mix_block_linear_float_32, float)
+MAKE_MIXER(read_to_mixer_cubic_float_32, cubic_spl32, NO_BLOCK, float)
+MAKE_MIXER(read_to_mixer_point_int16_t_16, point_spl16, NO_BLOCK, int16_t)
+MAKE_MIXER(read_to_mixer_linear_int16_t_16, linear_spl16, NO_BLOCK, int16_t)
 
 #undef MAKE_MIXER
+#undef NO_BLOCK
 
 
-/* _al_kcm_mixer_read:
- *  Mixes the streams attached to the mixer and writes additively to the
- *  specified buffer (or if *buf is NULL, indicating a voice, convert it and
- *  set it to the buffer pointer).
+/* Parallel mixers.
+ *
+ * A mixer with al_set_mixer_parallel enabled first renders the mixers
+ * attached to it on a fixed pool of worker threads, each into its own
+ * buffer, and then mixes its attachments in the usual order.  Only the
+ * rendering is spread out; the child buffers are added to the parent in
+ * the same order as when mixing serially, so the output is the same in
+ * both modes.
+ *
+ * There is a single pool, so while it is busy other parallel mixers,
+ * including parallel mixers nested inside a job, are mixed serially.
  */
-void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
-   ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+#define MAX_MIXER_THREADS     16
+#define MAX_PARALLEL_MIXERS   64
+
+typedef struct MIXER_JOB {
+   ALLEGRO_MIXER *mixers[MAX_PARALLEL_MIXERS];
+   int num_mixers;
+   unsigned int samples;
+   int next;
+} MIXER_JOB;
+
+static struct {
+   ALLEGRO_MUTEX *mutex;
+   ALLEGRO_COND *work_cond;
+   ALLEGRO_COND *done_cond;
+   ALLEGRO_THREAD *threads[MAX_MIXER_THREADS];
+   int num_threads;
+   bool started;
+   MIXER_JOB *job;
+   unsigned int generation;
+   int busy;
+   bool quit;
+} pool;
+
+static bool render_mixer(ALLEGRO_MIXER *m, unsigned int *samples);
+
+
+/* The calling thread and the workers all render mixers until none are
+ * left.
+ */
+static void render_job_mixers(MIXER_JOB *job)
 {
-   const ALLEGRO_MIXER *mixer;
-   ALLEGRO_MIXER *m = (ALLEGRO_MIXER *)source;
-   int maxc = al_get_channel_count(m->ss.spl_data.chan_conf);
-   int samples_l = *samples;
+   for (;;) {
+      ALLEGRO_MIXER *child;
+      unsigned int samples = job->samples;
+      int i;
+
+      al_lock_mutex(pool.mutex);
+      i = job->next++;
+      al_unlock_mutex(pool.mutex);
+
+      if (i >= job->num_mixers)
+         break;
+
+      child = job->mixers[i];
+      child->rendered = render_mixer(child, &samples);
+   }
+}
+
+
+static void *mixer_worker(ALLEGRO_THREAD *thread, void *arg)
+{
+   /* Workers are started before the job they are meant for is posted. */
+   unsigned int generation = (unsigned int)(uintptr_t)arg;
+   (void)thread;
+
+   al_lock_mutex(pool.mutex);
+   for (;;) {
+      MIXER_JOB *job;
+
+      while (!pool.quit && pool.generation == generation)
+         al_wait_cond(pool.work_cond, pool.mutex);
+      if (pool.quit)
+         break;
+      generation = pool.generation;
+      job = pool.job;
+      al_unlock_mutex(pool.mutex);
+
+      render_job_mixers(job);
+
+      al_lock_mutex(pool.mutex);
+      if (--pool.busy == 0)
+         al_broadcast_cond(pool.done_cond);
+   }
+   al_unlock_mutex(pool.mutex);
+
+   return NULL;
+}
+
+
+/* Starts the workers on first use.  The number of threads, counting the
+ * one mixing, comes from the mixer_threads option in the [audio] section
+ * of the system config and defaults to the number of CPUs.
+ */
+static void start_mixer_workers(void)
+{
+   const char *value = al_get_config_value(al_get_system_config(),
+      "audio", "mixer_threads");
+   int n = value ? atoi(value) : al_get_cpu_count();
    int i;
 
-   if (!m->ss.is_playing)
+   pool.started = true;
+   n = _ALLEGRO_CLAMP(0, n - 1, MAX_MIXER_THREADS);
+
+   for (i = 0; i < n; i++) {
+      pool.threads[i] = al_create_thread(mixer_worker,
+         (void *)(uintptr_t)pool.generation);
+      if (!pool.threads[i])
+         break;
+      al_start_thread(pool.threads[i]);
+   }
+   pool.num_threads = i;
+   ALLEGRO_INFO("Started %d mixer threads.\n", pool.num_threads);
+}
+
+
+/* prerender_mixers:
+ *  Renders the playing mixers attached to a parallel mixer on the pool, if
+ *  there is more than one and the pool is free.  Mixers which aren't
+ *  rendered here are rendered serially when the parent gets to them.
+ */
+static void prerender_mixers(ALLEGRO_MIXER *m, unsigned int samples)
+{
+   MIXER_JOB job;
+   int i;
+
+   if (!pool.mutex)
+      return;
+
+   job.num_mixers = 0;
+   job.samples = samples;
+   job.next = 0;
+   for (i = _al_vector_size(&m->streams) - 1; i >= 0; i--) {
+      ALLEGRO_SAMPLE_INSTANCE **slot = _al_vector_ref(&m->streams, i);
+      ALLEGRO_SAMPLE_INSTANCE *spl = *slot;
+      if (spl->is_mixer && spl->is_playing &&
+            job.num_mixers < MAX_PARALLEL_MIXERS) {
+         job.mixers[job.num_mixers++] = (ALLEGRO_MIXER *)spl;
+      }
+   }
+   if (job.num_mixers < 2)
+      return;
+
+   al_lock_mutex(pool.mutex);
+   if (pool.job) {
+      al_unlock_mutex(pool.mutex);
+      return;
+   }
+   if (!pool.started)
+      start_mixer_workers();
+   if (pool.num_threads == 0) {
+      al_unlock_mutex(pool.mutex);
+      return;
+   }
+   pool.job = &job;
+   pool.busy = pool.num_threads;
+   pool.generation++;
+   al_broadcast_cond(pool.work_cond);
+   al_unlock_mutex(pool.mutex);
+
+   render_job_mixers(&job);
+
+   al_lock_mutex(pool.mutex);
+   while (pool.busy > 0)
+      al_wait_cond(pool.done_cond, pool.mutex);
+   pool.job = NULL;
+   al_unlock_mutex(pool.mutex);
+}
+
+
+/* _al_kcm_init_mixer_pool:
+ *  Sets up the thread pool used by parallel mixers.  The threads are only
+ *  started on first use.
+ */
+void _al_kcm_init_mixer_pool(void)
+{
+   if (pool.mutex)
+      return;
+
+   pool.mutex = al_create_mutex();
+   pool.work_cond = al_create_cond();
+   pool.done_cond = al_create_cond();
+}
+
+
+/* _al_kcm_shutdown_mixer_pool:
+ *  Stops the mixer threads.  Must not be called while anything is mixing.
+ */
+void _al_kcm_shutdown_mixer_pool(void)
+{
+   int i;
+
+   if (!pool.mutex)
       return;
 
+   al_lock_mutex(pool.mutex);
+   pool.quit = true;
+   al_broadcast_cond(pool.work_cond);
+   al_unlock_mutex(pool.mutex);
+
+   for (i = 0; i < pool.num_threads; i++)
+      al_destroy_thread(pool.threads[i]);
+
+   al_destroy_cond(pool.done_cond);
+   al_destroy_cond(pool.work_cond);
+   al_destroy_mutex(pool.mutex);
+   memset(&pool, 0, sizeof(pool));
+}
+
+
+/* render_mixer:
+ *  Mixes the attachments of the mixer into its own buffer, then applies the
+ *  post-processing callback and the gain.  Returns false if there is no
+ *  memory for the buffer.
+ */
+static bool render_mixer(ALLEGRO_MIXER *m, unsigned int *samples)
+{
+   int maxc = al_get_channel_count(m->ss.spl_data.chan_conf);
+   int samples_l = *samples;
+   int i;
+
    /* Make sure the mixer buffer is big enough. */
    if (m->ss.spl_data.len*maxc < samples_l*maxc) {
       al_free(m->ss.spl_data.buffer.ptr);
@@ -393,41 +1118,41 @@ void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
          _al_set_error(ALLEGRO_GENERIC_ERROR,
             "Out of memory allocating mixer buffer");
          m->ss.spl_data.len = 0;
-         return;
+         return false;
       }
       m->ss.spl_data.len = samples_l;
    }
 
-   mixer = m;
-
    /* Clear the buffer to silence. */
-   memset(mixer->ss.spl_data.buffer.ptr, 0, samples_l * maxc * al_get_audio_depth_size(mixer->ss.spl_data.depth));
+   memset(m->ss.spl_data.buffer.ptr, 0, samples_l * maxc * al_get_audio_depth_size(m->ss.spl_data.depth));
 
    /* Mix the streams into the mixer buffer. */
-   for (i = _al_vector_size(&mixer->streams) - 1; i >= 0; i--) {
-      ALLEGRO_SAMPLE_INSTANCE **slot = _al_vector_ref(&mixer->streams, i);
+   if (m->parallel)
+      prerender_mixers(m, *samples);
+   for (i = _al_vector_size(&m->streams) - 1; i >= 0; i--) {
+      ALLEGRO_SAMPLE_INSTANCE **slot = _al_vector_ref(&m->streams, i);
       ALLEGRO_SAMPLE_INSTANCE *spl = *slot;
       ASSERT(spl->spl_read);
-      spl->spl_read(spl, (void **) &mixer->ss.spl_data.buffer.ptr, samples,
+      spl->spl_read(spl, (void **) &m->ss.spl_data.buffer.ptr, samples,
          m->ss.spl_data.depth, maxc);
    }
 
    /* Call the post-processing callback. */
-   if (mixer->postprocess_callback) {
-      mixer->postprocess_callback(mixer->ss.spl_data.buffer.ptr,
-         *samples, mixer->pp_callback_userdata);
+   if (m->postprocess_callback) {
+      m->postprocess_callback(m->ss.spl_data.buffer.ptr,
+         *samples, m->pp_callback_userdata);
    }
 
    samples_l *= maxc;
 
    /* Apply the gain if necessary. */
-   if (mixer->ss.gain != 1.0f) {
-      float mixer_gain = mixer->ss.gain;
+   if (m->ss.gain != 1.0f) {
+      float mixer_gain = m->ss.gain;
       unsigned long i = samples_l;
 
       switch (m->ss.spl_data.depth) {
          case ALLEGRO_AUDIO_DEPTH_FLOAT32: {
-            float *p = mixer->ss.spl_data.buffer.f32;
+            float *p = m->ss.spl_data.buffer.f32;
             while (i-- > 0) {
                *p++ *= mixer_gain;
             }
@@ -435,7 +1160,7 @@ void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
          }
 
          case ALLEGRO_AUDIO_DEPTH_INT16: {
-            int16_t *p = mixer->ss.spl_data.buffer.s16;
+            int16_t *p = m->ss.spl_data.buffer.s16;
             while (i-- > 0) {
                *p++ *= mixer_gain;
             }
@@ -453,6 +1178,34 @@ void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
       }
    }
 
+   return true;
+}
+
+
+/* _al_kcm_mixer_read:
+ *  Mixes the streams attached to the mixer and writes additively to the
+ *  specified buffer (or if *buf is NULL, indicating a voice, convert it and
+ *  set it to the buffer pointer).
+ */
+void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
+   ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+{
+   const ALLEGRO_MIXER *mixer;
+   ALLEGRO_MIXER *m = (ALLEGRO_MIXER *)source;
+   int maxc = al_get_channel_count(m->ss.spl_data.chan_conf);
+   int samples_l = *samples * maxc;
+
+   if (!m->ss.is_playing)
+      return;
+
+   /* A parallel parent mixer may have rendered us already. */
+   if (m->rendered)
+      m->rendered = false;
+   else if (!render_mixer(m, samples))
+      return;
+
+   mixer = m;
+
    /* Feeding to a non-voice.
     * Currently we only support mixers of the same audio depth doing this.
     */
@@ -666,6 +1419,8 @@ ALLEGRO_MIXER *al_create_mixer(unsigned int freq,
       return NULL;
    }
 
+   init_block_kernels();
+
    mixer = al_calloc(1, sizeof(ALLEGRO_MIXER));
    if (!mixer) {
       _al_set_error(ALLEGRO_GENERIC_ERROR,
@@ -994,6 +1749,30 @@ bool al_set_mixer_quality(ALLEGRO_MIXER *mixer, ALLEGRO_MIXER_QUALITY new_qualit
 }
 
 
+/* Function: al_get_mixer_parallel
+ */
+bool al_get_mixer_parallel(const ALLEGRO_MIXER *mixer)
+{
+   ASSERT(mixer);
+
+   return mixer->parallel;
+}
+
+
+/* Function: al_set_mixer_parallel
+ */
+bool al_set_mixer_parallel(ALLEGRO_MIXER *mixer, bool parallel)
+{
+   ASSERT(mixer);
+
+   maybe_lock_mutex(mixer->ss.mutex);
+   mixer->parallel = parallel;
+   maybe_unlock_mutex(mixer->ss.mutex);
+
+   return true;
+}
+
+
 /* Function: al_set_mixer_gain
  */
 bool al_set_mixer_gain(ALLEGRO_MIXER *mixer, float new_gain)
@@ -145,7 +145,7 @@ ALLEGRO_AUDIO_STREAM *al_create_audio_stream(size_t fragment_count,
 void al_destroy_audio_stream(ALLEGRO_AUDIO_STREAM *stream)
 {
    if (stream) {
-      if (stream->feed_thread) {
+      if (stream->feeding) {
          stream->unload_feeder(stream);
       }
       /* See commented out call to _al_kcm_register_destructor. */
@@ -675,123 +675,84 @@ bool _al_kcm_refill_stream(ALLEGRO_AUDIO_STREAM *stream)
 }
 
 
-/* _al_kcm_feed_stream:
- * A routine running in another thread that feeds the stream buffers as
- * necessary, usually getting data from some file reader backend.
+/* _al_kcm_feed_stream_fragment:
+ *  Fills one free fragment of the stream from its feeder, usually some
+ *  file reader backend.  Returns true if a fragment was filled.
  */
-void *_al_kcm_feed_stream(ALLEGRO_THREAD *self, void *vstream)
+bool _al_kcm_feed_stream_fragment(ALLEGRO_AUDIO_STREAM *stream)
 {
-   ALLEGRO_AUDIO_STREAM *stream = vstream;
-   ALLEGRO_EVENT_QUEUE *queue;
-   bool finished_event_sent = false;
-   bool prefill = true;
-   (void)self;
-
-   ALLEGRO_DEBUG("Stream feeder thread started.\n");
-
-   queue = al_create_event_queue();
-   al_register_event_source(queue, &stream->spl.es);
-
-   stream->quit_feed_thread = false;
-
-   while (!stream->quit_feed_thread) {
-      char *fragment;
-      ALLEGRO_EVENT event;
+   char *fragment;
+   unsigned long bytes;
+   unsigned long bytes_written;
+   ALLEGRO_MUTEX *stream_mutex;
 
-      if (!prefill)
-         al_wait_for_event(queue, &event);
+   if (stream->is_draining)
+      return false;
 
-      if ((prefill || event.type == ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT)
-          && !stream->is_draining) {
-         unsigned long bytes;
-         unsigned long bytes_written;
-         ALLEGRO_MUTEX *stream_mutex;
+   fragment = al_get_audio_stream_fragment(stream);
+   if (!fragment) {
+      /* This is not an error. */
+      return false;
+   }
 
-         fragment = al_get_audio_stream_fragment(stream);
-         if (!fragment) {
-            /* This is not an error. */
-            continue;
-         }
+   bytes = (stream->spl.spl_data.len) *
+         al_get_channel_count(stream->spl.spl_data.chan_conf) *
+         al_get_audio_depth_size(stream->spl.spl_data.depth);
 
-         bytes = (stream->spl.spl_data.len) *
-               al_get_channel_count(stream->spl.spl_data.chan_conf) *
-               al_get_audio_depth_size(stream->spl.spl_data.depth);
+   stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+   bytes_written = stream->feeder(stream, fragment, bytes);
+   maybe_unlock_mutex(stream_mutex);
 
+   if (stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
+      /* Keep rewinding until the fragment is filled. */
+      while (bytes_written < bytes &&
+               stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
+         size_t bw;
+         al_rewind_audio_stream(stream);
          stream_mutex = maybe_lock_mutex(stream->spl.mutex);
-         bytes_written = stream->feeder(stream, fragment, bytes);
+         bw = stream->feeder(stream, fragment + bytes_written,
+            bytes - bytes_written);
+         bytes_written += bw;
          maybe_unlock_mutex(stream_mutex);
-
-         if (stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
-            /* Keep rewinding until the fragment is filled. */
-            while (bytes_written < bytes &&
-                     stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
-               size_t bw;
-               al_rewind_audio_stream(stream);
-               stream_mutex = maybe_lock_mutex(stream->spl.mutex);
-               bw = stream->feeder(stream, fragment + bytes_written,
-                  bytes - bytes_written);
-               bytes_written += bw;
-               maybe_unlock_mutex(stream_mutex);
-            }
-         }
-         else if (bytes_written < bytes) {
-            /* Fill the rest of the fragment with silence. */
-            int silence_samples = (bytes - bytes_written) /
-               (al_get_channel_count(stream->spl.spl_data.chan_conf) *
-                al_get_audio_depth_size(stream->spl.spl_data.depth));
-            al_fill_silence(fragment + bytes_written, silence_samples,
-                            stream->spl.spl_data.depth, stream->spl.spl_data.chan_conf);
-         }
-
-         if (!al_set_audio_stream_fragment(stream, fragment)) {
-            ALLEGRO_ERROR("Error setting stream buffer.\n");
-            continue;
-         }
-
-         /* The streaming source doesn't feed any more, so drain the stream.
-          * Don't quit in case the user decides to seek and then restart the
-          * stream. */
-         if (bytes_written != bytes &&
-             (stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONCE ||
-              stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_LOOP_ONCE)) {
-            /* Why not al_drain_audio_stream? We don't want to block on draining
-             * because the user might adjust the stream loop points and restart
-             * the stream. */
-            stream->is_draining = true;
-
-            if (!finished_event_sent) {
-               ALLEGRO_EVENT fin_event;
-               fin_event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FINISHED;
-               fin_event.user.timestamp = al_get_time();
-               al_emit_user_event(&stream->spl.es, &fin_event, NULL);
-               finished_event_sent = true;
-            }
-         } else {
-            finished_event_sent = false;
-         }
       }
-      else if (event.type == _KCM_STREAM_FEEDER_QUIT_EVENT_TYPE) {
-         ALLEGRO_EVENT fin_event;
-         stream->quit_feed_thread = true;
+   }
+   else if (bytes_written < bytes) {
+      /* Fill the rest of the fragment with silence. */
+      int silence_samples = (bytes - bytes_written) /
+         (al_get_channel_count(stream->spl.spl_data.chan_conf) *
+          al_get_audio_depth_size(stream->spl.spl_data.depth));
+      al_fill_silence(fragment + bytes_written, silence_samples,
+                      stream->spl.spl_data.depth, stream->spl.spl_data.chan_conf);
+   }
+
+   if (!al_set_audio_stream_fragment(stream, fragment)) {
+      ALLEGRO_ERROR("Error setting stream buffer.\n");
+      return false;
+   }
+
+   /* The streaming source doesn't feed any more, so drain the stream.
+    * Don't quit in case the user decides to seek and then restart the
+    * stream. */
+   if (bytes_written != bytes &&
+       (stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONCE ||
+        stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_LOOP_ONCE)) {
+      /* Why not al_drain_audio_stream? We don't want to block on draining
+       * because the user might adjust the stream loop points and restart
+       * the stream. */
+      stream->is_draining = true;
 
+      if (!stream->finished_event_sent) {
+         ALLEGRO_EVENT fin_event;
          fin_event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FINISHED;
          fin_event.user.timestamp = al_get_time();
          al_emit_user_event(&stream->spl.es, &fin_event, NULL);
+         stream->finished_event_sent = true;
       }
-      if (prefill) {
-         al_lock_mutex(stream->feed_thread_started_mutex);
-         stream->feed_thread_started = true;
-         al_broadcast_cond(stream->feed_thread_started_cond);
-         al_unlock_mutex(stream->feed_thread_started_mutex);
-      }
-      prefill = false;
+   } else {
+      stream->finished_event_sent = false;
    }
 
-   al_destroy_event_queue(queue);
-
-   ALLEGRO_DEBUG("Stream feeder thread finished.\n");
-
-   return NULL;
+   return true;
 }
 
 
@@ -810,6 +771,9 @@ void _al_kcm_emit_stream_events(ALLEGRO_AUDIO_STREAM *stream)
     */
    int count = al_get_available_audio_stream_fragments(stream);
 
+   if (count > 0 && stream->feeding)
+      _al_kcm_wake_stream_feeder(stream);
+
    while (count--) {
       ALLEGRO_EVENT event;
       event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT;
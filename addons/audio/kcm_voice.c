@@ -447,13 +447,24 @@ ALLEGRO_AUDIO_DEPTH al_get_voice_depth(const ALLEGRO_VOICE *voice)
 }
 
 
+/* can_stop_streaming:
+ *  Only the offline driver can stop and restart a voice with a streaming
+ *  attachment, which pauses what al_render_voice mixes.
+ */
+static bool can_stop_streaming(const ALLEGRO_VOICE *voice)
+{
+   return voice->driver == &_al_kcm_offline_driver;
+}
+
+
 /* Function: al_get_voice_playing
  */
 bool al_get_voice_playing(const ALLEGRO_VOICE *voice)
 {
    ASSERT(voice);
 
-   if (voice->attached_stream && !voice->is_streaming) {
+   if (voice->attached_stream &&
+         (!voice->is_streaming || can_stop_streaming(voice))) {
       bool ret;
       al_lock_mutex(voice->mutex);
       ret = voice->driver->voice_is_playing(voice);
@@ -503,7 +514,7 @@ bool al_set_voice_playing(ALLEGRO_VOICE *voice, bool val)
       return false;
    }
 
-   if (voice->is_streaming) {
+   if (voice->is_streaming && !can_stop_streaming(voice)) {
       ALLEGRO_WARN("Attempted to change the playing state of a voice "
          "with a streaming attachment (mixer or audiostreams)\n");
       return false;
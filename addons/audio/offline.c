@@ -0,0 +1,565 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Offline sound driver.
+ *
+ *      Mixes without a sound card, either as fast as the CPU allows, at
+ *      the pace of a real device, or only when al_render_voice is called.
+ *      What the voices play can be written to a WAV file.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include <stdlib.h>
+
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_audio.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_audio.h"
+
+ALLEGRO_DEBUG_CHANNEL("offline")
+
+enum OFFLINE_CLOCK {
+   OC_FAST,
+   OC_REALTIME,
+   OC_MANUAL
+};
+
+enum OFFLINE_VOICE_STATUS {
+   OV_IDLE,
+   OV_PLAYING,
+   OV_JOIN
+};
+
+typedef struct OFFLINE_VOICE
+{
+   enum OFFLINE_CLOCK clock;
+   unsigned int buffer_size_in_frames;
+   unsigned int frame_size_in_bytes;
+
+   /* Only with the fast and realtime clocks. */
+   ALLEGRO_THREAD *thread;
+
+   /* status_cond and status are protected by voice->mutex, as in the
+    * PulseAudio driver.
+    */
+   ALLEGRO_COND *status_cond;
+   enum OFFLINE_VOICE_STATUS status;
+
+   /* WAV file receiving everything rendered, protected by voice->mutex. */
+   ALLEGRO_FILE *output;
+   uint32_t output_bytes;
+   uint32_t max_output_bytes;
+   int data_offset;        /* where the samples start */
+   int fact_offset;        /* 0 if there is no fact chunk */
+} OFFLINE_VOICE;
+
+#define DEFAULT_BUFFER_SIZE   1024
+#define MIN_BUFFER_SIZE       128
+
+
+static enum OFFLINE_CLOCK get_clock(const ALLEGRO_CONFIG *config)
+{
+   const char *val = al_get_config_value(config, "offline", "clock");
+
+   if (val && 0 == _al_stricmp(val, "realtime"))
+      return OC_REALTIME;
+   if (val && 0 == _al_stricmp(val, "manual"))
+      return OC_MANUAL;
+   return OC_FAST;
+}
+
+
+static unsigned int get_buffer_size(const ALLEGRO_CONFIG *config)
+{
+   const char *val = al_get_config_value(config, "offline", "buffer_size");
+
+   if (val && val[0] != '\0') {
+      int n = atoi(val);
+      if (n < MIN_BUFFER_SIZE)
+         n = MIN_BUFFER_SIZE;
+      return n;
+   }
+   return DEFAULT_BUFFER_SIZE;
+}
+
+
+static int offline_open(void)
+{
+   return 0;
+}
+
+
+static void offline_close(void)
+{
+}
+
+
+/* open_output:
+ *  Starts a WAV file for the voice. The sizes in the header are filled in
+ *  by close_output.
+ */
+static ALLEGRO_FILE *open_output(ALLEGRO_VOICE *voice, OFFLINE_VOICE *ov,
+   const char *filename)
+{
+   ALLEGRO_FILE *f;
+   int channels = al_get_channel_count(voice->chan_conf);
+   int bits, format;
+
+   switch (voice->depth) {
+      case ALLEGRO_AUDIO_DEPTH_INT8:
+      case ALLEGRO_AUDIO_DEPTH_UINT8:
+         bits = 8;
+         format = 1;
+         break;
+      case ALLEGRO_AUDIO_DEPTH_INT16:
+      case ALLEGRO_AUDIO_DEPTH_UINT16:
+         bits = 16;
+         format = 1;
+         break;
+      case ALLEGRO_AUDIO_DEPTH_FLOAT32:
+         /* Kept as float so nothing is lost in the output. */
+         bits = 32;
+         format = 3;
+         break;
+      default:
+         ALLEGRO_ERROR("Can't write %d bit voices to %s.\n",
+            (int)al_get_audio_depth_size(voice->depth) * 8, filename);
+         return NULL;
+   }
+
+   f = al_fopen(filename, "wb");
+   if (!f) {
+      ALLEGRO_ERROR("Unable to open %s for writing.\n", filename);
+      return NULL;
+   }
+
+   al_fputs(f, "RIFF");
+   al_fwrite32le(f, 0);
+   al_fputs(f, "WAVE");
+
+   /* Formats other than PCM have a cbSize field and a fact chunk. */
+   al_fputs(f, "fmt ");
+   al_fwrite32le(f, format == 1 ? 16 : 18);
+   al_fwrite16le(f, format);
+   al_fwrite16le(f, channels);
+   al_fwrite32le(f, voice->frequency);
+   al_fwrite32le(f, voice->frequency * channels * bits / 8);
+   al_fwrite16le(f, channels * bits / 8);
+   al_fwrite16le(f, bits);
+   if (format != 1) {
+      al_fwrite16le(f, 0);
+      al_fputs(f, "fact");
+      al_fwrite32le(f, 4);
+      ov->fact_offset = al_ftell(f);
+      al_fwrite32le(f, 0);
+   }
+
+   al_fputs(f, "data");
+   al_fwrite32le(f, 0);
+   ov->data_offset = al_ftell(f);
+
+   /* The RIFF chunk size, which counts everything after it, must fit in
+    * 32 bits, including a pad byte after the samples.
+    */
+   ov->max_output_bytes = UINT32_MAX - (ov->data_offset - 8) - 1;
+   ov->max_output_bytes -= ov->max_output_bytes % ov->frame_size_in_bytes;
+
+   return f;
+}
+
+
+static void write_output(ALLEGRO_VOICE *voice, OFFLINE_VOICE *ov,
+   const void *data, unsigned int frames)
+{
+   uint32_t room = ov->max_output_bytes - ov->output_bytes;
+   size_t n;
+   size_t i;
+
+   if (frames > room / ov->frame_size_in_bytes) {
+      if (room > 0)
+         ALLEGRO_WARN("The WAV file is full, the rest is not written.\n");
+      frames = room / ov->frame_size_in_bytes;
+      if (frames == 0)
+         return;
+   }
+   n = frames * al_get_channel_count(voice->chan_conf);
+
+   /* WAV files hold unsigned 8 bit and signed 16 bit samples. */
+   switch (voice->depth) {
+      case ALLEGRO_AUDIO_DEPTH_INT8:
+         for (i = 0; i < n; i++)
+            al_fputc(ov->output, ((const int8_t *)data)[i] + 0x80);
+         break;
+      case ALLEGRO_AUDIO_DEPTH_UINT16:
+         for (i = 0; i < n; i++)
+            al_fwrite16le(ov->output, ((const uint16_t *)data)[i] - 0x8000);
+         break;
+#ifdef ALLEGRO_BIG_ENDIAN
+      case ALLEGRO_AUDIO_DEPTH_INT16:
+         for (i = 0; i < n; i++)
+            al_fwrite16le(ov->output, ((const int16_t *)data)[i]);
+         break;
+      case ALLEGRO_AUDIO_DEPTH_FLOAT32:
+         for (i = 0; i < n; i++)
+            al_fwrite32le(ov->output, ((const int32_t *)data)[i]);
+         break;
+#endif
+      default:
+         al_fwrite(ov->output, data, frames * ov->frame_size_in_bytes);
+         break;
+   }
+
+   ov->output_bytes += frames * ov->frame_size_in_bytes;
+}
+
+
+static void close_output(OFFLINE_VOICE *ov)
+{
+   /* Chunks have an even size. */
+   if (ov->output_bytes & 1)
+      al_fputc(ov->output, 0);
+
+   al_fseek(ov->output, 4, ALLEGRO_SEEK_SET);
+   al_fwrite32le(ov->output,
+      ov->data_offset - 8 + ov->output_bytes + (ov->output_bytes & 1));
+   if (ov->fact_offset) {
+      al_fseek(ov->output, ov->fact_offset, ALLEGRO_SEEK_SET);
+      al_fwrite32le(ov->output, ov->output_bytes / ov->frame_size_in_bytes);
+   }
+   al_fseek(ov->output, ov->data_offset - 4, ALLEGRO_SEEK_SET);
+   al_fwrite32le(ov->output, ov->output_bytes);
+   al_fclose(ov->output);
+}
+
+
+/* render:
+ *  Fills buf with the next frames of the voice, padding with silence if
+ *  the attachment has nothing more to play. Returns the number of frames
+ *  which were not silence.
+ */
+static unsigned int render(ALLEGRO_VOICE *voice, OFFLINE_VOICE *ov,
+   char *buf, unsigned int frames)
+{
+   unsigned int done = 0;
+
+   if (voice->is_streaming) {
+      while (done < frames) {
+         unsigned int n = frames - done;
+         const void *data;
+         bool playing;
+
+         /* A stopped voice must not move its attachment forward. */
+         al_lock_mutex(voice->mutex);
+         playing = (ov->status == OV_PLAYING);
+         al_unlock_mutex(voice->mutex);
+         if (!playing)
+            break;
+
+         data = _al_voice_update(voice, voice->mutex, &n);
+         if (!data || n == 0)
+            break;
+         memcpy(buf + done * ov->frame_size_in_bytes, data,
+            n * ov->frame_size_in_bytes);
+         done += n;
+      }
+      al_lock_mutex(voice->mutex);
+   }
+   else {
+      al_lock_mutex(voice->mutex);
+      while (done < frames && ov->status == OV_PLAYING &&
+            voice->attached_stream) {
+         ALLEGRO_SAMPLE_INSTANCE *spl = voice->attached_stream;
+         int len = spl->spl_data.len;
+         unsigned int n = _ALLEGRO_MIN(frames - done,
+            (unsigned int)(len - spl->pos));
+         memcpy(buf + done * ov->frame_size_in_bytes,
+            (const char *)spl->spl_data.buffer.ptr +
+               spl->pos * ov->frame_size_in_bytes,
+            n * ov->frame_size_in_bytes);
+         done += n;
+         spl->pos += n;
+         if (spl->pos >= len) {
+            spl->pos = 0;
+            if (spl->loop == ALLEGRO_PLAYMODE_ONCE) {
+               ov->status = OV_IDLE;
+               al_broadcast_cond(ov->status_cond);
+            }
+         }
+      }
+   }
+
+   if (done < frames) {
+      al_fill_silence(buf + done * ov->frame_size_in_bytes, frames - done,
+         voice->depth, voice->chan_conf);
+   }
+   if (ov->output)
+      write_output(voice, ov, buf, frames);
+   al_unlock_mutex(voice->mutex);
+
+   return done;
+}
+
+
+static void *offline_update(ALLEGRO_THREAD *self, void *data)
+{
+   ALLEGRO_VOICE *voice = data;
+   OFFLINE_VOICE *ov = voice->extra;
+   char *buf;
+   double start = 0.0;
+   uint64_t played = 0;
+   (void)self;
+
+   buf = al_malloc(ov->buffer_size_in_frames * ov->frame_size_in_bytes);
+
+   for (;;) {
+      enum OFFLINE_VOICE_STATUS status;
+
+      al_lock_mutex(voice->mutex);
+      if (ov->status == OV_IDLE) {
+         while (ov->status == OV_IDLE)
+            al_wait_cond(ov->status_cond, voice->mutex);
+         start = al_get_time();
+         played = 0;
+      }
+      status = ov->status;
+      al_unlock_mutex(voice->mutex);
+
+      if (status == OV_JOIN)
+         break;
+
+      if (buf)
+         render(voice, ov, buf, ov->buffer_size_in_frames);
+      played += ov->buffer_size_in_frames;
+
+      if (ov->clock == OC_REALTIME) {
+         double wait = start + (double)played / voice->frequency -
+            al_get_time();
+         if (wait > 0)
+            al_rest(wait);
+      }
+   }
+
+   al_free(buf);
+   return NULL;
+}
+
+
+static int offline_allocate_voice(ALLEGRO_VOICE *voice)
+{
+   ALLEGRO_CONFIG *config = al_get_system_config();
+   OFFLINE_VOICE *ov = al_calloc(1, sizeof(OFFLINE_VOICE));
+   const char *output;
+
+   if (!ov)
+      return 1;
+
+   ov->clock = get_clock(config);
+   ov->buffer_size_in_frames = get_buffer_size(config);
+   ov->frame_size_in_bytes = al_get_channel_count(voice->chan_conf) *
+      al_get_audio_depth_size(voice->depth);
+   ov->status = OV_IDLE;
+   ov->status_cond = al_create_cond();
+   if (!ov->status_cond) {
+      al_free(ov);
+      return 1;
+   }
+
+   output = al_get_config_value(config, "offline", "output");
+   if (output && output[0] != '\0')
+      ov->output = open_output(voice, ov, output);
+
+   voice->extra = ov;
+
+   if (ov->clock != OC_MANUAL) {
+      ov->thread = al_create_thread(offline_update, voice);
+      if (!ov->thread) {
+         ALLEGRO_ERROR("Unable to create the mixing thread.\n");
+         if (ov->output)
+            close_output(ov);
+         al_destroy_cond(ov->status_cond);
+         al_free(ov);
+         voice->extra = NULL;
+         return 1;
+      }
+      al_start_thread(ov->thread);
+   }
+
+   return 0;
+}
+
+
+static void offline_deallocate_voice(ALLEGRO_VOICE *voice)
+{
+   OFFLINE_VOICE *ov = voice->extra;
+
+   if (ov->thread) {
+      al_lock_mutex(voice->mutex);
+      ov->status = OV_JOIN;
+      al_broadcast_cond(ov->status_cond);
+      al_unlock_mutex(voice->mutex);
+
+      /* We do NOT hold the voice mutex here, so this does NOT result in a
+       * deadlock when the thread calls _al_voice_update.
+       */
+      al_join_thread(ov->thread, NULL);
+      al_destroy_thread(ov->thread);
+   }
+
+   if (ov->output)
+      close_output(ov);
+   al_destroy_cond(ov->status_cond);
+   al_free(ov);
+   voice->extra = NULL;
+}
+
+
+static int offline_load_voice(ALLEGRO_VOICE *voice, const void *data)
+{
+   (void)data;
+
+   if (voice->attached_stream->loop == ALLEGRO_PLAYMODE_BIDIR) {
+      ALLEGRO_INFO("Backwards playing not supported by the driver.\n");
+      return 1;
+   }
+
+   voice->attached_stream->pos = 0;
+   return 0;
+}
+
+
+static void offline_unload_voice(ALLEGRO_VOICE *voice)
+{
+   (void)voice;
+}
+
+
+static int offline_start_voice(ALLEGRO_VOICE *voice)
+{
+   OFFLINE_VOICE *ov = voice->extra;
+
+   /* We hold the voice->mutex already. */
+   if (ov->status != OV_IDLE)
+      return 1;
+
+   ov->status = OV_PLAYING;
+   al_broadcast_cond(ov->status_cond);
+   return 0;
+}
+
+
+static int offline_stop_voice(ALLEGRO_VOICE *voice)
+{
+   OFFLINE_VOICE *ov = voice->extra;
+
+   /* We hold the voice->mutex already. */
+   if (ov->status == OV_PLAYING) {
+      ov->status = OV_IDLE;
+      al_broadcast_cond(ov->status_cond);
+   }
+   return 0;
+}
+
+
+static bool offline_voice_is_playing(const ALLEGRO_VOICE *voice)
+{
+   OFFLINE_VOICE *ov = voice->extra;
+   return ov->status == OV_PLAYING;
+}
+
+
+static unsigned int offline_get_voice_position(const ALLEGRO_VOICE *voice)
+{
+   return voice->attached_stream->pos;
+}
+
+
+static int offline_set_voice_position(ALLEGRO_VOICE *voice, unsigned int pos)
+{
+   /* We hold the voice->mutex already. */
+   if ((int)pos >= voice->attached_stream->spl_data.len)
+      return 1;
+   voice->attached_stream->pos = pos;
+   return 0;
+}
+
+
+/* Function: al_render_voice
+ */
+unsigned int al_render_voice(ALLEGRO_VOICE *voice, void *buffer,
+   unsigned int samples)
+{
+   OFFLINE_VOICE *ov;
+   char *buf = buffer;
+   unsigned int done = 0;
+   unsigned int chunk;
+
+   ASSERT(voice);
+
+   if (voice->driver != &_al_kcm_offline_driver) {
+      ALLEGRO_ERROR("Only voices of the offline driver can be rendered.\n");
+      return 0;
+   }
+   ov = voice->extra;
+   if (ov->clock != OC_MANUAL) {
+      ALLEGRO_ERROR("The offline driver renders by itself unless "
+         "clock=manual.\n");
+      return 0;
+   }
+
+   if (!buf) {
+      buf = al_malloc(ov->buffer_size_in_frames * ov->frame_size_in_bytes);
+      if (!buf)
+         return 0;
+   }
+
+   while (samples > 0) {
+      chunk = buffer ? samples : _ALLEGRO_MIN(samples, ov->buffer_size_in_frames);
+      done += render(voice, ov, buf, chunk);
+      samples -= chunk;
+      if (buffer)
+         buf += chunk * ov->frame_size_in_bytes;
+   }
+
+   if (!buffer)
+      al_free(buf);
+
+   return done;
+}
+
+
+ALLEGRO_AUDIO_DRIVER _al_kcm_offline_driver =
+{
+   "offline",
+
+   offline_open,
+   offline_close,
+
+   offline_allocate_voice,
+   offline_deallocate_voice,
+
+   offline_load_voice,
+   offline_unload_voice,
+
+   offline_start_voice,
+   offline_stop_voice,
+
+   offline_voice_is_playing,
+
+   offline_get_voice_position,
+   offline_set_voice_position,
+
+   NULL,
+   NULL,
+
+   NULL
+};
+
+/* vim: set sts=3 sw=3 et: */
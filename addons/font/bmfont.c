@@ -22,8 +22,6 @@ typedef struct {
    int xoffset, yoffset;
    int xadvance;
    int chnl;
-   int kerning_pairs;
-   BMFONT_KERNING *kerning;
 } BMFONT_CHAR;
 
 typedef struct BMFONT_RANGE BMFONT_RANGE;
@@ -45,6 +43,10 @@ typedef struct {
 
    int kerning_pairs;
    BMFONT_KERNING *kerning;
+
+   _AL_GLYPH_TABLE table;           /* codepoint -> BMFONT_CHAR */
+   BMFONT_KERNING *kerning_table;   /* open addressing, first < 0 if unused */
+   unsigned int kerning_mask;
 } BMFONT_DATA;
 
 typedef struct {
@@ -140,15 +142,62 @@ static void add_codepoint(BMFONT_PARSER *parser, int codepoint) {
 }
 
 static BMFONT_CHAR *find_codepoint(BMFONT_DATA *data, int codepoint) {
-   BMFONT_RANGE *range = data->range_first;
-   while (range) {
-      if (codepoint >= range->first &&
-            codepoint < range->first + range->count) {
-         return range->characters[codepoint - range->first];
+   return _al_glyph_table_get(&data->table, codepoint);
+}
+
+static unsigned int kerning_hash(int first, int second) {
+   return ((unsigned int)first * 0x9E3779B1u) ^ (unsigned int)second;
+}
+
+/* Builds the codepoint table and the kerning pair hash table once all
+ * characters have been parsed.
+ */
+static bool build_tables(BMFONT_DATA *data) {
+   BMFONT_RANGE *range;
+   unsigned int size = 1;
+   int i;
+
+   for (range = data->range_first; range; range = range->next) {
+      for (i = 0; i < range->count; i++) {
+         if (range->first + i < 0)
+            continue;
+         if (!_al_glyph_table_add(&data->table, range->first + i,
+               range->characters[i]))
+            return false;
       }
-      range = range->next;
    }
-   return NULL;
+
+   if (data->kerning_pairs == 0)
+      return true;
+
+   while (size < 2 * (unsigned int)data->kerning_pairs)
+      size *= 2;
+   data->kerning_table = al_malloc(size * sizeof *data->kerning_table);
+   if (!data->kerning_table)
+      return false;
+   data->kerning_mask = size - 1;
+   for (i = 0; i < (int)size; i++)
+      data->kerning_table[i].first = -1;
+
+   /* The first of duplicate pairs wins, pairs for characters the font
+    * doesn't have are dropped.
+    */
+   for (i = 0; i < data->kerning_pairs; i++) {
+      BMFONT_KERNING *k = data->kerning + i;
+      unsigned int h;
+      if (!find_codepoint(data, k->first))
+         continue;
+      h = kerning_hash(k->first, k->second) & data->kerning_mask;
+      while (data->kerning_table[h].first >= 0) {
+         if (data->kerning_table[h].first == k->first &&
+               data->kerning_table[h].second == k->second)
+            break;
+         h = (h + 1) & data->kerning_mask;
+      }
+      if (data->kerning_table[h].first < 0)
+         data->kerning_table[h] = *k;
+   }
+   return true;
 }
 
 static void add_page(BMFONT_PARSER *parser, char const *filename) {
@@ -243,14 +292,14 @@ static int font_descent(const ALLEGRO_FONT *f) {
    return data->line_height - data->base;
 }
 
-static int get_kerning(BMFONT_CHAR *prev, int c) {
-   if (!prev) return 0;
-   int i;
-   for (i = 0; i < prev->kerning_pairs; i++) {
-      if (prev->kerning[i].second == c) {
-         int a = prev->kerning[i].amount;
-         return a;
-      }
+static int get_kerning(BMFONT_DATA *data, int prev, int c) {
+   if (!data->kerning_table || prev < 0) return 0;
+   unsigned int h = kerning_hash(prev, c) & data->kerning_mask;
+   while (data->kerning_table[h].first >= 0) {
+      BMFONT_KERNING *k = data->kerning_table + h;
+      if (k->first == prev && k->second == c)
+         return k->amount;
+      h = (h + 1) & data->kerning_mask;
    }
    return 0;
 }
@@ -267,8 +316,7 @@ static int each_character(const ALLEGRO_FONT *f, ALLEGRO_COLOR color,
       int c = al_ustr_get_next(text, &pos);
       if (c < 0) break;
       if (prev) {
-         BMFONT_CHAR *pc = find_codepoint(data, prev);
-         advance += get_kerning(pc, c);
+         advance += get_kerning(data, prev, c);
       }
       advance += cb(f, color, c, x + advance, y, glyph);
       prev = c;
@@ -336,7 +384,7 @@ static int get_glyph_advance(const ALLEGRO_FONT *f,
    }
 
    if (codepoint2 != ALLEGRO_NO_KERNING)
-      kerning = get_kerning(c, codepoint2);
+      kerning = get_kerning(data, codepoint1, codepoint2);
 
    return c->xadvance + kerning;
 }
@@ -344,7 +392,6 @@ static int get_glyph_advance(const ALLEGRO_FONT *f,
 static bool get_glyph(const ALLEGRO_FONT *f, int prev_codepoint,
       int codepoint, ALLEGRO_GLYPH *glyph) {
    BMFONT_DATA *data = f->data;
-   BMFONT_CHAR *prev = find_codepoint(data, prev_codepoint);
    BMFONT_CHAR *c = find_codepoint(data, codepoint);
    if (c) {
       glyph->bitmap = data->pages[c->page];
@@ -352,7 +399,7 @@ static bool get_glyph(const ALLEGRO_FONT *f, int prev_codepoint,
       glyph->y = c->y;
       glyph->w = c->width;
       glyph->h = c->height;
-      glyph->kerning = get_kerning(prev, codepoint);
+      glyph->kerning = get_kerning(data, prev_codepoint, codepoint);
       glyph->offset_x = c->xoffset;
       glyph->offset_y = c->yoffset;
       glyph->advance = c->xadvance + glyph->kerning;
@@ -404,7 +451,6 @@ static void destroy_range(BMFONT_RANGE *range) {
    int i;
    for (i = 0; i < range->count; i++) {
       BMFONT_CHAR *c = range->characters[i];
-      al_free(c->kerning);
       al_free(c);
    }
    al_free(range);
@@ -426,6 +472,8 @@ static void destroy(ALLEGRO_FONT *f) {
    al_free(data->pages);
 
    al_free(data->kerning);
+   al_free(data->kerning_table);
+   _al_glyph_table_free(&data->table);
    al_free(f);
 }
 
@@ -501,19 +549,15 @@ ALLEGRO_FONT *_al_load_bmfont_xml(const char *filename, int size,
 
    _al_xml_parse(f, xml_callback, parser);
 
-   int i;
-   for (i = 0; i < data->kerning_pairs; i++) {
-      BMFONT_KERNING *k = data->kerning + i;
-      BMFONT_CHAR *c = find_codepoint(data, k->first);
-      c->kerning_pairs++;
-      c->kerning = al_realloc(c->kerning, c->kerning_pairs *
-         sizeof *c->kerning);
-      c->kerning[c->kerning_pairs - 1] = *k;
-   }
-
    al_ustr_free(parser->tag);
    al_ustr_free(parser->attribute);
    al_destroy_path(parser->path);
 
+   if (!build_tables(data)) {
+      ALLEGRO_ERROR("Out of memory for the glyph tables.\n");
+      destroy(font);
+      return NULL;
+   }
+
    return font;
 }
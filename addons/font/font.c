@@ -110,15 +110,51 @@ static void color_get_text_dimensions(ALLEGRO_FONT const *f,
 
 
 
-static ALLEGRO_FONT_COLOR_DATA *_al_font_find_page(
-   ALLEGRO_FONT_COLOR_DATA *cf, int ch)
+/* _al_glyph_table_add:
+ *  Maps the codepoint to the glyph, unless it already has one.  Returns
+ *  false if out of memory.
+ */
+bool _al_glyph_table_add(_AL_GLYPH_TABLE *table, int codepoint, void *glyph)
 {
-    while (cf) {
-        if (ch >= cf->begin && ch < cf->end)
-            return cf;
-        cf = cf->next;
+    int block = codepoint >> _AL_GLYPH_TABLE_BITS;
+    void **entry;
+
+    ASSERT(codepoint >= 0);
+
+    if (block >= table->num_blocks) {
+        void ***blocks = al_realloc(table->blocks,
+           (block + 1) * sizeof *blocks);
+        if (!blocks)
+            return false;
+        memset(blocks + table->num_blocks, 0,
+           (block + 1 - table->num_blocks) * sizeof *blocks);
+        table->blocks = blocks;
+        table->num_blocks = block + 1;
+    }
+
+    if (!table->blocks[block]) {
+        table->blocks[block] = al_calloc(_AL_GLYPH_TABLE_SIZE, sizeof(void *));
+        if (!table->blocks[block])
+            return false;
     }
-    return NULL;
+
+    entry = &table->blocks[block][codepoint & (_AL_GLYPH_TABLE_SIZE - 1)];
+    if (!*entry)
+        *entry = glyph;
+    return true;
+}
+
+
+
+void _al_glyph_table_free(_AL_GLYPH_TABLE *table)
+{
+    int i;
+
+    for (i = 0; i < table->num_blocks; i++)
+        al_free(table->blocks[i]);
+    al_free(table->blocks);
+    table->blocks = NULL;
+    table->num_blocks = 0;
 }
 
 
@@ -128,10 +164,11 @@ static ALLEGRO_FONT_COLOR_DATA *_al_font_find_page(
 static ALLEGRO_BITMAP* _al_font_color_find_glyph(const ALLEGRO_FONT* f, int ch)
 {
     ALLEGRO_FONT_COLOR_DATA* cf = (ALLEGRO_FONT_COLOR_DATA*)(f->data);
+    ALLEGRO_BITMAP *g;
 
-    cf = _al_font_find_page(cf, ch);
-    if (cf) {
-        return cf->bitmaps[ch - cf->begin];
+    g = cf ? _al_glyph_table_get(&cf->table, ch) : NULL;
+    if (g) {
+        return g;
     }
 
     /* if we don't find the character, then search for the missing
@@ -248,8 +285,10 @@ static void color_destroy(ALLEGRO_FONT* f)
 
     cf = (ALLEGRO_FONT_COLOR_DATA*)(f->data);
 
-    if (cf)
+    if (cf) {
         glyphs = cf->glyphs;
+        _al_glyph_table_free(&cf->table);
+    }
 
     while (cf) {
         ALLEGRO_FONT_COLOR_DATA* next = cf->next;
@@ -5,14 +5,40 @@
 
 extern ALLEGRO_FONT_VTABLE _al_font_vtable_color;
 
+/* Two-level direct-mapped table from codepoints to glyphs, so that looking
+ * up a glyph takes the same time no matter how many ranges a font has.
+ */
+#define _AL_GLYPH_TABLE_BITS  8
+#define _AL_GLYPH_TABLE_SIZE  (1 << _AL_GLYPH_TABLE_BITS)
+
+typedef struct _AL_GLYPH_TABLE
+{
+   void ***blocks;                   /* NULL or [_AL_GLYPH_TABLE_SIZE] each */
+   int num_blocks;
+} _AL_GLYPH_TABLE;
+
 typedef struct ALLEGRO_FONT_COLOR_DATA
 {
    int begin, end;                   /* first char and one-past-the-end char */
    ALLEGRO_BITMAP *glyphs;           /* our glyphs */
    ALLEGRO_BITMAP **bitmaps;         /* sub bitmaps pointing to our glyphs */
    struct ALLEGRO_FONT_COLOR_DATA *next;  /* linked list structure */
+   _AL_GLYPH_TABLE table;            /* all ranges, kept in the first one */
 } ALLEGRO_FONT_COLOR_DATA;
 
+bool _al_glyph_table_add(_AL_GLYPH_TABLE *table, int codepoint, void *glyph);
+void _al_glyph_table_free(_AL_GLYPH_TABLE *table);
+
+static INLINE void *_al_glyph_table_get(const _AL_GLYPH_TABLE *table,
+   int codepoint)
+{
+   unsigned int block = (unsigned int)codepoint >> _AL_GLYPH_TABLE_BITS;
+
+   if (block >= (unsigned int)table->num_blocks || !table->blocks[block])
+      return NULL;
+   return table->blocks[block][codepoint & (_AL_GLYPH_TABLE_SIZE - 1)];
+}
+
 ALLEGRO_FONT *_al_load_bitmap_font(const char *filename,
    int size, int flags);
 ALLEGRO_FONT *_al_load_bmfont_xml(const char *filename,
@@ -282,6 +282,18 @@ ALLEGRO_FONT *al_grab_font_from_bitmap(ALLEGRO_BITMAP *bmp,
    }
    al_restore_state(&backup);
 
+   /* Earlier ranges take precedence where ranges overlap. */
+   for (cf = f->data; cf; cf = cf->next) {
+      for (i = cf->begin; i < cf->end; i++) {
+         ALLEGRO_FONT_COLOR_DATA *first = f->data;
+         if (i >= 0 && !_al_glyph_table_add(&first->table, i,
+               cf->bitmaps[i - cf->begin])) {
+            ALLEGRO_ERROR("Out of memory for the glyph table.\n");
+            goto cleanup_and_fail_on_error;
+         }
+      }
+   }
+
    cf = f->data;
    if (cf && cf->bitmaps[0])
       f->height = al_get_bitmap_height(cf->bitmaps[0]);
@@ -394,8 +394,14 @@ static ALLEGRO_BITMAP *create_builtin_font_sheet(void)
    ALLEGRO_STATE state;
    ALLEGRO_BITMAP *bmp;
    ALLEGRO_LOCKED_REGION *lr;
+   bool hold;
    int i, j, k;
 
+   /* Changing the target flushes held drawing, so let it go first. */
+   hold = al_is_bitmap_drawing_held();
+   if (hold)
+      al_hold_bitmap_drawing(false);
+
    al_store_state(&state,
       ALLEGRO_STATE_NEW_BITMAP_PARAMETERS |
       ALLEGRO_STATE_TARGET_BITMAP);
@@ -437,6 +443,9 @@ static ALLEGRO_BITMAP *create_builtin_font_sheet(void)
 
    al_restore_state(&state);
 
+   if (hold)
+      al_hold_bitmap_drawing(true);
+
    return bmp;
 }
 
@@ -1,7 +1,7 @@
 #ifndef __al_included_allegro5_allegro_image_h
 #define __al_included_allegro5_allegro_image_h
 
-#include "allegro5/base.h"
+#include "allegro5/allegro.h"
 
 #if (defined ALLEGRO_MINGW32) || (defined ALLEGRO_MSVC) || (defined ALLEGRO_BCC32)
    #ifndef ALLEGRO_STATICLINK
@@ -36,6 +36,28 @@ ALLEGRO_IIO_FUNC(bool, al_is_image_addon_initialized, (void));
 ALLEGRO_IIO_FUNC(void, al_shutdown_image_addon, (void));
 ALLEGRO_IIO_FUNC(uint32_t, al_get_allegro_image_version, (void));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_IIO_SRC)
+/* Enum: ALLEGRO_BITMAP_BATCH_EVENT_TYPE
+ */
+enum ALLEGRO_BITMAP_BATCH_EVENT_TYPE
+{
+   ALLEGRO_EVENT_BITMAP_BATCH_LOADED     = 570,
+   ALLEGRO_EVENT_BITMAP_BATCH_FINISHED   = 571
+};
+
+/* Type: ALLEGRO_BITMAP_BATCH
+ */
+typedef struct ALLEGRO_BITMAP_BATCH ALLEGRO_BITMAP_BATCH;
+
+ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP_BATCH *, al_create_bitmap_batch, (const char * const *filenames, int count, int flags));
+ALLEGRO_IIO_FUNC(void, al_start_bitmap_batch, (ALLEGRO_BITMAP_BATCH *batch));
+ALLEGRO_IIO_FUNC(void, al_destroy_bitmap_batch, (ALLEGRO_BITMAP_BATCH *batch));
+ALLEGRO_IIO_FUNC(ALLEGRO_EVENT_SOURCE *, al_get_bitmap_batch_event_source, (ALLEGRO_BITMAP_BATCH *batch));
+ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, al_get_bitmap_batch_bitmap, (ALLEGRO_BITMAP_BATCH *batch, int index));
+ALLEGRO_IIO_FUNC(bool, al_is_bitmap_batch_finished, (ALLEGRO_BITMAP_BATCH *batch));
+ALLEGRO_IIO_FUNC(void, al_wait_for_bitmap_batch, (ALLEGRO_BITMAP_BATCH *batch));
+#endif
+
 
 #ifdef __cplusplus
 }
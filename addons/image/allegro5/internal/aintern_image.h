@@ -18,6 +18,12 @@ ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_iphone_load_image_f, (ALLEGRO_FILE *f, in
 
 #endif
 
+typedef void (*_AL_IIO_ROWS_FN)(void *arg, int y0, int y1);
+
+ALLEGRO_IIO_FUNC(void, _al_iio_init_decoder, (void));
+ALLEGRO_IIO_FUNC(void, _al_iio_shutdown_decoder, (void));
+ALLEGRO_IIO_FUNC(void, _al_iio_convert_rows, (int height, _AL_IIO_ROWS_FN fn, void *arg));
+
 ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_load_pcx, (const char *filename, int flags));
 ALLEGRO_IIO_FUNC(bool, _al_save_pcx, (const char *filename, ALLEGRO_BITMAP *bmp));
 ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_load_pcx_f, (ALLEGRO_FILE *f, int flags));
@@ -41,6 +47,10 @@ ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_load_dds, (const char *filename, int flag
 ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_load_dds_f, (ALLEGRO_FILE *f, int flags));
 ALLEGRO_IIO_FUNC(bool, _al_identify_dds, (ALLEGRO_FILE *f));
 
+ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_load_ktx, (const char *filename, int flags));
+ALLEGRO_IIO_FUNC(ALLEGRO_BITMAP *, _al_load_ktx_f, (ALLEGRO_FILE *f, int flags));
+ALLEGRO_IIO_FUNC(bool, _al_identify_ktx, (ALLEGRO_FILE *f));
+
 ALLEGRO_IIO_FUNC(bool, _al_identify_png, (ALLEGRO_FILE *f));
 ALLEGRO_IIO_FUNC(bool, _al_identify_jpg, (ALLEGRO_FILE *f));
 ALLEGRO_IIO_FUNC(bool, _al_identify_webp, (ALLEGRO_FILE *f));
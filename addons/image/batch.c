@@ -0,0 +1,491 @@
+/*
+ * Background image decoding.
+ *
+ * A small pool of worker threads, shared by everything in the addon, does
+ * two kinds of work.  Bitmap batches hand it lists of files, which the
+ * workers load into memory bitmaps one file at a time, in order, emitting
+ * an event for each.  Loaders which convert pixels a row at a time hand it
+ * bands of rows through _al_iio_convert_rows; the calling thread converts
+ * bands too, so those jobs finish even when every worker is busy loading.
+ * Row jobs are always served before files, since a loader is waiting on
+ * them.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_image.h"
+
+ALLEGRO_DEBUG_CHANNEL("image")
+
+#define MAX_DECODER_THREADS   16
+#define MIN_BAND_ROWS         32
+#define BANDS_PER_THREAD      4
+
+typedef struct ROW_JOB ROW_JOB;
+
+struct ROW_JOB
+{
+   ROW_JOB *next;
+   _AL_IIO_ROWS_FN fn;
+   void *arg;
+   int height;
+   int band_h;
+   int num_bands;
+   int next_band;
+   int bands_done;
+};
+
+struct ALLEGRO_BITMAP_BATCH
+{
+   ALLEGRO_EVENT_SOURCE es;
+   ALLEGRO_BITMAP_BATCH *next;   /* in the queue of unfinished batches */
+   int flags;
+   int count;
+   char **filenames;
+   ALLEGRO_BITMAP **bitmaps;
+   int next_file;                /* count once nothing is left to start */
+   int num_loading;
+   int num_done;
+   bool started;
+};
+
+static struct {
+   ALLEGRO_MUTEX *mutex;
+   ALLEGRO_COND *work_cond;
+   ALLEGRO_COND *done_cond;
+   ALLEGRO_THREAD *threads[MAX_DECODER_THREADS];
+   int num_threads;
+   ROW_JOB *row_jobs;
+   ALLEGRO_BITMAP_BATCH *batches;
+   int num_batches;
+   bool quit;
+} decoder;
+
+
+static ROW_JOB *next_row_job(void)
+{
+   ROW_JOB *job;
+
+   for (job = decoder.row_jobs; job; job = job->next) {
+      if (job->next_band < job->num_bands)
+         return job;
+   }
+   return NULL;
+}
+
+
+static ALLEGRO_BITMAP_BATCH *next_batch(void)
+{
+   ALLEGRO_BITMAP_BATCH *batch;
+
+   for (batch = decoder.batches; batch; batch = batch->next) {
+      if (batch->next_file < batch->count)
+         return batch;
+   }
+   return NULL;
+}
+
+
+/* run_band:
+ *  Converts the next band of the job.  The decoder mutex must be held, and
+ *  is released while converting.
+ */
+static void run_band(ROW_JOB *job)
+{
+   int y0 = job->next_band++ * job->band_h;
+   int y1 = _ALLEGRO_MIN(y0 + job->band_h, job->height);
+
+   al_unlock_mutex(decoder.mutex);
+   job->fn(job->arg, y0, y1);
+   al_lock_mutex(decoder.mutex);
+
+   if (++job->bands_done == job->num_bands)
+      al_broadcast_cond(decoder.done_cond);
+}
+
+
+static void emit_batch_event(ALLEGRO_BITMAP_BATCH *batch, int type,
+   int index, ALLEGRO_BITMAP *bmp)
+{
+   ALLEGRO_EVENT event;
+
+   event.user.type = type;
+   event.user.timestamp = al_get_time();
+   event.user.data1 = (intptr_t)batch;
+   event.user.data2 = index;
+   event.user.data3 = (intptr_t)bmp;
+   al_emit_user_event(&batch->es, &event, NULL);
+}
+
+
+/* load_next_file:
+ *  Loads the next file of the batch.  The decoder mutex must be held, and
+ *  is released while loading.
+ */
+static void load_next_file(ALLEGRO_BITMAP_BATCH *batch)
+{
+   int index = batch->next_file++;
+   ALLEGRO_BITMAP *bmp;
+
+   /* The batch can't be destroyed while num_loading > 0. */
+   batch->num_loading++;
+   al_unlock_mutex(decoder.mutex);
+
+   bmp = al_load_bitmap_flags(batch->filenames[index], batch->flags);
+   if (!bmp)
+      ALLEGRO_WARN("Failed to load %s.\n", batch->filenames[index]);
+
+   /* Emit with the mutex held so that FINISHED always comes after the
+    * LOADED events of the other workers.
+    */
+   al_lock_mutex(decoder.mutex);
+   batch->bitmaps[index] = bmp;
+   emit_batch_event(batch, ALLEGRO_EVENT_BITMAP_BATCH_LOADED, index, bmp);
+   if (++batch->num_done == batch->count)
+      emit_batch_event(batch, ALLEGRO_EVENT_BITMAP_BATCH_FINISHED, 0, NULL);
+   batch->num_loading--;
+   al_broadcast_cond(decoder.done_cond);
+}
+
+
+static void *decoder_worker(ALLEGRO_THREAD *thread, void *arg)
+{
+   (void)thread;
+   (void)arg;
+
+   /* Everything is decoded into memory bitmaps, there is no display here. */
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+   al_lock_mutex(decoder.mutex);
+   for (;;) {
+      ROW_JOB *job = NULL;
+      ALLEGRO_BITMAP_BATCH *batch = NULL;
+
+      while (!decoder.quit && !(job = next_row_job()) && !(batch = next_batch()))
+         al_wait_cond(decoder.work_cond, decoder.mutex);
+      if (decoder.quit)
+         break;
+
+      if (job)
+         run_band(job);
+      else
+         load_next_file(batch);
+   }
+   al_unlock_mutex(decoder.mutex);
+
+   return NULL;
+}
+
+
+/* start_workers:
+ *  Starts the workers if they aren't running yet.  The number comes from
+ *  the decoder_threads option in the [image] section of the system config
+ *  and defaults to the number of CPUs, up to 4.  The decoder mutex must be
+ *  held.
+ */
+static bool start_workers(void)
+{
+   const char *value;
+   int n, i;
+
+   if (decoder.num_threads > 0)
+      return true;
+
+   value = al_get_config_value(al_get_system_config(), "image",
+      "decoder_threads");
+   n = value ? atoi(value) : _ALLEGRO_MIN(al_get_cpu_count(), 4);
+   n = _ALLEGRO_CLAMP(1, n, MAX_DECODER_THREADS);
+
+   for (i = 0; i < n; i++) {
+      decoder.threads[i] = al_create_thread(decoder_worker, NULL);
+      if (!decoder.threads[i])
+         break;
+      al_start_thread(decoder.threads[i]);
+   }
+   decoder.num_threads = i;
+   ALLEGRO_INFO("Started %d image decoder threads.\n", decoder.num_threads);
+
+   return decoder.num_threads > 0;
+}
+
+
+/* _al_iio_init_decoder:
+ *  Sets up the decoder pool.  The threads are only started when first
+ *  needed.
+ */
+void _al_iio_init_decoder(void)
+{
+   if (decoder.mutex)
+      return;
+
+   decoder.mutex = al_create_mutex();
+   decoder.work_cond = al_create_cond();
+   decoder.done_cond = al_create_cond();
+   decoder.quit = false;
+}
+
+
+/* _al_iio_shutdown_decoder:
+ *  Stops the decoder threads.  Files of unfinished batches which haven't
+ *  been started yet are skipped.  The batches themselves stay valid, so the
+ *  pool is only freed if none are left.
+ */
+void _al_iio_shutdown_decoder(void)
+{
+   ALLEGRO_BITMAP_BATCH *batch;
+   int i;
+
+   if (!decoder.mutex)
+      return;
+
+   al_lock_mutex(decoder.mutex);
+   for (batch = decoder.batches; batch; batch = batch->next)
+      batch->next_file = batch->count;
+   decoder.quit = true;
+   al_broadcast_cond(decoder.work_cond);
+   al_unlock_mutex(decoder.mutex);
+
+   for (i = 0; i < decoder.num_threads; i++)
+      al_destroy_thread(decoder.threads[i]);
+   decoder.num_threads = 0;
+
+   if (decoder.num_batches > 0) {
+      ALLEGRO_WARN("Bitmap batches still exist, keeping the decoder.\n");
+      decoder.quit = false;
+      return;
+   }
+
+   al_destroy_cond(decoder.done_cond);
+   al_destroy_cond(decoder.work_cond);
+   al_destroy_mutex(decoder.mutex);
+   decoder.mutex = NULL;
+}
+
+
+/* _al_iio_convert_rows:
+ *  Calls fn for consecutive bands of rows covering [0, height), spread over
+ *  the calling thread and the decoder threads.  Bands are converted in no
+ *  particular order, so fn must only touch its own rows.
+ */
+void _al_iio_convert_rows(int height, _AL_IIO_ROWS_FN fn, void *arg)
+{
+   ROW_JOB job;
+   ROW_JOB **link;
+
+   if (height < 2 * MIN_BAND_ROWS || !decoder.mutex) {
+      fn(arg, 0, height);
+      return;
+   }
+
+   al_lock_mutex(decoder.mutex);
+   if (decoder.quit || !start_workers()) {
+      al_unlock_mutex(decoder.mutex);
+      fn(arg, 0, height);
+      return;
+   }
+
+   job.fn = fn;
+   job.arg = arg;
+   job.height = height;
+   job.num_bands = _ALLEGRO_MIN(height / MIN_BAND_ROWS,
+      (decoder.num_threads + 1) * BANDS_PER_THREAD);
+   job.band_h = (height + job.num_bands - 1) / job.num_bands;
+   job.num_bands = (height + job.band_h - 1) / job.band_h;
+   job.next_band = 0;
+   job.bands_done = 0;
+   job.next = decoder.row_jobs;
+   decoder.row_jobs = &job;
+   al_broadcast_cond(decoder.work_cond);
+
+   while (job.next_band < job.num_bands)
+      run_band(&job);
+   while (job.bands_done < job.num_bands)
+      al_wait_cond(decoder.done_cond, decoder.mutex);
+
+   for (link = &decoder.row_jobs; *link != &job; link = &(*link)->next)
+      ;
+   *link = job.next;
+   al_unlock_mutex(decoder.mutex);
+}
+
+
+/* Function: al_create_bitmap_batch
+ */
+ALLEGRO_BITMAP_BATCH *al_create_bitmap_batch(const char * const *filenames,
+   int count, int flags)
+{
+   ALLEGRO_BITMAP_BATCH *batch;
+   int i;
+   ASSERT(filenames || count == 0);
+   ASSERT(count >= 0);
+
+   if (!decoder.mutex) {
+      ALLEGRO_ERROR("Image addon not initialised.\n");
+      return NULL;
+   }
+
+   batch = al_calloc(1, sizeof *batch);
+   if (!batch)
+      return NULL;
+   batch->flags = flags;
+   batch->count = count;
+   batch->filenames = al_calloc(count + 1, sizeof *batch->filenames);
+   batch->bitmaps = al_calloc(count + 1, sizeof *batch->bitmaps);
+   if (!batch->filenames || !batch->bitmaps)
+      goto error;
+   for (i = 0; i < count; i++) {
+      batch->filenames[i] = _al_strdup(filenames[i]);
+      if (!batch->filenames[i])
+         goto error;
+   }
+   al_init_user_event_source(&batch->es);
+
+   al_lock_mutex(decoder.mutex);
+   decoder.num_batches++;
+   al_unlock_mutex(decoder.mutex);
+
+   return batch;
+
+error:
+   if (batch->filenames) {
+      for (i = 0; i < count; i++)
+         al_free(batch->filenames[i]);
+   }
+   al_free(batch->filenames);
+   al_free(batch->bitmaps);
+   al_free(batch);
+   return NULL;
+}
+
+
+/* Function: al_start_bitmap_batch
+ */
+void al_start_bitmap_batch(ALLEGRO_BITMAP_BATCH *batch)
+{
+   ALLEGRO_BITMAP_BATCH **link;
+   ASSERT(batch);
+
+   al_lock_mutex(decoder.mutex);
+   if (batch->started) {
+      al_unlock_mutex(decoder.mutex);
+      return;
+   }
+   batch->started = true;
+
+   if (batch->count > 0 &&
+         (!al_is_image_addon_initialized() || !start_workers())) {
+      ALLEGRO_ERROR("No decoder threads, not loading the batch.\n");
+      batch->next_file = batch->count;
+   }
+   else if (batch->count > 0) {
+      for (link = &decoder.batches; *link; link = &(*link)->next)
+         ;
+      *link = batch;
+      al_broadcast_cond(decoder.work_cond);
+   }
+   else {
+      emit_batch_event(batch, ALLEGRO_EVENT_BITMAP_BATCH_FINISHED, 0, NULL);
+   }
+   al_unlock_mutex(decoder.mutex);
+}
+
+
+/* Function: al_destroy_bitmap_batch
+ */
+void al_destroy_bitmap_batch(ALLEGRO_BITMAP_BATCH *batch)
+{
+   ALLEGRO_BITMAP_BATCH **link;
+   int i;
+
+   if (!batch)
+      return;
+
+   al_lock_mutex(decoder.mutex);
+   batch->next_file = batch->count;
+   while (batch->num_loading > 0)
+      al_wait_cond(decoder.done_cond, decoder.mutex);
+   for (link = &decoder.batches; *link; link = &(*link)->next) {
+      if (*link == batch) {
+         *link = batch->next;
+         break;
+      }
+   }
+   decoder.num_batches--;
+   al_unlock_mutex(decoder.mutex);
+
+   al_destroy_user_event_source(&batch->es);
+
+   for (i = 0; i < batch->count; i++) {
+      al_destroy_bitmap(batch->bitmaps[i]);
+      al_free(batch->filenames[i]);
+   }
+   al_free(batch->filenames);
+   al_free(batch->bitmaps);
+   al_free(batch);
+
+   /* The addon was shut down while this batch was alive. */
+   if (decoder.num_batches == 0 && decoder.num_threads == 0 &&
+         !al_is_image_addon_initialized())
+      _al_iio_shutdown_decoder();
+}
+
+
+/* Function: al_get_bitmap_batch_event_source
+ */
+ALLEGRO_EVENT_SOURCE *al_get_bitmap_batch_event_source(
+   ALLEGRO_BITMAP_BATCH *batch)
+{
+   ASSERT(batch);
+   return &batch->es;
+}
+
+
+/* Function: al_get_bitmap_batch_bitmap
+ */
+ALLEGRO_BITMAP *al_get_bitmap_batch_bitmap(ALLEGRO_BITMAP_BATCH *batch,
+   int index)
+{
+   ALLEGRO_BITMAP *bmp;
+   ASSERT(batch);
+   ASSERT(index >= 0 && index < batch->count);
+
+   al_lock_mutex(decoder.mutex);
+   bmp = batch->bitmaps[index];
+   batch->bitmaps[index] = NULL;
+   al_unlock_mutex(decoder.mutex);
+
+   return bmp;
+}
+
+
+/* Function: al_is_bitmap_batch_finished
+ */
+bool al_is_bitmap_batch_finished(ALLEGRO_BITMAP_BATCH *batch)
+{
+   bool finished;
+   ASSERT(batch);
+
+   al_lock_mutex(decoder.mutex);
+   finished = (batch->next_file == batch->count && batch->num_loading == 0);
+   al_unlock_mutex(decoder.mutex);
+
+   return finished;
+}
+
+
+/* Function: al_wait_for_bitmap_batch
+ */
+void al_wait_for_bitmap_batch(ALLEGRO_BITMAP_BATCH *batch)
+{
+   ASSERT(batch);
+
+   al_start_bitmap_batch(batch);
+
+   al_lock_mutex(decoder.mutex);
+   while (batch->next_file < batch->count || batch->num_loading > 0)
+      al_wait_cond(decoder.done_cond, decoder.mutex);
+   al_unlock_mutex(decoder.mutex);
+}
+
+/* vim: set sts=3 sw=3 et: */
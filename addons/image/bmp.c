@@ -22,6 +22,7 @@
 
 #include "allegro5/allegro.h"
 #include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_convert.h"
 #include "allegro5/internal/aintern_image.h"
 
@@ -45,6 +46,9 @@ ALLEGRO_DEBUG_CHANNEL("image")
 #define WININFOHEADERSIZEV4   108
 #define WININFOHEADERSIZEV5   124
 
+/* RGB images are read in chunks of about this many bytes. */
+#define BMP_CHUNK_SIZE        (4 << 20)
+
 typedef struct BMPFILEHEADER
 {
    unsigned short bfType;
@@ -100,6 +104,9 @@ typedef struct OS2BMPINFOHEADER
 typedef void(*bmp_line_fn)(ALLEGRO_FILE *f, char *buf, char *data,
    int length, bool premul);
 
+typedef void(*bmp_convert_fn)(const char *buf, char *data,
+   int length, bool premul);
+
 
 
 /* read_bmfileheader:
@@ -286,9 +293,9 @@ static void read_palette(int ncolors, PalEntry *pal, ALLEGRO_FILE *f,
  *  Support function for reading 16-bit little endian values
  *  from a memory buffer.
  */
-static uint16_t read_16le(void *buf)
+static uint16_t read_16le(const void *buf)
 {
-   unsigned char *ucbuf = (unsigned char *)buf;
+   const unsigned char *ucbuf = (const unsigned char *)buf;
 
    return ucbuf[0] | (ucbuf[1] << 8);
 }
@@ -299,9 +306,9 @@ static uint16_t read_16le(void *buf)
  *  Support function for reading 32-bit little endian values
  *  from a memory buffer.
  */
-static uint32_t read_32le(void *buf)
+static uint32_t read_32le(const void *buf)
 {
-   unsigned char *ucbuf = (unsigned char *)buf;
+   const unsigned char *ucbuf = (const unsigned char *)buf;
 
    return ucbuf[0] | (ucbuf[1] << 8) | (ucbuf[2] << 16) | (ucbuf[3] << 24);
 }
@@ -403,18 +410,14 @@ static void read_8bit_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_16_rgb_555_line:
- *  Support function for reading the 16 bit / RGB555 bitmap file format.
+/* convert_16_rgb_555_line:
+ *  Converts a row of the 16 bit / RGB555 bitmap file format.
  */
-static void read_16_rgb_555_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_16_rgb_555_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = (length + (length & 1)) * 2;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    (void)premul;
 
@@ -426,18 +429,14 @@ static void read_16_rgb_555_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_16_argb_1555_line:
- *  Support function for reading the 16 bit / ARGB1555 bitmap file format.
+/* convert_16_argb_1555_line:
+ *  Converts a row of the 16 bit / ARGB1555 bitmap file format.
  */
-static void read_16_argb_1555_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_16_argb_1555_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = (length + (length & 1)) * 2;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    for (i = 0; i < length; ++i) {
       uint16_t pixel = read_16le(buf + i*2);
@@ -450,18 +449,14 @@ static void read_16_argb_1555_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_16_rgb_565_line:
- *  Support function for reading the 16 bit / RGB565 bitmap file format.
+/* convert_16_rgb_565_line:
+ *  Converts a row of the 16 bit / RGB565 bitmap file format.
  */
-static void read_16_rgb_565_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_16_rgb_565_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = (length + (length & 1)) * 2;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    (void)premul;
 
@@ -473,19 +468,15 @@ static void read_16_rgb_565_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_24_rgb_888_line:
- *  Support function for reading the 24 bit / RGB888 bitmap file format.
+/* convert_24_rgb_888_line:
+ *  Converts a row of the 24 bit / RGB888 bitmap file format.
  */
-static void read_24_rgb_888_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_24_rgb_888_line(const char *buf, char *data,
    int length, bool premul)
 {
    int bi, i;
-   unsigned char *ucbuf = (unsigned char *)buf;
+   const unsigned char *ucbuf = (const unsigned char *)buf;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = length * 3 + (length & 3);
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    (void)premul;
 
@@ -515,18 +506,14 @@ static void read_24_rgb_888_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_32_xrgb_8888_line:
- *  Support function for reading the 32 bit / XRGB8888 bitmap file format.
+/* convert_32_xrgb_8888_line:
+ *  Converts a row of the 32 bit / XRGB8888 bitmap file format.
  */
-static void read_32_xrgb_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_32_xrgb_8888_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = length * 4;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    (void)premul;
 
@@ -538,18 +525,14 @@ static void read_32_xrgb_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_32_rgbx_8888_line:
- *  Support function for reading the 32 bit / RGBX8888 bitmap file format.
+/* convert_32_rgbx_8888_line:
+ *  Converts a row of the 32 bit / RGBX8888 bitmap file format.
  */
-static void read_32_rgbx_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_32_rgbx_8888_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = length * 4;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    (void)premul;
 
@@ -561,18 +544,14 @@ static void read_32_rgbx_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_32_argb_8888_line:
- *  Support function for reading the 32 bit / ARGB8888 bitmap file format.
+/* convert_32_argb_8888_line:
+ *  Converts a row of the 32 bit / ARGB8888 bitmap file format.
  */
-static void read_32_argb_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_32_argb_8888_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = length * 4;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    for (i = 0; i < length; i++) {
       uint32_t pixel = read_32le(buf + i*4);
@@ -589,18 +568,14 @@ static void read_32_argb_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
-/* read_32_rgba_8888_line:
- *  Support function for reading the 32 bit / RGBA8888 bitmap file format.
+/* convert_32_rgba_8888_line:
+ *  Converts a row of the 32 bit / RGBA8888 bitmap file format.
  */
-static void read_32_rgba_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
+static void convert_32_rgba_8888_line(const char *buf, char *data,
    int length, bool premul)
 {
    int i;
    uint32_t *data32 = (uint32_t *)data;
-   size_t bytes_wanted = length * 4;
-
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
 
    for (i = 0; i < length; i++) {
       uint32_t pixel = read_32le(buf + i*4);
@@ -617,32 +592,58 @@ static void read_32_rgba_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
+/* Rows of an RGB image, read from the file and waiting to be converted
+ * into the locked bitmap by convert_RGB_rows.
+ */
+typedef struct RGB_ROWS
+{
+   const char *buf;
+   size_t stride;
+   ALLEGRO_LOCKED_REGION *lr;
+   int first_line;
+   int dir;
+   int width;
+   bool premul;
+   bmp_convert_fn fn;
+} RGB_ROWS;
+
+
+
+static void convert_RGB_rows(void *arg, int y0, int y1)
+{
+   RGB_ROWS *rows = arg;
+   int i;
+
+   for (i = y0; i < y1; i++) {
+      int line = rows->first_line + i * rows->dir;
+      char *data = (char *)rows->lr->data + rows->lr->pitch * line;
+      rows->fn(rows->buf + rows->stride * i, data, rows->width, rows->premul);
+   }
+}
+
+
+
 /* read_RGB_image:
- *  For reading the standard BMP image format
+ *  For reading the standard BMP image format. The rows are read a chunk at
+ *  a time and each chunk is converted by several threads.
  */
 static bool read_RGB_image(ALLEGRO_FILE *f, int flags,
    const BMPINFOHEADER *infoheader, ALLEGRO_LOCKED_REGION *lr,
-   bmp_line_fn fn)
+   bmp_convert_fn fn)
 {
-   int i, line, height, width, dir;
-   size_t linesize;
-   char *linebuf;
-   bool premul = !(flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA);
+   int i, line, height, dir, chunk_rows;
+   char *buf;
+   RGB_ROWS rows;
 
    height = infoheader->biHeight;
-   width = infoheader->biWidth;
-
-   // Includes enough space to read the padding for a line
-   linesize = (infoheader->biWidth + 3) & ~3;
 
-   if (infoheader->biBitCount < 8)
-      linesize *= (8 / infoheader->biBitCount);
-   else
-      linesize *= (infoheader->biBitCount / 8);
+   // Rows are padded to a multiple of 4 bytes
+   rows.stride = ((infoheader->biWidth * infoheader->biBitCount + 31) / 32) * 4;
+   chunk_rows = _ALLEGRO_CLAMP(1, (int)(BMP_CHUNK_SIZE / rows.stride), abs(height));
 
-   linebuf = al_malloc(linesize);
+   buf = al_malloc(rows.stride * chunk_rows);
 
-   if (!linebuf) {
+   if (!buf) {
       ALLEGRO_WARN("Failed to allocate pixel row buffer\n");
       return false;
    }
@@ -651,12 +652,24 @@ static bool read_RGB_image(ALLEGRO_FILE *f, int flags,
    dir = height < 0 ? 1 : -1;
    height = abs(height);
 
-   for (i = 0; i < height; i++, line += dir) {
-      char *data = (char *)lr->data + lr->pitch * line;
-      fn(f, linebuf, data, width, premul);
+   rows.buf = buf;
+   rows.lr = lr;
+   rows.dir = dir;
+   rows.width = infoheader->biWidth;
+   rows.premul = !(flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA);
+   rows.fn = fn;
+
+   for (i = 0; i < height; i += chunk_rows, line += dir * chunk_rows) {
+      int n = _ALLEGRO_MIN(chunk_rows, height - i);
+      size_t bytes_wanted = rows.stride * n;
+      size_t bytes_read = al_fread(f, buf, bytes_wanted);
+      memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+
+      rows.first_line = line;
+      _al_iio_convert_rows(n, convert_RGB_rows, &rows);
    }
 
-   al_free(linebuf);
+   al_free(buf);
 
    return true;
 }
@@ -928,39 +941,24 @@ static bool read_RGB_image_32bit_alpha_hack(ALLEGRO_FILE *f, int flags,
 {
    int i, j, line, startline, height, width, dir;
    int have_alpha = 0;
-   size_t linesize;
-   char *linebuf;
    const bool premul = !(flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA);
 
+   /* Don't premultiply alpha here or the image will come out all black */
+   if (!read_RGB_image(f, flags | ALLEGRO_NO_PREMULTIPLIED_ALPHA, infoheader,
+         lr, convert_32_argb_8888_line))
+      return false;
+
    height = infoheader->biHeight;
    width = infoheader->biWidth;
 
-   // Includes enough space to read the padding for a line
-   linesize = (infoheader->biWidth + 3) & ~3;
-
-   if (infoheader->biBitCount < 8)
-      linesize *= (8 / infoheader->biBitCount);
-   else
-      linesize *= (infoheader->biBitCount / 8);
-
-   linebuf = al_malloc(linesize);
-
-   if (!linebuf) {
-      ALLEGRO_WARN("Failed to allocate pixel row buffer\n");
-      return false;
-   }
-
    line = startline = height < 0 ? 0 : height - 1;
    dir = height < 0 ? 1 : -1;
    height = abs(height);
 
-   for (i = 0; i < height; i++, line += dir) {
+   /* Check the alpha values of every pixel */
+   for (i = 0; i < height && !have_alpha; i++, line += dir) {
       unsigned char *data = (unsigned char *)lr->data + lr->pitch * line;
 
-      /* Don't premultiply alpha here or the image will come out all black */
-      read_32_argb_8888_line(f, linebuf, (char *)data, width, false);
-
-      /* Check the alpha values of every pixel in the row */
       for (j = 0; j < width; j++) {
          have_alpha |= ((data[j*4+3] & 0xFF) != 0);
       }
@@ -992,8 +990,6 @@ static bool read_RGB_image_32bit_alpha_hack(ALLEGRO_FILE *f, int flags,
       }
    }
 
-   al_free(linebuf);
-
    return true;
 }
 
@@ -1452,34 +1448,35 @@ ALLEGRO_BITMAP *_al_load_bmp_f(ALLEGRO_FILE *f, int flags)
          }
          else {
             bmp_line_fn fn = NULL;
+            bmp_convert_fn convert_fn = NULL;
 
             switch (infoheader.biBitCount) {
                case 1: fn = read_1bit_line; break;
                case 2: fn = read_2bit_line; break;
                case 4: fn = read_4bit_line; break;
                case 8: fn = read_8bit_line; break;
-               case 16: fn = read_16_rgb_555_line; break;
-               case 24: fn = read_24_rgb_888_line; break;
-               case 32: fn = read_32_xrgb_8888_line; break;
+               case 16: convert_fn = convert_16_rgb_555_line; break;
+               case 24: convert_fn = convert_24_rgb_888_line; break;
+               case 32: convert_fn = convert_32_xrgb_8888_line; break;
                default:
                   ALLEGRO_ERROR("No decoding function for bit depth %d\n", infoheader.biBitCount);
                   return NULL;
             }
 
             if (infoheader.biBitCount == 16 && infoheader.biAlphaMask == 0x00008000U)
-               fn = read_16_argb_1555_line;
+               convert_fn = convert_16_argb_1555_line;
             else if (infoheader.biBitCount == 32 && infoheader.biAlphaMask == 0xFF000000U)
-               fn = read_32_argb_8888_line;
-            if (keep_index) {
-               if (!read_RGB_image_indices(f, flags, &infoheader, lr, fn))
+               convert_fn = convert_32_argb_8888_line;
+            if (convert_fn) {
+               if (!read_RGB_image(f, flags, &infoheader, lr, convert_fn))
                   return NULL;
             }
-            else if (infoheader.biBitCount <= 8) {
-               if (!read_RGB_paletted_image(f, flags, &infoheader, pal, lr, fn))
+            else if (keep_index) {
+               if (!read_RGB_image_indices(f, flags, &infoheader, lr, fn))
                   return NULL;
             }
             else {
-               if (!read_RGB_image(f, flags, &infoheader, lr, fn))
+               if (!read_RGB_paletted_image(f, flags, &infoheader, pal, lr, fn))
                   return NULL;
             }
          }
@@ -1501,15 +1498,15 @@ ALLEGRO_BITMAP *_al_load_bmp_f(ALLEGRO_FILE *f, int flags)
          if (infoheader.biBitCount == 16) {
             if (infoheader.biRedMask == 0x00007C00U && infoheader.biGreenMask == 0x000003E0U &&
                 infoheader.biBlueMask == 0x0000001FU && infoheader.biAlphaMask == 0x00000000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_16_rgb_555_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_16_rgb_555_line);
             }
             else if (infoheader.biRedMask == 0x00007C00U && infoheader.biGreenMask == 0x000003E0U &&
                      infoheader.biBlueMask == 0x0000001FU && infoheader.biAlphaMask == 0x00008000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_16_argb_1555_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_16_argb_1555_line);
             }
             else if (infoheader.biRedMask == 0x0000F800U && infoheader.biGreenMask == 0x000007E0U &&
                      infoheader.biBlueMask == 0x0000001FU && infoheader.biAlphaMask == 0x00000000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_16_rgb_565_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_16_rgb_565_line);
             }
             else {
                loaded_ok = read_bitfields_image(f, flags, &infoheader, lr);
@@ -1518,7 +1515,7 @@ ALLEGRO_BITMAP *_al_load_bmp_f(ALLEGRO_FILE *f, int flags)
          else if (infoheader.biBitCount == 24) {
             if (infoheader.biRedMask == 0x00FF0000U && infoheader.biGreenMask == 0x0000FF00U &&
                 infoheader.biBlueMask == 0x000000FFU && infoheader.biAlphaMask == 0x00000000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_24_rgb_888_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_24_rgb_888_line);
             }
             else {
                loaded_ok = read_bitfields_image(f, flags, &infoheader, lr);
@@ -1527,19 +1524,19 @@ ALLEGRO_BITMAP *_al_load_bmp_f(ALLEGRO_FILE *f, int flags)
          else if (infoheader.biBitCount == 32) {
             if (infoheader.biRedMask == 0x00FF0000U && infoheader.biGreenMask == 0x0000FF00U &&
                 infoheader.biBlueMask == 0x000000FFU && infoheader.biAlphaMask == 0x00000000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_32_xrgb_8888_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_32_xrgb_8888_line);
             }
             else if (infoheader.biRedMask == 0x00FF0000U && infoheader.biGreenMask == 0x0000FF00U &&
                 infoheader.biBlueMask == 0x000000FFU && infoheader.biAlphaMask == 0xFF000000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_32_argb_8888_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_32_argb_8888_line);
             }
             else if (infoheader.biRedMask == 0xFF000000U && infoheader.biGreenMask == 0x00FF0000U &&
                 infoheader.biBlueMask == 0x0000FF00U && infoheader.biAlphaMask == 0x00000000U) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_32_rgbx_8888_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_32_rgbx_8888_line);
             }
             else if (infoheader.biRedMask == 0xFF000000U && infoheader.biGreenMask == 0x00FF0000U &&
                 infoheader.biBlueMask == 0x0000FF00U && infoheader.biAlphaMask == 0x000000FFU) {
-               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, read_32_rgba_8888_line);
+               loaded_ok = read_RGB_image(f, flags, &infoheader, lr, convert_32_rgba_8888_line);
             }
             else {
                loaded_ok = read_bitfields_image(f, flags, &infoheader, lr);
@@ -13,9 +13,14 @@
  *      See readme.txt for copyright information.
  */
 
+#define ALLEGRO_INTERNAL_UNSTABLE
+
 #include "allegro5/allegro.h"
 #include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_image.h"
+#include "allegro5/internal/aintern_pixels.h"
 
 #include "iio.h"
 
@@ -56,7 +61,116 @@ typedef struct {
 
 #define FOURCC(c0, c1, c2, c3) ((int)(c0) | ((int)(c1) << 8) | ((int)(c2) << 16) | ((int)(c3) << 24))
 
+#define DDPF_ALPHAPIXELS 0x1
 #define DDPF_FOURCC 0x4
+#define DDPF_RGB 0x40
+
+#define DDSD_MIPMAPCOUNT 0x20000
+
+/* Uncompressed formats which map straight onto a pixel format. */
+static const struct {
+   int bit_count;
+   uint32_t r, g, b, a;
+   int format;
+} rgb_formats[] = {
+   {32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000, ALLEGRO_PIXEL_FORMAT_ARGB_8888},
+   {32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000, ALLEGRO_PIXEL_FORMAT_XRGB_8888},
+   {32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000, ALLEGRO_PIXEL_FORMAT_ABGR_8888},
+   {32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0x00000000, ALLEGRO_PIXEL_FORMAT_XBGR_8888},
+   {32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff, ALLEGRO_PIXEL_FORMAT_RGBA_8888},
+   {32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x00000000, ALLEGRO_PIXEL_FORMAT_RGBX_8888},
+   {24, 0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000, ALLEGRO_PIXEL_FORMAT_RGB_888},
+   {24, 0x000000ff, 0x0000ff00, 0x00ff0000, 0x00000000, ALLEGRO_PIXEL_FORMAT_BGR_888},
+   {16, 0x0000f800, 0x000007e0, 0x0000001f, 0x00000000, ALLEGRO_PIXEL_FORMAT_RGB_565},
+   {16, 0x0000001f, 0x000007e0, 0x0000f800, 0x00000000, ALLEGRO_PIXEL_FORMAT_BGR_565},
+   {16, 0x00007c00, 0x000003e0, 0x0000001f, 0x00008000, ALLEGRO_PIXEL_FORMAT_ARGB_1555},
+   {16, 0x00007c00, 0x000003e0, 0x0000001f, 0x00000000, ALLEGRO_PIXEL_FORMAT_RGB_555},
+   {16, 0x0000001f, 0x000003e0, 0x00007c00, 0x00000000, ALLEGRO_PIXEL_FORMAT_BGR_555},
+   {16, 0x0000f800, 0x000007c0, 0x0000003e, 0x00000001, ALLEGRO_PIXEL_FORMAT_RGBA_5551},
+   {16, 0x00000f00, 0x000000f0, 0x0000000f, 0x0000f000, ALLEGRO_PIXEL_FORMAT_ARGB_4444},
+   {16, 0x0000f000, 0x00000f00, 0x000000f0, 0x0000000f, ALLEGRO_PIXEL_FORMAT_RGBA_4444}
+};
+
+
+static int find_rgb_format(const DDS_PIXELFORMAT *pf)
+{
+   uint32_t a = (pf->dwFlags & DDPF_ALPHAPIXELS) ? (uint32_t)pf->dwABitMask : 0;
+   unsigned i;
+
+   for (i = 0; i < sizeof(rgb_formats) / sizeof(rgb_formats[0]); i++) {
+      if (rgb_formats[i].bit_count == pf->dwRGBBitCount &&
+          rgb_formats[i].r == (uint32_t)pf->dwRBitMask &&
+          rgb_formats[i].g == (uint32_t)pf->dwGBitMask &&
+          rgb_formats[i].b == (uint32_t)pf->dwBBitMask &&
+          rgb_formats[i].a == a)
+         return rgb_formats[i].format;
+   }
+   return ALLEGRO_PIXEL_FORMAT_ANY;
+}
+
+
+/* read_rows:
+ *  Reads rows of row_bytes each into dst. If the file is memory mapped
+ *  and dst is NULL, *data is pointed into the mapping instead.
+ */
+static bool read_rows(ALLEGRO_FILE *f, const char *mapped, int64_t mapped_size,
+   char *dst, int dst_pitch, size_t row_bytes, int rows, const char **data)
+{
+   int ii;
+
+   if (mapped) {
+      int64_t pos = al_ftell(f);
+      if (pos < 0 || mapped_size - pos < (int64_t)(row_bytes * rows)) {
+         ALLEGRO_ERROR("DDS file too short.\n");
+         return false;
+      }
+      mapped += pos;
+      if (dst) {
+         for (ii = 0; ii < rows; ii++) {
+            memcpy(dst, mapped + ii * row_bytes, row_bytes);
+            dst += dst_pitch;
+         }
+      }
+      else {
+         *data = mapped;
+      }
+      al_fseek(f, pos + row_bytes * rows, ALLEGRO_SEEK_SET);
+      return true;
+   }
+
+   for (ii = 0; ii < rows; ii++) {
+      if (al_fread(f, dst, row_bytes) != row_bytes) {
+         ALLEGRO_ERROR("DDS file too short.\n");
+         return false;
+      }
+      dst += dst_pitch;
+   }
+   if (data)
+      *data = dst - rows * dst_pitch;
+   return true;
+}
+
+
+#ifdef ALLEGRO_BIG_ENDIAN
+/* DDS files are little endian, pixel formats are native endian. */
+static void swap_pixels(char *data, int pitch, int w, int rows, int pixel_size)
+{
+   int x, y, i;
+
+   for (y = 0; y < rows; y++) {
+      char *p = data + y * pitch;
+      for (x = 0; x < w; x++) {
+         for (i = 0; i < pixel_size / 2; i++) {
+            char t = p[i];
+            p[i] = p[pixel_size - 1 - i];
+            p[pixel_size - 1 - i] = t;
+         }
+         p += pixel_size;
+      }
+   }
+}
+#endif
+
 
 ALLEGRO_BITMAP *_al_load_dds_f(ALLEGRO_FILE *f, int flags)
 {
@@ -65,10 +179,15 @@ ALLEGRO_BITMAP *_al_load_dds_f(ALLEGRO_FILE *f, int flags)
    DWORD magic;
    size_t num_read;
    int w, h, fourcc, format, block_width, block_height, block_size;
+   int bitmap_flags;
    ALLEGRO_STATE state;
    ALLEGRO_LOCKED_REGION *lr = NULL;
-   int ii;
-   char* bitmap_data;
+   int level, num_levels, rows;
+   size_t pitch;
+   char *level_buffer = NULL;
+   const char *mapped;
+   const char *level_data;
+   int64_t mapped_size;
    (void)flags;
 
    magic = al_fread32le(f);
@@ -84,36 +203,58 @@ ALLEGRO_BITMAP *_al_load_dds_f(ALLEGRO_FILE *f, int flags)
       return NULL;
    }
 
-   if (!(header.ddspf.dwFlags & DDPF_FOURCC)) {
-      ALLEGRO_ERROR("Only compressed DDS formats supported.\n");
-      return NULL;
-   }
-
    w = header.dwWidth;
    h = header.dwHeight;
    fourcc = header.ddspf.dwFourCC;
+   bitmap_flags = al_get_new_bitmap_flags();
 
-   switch (fourcc) {
-      case FOURCC('D', 'X', 'T', '1'):
-         format = ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT1;
-         break;
-      case FOURCC('D', 'X', 'T', '3'):
-         format = ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT3;
-         break;
-      case FOURCC('D', 'X', 'T', '5'):
-         format = ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT5;
-         break;
-      default:
-         ALLEGRO_ERROR("Invalid pixel format.\n");
+   if (header.ddspf.dwFlags & DDPF_FOURCC) {
+      switch (fourcc) {
+         case FOURCC('D', 'X', 'T', '1'):
+            format = ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT1;
+            break;
+         case FOURCC('D', 'X', 'T', '3'):
+            format = ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT3;
+            break;
+         case FOURCC('D', 'X', 'T', '5'):
+            format = ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT5;
+            break;
+         default:
+            ALLEGRO_ERROR("Invalid pixel format.\n");
+            return NULL;
+      }
+      /* Only textures can hold compressed data. */
+      bitmap_flags = ALLEGRO_VIDEO_BITMAP | (bitmap_flags & ALLEGRO_MIPMAP);
+   }
+   else if (header.ddspf.dwFlags & DDPF_RGB) {
+      format = find_rgb_format(&header.ddspf);
+      if (format == ALLEGRO_PIXEL_FORMAT_ANY) {
+         ALLEGRO_ERROR("Unsupported uncompressed DDS format.\n");
          return NULL;
+      }
+   }
+   else {
+      ALLEGRO_ERROR("Unsupported DDS format.\n");
+      return NULL;
    }
 
+   num_levels = 1;
+   if ((header.dwFlags & DDSD_MIPMAPCOUNT) && header.dwMipMapCount > 1 &&
+       (bitmap_flags & ALLEGRO_MIPMAP)) {
+      num_levels = _ALLEGRO_MIN((uint32_t)header.dwMipMapCount,
+         (uint32_t)_al_get_mipmap_level_count(w, h));
+   }
+   /* Compressed textures can't generate the levels which are missing. */
+   if (_al_pixel_format_is_compressed(format) &&
+       num_levels < _al_get_mipmap_level_count(w, h))
+      bitmap_flags &= ~ALLEGRO_MIPMAP;
+
    block_width = al_get_pixel_block_width(format);
    block_height = al_get_pixel_block_height(format);
    block_size = al_get_pixel_block_size(format);
 
    al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
-   al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP);
+   al_set_new_bitmap_flags(bitmap_flags);
    al_set_new_bitmap_format(format);
    bmp = al_create_bitmap(w, h);
    if (!bmp) {
@@ -138,20 +279,50 @@ ALLEGRO_BITMAP *_al_load_dds_f(ALLEGRO_FILE *f, int flags)
          default:
             ALLEGRO_ERROR("Could not lock the bitmap.\n");
       }
-      return NULL;
+      goto FAIL;
    }
 
-   bitmap_data = lr->data;
+   /* Copy straight out of memory mapped files. */
+   mapped = al_get_file_mapping(f, &mapped_size);
+#ifdef ALLEGRO_BIG_ENDIAN
+   if (block_size > 1 && !_al_pixel_format_is_compressed(format))
+      mapped = NULL;
+#endif
 
-   for (ii = 0; ii < (h + block_height - 1) / block_height; ii++) {
-      size_t pitch = (size_t)((w + block_width - 1) / block_width * block_size);
-      num_read = al_fread(f, bitmap_data, pitch);
-      if (num_read != pitch) {
-         ALLEGRO_ERROR("DDS file too short.\n");
+   pitch = (size_t)((w + block_width - 1) / block_width * block_size);
+   rows = (h + block_height - 1) / block_height;
+   if (!read_rows(f, mapped, mapped_size, lr->data, lr->pitch, pitch, rows,
+         NULL))
+      goto FAIL;
+#ifdef ALLEGRO_BIG_ENDIAN
+   if (!_al_pixel_format_is_compressed(format))
+      swap_pixels(lr->data, lr->pitch, w, h, block_size);
+#endif
+
+   /* The mipmap levels follow, each half the size of the previous one. */
+   for (level = 1; level < num_levels; level++) {
+      int lw = _ALLEGRO_MAX(1, w >> level);
+      int lh = _ALLEGRO_MAX(1, h >> level);
+      pitch = (size_t)((lw + block_width - 1) / block_width * block_size);
+      rows = (lh + block_height - 1) / block_height;
+      if (!mapped && !level_buffer) {
+         level_buffer = al_malloc(pitch * rows);
+         if (!level_buffer)
+            goto FAIL;
+      }
+      if (!read_rows(f, mapped, mapped_size, mapped ? NULL : level_buffer,
+            pitch, pitch, rows, &level_data))
+         goto FAIL;
+#ifdef ALLEGRO_BIG_ENDIAN
+      if (!_al_pixel_format_is_compressed(format))
+         swap_pixels(level_buffer, pitch, lw, lh, block_size);
+#endif
+      if (!al_set_bitmap_mipmap_level(bmp, level, level_data, pitch)) {
+         ALLEGRO_ERROR("Could not set mipmap level %d.\n", level);
          goto FAIL;
       }
-      bitmap_data += lr->pitch;
    }
+
    al_unlock_bitmap(bmp);
 
    goto RESET;
@@ -161,6 +332,7 @@ FAIL:
    al_destroy_bitmap(bmp);
    bmp = NULL;
 RESET:
+   al_free(level_buffer);
    al_restore_state(&state);
    return bmp;
 }
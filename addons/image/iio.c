@@ -42,6 +42,10 @@ bool al_init_image_addon(void)
    success |= al_register_bitmap_loader_f(".dds", _al_load_dds_f);
    success |= al_register_bitmap_identifier(".dds", _al_identify_dds);
 
+   success |= al_register_bitmap_loader(".ktx", _al_load_ktx);
+   success |= al_register_bitmap_loader_f(".ktx", _al_load_ktx_f);
+   success |= al_register_bitmap_identifier(".ktx", _al_identify_ktx);
+
    /* Even if we don't have libpng or libjpeg we most likely have a
     * native reader for those instead so always identify them.
     */
@@ -151,8 +155,10 @@ bool al_init_image_addon(void)
 #endif
 #endif
 
-   if (success)
+   if (success) {
+      _al_iio_init_decoder();
       iio_inited = true;
+   }
 
    _al_add_exit_func(al_shutdown_image_addon, "al_shutdown_image_addon");
 
@@ -172,6 +178,8 @@ bool al_is_image_addon_initialized(void)
  */
 void al_shutdown_image_addon(void)
 {
+   if (iio_inited)
+      _al_iio_shutdown_decoder();
    iio_inited = false;
 }
 
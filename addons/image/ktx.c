@@ -0,0 +1,382 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      A simple KTX (version 1) reader.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#define ALLEGRO_INTERNAL_UNSTABLE
+
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_image.h"
+#include "allegro5/internal/aintern_pixels.h"
+
+#include "iio.h"
+
+ALLEGRO_DEBUG_CHANNEL("image")
+
+static const uint8_t ktx_identifier[12] = {
+   0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+#define KTX_ENDIAN_REF 0x04030201
+
+#define GL_UNSIGNED_BYTE               0x1401
+#define GL_UNSIGNED_SHORT_4_4_4_4      0x8033
+#define GL_UNSIGNED_SHORT_5_5_5_1      0x8034
+#define GL_UNSIGNED_SHORT_5_6_5        0x8363
+#define GL_RED                         0x1903
+#define GL_RGB                         0x1907
+#define GL_RGBA                        0x1908
+#define GL_BGRA                        0x80E1
+#define GL_COMPRESSED_RGB_S3TC_DXT1    0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1   0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3   0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5   0x83F3
+
+typedef struct {
+   uint32_t endianness;
+   uint32_t gl_type;
+   uint32_t gl_type_size;
+   uint32_t gl_format;
+   uint32_t gl_internal_format;
+   uint32_t gl_base_internal_format;
+   uint32_t pixel_width;
+   uint32_t pixel_height;
+   uint32_t pixel_depth;
+   uint32_t number_of_array_elements;
+   uint32_t number_of_faces;
+   uint32_t number_of_mipmap_levels;
+   uint32_t bytes_of_key_value_data;
+} KTX_HEADER;
+
+
+static int find_format(const KTX_HEADER *header)
+{
+   if (header->gl_type == 0) {
+      switch (header->gl_internal_format) {
+         case GL_COMPRESSED_RGB_S3TC_DXT1:
+         case GL_COMPRESSED_RGBA_S3TC_DXT1:
+            return ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT1;
+         case GL_COMPRESSED_RGBA_S3TC_DXT3:
+            return ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT3;
+         case GL_COMPRESSED_RGBA_S3TC_DXT5:
+            return ALLEGRO_PIXEL_FORMAT_COMPRESSED_RGBA_DXT5;
+      }
+      return ALLEGRO_PIXEL_FORMAT_ANY;
+   }
+
+   switch (header->gl_type) {
+      case GL_UNSIGNED_BYTE:
+         switch (header->gl_format) {
+            case GL_RGBA:
+               return ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE;
+            case GL_RGB:
+#ifdef ALLEGRO_BIG_ENDIAN
+               return ALLEGRO_PIXEL_FORMAT_RGB_888;
+#else
+               return ALLEGRO_PIXEL_FORMAT_BGR_888;
+#endif
+#ifndef ALLEGRO_BIG_ENDIAN
+            case GL_BGRA:
+               return ALLEGRO_PIXEL_FORMAT_ARGB_8888;
+#endif
+            case GL_RED:
+               return ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8;
+         }
+         break;
+      case GL_UNSIGNED_SHORT_5_6_5:
+         if (header->gl_format == GL_RGB)
+            return ALLEGRO_PIXEL_FORMAT_RGB_565;
+         break;
+      case GL_UNSIGNED_SHORT_4_4_4_4:
+         if (header->gl_format == GL_RGBA)
+            return ALLEGRO_PIXEL_FORMAT_RGBA_4444;
+         break;
+      case GL_UNSIGNED_SHORT_5_5_5_1:
+         if (header->gl_format == GL_RGBA)
+            return ALLEGRO_PIXEL_FORMAT_RGBA_5551;
+         break;
+   }
+   return ALLEGRO_PIXEL_FORMAT_ANY;
+}
+
+
+/* read_level:
+ *  Reads the rows of a mipmap level, which are src_pitch bytes apart in
+ *  the file. If dst is given the rows are copied there, otherwise *data
+ *  is pointed at them, either inside the file mapping or in buffer.
+ */
+static bool read_level(ALLEGRO_FILE *f, const char *mapped, int64_t mapped_size,
+   char *dst, int dst_pitch, char *buffer, const char **data,
+   int row_bytes, int src_pitch, int rows)
+{
+   int64_t size = (int64_t)src_pitch * rows;
+   int ii;
+
+   if (mapped) {
+      int64_t pos = al_ftell(f);
+      if (pos < 0 || mapped_size - pos < size) {
+         ALLEGRO_ERROR("KTX file too short.\n");
+         return false;
+      }
+      mapped += pos;
+      if (dst) {
+         for (ii = 0; ii < rows; ii++)
+            memcpy(dst + ii * dst_pitch, mapped + ii * src_pitch, row_bytes);
+      }
+      else {
+         *data = mapped;
+      }
+      return al_fseek(f, pos + size, ALLEGRO_SEEK_SET);
+   }
+
+   if (dst) {
+      for (ii = 0; ii < rows; ii++) {
+         if (al_fread(f, dst + ii * dst_pitch, row_bytes) != (size_t)row_bytes)
+            goto SHORT;
+         if (src_pitch > row_bytes &&
+               !al_fseek(f, src_pitch - row_bytes, ALLEGRO_SEEK_CUR))
+            goto SHORT;
+      }
+      return true;
+   }
+
+   if (al_fread(f, buffer, size) != (size_t)size)
+      goto SHORT;
+   *data = buffer;
+   return true;
+
+SHORT:
+   ALLEGRO_ERROR("KTX file too short.\n");
+   return false;
+}
+
+
+#ifdef ALLEGRO_BIG_ENDIAN
+/* KTX files written little endian have little endian packed pixels. */
+static void swap_pixels16(char *data, int pitch, int w, int rows)
+{
+   int x, y;
+
+   for (y = 0; y < rows; y++) {
+      char *p = data + y * pitch;
+      for (x = 0; x < w; x++, p += 2) {
+         char t = p[0];
+         p[0] = p[1];
+         p[1] = t;
+      }
+   }
+}
+#endif
+
+
+ALLEGRO_BITMAP *_al_load_ktx_f(ALLEGRO_FILE *f, int flags)
+{
+   ALLEGRO_BITMAP *bmp = NULL;
+   KTX_HEADER header;
+   uint8_t identifier[12];
+   uint32_t *fields = (uint32_t *)&header;
+   int w, h, format, block_width, block_height, block_size;
+   int bitmap_flags;
+   bool compressed;
+   ALLEGRO_STATE state;
+   ALLEGRO_LOCKED_REGION *lr = NULL;
+   int level, num_levels;
+   unsigned ii;
+   char *level_buffer = NULL;
+   const char *mapped;
+   int64_t mapped_size;
+   (void)flags;
+
+   if (al_fread(f, identifier, 12) != 12 ||
+         memcmp(identifier, ktx_identifier, 12) != 0) {
+      ALLEGRO_ERROR("Invalid KTX identifier.\n");
+      return NULL;
+   }
+
+   for (ii = 0; ii < sizeof(header) / sizeof(uint32_t); ii++)
+      fields[ii] = al_fread32le(f);
+   if (al_feof(f)) {
+      ALLEGRO_ERROR("KTX header too short.\n");
+      return NULL;
+   }
+
+   if (header.endianness != KTX_ENDIAN_REF) {
+      ALLEGRO_ERROR("Only little endian KTX files are supported.\n");
+      return NULL;
+   }
+
+   if (header.pixel_height == 0 || header.pixel_depth > 1 ||
+         header.number_of_array_elements > 0 || header.number_of_faces != 1) {
+      ALLEGRO_ERROR("Only 2D KTX textures are supported.\n");
+      return NULL;
+   }
+
+   format = find_format(&header);
+   if (format == ALLEGRO_PIXEL_FORMAT_ANY) {
+      ALLEGRO_ERROR("Unsupported KTX format (type 0x%x, format 0x%x, "
+         "internal format 0x%x).\n", header.gl_type, header.gl_format,
+         header.gl_internal_format);
+      return NULL;
+   }
+
+   if (!al_fseek(f, header.bytes_of_key_value_data, ALLEGRO_SEEK_CUR)) {
+      ALLEGRO_ERROR("KTX file too short.\n");
+      return NULL;
+   }
+
+   w = header.pixel_width;
+   h = header.pixel_height;
+   compressed = _al_pixel_format_is_compressed(format);
+   bitmap_flags = al_get_new_bitmap_flags();
+   if (compressed) {
+      /* Only textures can hold compressed data. */
+      bitmap_flags = ALLEGRO_VIDEO_BITMAP | (bitmap_flags & ALLEGRO_MIPMAP);
+   }
+
+   num_levels = 1;
+   if (header.number_of_mipmap_levels > 1 && (bitmap_flags & ALLEGRO_MIPMAP)) {
+      num_levels = _ALLEGRO_MIN(header.number_of_mipmap_levels,
+         (uint32_t)_al_get_mipmap_level_count(w, h));
+   }
+   /* Compressed textures can't generate the levels which are missing. */
+   if (compressed && num_levels < _al_get_mipmap_level_count(w, h))
+      bitmap_flags &= ~ALLEGRO_MIPMAP;
+
+   block_width = al_get_pixel_block_width(format);
+   block_height = al_get_pixel_block_height(format);
+   block_size = al_get_pixel_block_size(format);
+
+   al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
+   al_set_new_bitmap_flags(bitmap_flags);
+   al_set_new_bitmap_format(format);
+   bmp = al_create_bitmap(w, h);
+   if (!bmp) {
+      ALLEGRO_ERROR("Failed to create bitmap.\n");
+      goto FAIL;
+   }
+
+   if (al_get_bitmap_format(bmp) != format) {
+      ALLEGRO_ERROR("Created a bad bitmap.\n");
+      goto FAIL;
+   }
+
+   lr = al_lock_bitmap_blocked(bmp, ALLEGRO_LOCK_WRITEONLY);
+   if (!lr) {
+      ALLEGRO_ERROR("Could not lock the bitmap.\n");
+      goto FAIL;
+   }
+
+   mapped = al_get_file_mapping(f, &mapped_size);
+#ifdef ALLEGRO_BIG_ENDIAN
+   if (block_size == 2)
+      mapped = NULL;
+#endif
+
+   for (level = 0; level < num_levels; level++) {
+      int lw = _ALLEGRO_MAX(1, w >> level);
+      int lh = _ALLEGRO_MAX(1, h >> level);
+      int row_bytes = (lw + block_width - 1) / block_width * block_size;
+      int rows = (lh + block_height - 1) / block_height;
+      /* Rows of uncompressed levels are padded to 4 bytes. */
+      int src_pitch = compressed ? row_bytes : (row_bytes + 3) & ~3;
+      uint32_t image_size = al_fread32le(f);
+      const char *level_data;
+
+      if (al_feof(f) || image_size < (uint32_t)(src_pitch * rows)) {
+         ALLEGRO_ERROR("Bad KTX image size %u for level %d.\n", image_size,
+            level);
+         goto FAIL;
+      }
+
+      if (level == 0) {
+         if (!read_level(f, mapped, mapped_size, lr->data, lr->pitch, NULL,
+               NULL, row_bytes, src_pitch, rows))
+            goto FAIL;
+#ifdef ALLEGRO_BIG_ENDIAN
+         if (block_size == 2)
+            swap_pixels16(lr->data, lr->pitch, lw, lh);
+#endif
+      }
+      else {
+         if (!mapped && !level_buffer) {
+            /* Level 1 is the largest one read into the buffer. */
+            level_buffer = al_malloc(src_pitch * rows);
+            if (!level_buffer)
+               goto FAIL;
+         }
+         if (!read_level(f, mapped, mapped_size, NULL, 0, level_buffer,
+               &level_data, row_bytes, src_pitch, rows))
+            goto FAIL;
+#ifdef ALLEGRO_BIG_ENDIAN
+         if (block_size == 2)
+            swap_pixels16(level_buffer, src_pitch, lw, lh);
+#endif
+         if (!al_set_bitmap_mipmap_level(bmp, level, level_data, src_pitch)) {
+            ALLEGRO_ERROR("Could not set mipmap level %d.\n", level);
+            goto FAIL;
+         }
+      }
+
+      /* Skip what we don't read, then the mip padding. */
+      if (!al_fseek(f, (image_size - src_pitch * rows) + (3 - ((image_size + 3) % 4)),
+            ALLEGRO_SEEK_CUR))
+         goto FAIL;
+   }
+
+   al_unlock_bitmap(bmp);
+
+   goto RESET;
+FAIL:
+   if (lr)
+      al_unlock_bitmap(bmp);
+   al_destroy_bitmap(bmp);
+   bmp = NULL;
+RESET:
+   al_free(level_buffer);
+   al_restore_state(&state);
+   return bmp;
+}
+
+
+ALLEGRO_BITMAP *_al_load_ktx(const char *filename, int flags)
+{
+   ALLEGRO_FILE *f;
+   ALLEGRO_BITMAP *bmp;
+   ASSERT(filename);
+
+   f = al_fopen(filename, "rb");
+   if (!f) {
+      ALLEGRO_ERROR("Unable open %s for reading.\n", filename);
+      return NULL;
+   }
+
+   bmp = _al_load_ktx_f(f, flags);
+
+   al_fclose(f);
+
+   return bmp;
+}
+
+
+bool _al_identify_ktx(ALLEGRO_FILE *f)
+{
+   uint8_t x[12];
+   if (al_fread(f, x, 12) != 12)
+      return false;
+   return memcmp(x, ktx_identifier, 12) == 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -22,8 +22,11 @@
  */
 
 
+#include <string.h>
+
 #include "allegro5/allegro.h"
 #include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_image.h"
 #include "allegro5/internal/aintern_pixels.h"
 
@@ -31,6 +34,9 @@
 
 ALLEGRO_DEBUG_CHANNEL("image")
 
+/* Rows are read in chunks of about this many bytes. */
+#define TGA_CHUNK_SIZE     (4 << 20)
+
 
 /* raw_tga_read8:
  *  Helper for reading 256-color raw data from TGA files.
@@ -329,6 +335,133 @@ static unsigned short *rle_tga_read16(unsigned short *b, int w, ALLEGRO_FILE *f)
 
 typedef unsigned char palette_entry[3];
 
+
+/* Rows of the image, read from the file and waiting to be converted into
+ * the locked bitmap by convert_tga_rows.
+ */
+typedef struct TGA_ROWS
+{
+   const unsigned char *buf;
+   size_t row_size;
+   ALLEGRO_LOCKED_REGION *lr;
+   int first_y;
+   int width;
+   int height;
+   int image_type;
+   int bpp;
+   bool left_to_right;
+   bool top_to_bottom;
+   bool premul;
+   palette_entry *palette;
+   int palette_start;
+   int palette_colors;
+   bool *bad_rows;   /* per row of the chunk, so bands don't share a flag */
+} TGA_ROWS;
+
+
+
+/* read_tga_row:
+ *  Reads one row of raw or RLE pixels in the file's own format.
+ */
+static bool read_tga_row(unsigned char *buf, int w, int bpp, bool compressed,
+   ALLEGRO_FILE *f)
+{
+   switch (bpp) {
+      case 8:
+         if (compressed)
+            return rle_tga_read8(buf, w, f) != NULL;
+         return raw_tga_read8(buf, w, f) != NULL;
+      case 32:
+         if (compressed)
+            return rle_tga_read32((unsigned int *)buf, w, f) != NULL;
+         return raw_tga_read32((unsigned int *)buf, w, f) != NULL;
+      case 24:
+         if (compressed)
+            return rle_tga_read24(buf, w, f) != NULL;
+         return raw_tga_read24(buf, w, f) != NULL;
+      default:
+         if (compressed)
+            return rle_tga_read16((unsigned short *)buf, w, f) != NULL;
+         return raw_tga_read16((unsigned short *)buf, w, f) != NULL;
+   }
+}
+
+
+
+/* convert_tga_rows:
+ *  Converts rows [y0, y1) of the current chunk into the bitmap.
+ */
+static void convert_tga_rows(void *arg, int y0, int y1)
+{
+   TGA_ROWS *rows = arg;
+   int y, i;
+
+   for (y = y0; y < y1; y++) {
+      const unsigned char *buf = rows->buf + rows->row_size * y;
+      int true_y = (rows->top_to_bottom) ? rows->first_y + y :
+         (rows->height - 1 - rows->first_y - y);
+      unsigned char *row = (unsigned char *)rows->lr->data +
+         rows->lr->pitch*true_y;
+
+      for (i = 0; i < rows->width; i++) {
+         int true_x = (rows->left_to_right) ? i : (rows->width - 1 - i);
+         unsigned char *dest = row + true_x*4;
+
+         if (rows->image_type != 2) {
+            int pix = buf[i];
+            palette_entry *entry = rows->palette + pix;
+
+            if (pix < rows->palette_start ||
+                  pix >= (rows->palette_start + rows->palette_colors)) {
+               rows->bad_rows[y] = true;
+               return;
+            }
+            dest[0] = (*entry)[2];
+            dest[1] = (*entry)[1];
+            dest[2] = (*entry)[0];
+            dest[3] = 255;
+         }
+         else if (rows->bpp == 32) {
+#ifdef ALLEGRO_BIG_ENDIAN
+            int a = buf[i * 4 + 0];
+            int r = buf[i * 4 + 1];
+            int g = buf[i * 4 + 2];
+            int b = buf[i * 4 + 3];
+#else
+            int b = buf[i * 4 + 0];
+            int g = buf[i * 4 + 1];
+            int r = buf[i * 4 + 2];
+            int a = buf[i * 4 + 3];
+#endif
+            if (rows->premul) {
+               r = r * a / 255;
+               g = g * a / 255;
+               b = b * a / 255;
+            }
+
+            dest[0] = r;
+            dest[1] = g;
+            dest[2] = b;
+            dest[3] = a;
+         }
+         else if (rows->bpp == 24) {
+            dest[0] = buf[i * 3 + 2];
+            dest[1] = buf[i * 3 + 1];
+            dest[2] = buf[i * 3 + 0];
+            dest[3] = 255;
+         }
+         else {
+            int pix = *((const unsigned short *)(buf + i * 2));
+            /* TODO - do something with the 1-bit A value (alpha?) */
+            dest[0] = _al_rgb_scale_5[(pix >> 10) & 0x1F];
+            dest[1] = _al_rgb_scale_5[(pix >> 5) & 0x1F];
+            dest[2] = _al_rgb_scale_5[(pix & 0x1F)];
+            dest[3] = 255;
+         }
+      }
+   }
+}
+
 /* Like load_tga, but starts loading from the current place in the ALLEGRO_FILE
  *  specified. If successful the offset into the file will be left just after
  *  the image data. If unsuccessful the offset into the file is unspecified,
@@ -347,11 +480,13 @@ ALLEGRO_BITMAP *_al_load_tga_f(ALLEGRO_FILE *f, int flags)
    bool left_to_right;
    bool top_to_bottom;
    unsigned int c, i;
-   int y;
+   int y, chunk_rows;
    int compressed;
    ALLEGRO_BITMAP *bmp;
    ALLEGRO_LOCKED_REGION *lr;
    unsigned char *buf;
+   TGA_ROWS rows;
+   bool bad_data = false;
    bool premul = !(flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA);
    ASSERT(f);
 
@@ -482,159 +617,67 @@ ALLEGRO_BITMAP *_al_load_tga_f(ALLEGRO_FILE *f, int flags)
    }
 
    /* bpp + 1 accounts for 15 bpp. */
-   buf = al_malloc(image_width * ((bpp + 1) / 8));
-   if (!buf) {
+   rows.row_size = image_width * ((bpp + 1) / 8);
+   chunk_rows = _ALLEGRO_CLAMP(1,
+      (int)(TGA_CHUNK_SIZE / _ALLEGRO_MAX(rows.row_size, 1)), image_height);
+   buf = al_malloc(_ALLEGRO_MAX(rows.row_size * chunk_rows, 1));
+   rows.bad_rows = al_malloc(chunk_rows * sizeof(bool));
+   if (!buf || !rows.bad_rows) {
+      al_free(buf);
+      al_free(rows.bad_rows);
       al_unlock_bitmap(bmp);
       al_destroy_bitmap(bmp);
       ALLEGRO_ERROR("Failed to allocate enough memory.\n");
       return NULL;
    }
 
-   for (y = 0; y < image_height; y++) {
-      int true_y = (top_to_bottom) ? y : (image_height - 1 - y);
-
-      switch (image_type) {
-
-         case 1:
-         case 3: {
-            unsigned char *ptr;
-            if (compressed)
-               ptr = rle_tga_read8(buf, image_width, f);
-            else
-               ptr = raw_tga_read8(buf, image_width, f);
-            if (!ptr) {
-               al_free(buf);
-               al_unlock_bitmap(bmp);
-               al_destroy_bitmap(bmp);
-               ALLEGRO_ERROR("Invalid image data.\n");
-               return NULL;
-            }
-         }
-            for (i = 0; i < image_width; i++) {
-               int true_x = (left_to_right) ? i : (image_width - 1 - i);
-               int pix = buf[i];
-
-               unsigned char *dest = (unsigned char *)lr->data +
-                  lr->pitch*true_y + true_x*4;
-               if (pix < palette_start || pix >= (palette_start + palette_colors)) {
-                  al_free(buf);
-                  al_unlock_bitmap(bmp);
-                  al_destroy_bitmap(bmp);
-                  ALLEGRO_ERROR("Invalid image data.\n");
-                  return NULL;
-               }
-               palette_entry* entry = image_palette + pix;
-               dest[0] = (*entry)[2];
-               dest[1] = (*entry)[1];
-               dest[2] = (*entry)[0];
-               dest[3] = 255;
-            }
+   rows.buf = buf;
+   rows.lr = lr;
+   rows.width = image_width;
+   rows.height = image_height;
+   rows.image_type = image_type;
+   rows.bpp = bpp;
+   rows.left_to_right = left_to_right;
+   rows.top_to_bottom = top_to_bottom;
+   rows.premul = premul;
+   rows.palette = image_palette;
+   rows.palette_start = palette_start;
+   rows.palette_colors = palette_colors;
+
+   /* Reading is sequential, but each chunk of rows is converted by several
+    * threads.
+    */
+   for (y = 0; y < image_height; y += chunk_rows) {
+      int n = _ALLEGRO_MIN(chunk_rows, image_height - y);
 
+      for (i = 0; i < (unsigned int)n; i++) {
+         if (!read_tga_row(buf + rows.row_size * i, image_width, bpp,
+               compressed, f)) {
+            bad_data = true;
             break;
+         }
+      }
 
-         case 2:
-            if (bpp == 32) {
-               unsigned int *ptr;
-               if (compressed)
-                  ptr = rle_tga_read32((unsigned int *)buf, image_width, f);
-               else
-                  ptr = raw_tga_read32((unsigned int *)buf, image_width, f);
-               if (!ptr) {
-                  al_free(buf);
-                  al_unlock_bitmap(bmp);
-                  al_destroy_bitmap(bmp);
-                  ALLEGRO_ERROR("Invalid image data.\n");
-                  return NULL;
-               }
-               for (i = 0; i < image_width; i++) {
-                  int true_x = (left_to_right) ? i : (image_width - 1 - i);
-                  unsigned char *dest = (unsigned char *)lr->data +
-                     lr->pitch*true_y + true_x*4;
+      if (!bad_data) {
+         memset(rows.bad_rows, 0, n * sizeof(bool));
+         rows.first_y = y;
+         _al_iio_convert_rows(n, convert_tga_rows, &rows);
+         for (i = 0; i < (unsigned int)n; i++)
+            bad_data |= rows.bad_rows[i];
+      }
 
-#ifdef ALLEGRO_BIG_ENDIAN
-                  int a = buf[i * 4 + 0];
-                  int r = buf[i * 4 + 1];
-                  int g = buf[i * 4 + 2];
-                  int b = buf[i * 4 + 3];
-#else
-                  int b = buf[i * 4 + 0];
-                  int g = buf[i * 4 + 1];
-                  int r = buf[i * 4 + 2];
-                  int a = buf[i * 4 + 3];
-#endif
-                  if (premul) {
-                     r = r * a / 255;
-                     g = g * a / 255;
-                     b = b * a / 255;
-                  }
-
-                  dest[0] = r;
-                  dest[1] = g;
-                  dest[2] = b;
-                  dest[3] = a;
-               }
-            }
-            else if (bpp == 24) {
-               unsigned char *ptr;
-               if (compressed)
-                  ptr = rle_tga_read24(buf, image_width, f);
-               else
-                  ptr = raw_tga_read24(buf, image_width, f);
-               if (!ptr) {
-                  al_free(buf);
-                  al_unlock_bitmap(bmp);
-                  al_destroy_bitmap(bmp);
-                  ALLEGRO_ERROR("Invalid image data.\n");
-                  return NULL;
-               }
-               for (i = 0; i < image_width; i++) {
-                  int true_x = (left_to_right) ? i : (image_width - 1 - i);
-                  int b = buf[i * 3 + 0];
-                  int g = buf[i * 3 + 1];
-                  int r = buf[i * 3 + 2];
-
-                  unsigned char *dest = (unsigned char *)lr->data +
-                     lr->pitch*true_y + true_x*4;
-                  dest[0] = r;
-                  dest[1] = g;
-                  dest[2] = b;
-                  dest[3] = 255;
-               }
-            }
-            else {
-               unsigned short *ptr;
-               if (compressed)
-                  ptr = rle_tga_read16((unsigned short *)buf, image_width, f);
-               else
-                  ptr = raw_tga_read16((unsigned short *)buf, image_width, f);
-               if (!ptr) {
-                  al_free(buf);
-                  al_unlock_bitmap(bmp);
-                  al_destroy_bitmap(bmp);
-                  ALLEGRO_ERROR("Invalid image data.\n");
-                  return NULL;
-               }
-               for (i = 0; i < image_width; i++) {
-                  int true_x = (left_to_right) ? i : (image_width - 1 - i);
-                  int pix = *((unsigned short *)(buf + i * 2));
-                  /* TODO - do something with the 1-bit A value (alpha?) */
-                  int r = _al_rgb_scale_5[(pix >> 10) & 0x1F];
-                  int g = _al_rgb_scale_5[(pix >> 5) & 0x1F];
-                  int b = _al_rgb_scale_5[(pix & 0x1F)];
-
-                  unsigned char *dest = (unsigned char *)lr->data +
-                     lr->pitch*true_y + true_x*4;
-                  dest[0] = r;
-                  dest[1] = g;
-                  dest[2] = b;
-                  dest[3] = 255;
-               }
-            }
-            break;
+      if (bad_data) {
+         al_free(buf);
+         al_free(rows.bad_rows);
+         al_unlock_bitmap(bmp);
+         al_destroy_bitmap(bmp);
+         ALLEGRO_ERROR("Invalid image data.\n");
+         return NULL;
       }
    }
 
    al_free(buf);
+   al_free(rows.bad_rows);
    al_unlock_bitmap(bmp);
 
    if (al_get_errno()) {
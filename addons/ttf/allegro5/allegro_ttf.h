@@ -43,6 +43,33 @@ ALLEGRO_TTF_FUNC(bool, al_is_ttf_addon_initialized, (void));
 ALLEGRO_TTF_FUNC(void, al_shutdown_ttf_addon, (void));
 ALLEGRO_TTF_FUNC(uint32_t, al_get_allegro_ttf_version, (void));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_TTF_SRC)
+/* Type: ALLEGRO_TTF_CACHE_STATS
+ */
+typedef struct ALLEGRO_TTF_CACHE_STATS ALLEGRO_TTF_CACHE_STATS;
+
+struct ALLEGRO_TTF_CACHE_STATS
+{
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t evictions;
+   uint64_t page_evictions;
+   int pages;
+   uint64_t text_hits;
+   uint64_t text_misses;
+};
+
+ALLEGRO_TTF_FUNC(bool, al_set_ttf_font_max_pages, (ALLEGRO_FONT *font, int max_pages));
+ALLEGRO_TTF_FUNC(int, al_get_ttf_font_max_pages, (const ALLEGRO_FONT *font));
+ALLEGRO_TTF_FUNC(bool, al_set_ttf_font_text_cache_size, (ALLEGRO_FONT *font, int max_runs));
+ALLEGRO_TTF_FUNC(int, al_get_ttf_font_text_cache_size, (const ALLEGRO_FONT *font));
+ALLEGRO_TTF_FUNC(bool, al_get_ttf_font_cache_stats, (const ALLEGRO_FONT *font, ALLEGRO_TTF_CACHE_STATS *stats));
+ALLEGRO_TTF_FUNC(bool, al_save_ttf_font_atlas, (ALLEGRO_FONT *font, const char *filename));
+ALLEGRO_TTF_FUNC(bool, al_save_ttf_font_atlas_f, (ALLEGRO_FONT *font, ALLEGRO_FILE *file));
+ALLEGRO_TTF_FUNC(bool, al_load_ttf_font_atlas, (ALLEGRO_FONT *font, const char *filename));
+ALLEGRO_TTF_FUNC(bool, al_load_ttf_font_atlas_f, (ALLEGRO_FONT *font, ALLEGRO_FILE *file));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
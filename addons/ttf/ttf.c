@@ -18,6 +18,7 @@
 #include FT_FREETYPE_H
 #include FT_TRUETYPE_TABLES_H
 
+#include <limits.h>
 #include <stdlib.h>
 
 ALLEGRO_DEBUG_CHANNEL("font")
@@ -55,6 +56,7 @@ typedef struct ALLEGRO_TTF_GLYPH_DATA
    short offset_x;
    short offset_y;
    short advance;
+   short page;
 } ALLEGRO_TTF_GLYPH_DATA;
 
 
@@ -65,16 +67,73 @@ typedef struct ALLEGRO_TTF_GLYPH_RANGE
 } ALLEGRO_TTF_GLYPH_RANGE;
 
 
+/* One segment of a page's skyline: the free space above y, from x to x+w,
+ * is still unused.
+ */
+typedef struct SKYLINE_NODE
+{
+   int x;
+   int y;
+   int w;
+} SKYLINE_NODE;
+
+
+typedef struct ALLEGRO_TTF_PAGE
+{
+   ALLEGRO_BITMAP *bitmap;
+   _AL_VECTOR skyline;  /* of SKYLINE_NODE, sorted by x */
+   uint64_t last_use;
+} ALLEGRO_TTF_PAGE;
+
+
+/* A glyph of a cached text run, drawn pen pixels from the start. */
+typedef struct TEXT_RUN_GLYPH
+{
+   ALLEGRO_GLYPH glyph;
+   int pen;
+} TEXT_RUN_GLYPH;
+
+
+/* The result of drawing or measuring a string, cached by its contents. */
+typedef struct TEXT_RUN TEXT_RUN;
+
+struct TEXT_RUN
+{
+   TEXT_RUN *hash_next;
+   TEXT_RUN *lru_prev;
+   TEXT_RUN *lru_next;
+   uint32_t hash;
+   ALLEGRO_USTR *text;
+   int advance;       /* as returned by ttf_render, if has_glyphs */
+   int length;        /* as returned by ttf_text_length, or -1 */
+   bool has_glyphs;
+   unsigned int page_generation;
+   _AL_VECTOR glyphs; /* of TEXT_RUN_GLYPH */
+};
+
+
+/* Identifies the glyphs a font renders, for glyph atlas files. */
+typedef struct ATLAS_KEY
+{
+   uint32_t checksum;
+   uint32_t file_size;
+   uint32_t num_glyphs;
+   int32_t w;
+   int32_t h;
+   int32_t flags;
+   uint32_t freetype_version;
+} ATLAS_KEY;
+
+
 typedef struct ALLEGRO_TTF_FONT_DATA
 {
    FT_Face face;
    int flags;
    _AL_VECTOR glyph_ranges;  /* sorted array of of ALLEGRO_TTF_GLYPH_RANGE */
 
-   _AL_VECTOR page_bitmaps;  /* of ALLEGRO_BITMAP pointers */
-   int page_pos_x;
-   int page_pos_y;
-   int page_line_height;
+   _AL_VECTOR pages;  /* of ALLEGRO_TTF_PAGE */
+   ALLEGRO_BITMAP *locked_page;
+   bool locked_whole_page;
    ALLEGRO_LOCKED_REGION *page_lr;
 
    FT_StreamRec stream;
@@ -87,6 +146,21 @@ typedef struct ALLEGRO_TTF_FONT_DATA
 
    int min_page_size;
    int max_page_size;
+   int max_pages;
+
+   uint64_t use_count;
+   unsigned int page_generation;  /* bumped whenever a page is evicted */
+   ALLEGRO_TTF_CACHE_STATS stats;
+
+   TEXT_RUN **run_buckets;
+   unsigned int run_mask;
+   int max_runs;
+   int num_runs;
+   TEXT_RUN run_lru;  /* sentinel, most recently used first */
+
+   ATLAS_KEY atlas_key;
+   char *atlas_filename;  /* from the cache_dir option, or NULL */
+   bool atlas_dirty;      /* glyphs were cached since loading/saving it */
 
    bool skip_cache_misses;
 } ALLEGRO_TTF_FONT_DATA;
@@ -161,18 +235,138 @@ static bool get_glyph(ALLEGRO_TTF_FONT_DATA *data,
 static void unlock_current_page(ALLEGRO_TTF_FONT_DATA *data)
 {
    if (data->page_lr) {
-      ALLEGRO_BITMAP **back = _al_vector_ref_back(&data->page_bitmaps);
-      ASSERT(al_is_bitmap_locked(*back));
-      al_unlock_bitmap(*back);
+      ASSERT(al_is_bitmap_locked(data->locked_page));
+      al_unlock_bitmap(data->locked_page);
       data->page_lr = NULL;
-      ALLEGRO_DEBUG("Unlocking page: %p\n", *back);
+      ALLEGRO_DEBUG("Unlocking page: %p\n", data->locked_page);
+      data->locked_page = NULL;
+   }
+}
+
+
+static void reset_skyline(ALLEGRO_TTF_PAGE *page)
+{
+   SKYLINE_NODE *node;
+
+   _al_vector_free(&page->skyline);
+   node = _al_vector_alloc_back(&page->skyline);
+   node->x = 0;
+   node->y = 0;
+   node->w = al_get_bitmap_width(page->bitmap);
+}
+
+
+static bool is_page_empty(ALLEGRO_TTF_PAGE *page)
+{
+   SKYLINE_NODE *node = _al_vector_ref_front(&page->skyline);
+   return _al_vector_size(&page->skyline) == 1 && node->y == 0;
+}
+
+
+/* skyline_fit:
+ *  Returns the lowest y at which a w by h rectangle fits on the page with
+ *  its left edge at the start of skyline node i, or -1 if it doesn't fit.
+ */
+static int skyline_fit(ALLEGRO_TTF_PAGE *page, unsigned int i, int w, int h)
+{
+   SKYLINE_NODE *node = _al_vector_ref(&page->skyline, i);
+   int page_h = al_get_bitmap_height(page->bitmap);
+   int y = 0;
+
+   if (node->x + w > al_get_bitmap_width(page->bitmap))
+      return -1;
+
+   while (w > 0) {
+      node = _al_vector_ref(&page->skyline, i++);
+      if (node->y > y)
+         y = node->y;
+      if (y + h > page_h)
+         return -1;
+      w -= node->w;
+   }
+
+   return y;
+}
+
+
+/* skyline_find:
+ *  Finds the position which keeps the bottom of a w by h rectangle lowest,
+ *  preferring narrower gaps on ties.  Returns the index of the skyline node
+ *  the rectangle starts on, or -1 if there is no room on the page.
+ */
+static int skyline_find(ALLEGRO_TTF_PAGE *page, int w, int h,
+   int *x, int *y)
+{
+   int best = -1;
+   int best_bottom = INT_MAX;
+   int best_w = INT_MAX;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&page->skyline); i++) {
+      SKYLINE_NODE *node = _al_vector_ref(&page->skyline, i);
+      int fit_y = skyline_fit(page, i, w, h);
+
+      if (fit_y < 0)
+         continue;
+      if (fit_y + h < best_bottom ||
+            (fit_y + h == best_bottom && node->w < best_w)) {
+         best = i;
+         best_bottom = fit_y + h;
+         best_w = node->w;
+         *x = node->x;
+         *y = fit_y;
+      }
+   }
+
+   return best;
+}
+
+
+/* skyline_add:
+ *  Raises the skyline over a rectangle placed by skyline_find.
+ */
+static void skyline_add(ALLEGRO_TTF_PAGE *page, unsigned int i,
+   int x, int y, int w, int h)
+{
+   SKYLINE_NODE *node = _al_vector_alloc_mid(&page->skyline, i);
+   node->x = x;
+   node->y = y + h;
+   node->w = w;
+
+   /* Cut the nodes now covered by the new one. */
+   for (i++; i < _al_vector_size(&page->skyline);) {
+      SKYLINE_NODE *prev = _al_vector_ref(&page->skyline, i - 1);
+      int overlap;
+
+      node = _al_vector_ref(&page->skyline, i);
+      overlap = prev->x + prev->w - node->x;
+      if (overlap <= 0)
+         break;
+      node->x += overlap;
+      node->w -= overlap;
+      if (node->w > 0)
+         break;
+      _al_vector_delete_at(&page->skyline, i);
+   }
+
+   /* Merge neighbours of the same height. */
+   for (i = 0; i + 1 < _al_vector_size(&page->skyline);) {
+      SKYLINE_NODE *a = _al_vector_ref(&page->skyline, i);
+      SKYLINE_NODE *b = _al_vector_ref(&page->skyline, i + 1);
+      if (a->y == b->y) {
+         a->w += b->w;
+         _al_vector_delete_at(&page->skyline, i + 1);
+      }
+      else {
+         i++;
+      }
    }
 }
 
 
-static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size)
+static int push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size)
 {
-    ALLEGRO_BITMAP **back;
+    ALLEGRO_TTF_PAGE *back;
     ALLEGRO_BITMAP *page;
     ALLEGRO_STATE state;
     int page_size = 1;
@@ -190,7 +384,7 @@ static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size
     if (glyph_size > page_size) {
       ALLEGRO_ERROR("Unable create new page, glyph too large: %d > %d\n",
          glyph_size, page_size);
-      return NULL;
+      return -1;
     }
 
     unlock_current_page(data);
@@ -206,75 +400,204 @@ static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size
     al_restore_state(&state);
     _al_pop_destructor_owner();
 
-    if (page) {
-       back = _al_vector_alloc_back(&data->page_bitmaps);
-       *back = page;
-
-       data->page_pos_x = 0;
-       data->page_pos_y = 0;
-       data->page_line_height = 0;
+    if (!page) {
+       return -1;
     }
 
-    return page;
+    back = _al_vector_alloc_back(&data->pages);
+    back->bitmap = page;
+    back->last_use = data->use_count;
+    _al_vector_init(&back->skyline, sizeof(SKYLINE_NODE));
+    reset_skyline(back);
+
+    return _al_vector_size(&data->pages) - 1;
+}
+
+
+/* evict_page:
+ *  Forgets all glyphs cached on the page, so that it can be packed again.
+ */
+static void evict_page(ALLEGRO_TTF_FONT_DATA *data, int page_index)
+{
+   ALLEGRO_TTF_PAGE *page = _al_vector_ref(&data->pages, page_index);
+   unsigned int i;
+   int j;
+
+   /* Glyphs from this page may still be waiting to be drawn. */
+   if (al_is_bitmap_drawing_held()) {
+      al_hold_bitmap_drawing(false);
+      al_hold_bitmap_drawing(true);
+   }
+
+   if (data->locked_page == page->bitmap)
+      unlock_current_page(data);
+
+   for (i = 0; i < _al_vector_size(&data->glyph_ranges); i++) {
+      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
+      for (j = 0; j < RANGE_SIZE; j++) {
+         ALLEGRO_TTF_GLYPH_DATA *glyph = &range->glyphs[j];
+         if (glyph->page_bitmap == page->bitmap) {
+            glyph->page_bitmap = NULL;
+            memset(&glyph->region, 0, sizeof glyph->region);
+            data->stats.evictions++;
+         }
+      }
+   }
+
+   reset_skyline(page);
+   data->page_generation++;
+   data->stats.page_evictions++;
+   ALLEGRO_DEBUG("Evicted page %d: %p\n", page_index, page->bitmap);
+}
+
+
+/* lru_page:
+ *  Returns the least recently used page which can hold a glyph of the given
+ *  size, or -1.
+ */
+static int lru_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size)
+{
+   int best = -1;
+   uint64_t best_use = 0;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&data->pages); i++) {
+      ALLEGRO_TTF_PAGE *page = _al_vector_ref(&data->pages, i);
+      if (al_get_bitmap_width(page->bitmap) < glyph_size)
+         continue;
+      if (best < 0 || page->last_use < best_use) {
+         best = i;
+         best_use = page->last_use;
+      }
+   }
+
+   return best;
+}
+
+
+/* remove_page:
+ *  Evicts and destroys the page.
+ */
+static void remove_page(ALLEGRO_TTF_FONT_DATA *data, int page_index)
+{
+   ALLEGRO_TTF_PAGE *page;
+   unsigned int i;
+   int j;
+
+   evict_page(data, page_index);
+   page = _al_vector_ref(&data->pages, page_index);
+   al_destroy_bitmap(page->bitmap);
+   _al_vector_free(&page->skyline);
+   _al_vector_delete_at(&data->pages, page_index);
+
+   for (i = 0; i < _al_vector_size(&data->glyph_ranges); i++) {
+      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
+      for (j = 0; j < RANGE_SIZE; j++) {
+         ALLEGRO_TTF_GLYPH_DATA *glyph = &range->glyphs[j];
+         if (glyph->page_bitmap && glyph->page > page_index)
+            glyph->page--;
+      }
+   }
+}
+
+
+/* trim_pages:
+ *  Destroys the least recently used pages until the font is within its
+ *  page budget.
+ */
+static void trim_pages(ALLEGRO_TTF_FONT_DATA *data)
+{
+   if (data->max_pages == 0 || data->skip_cache_misses)
+      return;
+
+   while ((int)_al_vector_size(&data->pages) > data->max_pages)
+      remove_page(data, lru_page(data, 0));
 }
 
 
 static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
-   int ft_index, int w, int h, bool new, ALLEGRO_TTF_GLYPH_DATA *glyph,
+   int ft_index, int w, int h, ALLEGRO_TTF_GLYPH_DATA *glyph,
    bool lock_whole_page)
 {
-   ALLEGRO_BITMAP *page;
+   ALLEGRO_TTF_PAGE *page = NULL;
    int w4 = align4(w);
    int h4 = align4(h);
    int glyph_size = w4 > h4 ? w4 : h4;
+   int num_pages = _al_vector_size(&data->pages);
+   int page_index = -1;
+   int node = -1;
+   int x = 0;
+   int y = 0;
    bool lock = false;
+   bool whole_page;
+   int i;
 
-   if (_al_vector_is_empty(&data->page_bitmaps) || new) {
-      page = push_new_page(data, glyph_size);
-      if (!page) {
-         ALLEGRO_ERROR("Failed to create a new page for glyph %d.\n", ft_index);
-         return NULL;
+   /* Newer pages are the most likely to have room left. */
+   for (i = num_pages - 1; i >= 0; i--) {
+      page = _al_vector_ref(&data->pages, i);
+      node = skyline_find(page, w4, h4, &x, &y);
+      if (node >= 0) {
+         page_index = i;
+         break;
       }
    }
-   else {
-      ALLEGRO_BITMAP **back = _al_vector_ref_back(&data->page_bitmaps);
-      page = *back;
+
+   if (page_index < 0) {
+      /* Glyphs are never recached when skipping cache misses, so there is
+       * nothing to evict then.
+       */
+      if (data->max_pages > 0 && num_pages >= data->max_pages &&
+            !data->skip_cache_misses) {
+         page_index = lru_page(data, glyph_size);
+      }
+      if (page_index >= 0) {
+         evict_page(data, page_index);
+      }
+      else {
+         page_index = push_new_page(data, glyph_size);
+         if (page_index < 0) {
+            ALLEGRO_ERROR("Failed to create a new page for glyph %d.\n", ft_index);
+            return NULL;
+         }
+      }
+      page = _al_vector_ref(&data->pages, page_index);
+      node = skyline_find(page, w4, h4, &x, &y);
+      if (node < 0) {
+         ALLEGRO_ERROR("Glyph %d does not fit on an empty page.\n", ft_index);
+         return NULL;
+      }
    }
 
-   ALLEGRO_DEBUG("Glyph %d: %dx%d (%dx%d)%s\n",
-      ft_index, w, h, w4, h4, new ? " new" : "");
+   ALLEGRO_DEBUG("Glyph %d: %dx%d (%dx%d) on page %d\n",
+      ft_index, w, h, w4, h4, page_index);
 
-   if (data->page_pos_x + w4 > al_get_bitmap_width(page)) {
-      data->page_pos_y += data->page_line_height;
-      data->page_pos_y = align4(data->page_pos_y);
-      data->page_pos_x = 0;
-      data->page_line_height = 0;
-   }
+   /* The whole page is only locked (and cleared) while it holds nothing
+    * but glyphs added under that same lock.
+    */
+   whole_page = lock_whole_page && (is_page_empty(page) ||
+      (data->page_lr && data->locked_page == page->bitmap &&
+         data->locked_whole_page));
 
-   if (data->page_pos_y + h4 > al_get_bitmap_height(page)) {
-      return alloc_glyph_region(data, ft_index, w, h, true, glyph, lock_whole_page);
-   }
+   skyline_add(page, node, x, y, w4, h4);
+   page->last_use = ++data->use_count;
 
-   glyph->page_bitmap = page;
-   glyph->region.x = data->page_pos_x;
-   glyph->region.y = data->page_pos_y;
+   glyph->page_bitmap = page->bitmap;
+   glyph->page = page_index;
+   glyph->region.x = x;
+   glyph->region.y = y;
    glyph->region.w = w;
    glyph->region.h = h;
 
-   data->page_pos_x = align4(data->page_pos_x + w4);
-   if (h > data->page_line_height) {
-      data->page_line_height = h4;
-   }
-
    REGION lock_rect;
-   if (lock_whole_page) {
+   if (whole_page) {
       lock_rect.x = 0;
       lock_rect.y = 0;
-      lock_rect.w = al_get_bitmap_width(page);
-      lock_rect.h = al_get_bitmap_height(page);
-      if (!data->page_lr) {
+      lock_rect.w = al_get_bitmap_width(page->bitmap);
+      lock_rect.h = al_get_bitmap_height(page->bitmap);
+      if (!data->page_lr || data->locked_page != page->bitmap) {
+         unlock_current_page(data);
          lock = true;
-         ALLEGRO_DEBUG("Locking whole page: %p\n", page);
+         ALLEGRO_DEBUG("Locking whole page: %p\n", page->bitmap);
       }
    }
    else {
@@ -285,15 +608,14 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
       lock_rect.w = w4;
       lock_rect.h = h4;
       lock = true;
-      ALLEGRO_DEBUG("Locking glyph region: %p %d %d %d %d\n", page,
+      ALLEGRO_DEBUG("Locking glyph region: %p %d %d %d %d\n", page->bitmap,
          lock_rect.x, lock_rect.y, lock_rect.w, lock_rect.h);
    }
 
    if (lock) {
       unsigned char *ptr;
-      int i;
 
-      data->page_lr = al_lock_bitmap_region(page,
+      data->page_lr = al_lock_bitmap_region(page->bitmap,
          lock_rect.x, lock_rect.y, lock_rect.w, lock_rect.h,
          ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_WRITEONLY);
 
@@ -301,6 +623,8 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
          ALLEGRO_ERROR("Failed to lock page.\n");
          return NULL;
       }
+      data->locked_page = page->bitmap;
+      data->locked_whole_page = whole_page;
 
       if (data->flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
          /* Fill in border with "transparent white"
@@ -454,8 +778,19 @@ static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
     int w, h;
     unsigned char *glyph_data;
 
-    if (glyph->page_bitmap || glyph->region.x < 0)
+    if (glyph->page_bitmap) {
+       ALLEGRO_TTF_PAGE *page = _al_vector_ref(&font_data->pages, glyph->page);
+       page->last_use = ++font_data->use_count;
+       font_data->stats.hits++;
        return;
+    }
+    if (glyph->region.x < 0) {
+       font_data->stats.hits++;
+       return;
+    }
+
+    font_data->stats.misses++;
+    font_data->atlas_dirty = true;
 
     /* We shouldn't ever get here, as cache misses
      * should have been set to ft_index = 0. */
@@ -512,7 +847,7 @@ static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
      * even against the outer bitmap edge, to ensure consistent rendering.
      */
     glyph_data = alloc_glyph_region(font_data, ft_index,
-       w + 4, h + 4, false, glyph, lock_whole_page);
+       w + 4, h + 4, glyph, lock_whole_page);
 
     if (glyph_data == NULL) {
        return;
@@ -528,10 +863,11 @@ static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
     }
 }
 
-/* WARNING: It is only valid to call this function when the current page is empty
- * (or already locked), otherwise it will gibberify the current glyphs on that page.
+/* Locks whole pages at a time while they are being filled, which is faster
+ * than locking each glyph.  Pages which already held glyphs are still
+ * locked per glyph.
  *
- * This leaves the current page unlocked.
+ * This may leave the current page locked.
  */
 static void cache_glyphs(ALLEGRO_TTF_FONT_DATA *data, const char *text, size_t text_size)
 {
@@ -616,6 +952,23 @@ static bool ttf_get_glyph(ALLEGRO_FONT const *f, int prev_codepoint, int codepoi
 }
 
 
+static void draw_glyph(ALLEGRO_GLYPH const *glyph, ALLEGRO_COLOR color,
+   float xpos, float ypos)
+{
+   /*
+    * Include 1 pixel of the 2-pixel border when drawing glyph.
+    * This improves render results when rotating and scaling.
+    */
+   al_draw_tinted_bitmap_region(
+      glyph->bitmap, color,
+      glyph->x - 1, glyph->y - 1, glyph->w + 2, glyph->h + 2,
+      xpos + glyph->offset_x + glyph->kerning - 1,
+      ypos + glyph->offset_y - 1,
+      0
+   );
+}
+
+
 static int render_glyph(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    int prev_ft_index, int ft_index, int32_t prev_ch, int32_t ch, float xpos, float ypos)
 {
@@ -625,23 +978,146 @@ static int render_glyph(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
       return 0;
 
    if (glyph.bitmap != NULL) {
-      /*
-       * Include 1 pixel of the 2-pixel border when drawing glyph.
-       * This improves render results when rotating and scaling.
-       */
-      al_draw_tinted_bitmap_region(
-         glyph.bitmap, color,
-         glyph.x - 1, glyph.y - 1, glyph.w + 2, glyph.h + 2,
-         xpos + glyph.offset_x + glyph.kerning - 1,
-         ypos + glyph.offset_y - 1,
-         0
-      );
+      draw_glyph(&glyph, color, xpos, ypos);
    }
 
    return glyph.advance;
 }
 
 
+static uint32_t hash_text(const ALLEGRO_USTR *text)
+{
+   const unsigned char *p = (const unsigned char *)al_cstr(text);
+   size_t n = al_ustr_size(text);
+   uint32_t hash = 2166136261u;
+   size_t i;
+
+   for (i = 0; i < n; i++) {
+      hash ^= p[i];
+      hash *= 16777619u;
+   }
+
+   return hash;
+}
+
+
+static void unlink_text_run(TEXT_RUN *run)
+{
+   run->lru_prev->lru_next = run->lru_next;
+   run->lru_next->lru_prev = run->lru_prev;
+}
+
+
+static void link_text_run(ALLEGRO_TTF_FONT_DATA *data, TEXT_RUN *run)
+{
+   run->lru_prev = &data->run_lru;
+   run->lru_next = data->run_lru.lru_next;
+   run->lru_next->lru_prev = run;
+   data->run_lru.lru_next = run;
+}
+
+
+static void remove_text_run(ALLEGRO_TTF_FONT_DATA *data, TEXT_RUN *run)
+{
+   TEXT_RUN **link = &data->run_buckets[run->hash & data->run_mask];
+
+   while (*link != run)
+      link = &(*link)->hash_next;
+   *link = run->hash_next;
+
+   unlink_text_run(run);
+   al_ustr_free(run->text);
+   _al_vector_free(&run->glyphs);
+   al_free(run);
+   data->num_runs--;
+}
+
+
+static void clear_text_runs(ALLEGRO_TTF_FONT_DATA *data)
+{
+   while (data->num_runs > 0)
+      remove_text_run(data, data->run_lru.lru_prev);
+   al_free(data->run_buckets);
+   data->run_buckets = NULL;
+}
+
+
+static void set_text_cache_size(ALLEGRO_TTF_FONT_DATA *data, int max_runs)
+{
+   unsigned int num_buckets = 1;
+
+   clear_text_runs(data);
+   data->run_lru.lru_prev = &data->run_lru;
+   data->run_lru.lru_next = &data->run_lru;
+   data->max_runs = 0;
+
+   if (max_runs <= 0)
+      return;
+
+   while (num_buckets < (unsigned int)max_runs)
+      num_buckets *= 2;
+   data->run_buckets = al_calloc(num_buckets, sizeof *data->run_buckets);
+   if (!data->run_buckets) {
+      ALLEGRO_ERROR("Out of memory for the text run cache.\n");
+      return;
+   }
+   data->run_mask = num_buckets - 1;
+   data->max_runs = max_runs;
+}
+
+
+/* get_text_run:
+ *  Returns the cached run for the text, adding an empty one if there is
+ *  none yet, or NULL if runs of this font aren't cached.
+ */
+static TEXT_RUN *get_text_run(ALLEGRO_FONT const *f, const ALLEGRO_USTR *text)
+{
+   ALLEGRO_TTF_FONT_DATA *data = f->data;
+   TEXT_RUN **bucket;
+   TEXT_RUN *run;
+   uint32_t hash;
+
+   /* Glyphs may come from the fallback font, which we know nothing about. */
+   if (data->max_runs == 0 || f->fallback)
+      return NULL;
+
+   hash = hash_text(text);
+   bucket = &data->run_buckets[hash & data->run_mask];
+   for (run = *bucket; run; run = run->hash_next) {
+      if (run->hash == hash && al_ustr_equal(run->text, text)) {
+         unlink_text_run(run);
+         link_text_run(data, run);
+         data->stats.text_hits++;
+         return run;
+      }
+   }
+
+   data->stats.text_misses++;
+
+   if (data->num_runs >= data->max_runs)
+      remove_text_run(data, data->run_lru.lru_prev);
+
+   run = al_calloc(1, sizeof *run);
+   if (!run)
+      return NULL;
+   run->text = al_ustr_dup(text);
+   if (!run->text) {
+      al_free(run);
+      return NULL;
+   }
+   run->hash = hash;
+   run->length = -1;
+   _al_vector_init(&run->glyphs, sizeof(TEXT_RUN_GLYPH));
+
+   run->hash_next = *bucket;
+   *bucket = run;
+   link_text_run(data, run);
+   data->num_runs++;
+
+   return run;
+}
+
+
 static int ttf_font_height(ALLEGRO_FONT const *f)
 {
    ASSERT(f);
@@ -715,11 +1191,28 @@ static int ttf_char_length(ALLEGRO_FONT const *f, int ch)
 }
 
 
+/* Draws a run whose glyphs are still where it found them. */
+static int render_text_run(TEXT_RUN *run, ALLEGRO_COLOR color,
+   float x, float y)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&run->glyphs); i++) {
+      TEXT_RUN_GLYPH *g = _al_vector_ref(&run->glyphs, i);
+      draw_glyph(&g->glyph, color, x + g->pen, y);
+   }
+
+   return run->advance;
+}
+
+
 static int ttf_render(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    const ALLEGRO_USTR *text, float x, float y)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    FT_Face face = data->face;
+   TEXT_RUN *run;
+   unsigned int page_generation;
    int pos = 0;
    int advance = 0;
    int prev_ft_index = -1;
@@ -730,14 +1223,48 @@ static int ttf_render(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    hold = al_is_bitmap_drawing_held();
    al_hold_bitmap_drawing(true);
 
+   run = get_text_run(f, text);
+   if (run && run->has_glyphs &&
+         run->page_generation == data->page_generation) {
+      advance = render_text_run(run, color, x, y);
+      al_hold_bitmap_drawing(hold);
+      return advance;
+   }
+
+   if (run) {
+      _al_vector_free(&run->glyphs);
+   }
+   page_generation = data->page_generation;
+
    while ((ch = al_ustr_get_next(text, &pos)) >= 0) {
       int ft_index = FT_Get_Char_Index(face, ch);
-      advance += render_glyph(f, color, prev_ft_index, ft_index, prev_ch, ch,
-         x + advance, y);
+      ALLEGRO_GLYPH glyph;
+
+      if (ttf_get_glyph_worker(f, prev_ft_index, ft_index, prev_ch, ch,
+            &glyph)) {
+         if (glyph.bitmap != NULL) {
+            draw_glyph(&glyph, color, x + advance, y);
+            if (run) {
+               TEXT_RUN_GLYPH *g = _al_vector_alloc_back(&run->glyphs);
+               g->glyph = glyph;
+               g->pen = advance;
+            }
+         }
+         advance += glyph.advance;
+      }
       prev_ft_index = ft_index;
       prev_ch = ch;
    }
 
+   if (run) {
+      /* If caching the later glyphs evicted a page, the earlier ones may
+       * have moved; try again next time.
+       */
+      run->advance = advance;
+      run->page_generation = page_generation;
+      run->has_glyphs = (data->page_generation == page_generation);
+   }
+
    al_hold_bitmap_drawing(hold);
 
    return advance;
@@ -746,10 +1273,14 @@ static int ttf_render(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
 
 static int ttf_text_length(ALLEGRO_FONT const *f, const ALLEGRO_USTR *text)
 {
+   TEXT_RUN *run = get_text_run(f, text);
    int pos = 0;
    int x = 0;
    int32_t ch, nch;
 
+   if (run && run->length >= 0)
+      return run->length;
+
    nch = al_ustr_get_next(text, &pos);
    while (nch >= 0) {
       ch = nch;
@@ -759,6 +1290,9 @@ static int ttf_text_length(ALLEGRO_FONT const *f, const ALLEGRO_USTR *text)
          ALLEGRO_NO_KERNING : nch);
    }
 
+   if (run)
+      run->length = x;
+
    return x;
 }
 
@@ -816,16 +1350,16 @@ static void ttf_get_text_dimensions(ALLEGRO_FONT const *f,
 static void debug_cache(ALLEGRO_FONT *f)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
-   _AL_VECTOR *v = &data->page_bitmaps;
+   _AL_VECTOR *v = &data->pages;
    static int j = 0;
    int i;
 
    al_init_image_addon();
 
    for (i = 0; i < (int)_al_vector_size(v); i++) {
-      ALLEGRO_BITMAP **bmp = _al_vector_ref(v, i);
+      ALLEGRO_TTF_PAGE *page = _al_vector_ref(v, i);
       ALLEGRO_USTR *u = al_ustr_newf("font%d_%d.png", j, i);
-      al_save_bitmap(al_cstr(u), *bmp);
+      al_save_bitmap(al_cstr(u), page->bitmap);
       al_ustr_free(u);
    }
    j++;
@@ -833,12 +1367,454 @@ static void debug_cache(ALLEGRO_FONT *f)
 #endif
 
 
+/* Atlas cache files:
+ *
+ *    "ATC1"
+ *    key (ATLAS_KEY, 7 x 32-bit)
+ *    number of pages, then for each page:
+ *       width, height, number of skyline nodes, nodes (x, y, w)
+ *       each row of ABGR_8888_LE pixels as runs: a count n > 0 followed by
+ *       n pixels, or n < 0 followed by one pixel repeated -n times
+ *    number of glyph ranges, then for each range:
+ *       range start, number of cached glyphs, then for each glyph:
+ *       index in range, page or -1, region x, y, w, h, offset x, y, advance
+ *
+ * All numbers are little endian, glyph fields are 16 bits and the rest 32.
+ */
+#define ATLAS_MAGIC  "ATC1"
+
+
+static void compute_atlas_key(ALLEGRO_TTF_FONT_DATA *data, int w, int h)
+{
+   TT_Header *head = FT_Get_Sfnt_Table(data->face, FT_SFNT_HEAD);
+   FT_Int major, minor, patch;
+
+   FT_Library_Version(ft, &major, &minor, &patch);
+
+   /* The head table checksum covers the whole font file. */
+   data->atlas_key.checksum = head ? head->CheckSum_Adjust : 0;
+   data->atlas_key.file_size = data->stream.size;
+   data->atlas_key.num_glyphs = data->face->num_glyphs;
+   data->atlas_key.w = w;
+   data->atlas_key.h = h;
+   data->atlas_key.flags = data->flags;
+   data->atlas_key.freetype_version = (major << 16) | (minor << 8) | patch;
+}
+
+
+static void write_atlas_key(ALLEGRO_FILE *file, const ATLAS_KEY *key)
+{
+   al_fwrite32le(file, key->checksum);
+   al_fwrite32le(file, key->file_size);
+   al_fwrite32le(file, key->num_glyphs);
+   al_fwrite32le(file, key->w);
+   al_fwrite32le(file, key->h);
+   al_fwrite32le(file, key->flags);
+   al_fwrite32le(file, key->freetype_version);
+}
+
+
+static void read_atlas_key(ALLEGRO_FILE *file, ATLAS_KEY *key)
+{
+   key->checksum = al_fread32le(file);
+   key->file_size = al_fread32le(file);
+   key->num_glyphs = al_fread32le(file);
+   key->w = al_fread32le(file);
+   key->h = al_fread32le(file);
+   key->flags = al_fread32le(file);
+   key->freetype_version = al_fread32le(file);
+}
+
+
+static bool same_pixel(const unsigned char *a, const unsigned char *b)
+{
+   return memcmp(a, b, 4) == 0;
+}
+
+
+static void write_atlas_row(ALLEGRO_FILE *file, const unsigned char *row,
+   int w)
+{
+   int i = 0;
+
+   while (i < w) {
+      int run = 1;
+      int start = i;
+
+      while (i + run < w && same_pixel(row + 4 * i, row + 4 * (i + run)))
+         run++;
+      if (run >= 3) {
+         al_fwrite32le(file, -run);
+         al_fwrite(file, row + 4 * i, 4);
+         i += run;
+         continue;
+      }
+
+      /* Copy pixels literally up to the next run of three. */
+      while (i < w) {
+         if (i + 2 < w && same_pixel(row + 4 * i, row + 4 * (i + 1)) &&
+               same_pixel(row + 4 * i, row + 4 * (i + 2)))
+            break;
+         i++;
+      }
+      al_fwrite32le(file, i - start);
+      al_fwrite(file, row + 4 * start, 4 * (i - start));
+   }
+}
+
+
+static bool read_atlas_row(ALLEGRO_FILE *file, unsigned char *row, int w)
+{
+   int i = 0;
+
+   while (i < w) {
+      int n = al_fread32le(file);
+
+      if (al_feof(file) || al_ferror(file) || n == 0 || n == INT_MIN)
+         return false;
+      if (n > 0) {
+         if (n > w - i || al_fread(file, row + 4 * i, 4 * n) != 4 * (size_t)n)
+            return false;
+         i += n;
+      }
+      else {
+         unsigned char pixel[4];
+         n = -n;
+         if (n > w - i || al_fread(file, pixel, 4) != 4)
+            return false;
+         while (n-- > 0) {
+            memcpy(row + 4 * i, pixel, 4);
+            i++;
+         }
+      }
+   }
+
+   return true;
+}
+
+
+static bool save_atlas(ALLEGRO_TTF_FONT_DATA *data, ALLEGRO_FILE *file)
+{
+   unsigned int i, j;
+
+   unlock_current_page(data);
+
+   al_fwrite(file, ATLAS_MAGIC, 4);
+   write_atlas_key(file, &data->atlas_key);
+
+   al_fwrite32le(file, _al_vector_size(&data->pages));
+   for (i = 0; i < _al_vector_size(&data->pages); i++) {
+      ALLEGRO_TTF_PAGE *page = _al_vector_ref(&data->pages, i);
+      int w = al_get_bitmap_width(page->bitmap);
+      int h = al_get_bitmap_height(page->bitmap);
+      ALLEGRO_LOCKED_REGION *lr;
+      int y;
+
+      al_fwrite32le(file, w);
+      al_fwrite32le(file, h);
+      al_fwrite32le(file, _al_vector_size(&page->skyline));
+      for (j = 0; j < _al_vector_size(&page->skyline); j++) {
+         SKYLINE_NODE *node = _al_vector_ref(&page->skyline, j);
+         al_fwrite32le(file, node->x);
+         al_fwrite32le(file, node->y);
+         al_fwrite32le(file, node->w);
+      }
+
+      lr = al_lock_bitmap(page->bitmap, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+         ALLEGRO_LOCK_READONLY);
+      if (!lr) {
+         ALLEGRO_ERROR("Failed to lock page %d for saving.\n", i);
+         return false;
+      }
+      for (y = 0; y < h; y++) {
+         write_atlas_row(file, (unsigned char *)lr->data + y * lr->pitch, w);
+      }
+      al_unlock_bitmap(page->bitmap);
+   }
+
+   al_fwrite32le(file, _al_vector_size(&data->glyph_ranges));
+   for (i = 0; i < _al_vector_size(&data->glyph_ranges); i++) {
+      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
+      int count = 0;
+
+      for (j = 0; j < RANGE_SIZE; j++) {
+         ALLEGRO_TTF_GLYPH_DATA *glyph = &range->glyphs[j];
+         if (glyph->page_bitmap || glyph->region.x < 0)
+            count++;
+      }
+
+      al_fwrite32le(file, range->range_start);
+      al_fwrite32le(file, count);
+      for (j = 0; j < RANGE_SIZE; j++) {
+         ALLEGRO_TTF_GLYPH_DATA *glyph = &range->glyphs[j];
+         if (!glyph->page_bitmap && glyph->region.x >= 0)
+            continue;
+         al_fwrite16le(file, j);
+         al_fwrite16le(file, glyph->page_bitmap ? glyph->page : -1);
+         al_fwrite16le(file, glyph->region.x);
+         al_fwrite16le(file, glyph->region.y);
+         al_fwrite16le(file, glyph->region.w);
+         al_fwrite16le(file, glyph->region.h);
+         al_fwrite16le(file, glyph->offset_x);
+         al_fwrite16le(file, glyph->offset_y);
+         al_fwrite16le(file, glyph->advance);
+      }
+   }
+
+   if (al_ferror(file)) {
+      ALLEGRO_ERROR("Error writing glyph atlas.\n");
+      return false;
+   }
+
+   data->atlas_dirty = false;
+   return true;
+}
+
+
+static void free_pages(_AL_VECTOR *pages)
+{
+   int i;
+
+   for (i = _al_vector_size(pages) - 1; i >= 0; i--) {
+      ALLEGRO_TTF_PAGE *page = _al_vector_ref(pages, i);
+      al_destroy_bitmap(page->bitmap);
+      _al_vector_free(&page->skyline);
+   }
+   _al_vector_free(pages);
+}
+
+
+static bool read_atlas_page(ALLEGRO_TTF_FONT_DATA *data, ALLEGRO_FILE *file,
+   ALLEGRO_TTF_PAGE *page)
+{
+   ALLEGRO_STATE state;
+   ALLEGRO_LOCKED_REGION *lr;
+   int w = al_fread32le(file);
+   int h = al_fread32le(file);
+   int num_nodes = al_fread32le(file);
+   int i, x;
+
+   if (al_feof(file) || w <= 0 || h <= 0 || w > 32767 || h > 32767 ||
+         num_nodes <= 0 || num_nodes > w)
+      return false;
+
+   _al_push_destructor_owner();
+   al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
+   al_set_new_bitmap_format(data->bitmap_format);
+   al_set_new_bitmap_flags(data->bitmap_flags);
+   page->bitmap = al_create_bitmap(w, h);
+   al_restore_state(&state);
+   _al_pop_destructor_owner();
+   if (!page->bitmap)
+      return false;
+
+   /* The skyline must cover the page exactly. */
+   for (i = 0, x = 0; i < num_nodes; i++) {
+      SKYLINE_NODE *node = _al_vector_alloc_back(&page->skyline);
+      node->x = al_fread32le(file);
+      node->y = al_fread32le(file);
+      node->w = al_fread32le(file);
+      if (node->x != x || node->w <= 0 || node->w > w - x ||
+            node->y < 0 || node->y > h)
+         return false;
+      x += node->w;
+   }
+   if (x != w)
+      return false;
+
+   lr = al_lock_bitmap(page->bitmap, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+      ALLEGRO_LOCK_WRITEONLY);
+   if (!lr)
+      return false;
+   for (i = 0; i < h; i++) {
+      if (!read_atlas_row(file, (unsigned char *)lr->data + i * lr->pitch, w)) {
+         al_unlock_bitmap(page->bitmap);
+         return false;
+      }
+   }
+   al_unlock_bitmap(page->bitmap);
+
+   return true;
+}
+
+
+/* load_atlas:
+ *  Replaces the glyph cache of the font with the one stored in the file.
+ *  Leaves the font alone if the file is broken or for a different font.
+ */
+static bool load_atlas(ALLEGRO_TTF_FONT_DATA *data, ALLEGRO_FILE *file)
+{
+   char magic[4];
+   ATLAS_KEY key;
+   _AL_VECTOR pages;
+   _AL_VECTOR glyphs;
+   int num_pages, num_ranges;
+   int i, j;
+   bool ok = false;
+
+   _al_vector_init(&pages, sizeof(ALLEGRO_TTF_PAGE));
+   _al_vector_init(&glyphs, sizeof(int32_t) + sizeof(ALLEGRO_TTF_GLYPH_DATA));
+
+   if (al_fread(file, magic, 4) != 4 || memcmp(magic, ATLAS_MAGIC, 4)) {
+      ALLEGRO_WARN("Not a glyph atlas file.\n");
+      goto done;
+   }
+   read_atlas_key(file, &key);
+   if (memcmp(&key, &data->atlas_key, sizeof key)) {
+      ALLEGRO_WARN("Glyph atlas is for a different font.\n");
+      goto done;
+   }
+
+   num_pages = al_fread32le(file);
+   if (al_feof(file) || num_pages < 0 || num_pages > 32767)
+      goto done;
+   for (i = 0; i < num_pages; i++) {
+      ALLEGRO_TTF_PAGE *page = _al_vector_alloc_back(&pages);
+      page->bitmap = NULL;
+      page->last_use = 0;
+      _al_vector_init(&page->skyline, sizeof(SKYLINE_NODE));
+      if (!read_atlas_page(data, file, page)) {
+         ALLEGRO_WARN("Broken page %d in glyph atlas.\n", i);
+         goto done;
+      }
+   }
+
+   /* Glyphs are collected first so nothing changes if the file is cut. */
+   num_ranges = al_fread32le(file);
+   if (al_feof(file) || num_ranges < 0)
+      goto done;
+   for (i = 0; i < num_ranges; i++) {
+      int range_start = al_fread32le(file);
+      int count = al_fread32le(file);
+
+      if (al_feof(file) || range_start < 0 || range_start % RANGE_SIZE ||
+            count < 0 || count > RANGE_SIZE)
+         goto done;
+      for (j = 0; j < count; j++) {
+         unsigned char *entry = _al_vector_alloc_back(&glyphs);
+         ALLEGRO_TTF_GLYPH_DATA glyph;
+         int index = al_fread16le(file);
+         int32_t ft_index = range_start + index;
+         int page = al_fread16le(file);
+
+         memset(&glyph, 0, sizeof glyph);
+         glyph.region.x = al_fread16le(file);
+         glyph.region.y = al_fread16le(file);
+         glyph.region.w = al_fread16le(file);
+         glyph.region.h = al_fread16le(file);
+         glyph.offset_x = al_fread16le(file);
+         glyph.offset_y = al_fread16le(file);
+         glyph.advance = al_fread16le(file);
+         if (al_feof(file) || index < 0 || index >= RANGE_SIZE ||
+               page >= num_pages || (page < 0 && glyph.region.x >= 0))
+            goto done;
+         if (page >= 0) {
+            ALLEGRO_TTF_PAGE *p = _al_vector_ref(&pages, page);
+            if (glyph.region.x < 0 || glyph.region.y < 0 ||
+                  glyph.region.w <= 0 || glyph.region.h <= 0 ||
+                  glyph.region.x + glyph.region.w > al_get_bitmap_width(p->bitmap) ||
+                  glyph.region.y + glyph.region.h > al_get_bitmap_height(p->bitmap))
+               goto done;
+         }
+         glyph.page = page;
+         memcpy(entry, &ft_index, sizeof ft_index);
+         memcpy(entry + sizeof ft_index, &glyph, sizeof glyph);
+      }
+   }
+
+   while (!_al_vector_is_empty(&data->pages))
+      remove_page(data, _al_vector_size(&data->pages) - 1);
+   free_pages(&data->pages);
+   data->pages = pages;
+   _al_vector_init(&pages, sizeof(ALLEGRO_TTF_PAGE));
+
+   for (i = 0; i < (int)_al_vector_size(&glyphs); i++) {
+      unsigned char *entry = _al_vector_ref(&glyphs, i);
+      ALLEGRO_TTF_GLYPH_DATA *glyph;
+      int32_t ft_index;
+
+      memcpy(&ft_index, entry, sizeof ft_index);
+      get_glyph(data, ft_index, &glyph);
+      memcpy(glyph, entry + sizeof ft_index, sizeof *glyph);
+      if (glyph->page >= 0) {
+         ALLEGRO_TTF_PAGE *page = _al_vector_ref(&data->pages, glyph->page);
+         glyph->page_bitmap = page->bitmap;
+      }
+      else {
+         glyph->page = 0;
+      }
+   }
+
+   data->page_generation++;
+   data->atlas_dirty = false;
+   trim_pages(data);
+   ok = true;
+   ALLEGRO_DEBUG("Loaded glyph atlas with %d pages and %d glyphs.\n",
+      num_pages, (int)_al_vector_size(&glyphs));
+
+done:
+   free_pages(&pages);
+   _al_vector_free(&glyphs);
+   return ok;
+}
+
+
+/* use_atlas_dir:
+ *  Loads the glyph atlas of the font from the directory if it has been
+ *  saved there before, and remembers to save it there when the font is
+ *  destroyed.
+ */
+static void use_atlas_dir(ALLEGRO_TTF_FONT_DATA *data, const char *dir)
+{
+   const unsigned char *p = (const unsigned char *)&data->atlas_key;
+   uint64_t hash = 14695981039346656037u;
+   ALLEGRO_PATH *path;
+   ALLEGRO_FILE *file;
+   char name[32];
+   size_t i;
+
+   for (i = 0; i < sizeof data->atlas_key; i++) {
+      hash ^= p[i];
+      hash *= 1099511628211u;
+   }
+   snprintf(name, sizeof name, "%08x%08x.ttfcache",
+      (uint32_t)(hash >> 32), (uint32_t)hash);
+
+   path = al_create_path_for_directory(dir);
+   al_set_path_filename(path, name);
+   data->atlas_filename = _al_strdup(al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP));
+   al_destroy_path(path);
+
+   file = al_fopen(data->atlas_filename, "rb");
+   if (file) {
+      load_atlas(data, file);
+      al_fclose(file);
+   }
+}
+
+
 static void ttf_destroy(ALLEGRO_FONT *f)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    int i;
 
    unlock_current_page(data);
+   clear_text_runs(data);
+
+   if (data->atlas_filename) {
+      if (data->atlas_dirty) {
+         ALLEGRO_FILE *file = al_fopen(data->atlas_filename, "wb");
+         if (file) {
+            save_atlas(data, file);
+            al_fclose(file);
+         }
+         else {
+            ALLEGRO_WARN("Unable to write glyph atlas %s.\n",
+               data->atlas_filename);
+         }
+      }
+      al_free(data->atlas_filename);
+   }
 
 #ifdef DEBUG_CACHE
    debug_cache(f);
@@ -850,11 +1826,7 @@ static void ttf_destroy(ALLEGRO_FONT *f)
       al_free(range->glyphs);
    }
    _al_vector_free(&data->glyph_ranges);
-   for (i = _al_vector_size(&data->page_bitmaps) - 1; i >= 0; i--) {
-      ALLEGRO_BITMAP **bmp = _al_vector_ref(&data->page_bitmaps, i);
-      al_destroy_bitmap(*bmp);
-   }
-   _al_vector_free(&data->page_bitmaps);
+   free_pages(&data->pages);
    al_free(data);
    al_free(f);
 }
@@ -913,6 +1885,12 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
       al_get_config_value(system_cfg, "ttf", "cache_text");
     const char* skip_cache_misses_str =
       al_get_config_value(system_cfg, "ttf", "skip_cache_misses");
+    const char* max_pages_str =
+      al_get_config_value(system_cfg, "ttf", "max_pages");
+    const char* text_cache_size_str =
+      al_get_config_value(system_cfg, "ttf", "text_cache_size");
+    const char* cache_dir_str =
+      al_get_config_value(system_cfg, "ttf", "cache_dir");
 
     if ((h > 0 && w < 0) || (h < 0 && w > 0)) {
        ALLEGRO_ERROR("Height/width have opposite signs (w = %d, h = %d).\n", w, h);
@@ -945,6 +1923,13 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
       }
     }
 
+    if (max_pages_str) {
+      int max_pages = atoi(max_pages_str);
+      if (max_pages > 0) {
+         data->max_pages = max_pages;
+      }
+    }
+
     if (skip_cache_misses_str && !strcmp(skip_cache_misses_str, "true")) {
        data->skip_cache_misses = true;
     }
@@ -1014,7 +1999,14 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
     data->flags = flags;
 
     _al_vector_init(&data->glyph_ranges, sizeof(ALLEGRO_TTF_GLYPH_RANGE));
-    _al_vector_init(&data->page_bitmaps, sizeof(ALLEGRO_BITMAP*));
+    _al_vector_init(&data->pages, sizeof(ALLEGRO_TTF_PAGE));
+    set_text_cache_size(data,
+       text_cache_size_str ? atoi(text_cache_size_str) : 0);
+    compute_atlas_key(data, w, h);
+
+    if (cache_dir_str && cache_dir_str[0]) {
+       use_atlas_dir(data, cache_dir_str);
+    }
 
     if (data->skip_cache_misses) {
        cache_glyphs(data, "\0", 1);
@@ -1225,6 +2217,158 @@ void al_shutdown_ttf_addon(void)
 }
 
 
+/* Function: al_set_ttf_font_max_pages
+ */
+bool al_set_ttf_font_max_pages(ALLEGRO_FONT *font, int max_pages)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+
+   if (font->vtable != &vt || max_pages < 0)
+      return false;
+
+   data = font->data;
+   data->max_pages = max_pages;
+   trim_pages(data);
+
+   return true;
+}
+
+
+/* Function: al_get_ttf_font_max_pages
+ */
+int al_get_ttf_font_max_pages(const ALLEGRO_FONT *font)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+
+   if (font->vtable != &vt)
+      return -1;
+
+   data = font->data;
+   return data->max_pages;
+}
+
+
+/* Function: al_set_ttf_font_text_cache_size
+ */
+bool al_set_ttf_font_text_cache_size(ALLEGRO_FONT *font, int max_runs)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+
+   if (font->vtable != &vt || max_runs < 0)
+      return false;
+
+   data = font->data;
+   set_text_cache_size(data, max_runs);
+   return data->max_runs == max_runs;
+}
+
+
+/* Function: al_get_ttf_font_text_cache_size
+ */
+int al_get_ttf_font_text_cache_size(const ALLEGRO_FONT *font)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+
+   if (font->vtable != &vt)
+      return -1;
+
+   data = font->data;
+   return data->max_runs;
+}
+
+
+/* Function: al_get_ttf_font_cache_stats
+ */
+bool al_get_ttf_font_cache_stats(const ALLEGRO_FONT *font,
+   ALLEGRO_TTF_CACHE_STATS *stats)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+   ASSERT(stats);
+
+   if (font->vtable != &vt)
+      return false;
+
+   data = font->data;
+   *stats = data->stats;
+   stats->pages = _al_vector_size(&data->pages);
+   return true;
+}
+
+
+/* Function: al_save_ttf_font_atlas_f
+ */
+bool al_save_ttf_font_atlas_f(ALLEGRO_FONT *font, ALLEGRO_FILE *file)
+{
+   ASSERT(font);
+   ASSERT(file);
+
+   if (font->vtable != &vt)
+      return false;
+
+   return save_atlas(font->data, file);
+}
+
+
+/* Function: al_save_ttf_font_atlas
+ */
+bool al_save_ttf_font_atlas(ALLEGRO_FONT *font, const char *filename)
+{
+   ALLEGRO_FILE *file;
+   bool ret;
+   ASSERT(filename);
+
+   file = al_fopen(filename, "wb");
+   if (!file) {
+      ALLEGRO_ERROR("Unable to open file for writing: %s\n", filename);
+      return false;
+   }
+
+   ret = al_save_ttf_font_atlas_f(font, file);
+   if (!al_fclose(file))
+      ret = false;
+   return ret;
+}
+
+
+/* Function: al_load_ttf_font_atlas_f
+ */
+bool al_load_ttf_font_atlas_f(ALLEGRO_FONT *font, ALLEGRO_FILE *file)
+{
+   ASSERT(font);
+   ASSERT(file);
+
+   if (font->vtable != &vt)
+      return false;
+
+   return load_atlas(font->data, file);
+}
+
+
+/* Function: al_load_ttf_font_atlas
+ */
+bool al_load_ttf_font_atlas(ALLEGRO_FONT *font, const char *filename)
+{
+   ALLEGRO_FILE *file;
+   bool ret;
+   ASSERT(filename);
+
+   file = al_fopen(filename, "rb");
+   if (!file) {
+      ALLEGRO_ERROR("Unable to open file for reading: %s\n", filename);
+      return false;
+   }
+
+   ret = al_load_ttf_font_atlas_f(font, file);
+   al_fclose(file);
+   return ret;
+}
+
+
 /* Function: al_get_allegro_ttf_version
  */
 uint32_t al_get_allegro_ttf_version(void)
@@ -1,9 +1,11 @@
 set(ALLEGRO_SRC_FILES
     src/allegro.c
     src/bitmap.c
+    src/bitmap_atlas.c
     src/bitmap_draw.c
     src/bitmap_io.c
     src/bitmap_lock.c
+    src/bitmap_lock_pool.c
     src/bitmap_pixel.c
     src/bitmap_type.c
     src/blenders.c
@@ -13,6 +15,7 @@ set(ALLEGRO_SRC_FILES
     src/cpu.c
     src/debug.c
     src/display.c
+    src/display_headless.c
     src/display_settings.c
     src/drawing.c
     src/dtor.c
@@ -20,9 +23,13 @@ set(ALLEGRO_SRC_FILES
     src/evtsrc.c
     src/exitfunc.c
     src/file.c
+    src/file_mmap.c
+    src/file_pack.c
+    src/file_pack_save.c
     src/file_slice.c
     src/file_stdio.c
     src/fshook.c
+    src/fshook_pack.c
     src/fshook_stdio.c
     src/fullscreen_mode.c
     src/haptic.c
@@ -0,0 +1,122 @@
+/* Benchmark of the pixel format conversions used when blitting between
+ * memory bitmaps of different formats.  Reports megapixels per second for
+ * each pair of formats.
+ */
+
+#include <stdio.h>
+#include "allegro5/allegro.h"
+
+#include "common.c"
+
+#define WIDTH        1024
+#define HEIGHT       1024
+#define MIN_TIME     0.5
+
+typedef struct FORMAT_PAIR {
+   int src, dst;
+   char const *name;
+} FORMAT_PAIR;
+
+#define PAIR(a, b) \
+   { ALLEGRO_PIXEL_FORMAT_##a, ALLEGRO_PIXEL_FORMAT_##b, #a " -> " #b }
+
+static FORMAT_PAIR pairs[] = {
+   PAIR(ARGB_8888, ABGR_8888),
+   PAIR(ABGR_8888, ARGB_8888),
+   PAIR(ARGB_8888, ABGR_8888_LE),
+   PAIR(ABGR_8888_LE, ARGB_8888),
+   PAIR(ARGB_8888, RGBA_8888),
+   PAIR(ARGB_8888, XRGB_8888),
+   PAIR(ARGB_8888, RGB_565),
+   PAIR(ABGR_8888, RGB_565),
+   PAIR(ARGB_8888, BGR_565),
+   PAIR(ARGB_8888, ARGB_4444),
+   PAIR(ABGR_8888, RGBA_4444),
+   PAIR(ARGB_8888, SINGLE_CHANNEL_8),
+   PAIR(SINGLE_CHANNEL_8, ARGB_8888),
+   PAIR(SINGLE_CHANNEL_8, ABGR_8888_LE),
+   PAIR(SINGLE_CHANNEL_8, RGB_565),
+   PAIR(ARGB_8888, RGB_888),
+   PAIR(RGB_565, ARGB_8888),
+   PAIR(ARGB_8888, ABGR_F32),
+};
+
+
+static ALLEGRO_BITMAP *create_bitmap(int format)
+{
+   ALLEGRO_BITMAP *bmp;
+   ALLEGRO_LOCKED_REGION *lr;
+   int x, y;
+
+   al_set_new_bitmap_format(format);
+   bmp = al_create_bitmap(WIDTH, HEIGHT);
+   if (!bmp)
+      return NULL;
+
+   lr = al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_WRITEONLY);
+   for (y = 0; y < HEIGHT; y++) {
+      unsigned char *row = (unsigned char *)lr->data + y * lr->pitch;
+      for (x = 0; x < WIDTH * lr->pixel_size; x++)
+         row[x] = x ^ y;
+   }
+   al_unlock_bitmap(bmp);
+   return bmp;
+}
+
+
+static double run_pair(FORMAT_PAIR *pair)
+{
+   ALLEGRO_BITMAP *src = create_bitmap(pair->src);
+   ALLEGRO_BITMAP *dst = create_bitmap(pair->dst);
+   double t0, t;
+   int n = 0;
+
+   if (!src || !dst) {
+      abort_example("Could not create bitmaps for %s\n", pair->name);
+   }
+
+   al_set_target_bitmap(dst);
+   /* This blender makes the blit a plain format conversion. */
+   al_set_blender(ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
+
+   t0 = al_get_time();
+   do {
+      al_draw_bitmap(src, 0, 0, 0);
+      n++;
+      t = al_get_time() - t0;
+   } while (t < MIN_TIME);
+
+   al_set_target_bitmap(NULL);
+   al_destroy_bitmap(src);
+   al_destroy_bitmap(dst);
+
+   return (double)n * WIDTH * HEIGHT / t / 1e6;
+}
+
+
+int main(int argc, char **argv)
+{
+   int i;
+
+   (void)argc;
+   (void)argv;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log_monospace();
+
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+   log_printf("%-36s %10s\n", "Conversion", "MPix/s");
+   for (i = 0; i < (int)(sizeof(pairs) / sizeof(pairs[0])); i++) {
+      log_printf("%-36s %10.1f\n", pairs[i].name, run_pair(&pairs[i]));
+   }
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
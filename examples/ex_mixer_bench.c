@@ -0,0 +1,144 @@
+/* Benchmark of the audio mixer.  Uses the offline audio driver to mix as
+ * fast as possible without a sound card, and reports how many seconds of
+ * voices are mixed per second, for each mixer quality and number of
+ * playing sample instances.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <math.h>
+#include <stdio.h>
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_audio.h"
+
+#include "common.c"
+
+#define FREQUENCY    44100
+#define SAMPLE_LEN   FREQUENCY
+#define CHUNK        4096
+#define MIN_TIME     0.5
+
+static int counts[] = { 1, 8, 32, 128 };
+
+static struct {
+   ALLEGRO_MIXER_QUALITY quality;
+   char const *name;
+} qualities[] = {
+   { ALLEGRO_MIXER_QUALITY_POINT, "point" },
+   { ALLEGRO_MIXER_QUALITY_LINEAR, "linear" },
+   { ALLEGRO_MIXER_QUALITY_CUBIC, "cubic" },
+};
+
+
+static ALLEGRO_SAMPLE *create_sample(void)
+{
+   float *data = al_malloc(SAMPLE_LEN * sizeof(float));
+   int i;
+
+   if (!data)
+      return NULL;
+   for (i = 0; i < SAMPLE_LEN; i++)
+      data[i] = sin(i * 440.0 * 2 * ALLEGRO_PI / FREQUENCY) * 0.1;
+
+   return al_create_sample(data, SAMPLE_LEN, FREQUENCY,
+      ALLEGRO_AUDIO_DEPTH_FLOAT32, ALLEGRO_CHANNEL_CONF_1, true);
+}
+
+
+/* Returns the seconds of audio of all instances mixed per second. */
+static double run(ALLEGRO_VOICE *voice, ALLEGRO_SAMPLE *spl,
+   ALLEGRO_MIXER_QUALITY quality, int count)
+{
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_SAMPLE_INSTANCE **instances;
+   static float buffer[CHUNK * 2];
+   double t0, t;
+   int frames = 0;
+   int i;
+
+   mixer = al_create_mixer(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   instances = al_malloc(count * sizeof(*instances));
+   if (!mixer || !instances) {
+      abort_example("Could not create the mixer.\n");
+   }
+   al_set_mixer_quality(mixer, quality);
+   al_attach_mixer_to_voice(mixer, voice);
+
+   for (i = 0; i < count; i++) {
+      instances[i] = al_create_sample_instance(spl);
+      al_set_sample_instance_playmode(instances[i], ALLEGRO_PLAYMODE_LOOP);
+      /* Slightly different speeds, so every instance gets resampled. */
+      al_set_sample_instance_speed(instances[i], 0.9 + 0.2 * i / count);
+      al_set_sample_instance_pan(instances[i], -1.0 + 2.0 * i / count);
+      al_attach_sample_instance_to_mixer(instances[i], mixer);
+      al_play_sample_instance(instances[i]);
+   }
+
+   t0 = al_get_time();
+   do {
+      al_render_voice(voice, buffer, CHUNK);
+      frames += CHUNK;
+      t = al_get_time() - t0;
+   } while (t < MIN_TIME);
+
+   al_detach_voice(voice);
+   for (i = 0; i < count; i++)
+      al_destroy_sample_instance(instances[i]);
+   al_free(instances);
+   al_destroy_mixer(mixer);
+
+   return (double)frames / FREQUENCY * count / t;
+}
+
+
+int main(int argc, char **argv)
+{
+   ALLEGRO_CONFIG *config;
+   ALLEGRO_VOICE *voice;
+   ALLEGRO_SAMPLE *spl;
+   int i, j;
+
+   (void)argc;
+   (void)argv;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log_monospace();
+
+   /* Mix only when al_render_voice is called. */
+   config = al_get_system_config();
+   al_set_config_value(config, "audio", "driver", "offline");
+   al_set_config_value(config, "offline", "clock", "manual");
+   al_set_config_value(config, "offline", "output", "");
+
+   if (!al_install_audio()) {
+      abort_example("Could not init sound.\n");
+   }
+
+   voice = al_create_voice(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   spl = create_sample();
+   if (!voice || !spl) {
+      abort_example("Could not create the voice.\n");
+   }
+
+   log_printf("%-8s %9s %22s\n", "Quality", "Instances", "Voice seconds / second");
+   for (i = 0; i < (int)(sizeof(qualities) / sizeof(qualities[0])); i++) {
+      for (j = 0; j < (int)(sizeof(counts) / sizeof(counts[0])); j++) {
+         log_printf("%-8s %9d %22.1f\n", qualities[i].name, counts[j],
+            run(voice, spl, qualities[i].quality, counts[j]));
+      }
+   }
+
+   al_destroy_voice(voice);
+   al_destroy_sample(spl);
+   al_uninstall_audio();
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
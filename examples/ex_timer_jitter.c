@@ -0,0 +1,129 @@
+/* Measures how precisely timer events arrive.
+ *
+ * One timer is observed while many other timers with random speeds run in
+ * the background.  For every tick of the observed timer we compare the
+ * time the event was generated and the time it was received with the
+ * ideal tick time, and the spacing between consecutive events with the
+ * timer speed.
+ *
+ * Usage: ex_timer_jitter [background timers] [speed] [seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "allegro5/allegro.h"
+
+#include "common.c"
+
+
+typedef struct STATS {
+   double sum;
+   double sum_sq;
+   double max;
+   int n;
+} STATS;
+
+
+static void add_sample(STATS *stats, double x)
+{
+   stats->sum += x;
+   stats->sum_sq += x * x;
+   if (stats->n == 0 || x > stats->max)
+      stats->max = x;
+   stats->n++;
+}
+
+
+static void print_stats(char const *name, STATS *stats)
+{
+   double mean, dev;
+
+   if (stats->n == 0)
+      return;
+
+   mean = stats->sum / stats->n;
+   dev = stats->sum_sq / stats->n - mean * mean;
+   dev = dev > 0 ? sqrt(dev) : 0;
+   log_printf("%-22s %10.3f %10.3f %10.3f\n", name,
+      mean * 1000, dev * 1000, stats->max * 1000);
+}
+
+
+int main(int argc, char **argv)
+{
+   int num_timers = 1000;
+   double speed = 1.0 / 60;
+   double duration = 5;
+   ALLEGRO_TIMER **timers;
+   ALLEGRO_TIMER *timer;
+   ALLEGRO_EVENT_QUEUE *queue;
+   STATS latency = {0, 0, 0, 0};
+   STATS wakeup = {0, 0, 0, 0};
+   STATS jitter = {0, 0, 0, 0};
+   double start, last = 0;
+   int i;
+
+   if (argc > 1)
+      num_timers = atoi(argv[1]);
+   if (argc > 2)
+      speed = atof(argv[2]);
+   if (argc > 3)
+      duration = atof(argv[3]);
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log_monospace();
+
+   timers = calloc(num_timers + 1, sizeof *timers);
+   for (i = 0; i < num_timers; i++) {
+      timers[i] = al_create_timer(0.001 + (rand() % 1000) / 1000.0);
+      al_start_timer(timers[i]);
+   }
+
+   queue = al_create_event_queue();
+   timer = al_create_timer(speed);
+   al_register_event_source(queue, al_get_timer_event_source(timer));
+
+   log_printf("%d background timers, observed timer speed %.3f ms\n\n",
+      num_timers, speed * 1000);
+
+   start = al_get_time();
+   al_start_timer(timer);
+
+   while (al_get_time() - start < duration) {
+      ALLEGRO_EVENT event;
+      double ideal;
+
+      al_wait_for_event(queue, &event);
+      ideal = start + event.timer.count * speed;
+
+      /* Time between the ideal tick and the event being generated. */
+      add_sample(&latency, event.any.timestamp - ideal);
+      /* Time between the ideal tick and us seeing the event. */
+      add_sample(&wakeup, al_get_time() - ideal);
+      /* Deviation of the event spacing from the timer speed. */
+      if (event.timer.count > 1)
+         add_sample(&jitter, fabs(event.any.timestamp - last - speed));
+      last = event.any.timestamp;
+   }
+
+   log_printf("%-22s %10s %10s %10s\n", "(ms)", "mean", "stddev", "max");
+   print_stats("generation latency", &latency);
+   print_stats("wakeup latency", &wakeup);
+   print_stats("jitter", &jitter);
+
+   al_destroy_timer(timer);
+   for (i = 0; i < num_timers; i++)
+      al_destroy_timer(timers[i]);
+   free(timers);
+   al_destroy_event_queue(queue);
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -107,6 +107,32 @@ AL_FUNC(void, al_convert_bitmap, (ALLEGRO_BITMAP *bitmap));
 AL_FUNC(void, al_convert_memory_bitmaps, (void));
 #if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
 AL_FUNC(void, al_backup_dirty_bitmap, (ALLEGRO_BITMAP *bitmap));
+AL_FUNC(bool, al_set_bitmap_mipmap_level, (ALLEGRO_BITMAP *bitmap, int level, const void *data, int pitch));
+AL_FUNC(int, al_get_bitmap_mipmap_levels, (ALLEGRO_BITMAP *bitmap));
+#endif
+
+/* Atlases */
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Type: ALLEGRO_BITMAP_ATLAS
+ */
+typedef struct ALLEGRO_BITMAP_ATLAS ALLEGRO_BITMAP_ATLAS;
+
+/* Type: ALLEGRO_BITMAP_ATLAS_STATS
+ */
+typedef struct ALLEGRO_BITMAP_ATLAS_STATS {
+   int num_pages;
+   int num_bitmaps;
+   int64_t used_pixels;
+   int64_t total_pixels;
+   int num_free_rects;
+} ALLEGRO_BITMAP_ATLAS_STATS;
+
+AL_FUNC(ALLEGRO_BITMAP_ATLAS *, al_create_bitmap_atlas, (int page_w, int page_h, int padding));
+AL_FUNC(void, al_destroy_bitmap_atlas, (ALLEGRO_BITMAP_ATLAS *atlas));
+AL_FUNC(ALLEGRO_BITMAP *, al_add_bitmap_to_atlas, (ALLEGRO_BITMAP_ATLAS *atlas, ALLEGRO_BITMAP *bitmap));
+AL_FUNC(int, al_add_bitmaps_to_atlas, (ALLEGRO_BITMAP_ATLAS *atlas, int num_bitmaps, ALLEGRO_BITMAP **bitmaps, ALLEGRO_BITMAP **subs));
+AL_FUNC(bool, al_remove_bitmap_from_atlas, (ALLEGRO_BITMAP_ATLAS *atlas, ALLEGRO_BITMAP *bitmap));
+AL_FUNC(void, al_get_bitmap_atlas_stats, (ALLEGRO_BITMAP_ATLAS *atlas, ALLEGRO_BITMAP_ATLAS_STATS *stats));
 #endif
 
 #ifdef __cplusplus
@@ -37,6 +37,31 @@ AL_FUNC(ALLEGRO_LOCKED_REGION*, al_lock_bitmap_region_blocked, (ALLEGRO_BITMAP *
 AL_FUNC(void, al_unlock_bitmap, (ALLEGRO_BITMAP *bitmap));
 AL_FUNC(bool, al_is_bitmap_locked, (ALLEGRO_BITMAP *bitmap));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Type: ALLEGRO_BITMAP_LOCK
+ */
+typedef struct ALLEGRO_BITMAP_LOCK ALLEGRO_BITMAP_LOCK;
+
+AL_FUNC(ALLEGRO_BITMAP_LOCK*, al_lock_bitmap_region_concurrent, (ALLEGRO_BITMAP *bitmap, int x, int y, int width, int height, int format, int flags));
+AL_FUNC(ALLEGRO_LOCKED_REGION*, al_get_bitmap_lock_region, (ALLEGRO_BITMAP_LOCK *lock));
+AL_FUNC(void, al_unlock_bitmap_region_concurrent, (ALLEGRO_BITMAP_LOCK *lock));
+
+/* Type: ALLEGRO_LOCK_BUFFER_POOL_STATS
+ */
+typedef struct ALLEGRO_LOCK_BUFFER_POOL_STATS
+{
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t releases;
+   size_t cached_bytes;
+   int cached_buffers;
+} ALLEGRO_LOCK_BUFFER_POOL_STATS;
+
+AL_FUNC(void, al_set_lock_buffer_pool_size, (size_t max_bytes));
+AL_FUNC(size_t, al_get_lock_buffer_pool_size, (void));
+AL_FUNC(void, al_get_lock_buffer_pool_stats, (ALLEGRO_LOCK_BUFFER_POOL_STATS *stats));
+#endif
+
 
 #ifdef __cplusplus
    }
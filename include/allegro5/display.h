@@ -30,6 +30,7 @@ enum {
 #if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
    ALLEGRO_OPENGL_CORE_PROFILE         = 1 << 15,
    ALLEGRO_DRAG_AND_DROP               = 1 << 16,
+   ALLEGRO_HEADLESS                    = 1 << 17,
 #endif
 };
 
@@ -179,6 +180,7 @@ AL_FUNC(void, al_acknowledge_drawing_halt, (ALLEGRO_DISPLAY *display));
 AL_FUNC(void, al_acknowledge_drawing_resume, (ALLEGRO_DISPLAY *display));
 #if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
 AL_FUNC(void, al_backup_dirty_bitmaps, (ALLEGRO_DISPLAY *display));
+AL_FUNC(void, al_acknowledge_display_frame, (ALLEGRO_DISPLAY *display, int64_t number));
 #endif
 
 #ifdef __cplusplus
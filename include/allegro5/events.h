@@ -52,6 +52,10 @@ enum
    ALLEGRO_EVENT_DISPLAY_DISCONNECTED        = 61,
 
    ALLEGRO_EVENT_DROP                        = 62,
+
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+   ALLEGRO_EVENT_DISPLAY_FRAME               = 63,
+#endif
 };
 
 
@@ -211,6 +215,23 @@ typedef struct ALLEGRO_DROP_EVENT
 
 
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+typedef struct ALLEGRO_DISPLAY_FRAME_EVENT
+{
+   _AL_EVENT_HEADER(struct ALLEGRO_DISPLAY)
+   /* (data, pitch, format, width, height) The pixels of the finished frame.
+    * (number) Passed to al_acknowledge_display_frame when done with them.
+    */
+   void *data;
+   int pitch;
+   int format;
+   int width, height;
+   int64_t number;
+} ALLEGRO_DISPLAY_FRAME_EVENT;
+#endif
+
+
+
 /* Type: ALLEGRO_EVENT
  */
 typedef union ALLEGRO_EVENT ALLEGRO_EVENT;
@@ -232,6 +253,9 @@ union ALLEGRO_EVENT
    ALLEGRO_TOUCH_EVENT    touch;
    ALLEGRO_USER_EVENT     user;
    ALLEGRO_DROP_EVENT     drop;
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+   ALLEGRO_DISPLAY_FRAME_EVENT frame;
+#endif
 };
 
 
@@ -279,6 +303,17 @@ AL_FUNC(bool, al_wait_for_event_until, (ALLEGRO_EVENT_QUEUE *queue,
                                         ALLEGRO_EVENT *ret_event,
                                         ALLEGRO_TIMEOUT *timeout));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+AL_FUNC(ALLEGRO_EVENT_QUEUE*, al_create_bounded_event_queue, (int capacity));
+AL_FUNC(void, al_register_broadcast_event_source, (ALLEGRO_EVENT_QUEUE*,
+                                                  ALLEGRO_EVENT_SOURCE*));
+AL_FUNC(int, al_get_next_events, (ALLEGRO_EVENT_QUEUE*,
+                                  ALLEGRO_EVENT *ret_events, int max));
+AL_FUNC(int, al_wait_for_events_timed, (ALLEGRO_EVENT_QUEUE*,
+                                        ALLEGRO_EVENT *ret_events, int max,
+                                        float secs));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
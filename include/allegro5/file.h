@@ -97,6 +97,28 @@ AL_FUNC(void, al_set_standard_file_interface, (void));
 /* ALLEGRO_FILE field accessors */
 AL_FUNC(void *, al_get_file_userdata, (ALLEGRO_FILE *f));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Specific to memory mapped files. */
+AL_FUNC(ALLEGRO_FILE*, al_fopen_mmap, (const char *path, const char *mode));
+AL_FUNC(const ALLEGRO_FILE_INTERFACE *, al_get_mmap_file_interface, (void));
+AL_FUNC(const void *, al_get_file_mapping, (ALLEGRO_FILE *f, int64_t *size));
+
+/* Pack files. */
+/* Type: ALLEGRO_PACK
+ */
+typedef struct ALLEGRO_PACK ALLEGRO_PACK;
+
+enum {
+   ALLEGRO_PACK_COMPRESS = 1
+};
+
+AL_FUNC(ALLEGRO_PACK *, al_open_pack, (const char *path));
+AL_FUNC(void, al_close_pack, (ALLEGRO_PACK *pack));
+AL_FUNC(ALLEGRO_FILE *, al_fopen_pack_entry, (ALLEGRO_PACK *pack, const char *name));
+AL_FUNC(void, al_set_pack_file_interface, (ALLEGRO_PACK *pack));
+AL_FUNC(bool, al_save_pack, (const char *path, const char *dir, int flags));
+#endif
+
 
 #ifdef __cplusplus
    }
@@ -19,6 +19,31 @@
       return __sync_sub_and_fetch(ptr, 1);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_value,
+         _AL_ATOMIC new_value),
+   {
+      return __sync_bool_compare_and_swap(ptr, old_value, new_value);
+   })
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      _AL_ATOMIC value;
+      __sync_synchronize();
+      value = *ptr;
+      __sync_synchronize();
+      return value;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC value),
+   {
+      __sync_synchronize();
+      *ptr = value;
+      __sync_synchronize();
+   })
+
 #elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 
    /* gcc, x86 or x86-64 */
@@ -49,9 +74,43 @@
       return old - 1;
    })
 
-#elif defined(_MSC_VER) && _M_IX86 >= 400
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_value,
+         _AL_ATOMIC new_value),
+   {
+      _AL_ATOMIC prev;
+      __asm__ __volatile__ (
+         "lock; cmpxchgl %2, %1"
+         : "=a" (prev), "+m" (*ptr)
+         : "r" (new_value), "0" (old_value)
+         : "memory"
+      );
+      return prev == old_value;
+   })
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      _AL_ATOMIC value;
+      __al_fetch_and_add(ptr, 0, value);
+      return value;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC value),
+   {
+      __asm__ __volatile__ (
+         "xchgl %0, %1"
+         : "+r" (value), "+m" (*ptr)
+         :
+         : "memory"
+      );
+   })
+
+#elif defined(_MSC_VER) && \
+   (_M_IX86 >= 400 || defined(_M_X64) || defined(_M_ARM) || defined(_M_ARM64))
 
-   /* MSVC, x86 */
+   /* MSVC, x86, x86-64 and ARM */
    /* MinGW supports these too, but we already have asm code above. */
 
    typedef LONG _AL_ATOMIC;
@@ -68,6 +127,26 @@
       return InterlockedDecrement(ptr);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_value,
+         _AL_ATOMIC new_value),
+   {
+      return InterlockedCompareExchange(ptr, new_value, old_value) ==
+         old_value;
+   })
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      return InterlockedCompareExchange(ptr, 0, 0);
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC value),
+   {
+      InterlockedExchange(ptr, value);
+   })
+
 #elif defined(ALLEGRO_HAVE_OSATOMIC_H)
 
    /* OS X, GCC < 4.1
@@ -93,12 +172,37 @@
       return OSAtomicDecrement32Barrier((_AL_ATOMIC *)ptr);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_value,
+         _AL_ATOMIC new_value),
+   {
+      return OSAtomicCompareAndSwap32Barrier(old_value, new_value,
+         (_AL_ATOMIC *)ptr);
+   })
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      return OSAtomicAdd32Barrier(0, (_AL_ATOMIC *)ptr);
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC value),
+   {
+      OSMemoryBarrier();
+      *ptr = value;
+      OSMemoryBarrier();
+   })
+
 
 #else
 
    /* Hope for the best? */
    #warning Atomic operations undefined for your compiler/architecture.
 
+   /* Users which need real atomicity can check for this and use a lock. */
+   #define _AL_ATOMICOPS_EMULATED
+
    typedef int _AL_ATOMIC;
 
    AL_INLINE(_AL_ATOMIC,
@@ -113,6 +217,28 @@
       return --(*ptr);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_value,
+         _AL_ATOMIC new_value),
+   {
+      if (*ptr != old_value)
+         return false;
+      *ptr = new_value;
+      return true;
+   })
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      return *ptr;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC value),
+   {
+      *ptr = value;
+   })
+
 #endif
 
 #endif
@@ -88,6 +88,8 @@ struct ALLEGRO_BITMAP
    void* lock_data;
    int lock_flags;
    ALLEGRO_LOCKED_REGION locked_region;
+   /* Regions locked with al_lock_bitmap_region_concurrent, see bitmap_lock.c */
+   struct ALLEGRO_BITMAP_LOCK *concurrent_locks;
 
    /* Transformation for this bitmap */
    ALLEGRO_TRANSFORM transform;
@@ -112,6 +114,12 @@ struct ALLEGRO_BITMAP
    /* A memory copy of the bitmap data. May be NULL for an empty bitmap. */
    unsigned char *memory;
 
+   /* Mipmap levels 1 to num_mipmaps given to al_set_bitmap_mipmap_level,
+    * each tightly packed in the bitmap's format.
+    */
+   unsigned char **mipmaps;
+   int num_mipmaps;
+
    /* Extra data for display bitmaps, like texture id and so on. */
    void *extra;
 
@@ -154,6 +162,11 @@ struct ALLEGRO_BITMAP_INTERFACE
 
    /* Back up texture to system RAM */
    void (*backup_dirty_bitmap)(ALLEGRO_BITMAP *bitmap);
+
+   /* Called after the stored mipmap levels from first_level on have changed.
+    * Without stored levels, mipmaps should be generated again.
+    */
+   void (*update_mipmaps)(ALLEGRO_BITMAP *bitmap, int first_level);
 };
 
 ALLEGRO_BITMAP *_al_create_bitmap_params(ALLEGRO_DISPLAY *current_display,
@@ -167,6 +180,21 @@ extern void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
    [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
    int, int, int, int, int, int);
 
+/* Replaces converters with vectorized ones where the CPU supports them. */
+void _al_init_convert_funcs(void);
+
+void _al_init_bitmap_locks(void);
+
+/* Stored mipmap levels, see al_set_bitmap_mipmap_level */
+AL_FUNC(int, _al_get_mipmap_level_count, (int w, int h));
+void _al_get_mipmap_level_size(ALLEGRO_BITMAP *bitmap, int level,
+   int *w, int *h, int *row_bytes, int *rows);
+
+/* Staging buffers for locks, see bitmap_lock_pool.c */
+void _al_init_lock_buffer_pool(void);
+void *_al_alloc_lock_buffer(size_t size);
+void _al_free_lock_buffer(void *buf);
+
 /* Bitmap conversion */
 void _al_convert_bitmap_data(
         const void *src, int src_format, int src_pitch,
@@ -246,6 +246,20 @@ void _al_blend_memory(ALLEGRO_COLOR *src_color, ALLEGRO_BITMAP *dest,
    int dx, int dy, ALLEGRO_COLOR *result);
 
 
+/* Blend factors of the integer span blender. */
+enum {
+   _AL_INT_BLEND_ZERO,
+   _AL_INT_BLEND_ONE,
+   _AL_INT_BLEND_ALPHA,
+   _AL_INT_BLEND_INVERSE_ALPHA
+};
+
+bool _al_get_int_blender(int op, int src_mode, int dst_mode,
+   int op_alpha, int src_alpha, int dst_alpha, int factors[4]);
+void _al_blend_span_int(uint32_t *dst, const uint32_t *src, int w,
+   bool swap_rb, const uint32_t *tint, const int factors[4]);
+
+
 #ifdef __cplusplus
    }
 #endif
@@ -104,6 +104,8 @@ struct ALLEGRO_DISPLAY_INTERFACE
 
    int (*draw_vertex_buffer)(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX_BUFFER* vertex_buffer, int start, int end, int type);
    int (*draw_indexed_buffer)(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX_BUFFER* vertex_buffer, ALLEGRO_INDEX_BUFFER* index_buffer, int start, int end, int type);
+
+   void (*acknowledge_frame)(ALLEGRO_DISPLAY *d, int64_t number);
 };
 
 
@@ -189,6 +191,9 @@ AL_FUNC(void, _al_remove_display_invalidated_callback, (ALLEGRO_DISPLAY *display
 AL_FUNC(void, _al_remove_display_validated_callback, (ALLEGRO_DISPLAY *display,
    void (*display_validated)(ALLEGRO_DISPLAY*)));
 
+/* Defined in display_headless.c */
+ALLEGRO_DISPLAY_INTERFACE *_al_display_headless_driver(void);
+
 /* Defined in tls.c */
 bool _al_set_current_display_only(ALLEGRO_DISPLAY *display);
 void _al_set_new_display_settings(ALLEGRO_EXTRA_DISPLAY_SETTINGS *settings);
@@ -10,12 +10,14 @@
 
 
 typedef struct ALLEGRO_EVENT_SOURCE_REAL ALLEGRO_EVENT_SOURCE_REAL;
+typedef struct _AL_EVENT_BROADCAST _AL_EVENT_BROADCAST;
 
 struct ALLEGRO_EVENT_SOURCE_REAL
 {
    _AL_MUTEX mutex;
    _AL_VECTOR queues;
    intptr_t data;
+   _AL_EVENT_BROADCAST *broadcast;  /* for broadcast registrations, or NULL */
 };
 
 typedef struct ALLEGRO_USER_EVENT_DESCRIPTOR
@@ -38,6 +40,13 @@ void _al_event_source_emit_event(ALLEGRO_EVENT_SOURCE *, ALLEGRO_EVENT*);
 
 void _al_event_queue_push_event(ALLEGRO_EVENT_QUEUE*, const ALLEGRO_EVENT*);
 
+bool _al_event_broadcast_has_readers(_AL_EVENT_BROADCAST *broadcast);
+bool _al_event_broadcast_remove_reader(_AL_EVENT_BROADCAST *broadcast,
+   ALLEGRO_EVENT_QUEUE *queue);
+void _al_event_broadcast_publish(_AL_EVENT_BROADCAST *broadcast,
+   const ALLEGRO_EVENT *event);
+void _al_event_broadcast_free(ALLEGRO_EVENT_SOURCE *es);
+
 
 #ifdef __cplusplus
    }
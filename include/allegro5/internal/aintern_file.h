@@ -7,6 +7,62 @@
 
 
 extern const ALLEGRO_FILE_INTERFACE _al_file_interface_stdio;
+extern const ALLEGRO_FILE_INTERFACE _al_file_interface_mmap;
+extern const ALLEGRO_FILE_INTERFACE _al_file_interface_slice;
+
+extern const ALLEGRO_FILE_INTERFACE _al_file_interface_pack;
+extern const ALLEGRO_FS_INTERFACE _al_fs_interface_pack;
+
+const void *_al_get_mmap_file_data(ALLEGRO_FILE *f, int64_t *size);
+const void *_al_get_slice_file_data(ALLEGRO_FILE *f, int64_t *size);
+const void *_al_get_pack_file_data(ALLEGRO_FILE *f, int64_t *size);
+
+/* Pack files, see file_pack.c for the layout. */
+#define _AL_PACK_MAGIC           "ALPK"
+#define _AL_PACK_VERSION         1
+#define _AL_PACK_HEADER_SIZE     40
+#define _AL_PACK_ENTRY_SIZE      40
+#define _AL_PACK_ALIGN           16
+
+enum {
+   _AL_PACK_STORED = 0,
+   _AL_PACK_LZ4    = 1
+};
+
+typedef struct _AL_PACK_ENTRY
+{
+   uint32_t hash;
+   const char *name;
+   uint32_t name_len;
+   uint32_t method;
+   uint64_t offset;
+   uint64_t size;
+   uint64_t raw_size;
+} _AL_PACK_ENTRY;
+
+struct ALLEGRO_PACK
+{
+   ALLEGRO_FILE *fp;
+   const unsigned char *data;
+   int64_t size;
+   _AL_PACK_ENTRY *entries;   /* sorted by hash, then name */
+   uint32_t num_entries;
+   uint32_t *by_name;         /* entry numbers sorted by name */
+   ALLEGRO_USTR *cwd;         /* no leading or trailing slash */
+};
+
+uint32_t _al_pack_hash(const char *name, size_t len);
+int _al_pack_compare_names(const char *a, size_t a_len,
+   const char *b, size_t b_len);
+bool _al_pack_resolve_path(ALLEGRO_PACK *pack, const char *path,
+   ALLEGRO_USTR *out);
+_AL_PACK_ENTRY *_al_pack_find_entry(ALLEGRO_PACK *pack, const char *name,
+   size_t len);
+uint32_t _al_pack_find_prefix(ALLEGRO_PACK *pack, const char *prefix,
+   size_t len);
+ALLEGRO_FILE *_al_pack_open_entry(ALLEGRO_PACK *pack, _AL_PACK_ENTRY *e);
+int _al_lz4_compress(const unsigned char *src, int src_size,
+   unsigned char *dst, int dst_capacity);
 
 #define ALLEGRO_UNGETC_SIZE 16
 
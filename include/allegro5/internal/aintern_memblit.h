@@ -10,6 +10,24 @@ void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *bitmap,
    ALLEGRO_COLOR tint,
    int sx, int sy, int sw, int sh, int dx, int dy, int flags);
 
+/* Bitmap draws to memory bitmaps recorded while drawing is held, kept per
+ * thread.
+ */
+typedef struct _AL_HELD_DRAWS
+{
+   bool held;
+   struct _AL_HELD_DRAW *draws;
+   int num_draws;
+   int max_draws;
+   struct ALLEGRO_VERTEX *vtxs;
+   int max_vtxs;
+} _AL_HELD_DRAWS;
+
+void _al_hold_memory_drawing(bool hold);
+bool _al_is_memory_drawing_held(void);
+bool _al_hold_bitmap_region_memory(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh, int flags);
+
 
 #ifdef __cplusplus
    }
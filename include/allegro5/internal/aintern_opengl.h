@@ -176,6 +176,7 @@ int _al_ogl_get_glformat(int format, int component);
 ALLEGRO_BITMAP *_al_ogl_create_bitmap(ALLEGRO_DISPLAY *d, int w, int h,
     int format, int flags);
 void _al_ogl_upload_bitmap_memory(ALLEGRO_BITMAP *bitmap, int format, void *ptr);
+void _al_ogl_update_mipmaps(ALLEGRO_BITMAP *bitmap, int first_level);
 
 /* locking */
 #ifndef ALLEGRO_CFG_OPENGLES
@@ -11,6 +11,10 @@ void _al_reinitialize_tls_values(void);
 
 int *_al_tls_get_dtor_owner_count(void);
 
+struct _AL_HELD_DRAWS *_al_tls_get_held_draws(void);
+
+struct ALLEGRO_PACK **_al_tls_get_pack(void);
+
 
 #ifdef __cplusplus
    }
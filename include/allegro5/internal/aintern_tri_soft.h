@@ -12,4 +12,9 @@ AL_FUNC(void, _al_draw_soft_triangle, (
    void (*step)(uintptr_t, int),
    void (*draw)(uintptr_t, int, int, int)));
 
+bool _al_want_soft_triangle_batch(void);
+void _al_draw_soft_triangle_batch(struct ALLEGRO_BITMAP *texture,
+   struct ALLEGRO_VERTEX *vtxs, int num_triangles);
+void _al_init_soft_rasterizer(void);
+
 #endif
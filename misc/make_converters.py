@@ -4,6 +4,13 @@ import collections, optparse, re, sys
 formats_by_name = {}
 formats_list = []
 
+# Formats which get vectorized converters (see vector_terms). Only the
+# 8888 and single channel formats are supported as source.
+vector_formats = [
+    "ARGB_8888", "RGBA_8888", "ABGR_8888", "XBGR_8888", "RGBX_8888",
+    "XRGB_8888", "ABGR_8888_LE", "RGB_565", "BGR_565", "ARGB_4444",
+    "RGBA_4444", "SINGLE_CHANNEL_8"]
+
 def read_color_h(filename):
     """
     Read in the list of formats.
@@ -77,6 +84,65 @@ def parse_format(format):
         float=False,
     )
 
+def component_ops(info_a, info_b, names):
+    """
+    Work out how to move each component of info_a into info_b. Returns the
+    list of (possibly merged) component names and a dictionary mapping
+    them to (mask, shift, add, size_a, size_b, mask_pos) tuples.
+    """
+    # Generate a list of (mask, shift, add) tuples for all components.
+    ops = {}
+    for name in names:
+        if name == "X": continue # We simply ignore X components.
+        c_b = info_b.components[name]
+        if name not in info_a.components:
+            # Set A component to all 1 bits if the source doesn't have it.
+            if name == "A":
+                add = (1 << c_b.size) - 1
+                add <<= c_b.position
+                ops[name] = (0, 0, add, 0, 0, 0)
+            continue
+        c_a = info_a.components[name]
+        mask = (1 << c_b.size) - 1
+        shift_right = c_a.position
+        mask_pos = c_a.position
+        shift_left = c_b.position
+        bitdiff = c_a.size - c_b.size
+        if bitdiff > 0:
+            shift_right += bitdiff
+            mask_pos += bitdiff
+        else:
+            shift_left -= bitdiff
+            mask = (1 << c_a.size) - 1
+
+        mask <<= mask_pos
+        shift = shift_left - shift_right
+        ops[name] = (mask, shift, 0, c_a.size, c_b.size, mask_pos)
+
+    # Collapse multiple components if possible.
+    common_shifts = {}
+    for name, (mask, shift, add, size_a, size_b, mask_pos) in ops.items():
+        if not add and not (size_a != 8 and size_b == 8):
+            if shift in common_shifts: common_shifts[shift].append(name)
+            else: common_shifts[shift] = [name]
+    for newshift, colors in common_shifts.items():
+        if len(colors) == 1: continue
+        newname = ""
+        newmask = 0
+        colors.sort()
+        masks_pos = []
+        for name in colors:
+            mask, shift, add, size_a, size_b, mask_pos = ops[name]
+
+            names.remove(name)
+            newname += name
+            newmask |= mask
+            masks_pos.append(mask_pos)
+        names.append(newname)
+        ops[newname] = (newmask, newshift, 0, size_a, size_b, min(masks_pos))
+
+    return names, ops
+
 def macro_lines(info_a, info_b):
     """
     Write out the lines of a conversion macro.
@@ -154,56 +220,7 @@ def macro_lines(info_a, info_b):
         r += "   " + scale + "\n"
         return r
 
-    # Generate a list of (mask, shift, add) tuples for all components.
-    ops = {}
-    for name in names:
-        if name == "X": continue # We simply ignore X components.
-        c_b = info_b.components[name]
-        if name not in info_a.components:
-            # Set A component to all 1 bits if the source doesn't have it.
-            if name == "A":
-                add = (1 << c_b.size) - 1
-                add <<= c_b.position
-                ops[name] = (0, 0, add, 0, 0, 0)
-            continue
-        c_a = info_a.components[name]
-        mask = (1 << c_b.size) - 1
-        shift_right = c_a.position
-        mask_pos = c_a.position
-        shift_left = c_b.position
-        bitdiff = c_a.size - c_b.size
-        if bitdiff > 0:
-            shift_right += bitdiff
-            mask_pos += bitdiff
-        else:
-            shift_left -= bitdiff
-            mask = (1 << c_a.size) - 1
-
-        mask <<= mask_pos
-        shift = shift_left - shift_right
-        ops[name] = (mask, shift, 0, c_a.size, c_b.size, mask_pos)
-
-    # Collapse multiple components if possible.
-    common_shifts = {}
-    for name, (mask, shift, add, size_a, size_b, mask_pos) in ops.items():
-        if not add and not (size_a != 8 and size_b == 8):
-            if shift in common_shifts: common_shifts[shift].append(name)
-            else: common_shifts[shift] = [name]
-    for newshift, colors in common_shifts.items():
-        if len(colors) == 1: continue
-        newname = ""
-        newmask = 0
-        colors.sort()
-        masks_pos = []
-        for name in colors:
-            mask, shift, add, size_a, size_b, mask_pos = ops[name]
-
-            names.remove(name)
-            newname += name
-            newmask |= mask
-            masks_pos.append(mask_pos)
-        names.append(newname)
-        ops[newname] = (newmask, newshift, 0, size_a, size_b, min(masks_pos))
+    names, ops = component_ops(info_a, info_b, names)
 
     # Write out a line for each remaining operation.
     lines = []
@@ -233,7 +250,7 @@ def macro_lines(info_a, info_b):
         line, name, shift, size_a, size_b, mask_pos = lines[i]
         if i == 0: start = "   ("
         else: start = "    "
-        if i == len(lines) - 1: cont = ")   "
+        if i == len(lines) - 1: cont = ")"
         else: cont = " | \\"
         if size_a != 8 and size_b == 8:
             shift = shift+(mask_pos-(8-size_a))
@@ -399,6 +416,321 @@ def converter_function(info_a, info_b):
 
     return r
 
+def vector_terms(info_a, info_b):
+    """
+    Describe a conversion as a list of terms to be ORed together, or return
+    None if no vectorized converter should be made. A term is one of
+    ("mask", mask, shift) for ((x) & mask) shifted left by shift,
+    ("shift", shift, mask) for (x) shifted left by shift and then masked,
+    or ("const", value). Negative shifts are right shifts.
+    """
+    if not info_a or not info_b: return None
+    if info_a.name not in vector_formats: return None
+    if info_b.name not in vector_formats: return None
+    if info_a.size not in [8, 32]: return None
+
+    terms = []
+    if info_a.single_channel:
+        for name in sorted(info_b.components.keys()):
+            if name in ["X", "G", "B"]: continue
+            c = info_b.components[name]
+            m = ((1 << c.size) - 1) << c.position
+            if name == "A":
+                terms.append(("const", m))
+            else:
+                terms.append(("shift", c.size + c.position - 8, m))
+        return terms
+
+    if info_b.single_channel:
+        c = info_a.components["R"]
+        if c.size != 8: return None
+        return [("shift", -c.position, 0xff)]
+
+    names = list(info_b.components.keys())
+    names.sort()
+    names, ops = component_ops(info_a, info_b, names)
+    for name in names:
+        if not name in ops: continue
+        mask, shift, add, size_a, size_b, mask_pos = ops[name]
+        if add:
+            terms.append(("const", add))
+        elif size_a != 8 and size_b == 8:
+            return None
+        else:
+            terms.append(("mask", mask, shift))
+    return terms
+
+def vector_shift(e, shift):
+    if shift > 0: return "VSHL(%s, %d)" % (e, shift)
+    if shift < 0: return "VSHR(%s, %d)" % (e, -shift)
+    return e
+
+def vector_macro(info_a, info_b):
+    """
+    Create a vectorized conversion macro. It is written in terms of the
+    VAND, VOR, VSHL, VSHR and VSET operations which each instruction set
+    defines before use.
+    """
+    terms = vector_terms(info_a, info_b)
+    if not terms: return None
+
+    exprs = []
+    const = 0
+    for term in terms:
+        if term[0] == "const":
+            const |= term[1]
+        elif term[0] == "mask":
+            exprs.append(vector_shift("VAND(x, 0x%08x)" % term[1], term[2]))
+        else:
+            exprs.append("VAND(%s, 0x%08x)" % (vector_shift("x", term[1]),
+                term[2]))
+    if const:
+        exprs.append("VSET(0x%08x)" % const)
+
+    expr = exprs[-1]
+    for e in reversed(exprs[:-1]):
+        expr = "VOR(" + e + ", \\\n   " + expr + ")"
+
+    name = "VCONVERT_" + info_a.name + "_TO_" + info_b.name
+    return "#define " + name + "(x) \\\n   " + expr + "\n"
+
+# name, define, capability flag, pixels per vector, function attributes
+vector_isas = [
+    ("sse2", "ALLEGRO_CONVERT_SSE2", "_AL_CPU_SSE2", 4, ""),
+    ("avx2", "ALLEGRO_CONVERT_AVX2", "_AL_CPU_AVX2", 8, "_AL_TARGET_AVX2 "),
+    ("neon", "ALLEGRO_CONVERT_NEON", "_AL_CPU_NEON", 4, ""),
+]
+
+vector_prologue = """\
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \\
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define ALLEGRO_CONVERT_SSE2
+      #include <emmintrin.h>
+   #endif
+   #if (defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__)) && \\
+         (defined(__x86_64__) || defined(__i386__))) || \\
+      (defined(_MSC_VER) && _MSC_VER >= 1700 && \\
+         (defined(_M_X64) || defined(_M_IX86)))
+      #define ALLEGRO_CONVERT_AVX2
+      #include <immintrin.h>
+      #ifdef __GNUC__
+         #define _AL_TARGET_AVX2 __attribute__((target("avx2")))
+      #else
+         #define _AL_TARGET_AVX2
+      #endif
+   #endif
+   #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+      #define ALLEGRO_CONVERT_NEON
+      #include <arm_neon.h>
+   #endif
+#endif
+"""
+
+vector_isa_prologues = {
+    "sse2": """\
+#define VEC __m128i
+#define VAND(x, m) _mm_and_si128(x, _mm_set1_epi32((int)(m)))
+#define VOR(x, y) _mm_or_si128(x, y)
+#define VSHL(x, n) _mm_slli_epi32(x, n)
+#define VSHR(x, n) _mm_srli_epi32(x, n)
+#define VSET(c) _mm_set1_epi32((int)(c))
+static INLINE __m128i sse2_load32(const uint32_t *p)
+{
+   return _mm_loadu_si128((const __m128i *)p);
+}
+static INLINE __m128i sse2_load8(const uint8_t *p)
+{
+   int32_t t;
+   __m128i zero = _mm_setzero_si128();
+   memcpy(&t, p, 4);
+   return _mm_unpacklo_epi16(
+      _mm_unpacklo_epi8(_mm_cvtsi32_si128(t), zero), zero);
+}
+static INLINE void sse2_store32(uint32_t *p, __m128i v)
+{
+   _mm_storeu_si128((__m128i *)p, v);
+}
+static INLINE void sse2_store16(uint16_t *p, __m128i v)
+{
+   /* Sign extend so that the saturating pack keeps all 16 bits. */
+   v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+   _mm_storel_epi64((__m128i *)p, _mm_packs_epi32(v, v));
+}
+static INLINE void sse2_store8(uint8_t *p, __m128i v)
+{
+   int32_t t;
+   v = _mm_packs_epi32(v, v);
+   t = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+   memcpy(p, &t, 4);
+}
+""",
+    "avx2": """\
+#define VEC __m256i
+#define VAND(x, m) _mm256_and_si256(x, _mm256_set1_epi32((int)(m)))
+#define VOR(x, y) _mm256_or_si256(x, y)
+#define VSHL(x, n) _mm256_slli_epi32(x, n)
+#define VSHR(x, n) _mm256_srli_epi32(x, n)
+#define VSET(c) _mm256_set1_epi32((int)(c))
+static INLINE _AL_TARGET_AVX2 __m256i avx2_load32(const uint32_t *p)
+{
+   return _mm256_loadu_si256((const __m256i *)p);
+}
+static INLINE _AL_TARGET_AVX2 __m256i avx2_load8(const uint8_t *p)
+{
+   return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p));
+}
+static INLINE _AL_TARGET_AVX2 void avx2_store32(uint32_t *p, __m256i v)
+{
+   _mm256_storeu_si256((__m256i *)p, v);
+}
+static INLINE _AL_TARGET_AVX2 __m128i avx2_pack16(__m256i v)
+{
+   /* Sign extend so that the saturating pack keeps all 16 bits. */
+   v = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+   return _mm_packs_epi32(_mm256_castsi256_si128(v),
+      _mm256_extracti128_si256(v, 1));
+}
+static INLINE _AL_TARGET_AVX2 void avx2_store16(uint16_t *p, __m256i v)
+{
+   _mm_storeu_si128((__m128i *)p, avx2_pack16(v));
+}
+static INLINE _AL_TARGET_AVX2 void avx2_store8(uint8_t *p, __m256i v)
+{
+   __m128i w = avx2_pack16(v);
+   _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(w, w));
+}
+""",
+    "neon": """\
+#define VEC uint32x4_t
+#define VAND(x, m) vandq_u32(x, vdupq_n_u32(m))
+#define VOR(x, y) vorrq_u32(x, y)
+#define VSHL(x, n) vshlq_n_u32(x, n)
+#define VSHR(x, n) vshrq_n_u32(x, n)
+#define VSET(c) vdupq_n_u32(c)
+static INLINE uint32x4_t neon_load32(const uint32_t *p)
+{
+   return vld1q_u32(p);
+}
+static INLINE uint32x4_t neon_load8(const uint8_t *p)
+{
+   uint32_t t;
+   memcpy(&t, p, 4);
+   return vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(t)))));
+}
+static INLINE void neon_store32(uint32_t *p, uint32x4_t v)
+{
+   vst1q_u32(p, v);
+}
+static INLINE void neon_store16(uint16_t *p, uint32x4_t v)
+{
+   vst1_u16(p, vmovn_u32(v));
+}
+static INLINE void neon_store8(uint8_t *p, uint32x4_t v)
+{
+   uint16x4_t h = vmovn_u32(v);
+   uint32_t t = vget_lane_u32(
+      vreinterpret_u32_u8(vmovn_u16(vcombine_u16(h, h))), 0);
+   memcpy(p, &t, 4);
+}
+""",
+}
+
+vector_isa_epilogue = """\
+#undef VEC
+#undef VAND
+#undef VOR
+#undef VSHL
+#undef VSHR
+#undef VSET
+"""
+
+def vector_function(info_a, info_b, isa):
+    """
+    Create a string with one vectorized conversion function. Pixels which
+    don't fill a whole vector at the end of each row use the scalar macro.
+    """
+    isa_name, define, cap, count, attributes = isa
+    name = info_a.name.lower() + "_to_" + info_b.name.lower() + "_" + isa_name
+    macro_name = "ALLEGRO_CONVERT_" + info_a.name + "_TO_" + info_b.name
+    vmacro_name = "VCONVERT_" + info_a.name + "_TO_" + info_b.name
+
+    types = {8: "uint8_t", 16: "uint16_t", 32: "uint32_t"}
+    a_type = types[info_a.size]
+    b_type = types[info_b.size]
+    load = isa_name + "_load" + str(info_a.size)
+    store = isa_name + "_store" + str(info_b.size)
+
+    return """\
+static %(attributes)svoid %(name)s(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const %(a_type)s *src_ptr = (const %(a_type)s *)((const char *)src + sy * src_pitch) + sx;
+   %(b_type)s *dst_ptr = (%(b_type)s *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + %(count)d <= width; x += %(count)d) {
+         VEC v = %(load)s(src_ptr + x);
+         %(store)s(dst_ptr + x, %(vmacro_name)s(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = %(macro_name)s(src_ptr[x]);
+      }
+      src_ptr = (const %(a_type)s *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (%(b_type)s *)((char *)dst_ptr + dst_pitch);
+   }
+}
+""" % locals()
+
+def vector_pairs():
+    pairs = []
+    for a in formats_list:
+        for b in formats_list:
+            if a and b and a != b and vector_terms(a, b):
+                pairs.append((a, b))
+    return pairs
+
+def write_vector_converters(f):
+    """
+    Write out the vectorized conversion functions and the function which
+    installs them into _al_convert_funcs.
+    """
+    pairs = vector_pairs()
+
+    f.write(vector_prologue)
+    for a, b in pairs:
+        f.write(vector_macro(a, b))
+
+    for isa in vector_isas:
+        isa_name, define, cap, count, attributes = isa
+        f.write("#ifdef " + define + "\n")
+        f.write(vector_isa_prologues[isa_name])
+        for a, b in pairs:
+            f.write(vector_function(a, b, isa))
+        f.write(vector_isa_epilogue)
+        f.write("#endif\n")
+
+    f.write("""\
+void _al_init_convert_funcs(void)
+{
+   int caps = _al_get_cpu_capabilities();
+   (void)caps;
+""")
+    # Later entries win, so list the preferred instruction sets last.
+    for isa in vector_isas:
+        isa_name, define, cap, count, attributes = isa
+        f.write("#ifdef " + define + "\n")
+        f.write("   if (caps & " + cap + ") {\n")
+        for a, b in pairs:
+            f.write("      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_%s][ALLEGRO_PIXEL_FORMAT_%s] =\n"
+                % (a.name, b.name))
+            f.write("         %s_to_%s_%s;\n" % (a.name.lower(), b.name.lower(),
+                isa_name))
+        f.write("   }\n")
+        f.write("#endif\n")
+    f.write("}\n")
+
 def write_convert_c(filename):
     """
     Write out the file with the conversion functions.
@@ -409,6 +741,8 @@ def write_convert_c(filename):
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_cpu.h"
+#include <string.h>
 """)
 
     for a in formats_list:
@@ -443,6 +777,11 @@ void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
     f.write("""\
 };
 
+""")
+
+    write_vector_converters(f)
+
+    f.write("""\
 // Warning: This file was created by make_converters.py - do not edit.
 """)
 
@@ -112,9 +112,12 @@ def make_drawer(name):
       int op, src_mode, dst_mode;
       int op_alpha, src_alpha, dst_alpha;
       ALLEGRO_COLOR const_color;
+      int int_blender[4];
       al_get_separate_bitmap_blender(&op, &src_mode, &dst_mode,
          &op_alpha, &src_alpha, &dst_alpha);
       const_color = al_get_blend_color();
+      const bool int_blend = _al_get_int_blender(op, src_mode, dst_mode,
+         op_alpha, src_alpha, dst_alpha, int_blender);
       """)
 
    print("{")
@@ -147,6 +150,27 @@ def make_drawer(name):
          + x1 * target->locked_region.pixel_size;
       """)
 
+   # The integer drawers handle the 8888 formats.  They are skipped for
+   # colours which could overflow the fixed point interpolation, and for
+   # plain copies between equal formats which the copy loops below do.
+   print("const bool int_span = int_span_format(dst_format)")
+   if texture:
+      print("&& int_span_format(src_format)")
+   if opaque and white:
+      print("&& src_format != dst_format")
+   if shade:
+      print("&& int_blend")
+   if grad:
+      print("&& int_span_color_ok(&cur_color, &gs->color_dx, x2 - x1)")
+   elif not texture:
+      print("&& int_span_color_ok(&cur_color, NULL, 0)")
+   elif not white:
+      print("&& int_span_color_ok(&s->cur_color, NULL, 0)")
+   print(";")
+
+   make_loop(int_span=True)
+   print("else")
+
    if shade:
       make_if_blender_loop(
             op='ALLEGRO_ADD',
@@ -277,9 +301,13 @@ def make_loop(
       copy_format=False,
       alpha_only=False,
       repeat=False,
+      int_span=False,
       ):
 
-   if if_format:
+   if int_span:
+      src_size = '4'
+      print("if (int_span)")
+   elif if_format:
       src_format = if_format
       dst_format = if_format
       print(interp("if (dst_format == #{dst_format}"))
@@ -299,6 +327,10 @@ def make_loop(
          const al_fixed du_dx = al_ftofix(s->du_dx);
          const al_fixed dv_dx = al_ftofix(s->dv_dx);
          """)
+      if int_span:
+         print("""\
+            const bool swap_rb = int_span_swap_rb(src_format, dst_format);
+            """)
 
       if opaque:
          # If texture coordinates never wrap around then we can simplify the
@@ -325,6 +357,7 @@ def make_loop(
             tiling=False,
             alpha_only=alpha_only,
             repeat=repeat,
+            int_span=int_span,
             )
          print("} else")
 
@@ -342,6 +375,7 @@ def make_loop(
       copy_format=copy_format,
       alpha_only=alpha_only,
       repeat=repeat,
+      int_span=int_span,
       )
 
    print("}")
@@ -361,6 +395,7 @@ def make_innermost_loop(
       tiling=True,
       alpha_only=True,
       repeat=False,
+      int_span=False,
       ):
 
    print("{")
@@ -385,9 +420,29 @@ def make_innermost_loop(
             """)
          uu_ofs = vv_ofs = "0"
 
-   print("for (; x1 <= x2; x1++) {")
+   if int_span:
+      make_int_span_prologue()
+      if shade:
+         print("""\
+            while (x1 <= x2) {
+               const int x_end = MIN(x2, x1 + INT_SPAN_SIZE - 1);
+               uint32_t *span_end = span;
+               for (; x1 <= x_end; x1++) {""")
+      else:
+         print("for (; x1 <= x2; x1++) {")
+   else:
+      print("for (; x1 <= x2; x1++) {")
 
-   if not texture:
+   if int_span and not texture:
+      if grad:
+         print("""\
+            uint32_t src_pixel = int_span_pack(color);
+            """)
+      else:
+         print("""\
+            uint32_t src_pixel = color_pixel;
+            """)
+   elif not texture:
       print("""\
          ALLEGRO_COLOR src_color = cur_color;
          """)
@@ -438,6 +493,16 @@ def make_innermost_loop(
 
       if copy_format:
          pass
+      elif int_span:
+         print("""\
+            uint32_t src_pixel = *(uint32_t *)src_data;
+            if (swap_rb)
+               src_pixel = INT_SPAN_SWAP_RB(src_pixel);
+            """)
+         if grad or not white:
+            print("""\
+            src_pixel = int_span_tint(src_pixel, tint);
+            """)
       else:
          print(interp("""\
             ALLEGRO_COLOR src_color;
@@ -452,7 +517,16 @@ def make_innermost_loop(
             SHADE_COLORS(src_color, s->cur_color);
             """)
 
-   if copy_format:
+   if int_span:
+      if shade:
+         print("""\
+            *span_end++ = src_pixel;
+            """)
+      else:
+         print("""\
+            *dst32++ = src_pixel;
+            """)
+   elif copy_format:
       print(interp("""\
          switch (#{src_size}) {
             case 4:
@@ -520,7 +594,15 @@ def make_innermost_loop(
          }
          """)
 
-   if grad:
+   if grad and int_span:
+      channels = "tint" if texture else "color"
+      print(interp("""\
+         #{channels}[0] += #{channels}_dx[0];
+         #{channels}[1] += #{channels}_dx[1];
+         #{channels}[2] += #{channels}_dx[2];
+         #{channels}[3] += #{channels}_dx[3];
+         """))
+   elif grad:
       print("""\
          cur_color.r += gs->color_dx.r;
          cur_color.g += gs->color_dx.g;
@@ -528,10 +610,58 @@ def make_innermost_loop(
          cur_color.a += gs->color_dx.a;
          """)
 
-   print("""\
+   if int_span and shade:
+      print("""\
+            }
+            _al_blend_span_int(dst32, span, span_end - span, false, NULL,
+               int_blender);
+            dst32 += span_end - span;
+         }
+      }""")
+   else:
+      print("""\
       }
    }""")
 
+def make_int_span_prologue():
+   # Colours are kept as 16.16 fixed point channels in the order of the
+   # destination pixel, see int_span_channels.
+   print("""\
+      uint32_t *dst32 = (uint32_t *)dst_data;
+      """)
+   if shade:
+      print("""\
+      uint32_t span[INT_SPAN_SIZE];
+      """)
+
+   if not texture:
+      if grad:
+         print("""\
+         int32_t color[4];
+         int32_t color_dx[4];
+         int_span_channels(dst_format, &cur_color, 255, color);
+         int_span_channels(dst_format, &gs->color_dx, 255, color_dx);
+         """)
+      else:
+         print("""\
+         int32_t color[4];
+         uint32_t color_pixel;
+         int_span_channels(dst_format, &cur_color, 255, color);
+         color_pixel = int_span_pack(color);
+         """)
+   elif grad:
+      print("""\
+         int32_t tint[4];
+         int32_t tint_dx[4];
+         int_span_channels(dst_format, &cur_color, 1, tint);
+         int_span_channels(dst_format, &gs->color_dx, 1, tint_dx);
+         """)
+   elif not white:
+      print("""\
+         int32_t tint[4];
+         int_span_channels(dst_format, &s->cur_color, 1, tint);
+         """)
+
 if __name__ == "__main__":
    print("""\
 // Warning: This file was created by make_scanline_drawers.py - do not edit.
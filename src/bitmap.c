@@ -84,9 +84,30 @@ static ALLEGRO_BITMAP *create_memory_bitmap(ALLEGRO_DISPLAY *current_display,
 
 
 
+/* free_mipmaps:
+ *  Frees the stored mipmap levels from first_level on.
+ */
+static void free_mipmaps(ALLEGRO_BITMAP *bitmap, int first_level)
+{
+   int i;
+
+   for (i = first_level; i <= bitmap->num_mipmaps; i++)
+      al_free(bitmap->mipmaps[i - 1]);
+   if (first_level <= bitmap->num_mipmaps)
+      bitmap->num_mipmaps = first_level - 1;
+
+   if (bitmap->num_mipmaps == 0) {
+      al_free(bitmap->mipmaps);
+      bitmap->mipmaps = NULL;
+   }
+}
+
+
+
 static void destroy_memory_bitmap(ALLEGRO_BITMAP *bmp)
 {
    _al_unregister_convert_bitmap(bmp);
+   free_mipmaps(bmp, 1);
 
    if (bmp->memory)
       al_free(bmp->memory);
@@ -239,6 +260,8 @@ void al_destroy_bitmap(ALLEGRO_BITMAP *bitmap)
       if (bitmap->vt)
          bitmap->vt->destroy_bitmap(bitmap);
 
+      free_mipmaps(bitmap, 1);
+
       if (disp)
          _al_vector_find_and_delete(&disp->bitmaps, &bitmap);
 
@@ -259,9 +282,17 @@ void al_convert_mask_to_alpha(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR mask_color)
    ALLEGRO_COLOR pixel;
    ALLEGRO_COLOR alpha_pixel;
    ALLEGRO_STATE state;
+   bool hold;
+
+   /* Held drawing is flushed to the target, which is about to change. */
+   hold = al_is_bitmap_drawing_held();
+   if (hold)
+      al_hold_bitmap_drawing(false);
 
    if (!(lr = al_lock_bitmap(bitmap, ALLEGRO_PIXEL_FORMAT_ANY, 0))) {
       ALLEGRO_ERROR("Couldn't lock bitmap.");
+      if (hold)
+         al_hold_bitmap_drawing(true);
       return;
    }
 
@@ -282,6 +313,9 @@ void al_convert_mask_to_alpha(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR mask_color)
    al_unlock_bitmap(bitmap);
 
    al_restore_state(&state);
+
+   if (hold)
+      al_hold_bitmap_drawing(true);
 }
 
 
@@ -788,6 +822,166 @@ void _al_convert_bitmap_data(
 }
 
 
+/* _al_get_mipmap_level_count:
+ *  Returns the number of levels in a full mipmap chain for a bitmap of
+ *  the given size, counting the bitmap itself.
+ */
+int _al_get_mipmap_level_count(int w, int h)
+{
+   int size = _ALLEGRO_MAX(w, h);
+   int levels = 1;
+
+   while (size > 1) {
+      size >>= 1;
+      levels++;
+   }
+   return levels;
+}
+
+
+/* _al_get_mipmap_level_size:
+ *  Returns the size in pixels of a mipmap level of the bitmap, and the
+ *  size of its data in the bitmap's format as rows of row_bytes each.
+ *  For compressed formats a row is a row of blocks.
+ */
+void _al_get_mipmap_level_size(ALLEGRO_BITMAP *bitmap, int level,
+   int *w, int *h, int *row_bytes, int *rows)
+{
+   int format = al_get_bitmap_format(bitmap);
+   int block_width = al_get_pixel_block_width(format);
+   int block_height = al_get_pixel_block_height(format);
+
+   *w = _ALLEGRO_MAX(1, bitmap->w >> level);
+   *h = _ALLEGRO_MAX(1, bitmap->h >> level);
+   *row_bytes = (*w + block_width - 1) / block_width *
+      al_get_pixel_block_size(format);
+   *rows = (*h + block_height - 1) / block_height;
+}
+
+
+
+/* store_mipmap_level:
+ *  Stores a copy of a mipmap level given in the format src_format, which
+ *  must be the bitmap's own format if that is compressed. The level must
+ *  already exist or be the one after the last.
+ */
+static bool store_mipmap_level(ALLEGRO_BITMAP *bitmap, int level,
+   const void *data, int src_format, int pitch)
+{
+   int format = al_get_bitmap_format(bitmap);
+   int w, h, row_bytes, rows, y;
+   unsigned char *buf;
+
+   ASSERT(level >= 1 && level <= bitmap->num_mipmaps + 1);
+
+   _al_get_mipmap_level_size(bitmap, level, &w, &h, &row_bytes, &rows);
+   buf = al_malloc(row_bytes * rows);
+   if (!buf)
+      return false;
+
+   if (src_format == format) {
+      for (y = 0; y < rows; y++) {
+         memcpy(buf + y * row_bytes, (const char *)data + y * pitch,
+            row_bytes);
+      }
+   }
+   else {
+      _al_convert_bitmap_data(data, src_format, pitch, buf, format, row_bytes,
+         0, 0, 0, 0, w, h);
+   }
+
+   if (level > bitmap->num_mipmaps) {
+      unsigned char **mipmaps = al_realloc(bitmap->mipmaps,
+         level * sizeof *mipmaps);
+      if (!mipmaps) {
+         al_free(buf);
+         return false;
+      }
+      bitmap->mipmaps = mipmaps;
+      bitmap->num_mipmaps = level;
+   }
+   else {
+      al_free(bitmap->mipmaps[level - 1]);
+   }
+   bitmap->mipmaps[level - 1] = buf;
+
+   return true;
+}
+
+
+
+/* copy_mipmaps:
+ *  Gives dst the stored mipmap levels of src, converted to its format.
+ *  Levels of compressed bitmaps are only kept in the same format.
+ */
+static void copy_mipmaps(ALLEGRO_BITMAP *src, ALLEGRO_BITMAP *dst)
+{
+   int src_format = al_get_bitmap_format(src);
+   int dst_format = al_get_bitmap_format(dst);
+   int level;
+
+   if (src_format != dst_format &&
+         (_al_pixel_format_is_compressed(src_format) ||
+          _al_pixel_format_is_compressed(dst_format)))
+      return;
+
+   for (level = 1; level <= src->num_mipmaps; level++) {
+      int w, h, row_bytes, rows;
+      _al_get_mipmap_level_size(src, level, &w, &h, &row_bytes, &rows);
+      if (!store_mipmap_level(dst, level, src->mipmaps[level - 1], src_format,
+            row_bytes))
+         break;
+   }
+}
+
+
+
+/* Function: al_set_bitmap_mipmap_level
+ */
+bool al_set_bitmap_mipmap_level(ALLEGRO_BITMAP *bitmap, int level,
+   const void *data, int pitch)
+{
+   ASSERT(bitmap);
+   ASSERT(level >= 1);
+
+   if (bitmap->parent || level < 1)
+      return false;
+
+   if (!data) {
+      if (level > bitmap->num_mipmaps)
+         return true;
+      free_mipmaps(bitmap, level);
+   }
+   else {
+      if (level > bitmap->num_mipmaps + 1 ||
+            level >= _al_get_mipmap_level_count(bitmap->w, bitmap->h))
+         return false;
+      if (!store_mipmap_level(bitmap, level, data,
+            al_get_bitmap_format(bitmap), pitch))
+         return false;
+   }
+
+   if (bitmap->vt && bitmap->vt->update_mipmaps)
+      bitmap->vt->update_mipmaps(bitmap, level);
+
+   return true;
+}
+
+
+
+/* Function: al_get_bitmap_mipmap_levels
+ */
+int al_get_bitmap_mipmap_levels(ALLEGRO_BITMAP *bitmap)
+{
+   ASSERT(bitmap);
+
+   if (bitmap->parent)
+      bitmap = bitmap->parent;
+   return bitmap->num_mipmaps;
+}
+
+
+
 /* Function: al_clone_bitmap
  */
 ALLEGRO_BITMAP *al_clone_bitmap(ALLEGRO_BITMAP *bitmap)
@@ -798,6 +992,8 @@ ALLEGRO_BITMAP *al_clone_bitmap(ALLEGRO_BITMAP *bitmap)
    clone = al_create_bitmap(bitmap->w, bitmap->h);
    if (!clone)
       return NULL;
+   /* Before the pixels, so a texture gets the stored levels right away. */
+   copy_mipmaps(bitmap, clone);
    if (!transfer_bitmap_data(bitmap, clone)) {
       al_destroy_bitmap(clone);
       return NULL;
@@ -0,0 +1,555 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Bitmap atlases.
+ *
+ *      Bitmaps are copied into a few large pages and handed back as
+ *      sub-bitmaps of them, so drawing them doesn't switch textures.
+ *      The free space of each page is kept as a list of maximal free
+ *      rectangles (MaxRects), which also allows removing bitmaps again.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_dtor.h"
+#include "allegro5/internal/aintern_system.h"
+#include "allegro5/internal/aintern_vector.h"
+
+ALLEGRO_DEBUG_CHANNEL("atlas")
+
+
+typedef struct ATLAS_RECT
+{
+   int x, y, w, h;
+} ATLAS_RECT;
+
+typedef struct ATLAS_PAGE
+{
+   ALLEGRO_BITMAP *bitmap;
+   _AL_VECTOR free_rects;  /* of ATLAS_RECT */
+   int num_bitmaps;
+   int64_t used_pixels;
+} ATLAS_PAGE;
+
+typedef struct ATLAS_ENTRY
+{
+   ALLEGRO_BITMAP *bitmap;
+   ATLAS_PAGE *page;
+   /* The area taken in the page, including the padding to the right and
+    * bottom.
+    */
+   ATLAS_RECT rect;
+} ATLAS_ENTRY;
+
+struct ALLEGRO_BITMAP_ATLAS
+{
+   int page_w, page_h;
+   int padding;
+   int bitmap_format;
+   int bitmap_flags;
+   _AL_VECTOR pages;    /* of ATLAS_PAGE * */
+   _AL_VECTOR entries;  /* of ATLAS_ENTRY */
+   _AL_LIST_ITEM *dtor_item;
+};
+
+
+static bool rect_contains(const ATLAS_RECT *a, const ATLAS_RECT *b)
+{
+   return b->x >= a->x && b->y >= a->y &&
+      b->x + b->w <= a->x + a->w && b->y + b->h <= a->y + a->h;
+}
+
+
+static bool rects_intersect(const ATLAS_RECT *a, const ATLAS_RECT *b)
+{
+   return a->x < b->x + b->w && b->x < a->x + a->w &&
+      a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+
+static void add_free_rect(ATLAS_PAGE *page, int x, int y, int w, int h)
+{
+   ATLAS_RECT *r = _al_vector_alloc_back(&page->free_rects);
+   if (r) {
+      r->x = x;
+      r->y = y;
+      r->w = w;
+      r->h = h;
+   }
+}
+
+
+/* Removes free rectangles contained in others. */
+static void prune_free_rects(ATLAS_PAGE *page)
+{
+   unsigned int i, j;
+
+   for (i = 0; i < _al_vector_size(&page->free_rects); i++) {
+      for (j = i + 1; j < _al_vector_size(&page->free_rects); j++) {
+         ATLAS_RECT *a = _al_vector_ref(&page->free_rects, i);
+         ATLAS_RECT *b = _al_vector_ref(&page->free_rects, j);
+         if (rect_contains(b, a)) {
+            _al_vector_delete_at(&page->free_rects, i);
+            i--;
+            break;
+         }
+         if (rect_contains(a, b)) {
+            _al_vector_delete_at(&page->free_rects, j);
+            j--;
+         }
+      }
+   }
+}
+
+
+/* Joins free rectangles which share a whole edge, to undo some of the
+ * fragmentation left by removed bitmaps.
+ */
+static void merge_free_rects(ATLAS_PAGE *page)
+{
+   bool merged = true;
+   unsigned int i, j;
+
+   while (merged) {
+      merged = false;
+      for (i = 0; i < _al_vector_size(&page->free_rects); i++) {
+         for (j = i + 1; j < _al_vector_size(&page->free_rects); j++) {
+            ATLAS_RECT *a = _al_vector_ref(&page->free_rects, i);
+            ATLAS_RECT *b = _al_vector_ref(&page->free_rects, j);
+            if (a->x == b->x && a->w == b->w &&
+                  (a->y + a->h == b->y || b->y + b->h == a->y)) {
+               a->y = _ALLEGRO_MIN(a->y, b->y);
+               a->h += b->h;
+            }
+            else if (a->y == b->y && a->h == b->h &&
+                  (a->x + a->w == b->x || b->x + b->w == a->x)) {
+               a->x = _ALLEGRO_MIN(a->x, b->x);
+               a->w += b->w;
+            }
+            else {
+               continue;
+            }
+            _al_vector_delete_at(&page->free_rects, j);
+            merged = true;
+            break;
+         }
+      }
+   }
+}
+
+
+/* Splits all free rectangles overlapping the used one into the parts
+ * left free around it.
+ */
+static void place_rect(ATLAS_PAGE *page, const ATLAS_RECT *used)
+{
+   unsigned int n = _al_vector_size(&page->free_rects);
+   unsigned int i;
+
+   for (i = 0; i < n; i++) {
+      ATLAS_RECT fr = *(ATLAS_RECT *)_al_vector_ref(&page->free_rects, i);
+
+      if (!rects_intersect(&fr, used))
+         continue;
+
+      if (used->x > fr.x)
+         add_free_rect(page, fr.x, fr.y, used->x - fr.x, fr.h);
+      if (used->x + used->w < fr.x + fr.w)
+         add_free_rect(page, used->x + used->w, fr.y,
+            fr.x + fr.w - used->x - used->w, fr.h);
+      if (used->y > fr.y)
+         add_free_rect(page, fr.x, fr.y, fr.w, used->y - fr.y);
+      if (used->y + used->h < fr.y + fr.h)
+         add_free_rect(page, fr.x, used->y + used->h,
+            fr.w, fr.y + fr.h - used->y - used->h);
+
+      _al_vector_delete_at(&page->free_rects, i);
+      i--;
+      n--;
+   }
+
+   prune_free_rects(page);
+}
+
+
+/* Finds the free rectangle of the page leaving the shortest side over
+ * (best short side fit).  Returns false if none is large enough.
+ */
+static bool find_position(ATLAS_PAGE *page, int w, int h, int *best_short,
+   int *best_long, int *x, int *y)
+{
+   bool found = false;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&page->free_rects); i++) {
+      ATLAS_RECT *fr = _al_vector_ref(&page->free_rects, i);
+      int dw = fr->w - w;
+      int dh = fr->h - h;
+      int s, l;
+
+      if (dw < 0 || dh < 0)
+         continue;
+
+      s = _ALLEGRO_MIN(dw, dh);
+      l = _ALLEGRO_MAX(dw, dh);
+      if (s < *best_short || (s == *best_short && l < *best_long)) {
+         *best_short = s;
+         *best_long = l;
+         *x = fr->x;
+         *y = fr->y;
+         found = true;
+      }
+   }
+
+   return found;
+}
+
+
+static ATLAS_PAGE *create_page(ALLEGRO_BITMAP_ATLAS *atlas)
+{
+   ALLEGRO_STATE state;
+   ATLAS_PAGE *page, **slot;
+
+   page = al_calloc(1, sizeof *page);
+   if (!page)
+      return NULL;
+
+   /* The pages are destroyed with the atlas. */
+   _al_push_destructor_owner();
+   al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS |
+      ALLEGRO_STATE_TARGET_BITMAP);
+   al_set_new_bitmap_format(atlas->bitmap_format);
+   al_set_new_bitmap_flags(atlas->bitmap_flags);
+   page->bitmap = al_create_bitmap(atlas->page_w, atlas->page_h);
+   if (page->bitmap) {
+      al_set_target_bitmap(page->bitmap);
+      al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+   }
+   al_restore_state(&state);
+   _al_pop_destructor_owner();
+
+   slot = _al_vector_alloc_back(&atlas->pages);
+   if (!page->bitmap || !slot) {
+      ALLEGRO_ERROR("Unable to create a %dx%d atlas page.\n",
+         atlas->page_w, atlas->page_h);
+      if (slot)
+         _al_vector_delete_at(&atlas->pages, _al_vector_size(&atlas->pages) - 1);
+      if (page->bitmap)
+         al_destroy_bitmap(page->bitmap);
+      al_free(page);
+      return NULL;
+   }
+   *slot = page;
+
+   _al_vector_init(&page->free_rects, sizeof(ATLAS_RECT));
+   add_free_rect(page, atlas->padding, atlas->padding,
+      atlas->page_w - atlas->padding, atlas->page_h - atlas->padding);
+   return page;
+}
+
+
+static void destroy_page(ATLAS_PAGE *page)
+{
+   al_destroy_bitmap(page->bitmap);
+   _al_vector_free(&page->free_rects);
+   al_free(page);
+}
+
+
+/* Function: al_create_bitmap_atlas
+ */
+ALLEGRO_BITMAP_ATLAS *al_create_bitmap_atlas(int page_w, int page_h,
+   int padding)
+{
+   ALLEGRO_BITMAP_ATLAS *atlas;
+
+   ASSERT(page_w > 0);
+   ASSERT(page_h > 0);
+   ASSERT(padding >= 0);
+
+   if (2 * padding >= page_w || 2 * padding >= page_h)
+      return NULL;
+
+   atlas = al_calloc(1, sizeof *atlas);
+   if (!atlas)
+      return NULL;
+
+   atlas->page_w = page_w;
+   atlas->page_h = page_h;
+   atlas->padding = padding;
+   atlas->bitmap_format = al_get_new_bitmap_format();
+   atlas->bitmap_flags = al_get_new_bitmap_flags();
+   _al_vector_init(&atlas->pages, sizeof(ATLAS_PAGE *));
+   _al_vector_init(&atlas->entries, sizeof(ATLAS_ENTRY));
+
+   atlas->dtor_item = _al_register_destructor(_al_dtor_list, "bitmap_atlas",
+      atlas, (void (*)(void *))al_destroy_bitmap_atlas);
+
+   return atlas;
+}
+
+
+/* Function: al_destroy_bitmap_atlas
+ */
+void al_destroy_bitmap_atlas(ALLEGRO_BITMAP_ATLAS *atlas)
+{
+   unsigned int i;
+
+   if (!atlas)
+      return;
+
+   _al_unregister_destructor(_al_dtor_list, atlas->dtor_item);
+
+   for (i = 0; i < _al_vector_size(&atlas->entries); i++) {
+      ATLAS_ENTRY *e = _al_vector_ref(&atlas->entries, i);
+      al_destroy_bitmap(e->bitmap);
+   }
+   for (i = 0; i < _al_vector_size(&atlas->pages); i++) {
+      ATLAS_PAGE **page = _al_vector_ref(&atlas->pages, i);
+      destroy_page(*page);
+   }
+
+   _al_vector_free(&atlas->entries);
+   _al_vector_free(&atlas->pages);
+   al_free(atlas);
+}
+
+
+/* Function: al_add_bitmap_to_atlas
+ */
+ALLEGRO_BITMAP *al_add_bitmap_to_atlas(ALLEGRO_BITMAP_ATLAS *atlas,
+   ALLEGRO_BITMAP *bitmap)
+{
+   int w = al_get_bitmap_width(bitmap);
+   int h = al_get_bitmap_height(bitmap);
+   int best_short = INT_MAX, best_long = INT_MAX;
+   ATLAS_PAGE *page = NULL;
+   ATLAS_ENTRY *entry;
+   ATLAS_RECT rect;
+   ALLEGRO_BITMAP *sub;
+   ALLEGRO_STATE state;
+   ALLEGRO_TRANSFORM ident;
+   unsigned int i;
+   bool hold;
+
+   ASSERT(atlas);
+   ASSERT(bitmap);
+
+   rect.w = w + atlas->padding;
+   rect.h = h + atlas->padding;
+   if (rect.w > atlas->page_w - atlas->padding ||
+         rect.h > atlas->page_h - atlas->padding) {
+      ALLEGRO_WARN("Bitmap of %dx%d does not fit into the atlas pages.\n",
+         w, h);
+      return NULL;
+   }
+
+   /* New pages are cleared and the bitmap is copied with the page as the
+    * target, which isn't allowed while drawing is held.  Anything already
+    * held belongs to the old target, so flush it first.
+    */
+   hold = al_is_bitmap_drawing_held();
+   if (hold)
+      al_hold_bitmap_drawing(false);
+
+   for (i = 0; i < _al_vector_size(&atlas->pages); i++) {
+      ATLAS_PAGE **p = _al_vector_ref(&atlas->pages, i);
+      if (find_position(*p, rect.w, rect.h, &best_short, &best_long,
+            &rect.x, &rect.y)) {
+         page = *p;
+      }
+   }
+
+   if (!page) {
+      page = create_page(atlas);
+      if (!page) {
+         if (hold)
+            al_hold_bitmap_drawing(true);
+         return NULL;
+      }
+      find_position(page, rect.w, rect.h, &best_short, &best_long,
+         &rect.x, &rect.y);
+   }
+
+   _al_push_destructor_owner();
+   sub = al_create_sub_bitmap(page->bitmap, rect.x, rect.y, w, h);
+   _al_pop_destructor_owner();
+   entry = sub ? _al_vector_alloc_back(&atlas->entries) : NULL;
+   if (!entry) {
+      if (sub)
+         al_destroy_bitmap(sub);
+      if (page->num_bitmaps == 0) {
+         _al_vector_find_and_delete(&atlas->pages, &page);
+         destroy_page(page);
+      }
+      if (hold)
+         al_hold_bitmap_drawing(true);
+      return NULL;
+   }
+
+   entry->bitmap = sub;
+   entry->page = page;
+   entry->rect = rect;
+   place_rect(page, &rect);
+   page->num_bitmaps++;
+   page->used_pixels += (int64_t)w * h;
+
+   al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP |
+      ALLEGRO_STATE_BLENDER | ALLEGRO_STATE_TRANSFORM);
+   al_set_target_bitmap(page->bitmap);
+   al_identity_transform(&ident);
+   al_use_transform(&ident);
+   al_set_blender(ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
+   al_draw_bitmap(bitmap, rect.x, rect.y, 0);
+   al_restore_state(&state);
+
+   if (hold)
+      al_hold_bitmap_drawing(true);
+
+   return sub;
+}
+
+
+static int compare_by_size(const void *a, const void *b)
+{
+   ALLEGRO_BITMAP *ba = **(ALLEGRO_BITMAP ***)a;
+   ALLEGRO_BITMAP *bb = **(ALLEGRO_BITMAP ***)b;
+   int wa = al_get_bitmap_width(ba), ha = al_get_bitmap_height(ba);
+   int wb = al_get_bitmap_width(bb), hb = al_get_bitmap_height(bb);
+   int sa = _ALLEGRO_MAX(wa, ha), sb = _ALLEGRO_MAX(wb, hb);
+
+   if (sa != sb)
+      return sb - sa;
+   if (wa * ha != wb * hb)
+      return wb * hb - wa * ha;
+   /* Keep the order stable. */
+   return *(ALLEGRO_BITMAP ***)a < *(ALLEGRO_BITMAP ***)b ? -1 : 1;
+}
+
+
+/* Function: al_add_bitmaps_to_atlas
+ */
+int al_add_bitmaps_to_atlas(ALLEGRO_BITMAP_ATLAS *atlas, int num_bitmaps,
+   ALLEGRO_BITMAP **bitmaps, ALLEGRO_BITMAP **subs)
+{
+   ALLEGRO_BITMAP ***order;
+   int num_added = 0;
+   int i;
+
+   ASSERT(atlas);
+   ASSERT(num_bitmaps >= 0);
+
+   /* Placing the largest bitmaps first packs much tighter. */
+   order = al_malloc(num_bitmaps * sizeof(*order));
+   if (!order)
+      return 0;
+   for (i = 0; i < num_bitmaps; i++)
+      order[i] = &bitmaps[i];
+   qsort(order, num_bitmaps, sizeof(*order), compare_by_size);
+
+   for (i = 0; i < num_bitmaps; i++) {
+      int index = order[i] - bitmaps;
+      subs[index] = al_add_bitmap_to_atlas(atlas, bitmaps[index]);
+      if (subs[index])
+         num_added++;
+   }
+
+   al_free(order);
+   return num_added;
+}
+
+
+/* Function: al_remove_bitmap_from_atlas
+ */
+bool al_remove_bitmap_from_atlas(ALLEGRO_BITMAP_ATLAS *atlas,
+   ALLEGRO_BITMAP *bitmap)
+{
+   ATLAS_ENTRY *entry = NULL;
+   ATLAS_PAGE *page;
+   ALLEGRO_STATE state;
+   unsigned int i;
+   bool hold;
+
+   ASSERT(atlas);
+
+   for (i = 0; i < _al_vector_size(&atlas->entries); i++) {
+      entry = _al_vector_ref(&atlas->entries, i);
+      if (entry->bitmap == bitmap)
+         break;
+   }
+   if (i == _al_vector_size(&atlas->entries))
+      return false;
+
+   page = entry->page;
+   page->num_bitmaps--;
+   page->used_pixels -= (int64_t)al_get_bitmap_width(bitmap) *
+      al_get_bitmap_height(bitmap);
+   al_destroy_bitmap(bitmap);
+
+   if (page->num_bitmaps == 0) {
+      _al_vector_find_and_delete(&atlas->pages, &page);
+      destroy_page(page);
+   }
+   else {
+      /* Clear the area, as the padding of later bitmaps must stay
+       * transparent.  The target can't change while drawing is held.
+       */
+      hold = al_is_bitmap_drawing_held();
+      if (hold)
+         al_hold_bitmap_drawing(false);
+      al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP);
+      al_set_target_bitmap(page->bitmap);
+      al_set_clipping_rectangle(entry->rect.x, entry->rect.y,
+         entry->rect.w, entry->rect.h);
+      al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+      al_reset_clipping_rectangle();
+      al_restore_state(&state);
+      if (hold)
+         al_hold_bitmap_drawing(true);
+
+      add_free_rect(page, entry->rect.x, entry->rect.y,
+         entry->rect.w, entry->rect.h);
+      merge_free_rects(page);
+      prune_free_rects(page);
+   }
+
+   _al_vector_delete_at(&atlas->entries, i);
+   return true;
+}
+
+
+/* Function: al_get_bitmap_atlas_stats
+ */
+void al_get_bitmap_atlas_stats(ALLEGRO_BITMAP_ATLAS *atlas,
+   ALLEGRO_BITMAP_ATLAS_STATS *stats)
+{
+   unsigned int i;
+
+   ASSERT(atlas);
+   ASSERT(stats);
+
+   stats->num_pages = _al_vector_size(&atlas->pages);
+   stats->num_bitmaps = _al_vector_size(&atlas->entries);
+   stats->used_pixels = 0;
+   stats->total_pixels = (int64_t)stats->num_pages *
+      atlas->page_w * atlas->page_h;
+   stats->num_free_rects = 0;
+   for (i = 0; i < _al_vector_size(&atlas->pages); i++) {
+      ATLAS_PAGE **page = _al_vector_ref(&atlas->pages, i);
+      stats->used_pixels += (*page)->used_pixels;
+      stats->num_free_rects += _al_vector_size(&(*page)->free_rects);
+   }
+}
+
+
+/* vim: set sts=3 sw=3 et: */
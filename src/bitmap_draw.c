@@ -36,7 +36,8 @@ static void _bitmap_drawer(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint,
    /* If destination is memory, do a memory blit */
    if (al_get_bitmap_flags(dest) & ALLEGRO_MEMORY_BITMAP ||
        _al_pixel_format_is_compressed(al_get_bitmap_format(dest))) {
-      _al_draw_bitmap_region_memory(bitmap, tint, sx, sy, sw, sh, 0, 0, flags);
+      if (!_al_hold_bitmap_region_memory(bitmap, tint, sx, sy, sw, sh, flags))
+         _al_draw_bitmap_region_memory(bitmap, tint, sx, sy, sw, sh, 0, 0, flags);
    }
    else {
       /* if source is memory or incompatible */
@@ -17,7 +17,42 @@
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_exitfunc.h"
 #include "allegro5/internal/aintern_pixels.h"
+#include "allegro5/internal/aintern_thread.h"
+
+
+/* A region of a memory bitmap locked with al_lock_bitmap_region_concurrent.
+ * The locks of a bitmap are kept in a list so new ones can be checked for
+ * overlap; the list is protected by concurrent_lock_mutex.
+ */
+struct ALLEGRO_BITMAP_LOCK
+{
+   ALLEGRO_BITMAP *bitmap;
+   ALLEGRO_BITMAP_LOCK *next;
+   int x, y, w, h;
+   int flags;
+   bool converted;   /* region.data is our own conversion buffer */
+   ALLEGRO_LOCKED_REGION region;
+};
+
+static _AL_MUTEX concurrent_lock_mutex = _AL_MUTEX_UNINITED;
+
+
+static void shutdown_bitmap_locks(void)
+{
+   _al_mutex_destroy(&concurrent_lock_mutex);
+}
+
+
+/* _al_init_bitmap_locks:
+ *  Initialises the mutex used by concurrent region locks.
+ */
+void _al_init_bitmap_locks(void)
+{
+   _al_mutex_init(&concurrent_lock_mutex);
+   _al_add_exit_func(shutdown_bitmap_locks, "shutdown_bitmap_locks");
+}
 
 
 /* Function: al_lock_bitmap_region
@@ -48,8 +83,22 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
       bitmap = bitmap->parent;
    }
 
-   if (bitmap->locked)
+   if (bitmap_flags & ALLEGRO_MEMORY_BITMAP) {
+      /* Claim the bitmap under the mutex, or a concurrent lock taken by
+       * another thread in the meantime could go unnoticed.  Only memory
+       * bitmaps can have those.
+       */
+      _al_mutex_lock(&concurrent_lock_mutex);
+      if (bitmap->locked || bitmap->concurrent_locks) {
+         _al_mutex_unlock(&concurrent_lock_mutex);
+         return NULL;
+      }
+      bitmap->locked = true;
+      _al_mutex_unlock(&concurrent_lock_mutex);
+   }
+   else if (bitmap->locked) {
       return NULL;
+   }
 
    if (!(bitmap_flags & ALLEGRO_MEMORY_BITMAP) &&
          !(flags & ALLEGRO_LOCK_READONLY))
@@ -80,6 +129,9 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
    if (bitmap_flags & ALLEGRO_MEMORY_BITMAP) {
       int f = _al_get_real_pixel_format(al_get_current_display(), format);
       if (f < 0) {
+         _al_mutex_lock(&concurrent_lock_mutex);
+         bitmap->locked = false;
+         _al_mutex_unlock(&concurrent_lock_mutex);
          return NULL;
       }
       ASSERT(bitmap->memory);
@@ -92,7 +144,7 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
       }
       else {
          bitmap->locked_region.pitch = al_get_pixel_size(f) * wc;
-         bitmap->locked_region.data = al_malloc(bitmap->locked_region.pitch*hc);
+         bitmap->locked_region.data = _al_alloc_lock_buffer(bitmap->locked_region.pitch*hc);
          bitmap->locked_region.format = f;
          bitmap->locked_region.pixel_size = al_get_pixel_size(f);
          if (!(bitmap->lock_flags & ALLEGRO_LOCK_WRITEONLY)) {
@@ -154,8 +206,12 @@ void al_unlock_bitmap(ALLEGRO_BITMAP *bitmap)
                bitmap->memory, bitmap_format, bitmap->pitch,
                0, 0, bitmap->lock_x, bitmap->lock_y, bitmap->lock_w, bitmap->lock_h);
          }
-         al_free(bitmap->locked_region.data);
+         _al_free_lock_buffer(bitmap->locked_region.data);
       }
+      _al_mutex_lock(&concurrent_lock_mutex);
+      bitmap->locked = false;
+      _al_mutex_unlock(&concurrent_lock_mutex);
+      return;
    }
 
    bitmap->locked = false;
@@ -166,7 +222,148 @@ void al_unlock_bitmap(ALLEGRO_BITMAP *bitmap)
  */
 bool al_is_bitmap_locked(ALLEGRO_BITMAP *bitmap)
 {
-   return bitmap->locked;
+   ALLEGRO_BITMAP *owner = bitmap->parent ? bitmap->parent : bitmap;
+   return bitmap->locked || owner->concurrent_locks;
+}
+
+
+static bool regions_overlap(const ALLEGRO_BITMAP_LOCK *a,
+   int x, int y, int w, int h)
+{
+   return a->x < x + w && x < a->x + a->w && a->y < y + h && y < a->y + a->h;
+}
+
+
+/* Function: al_lock_bitmap_region_concurrent
+ */
+ALLEGRO_BITMAP_LOCK *al_lock_bitmap_region_concurrent(ALLEGRO_BITMAP *bitmap,
+   int x, int y, int width, int height, int format, int flags)
+{
+   ALLEGRO_BITMAP_LOCK *lock;
+   ALLEGRO_BITMAP_LOCK *other;
+   int bitmap_format = al_get_bitmap_format(bitmap);
+   int pixel_size = al_get_pixel_size(bitmap_format);
+   int f;
+   ASSERT(x >= 0);
+   ASSERT(y >= 0);
+   ASSERT(width >= 0);
+   ASSERT(height >= 0);
+
+   if (!(al_get_bitmap_flags(bitmap) & ALLEGRO_MEMORY_BITMAP))
+      return NULL;
+
+   f = _al_get_real_pixel_format(al_get_current_display(), format);
+   if (f < 0 || _al_pixel_format_is_video_only(f))
+      return NULL;
+
+   /* For sub-bitmaps */
+   if (bitmap->parent) {
+      x += bitmap->xofs;
+      y += bitmap->yofs;
+      bitmap = bitmap->parent;
+   }
+
+   ASSERT(x+width <= bitmap->w);
+   ASSERT(y+height <= bitmap->h);
+   ASSERT(bitmap->memory);
+
+   lock = al_calloc(1, sizeof *lock);
+   if (!lock)
+      return NULL;
+   lock->bitmap = bitmap;
+   lock->x = x;
+   lock->y = y;
+   lock->w = width;
+   lock->h = height;
+   lock->flags = flags;
+
+   /* Only read-only locks may overlap each other. */
+   _al_mutex_lock(&concurrent_lock_mutex);
+   if (bitmap->locked) {
+      _al_mutex_unlock(&concurrent_lock_mutex);
+      al_free(lock);
+      return NULL;
+   }
+   for (other = bitmap->concurrent_locks; other; other = other->next) {
+      if (regions_overlap(other, x, y, width, height) &&
+            !(flags == ALLEGRO_LOCK_READONLY &&
+               other->flags == ALLEGRO_LOCK_READONLY)) {
+         _al_mutex_unlock(&concurrent_lock_mutex);
+         al_free(lock);
+         return NULL;
+      }
+   }
+   lock->next = bitmap->concurrent_locks;
+   bitmap->concurrent_locks = lock;
+   _al_mutex_unlock(&concurrent_lock_mutex);
+
+   if (format == ALLEGRO_PIXEL_FORMAT_ANY || bitmap_format == format ||
+         bitmap_format == f) {
+      lock->region.data = bitmap->memory + bitmap->pitch * y + x * pixel_size;
+      lock->region.format = bitmap_format;
+      lock->region.pitch = bitmap->pitch;
+      lock->region.pixel_size = pixel_size;
+   }
+   else {
+      lock->region.pitch = al_get_pixel_size(f) * width;
+      lock->region.data = _al_alloc_lock_buffer(lock->region.pitch * height);
+      lock->region.format = f;
+      lock->region.pixel_size = al_get_pixel_size(f);
+      lock->converted = true;
+      if (!lock->region.data) {
+         al_unlock_bitmap_region_concurrent(lock);
+         return NULL;
+      }
+      if (!(flags & ALLEGRO_LOCK_WRITEONLY)) {
+         _al_convert_bitmap_data(
+            bitmap->memory, bitmap_format, bitmap->pitch,
+            lock->region.data, f, lock->region.pitch,
+            x, y, 0, 0, width, height);
+      }
+   }
+
+   return lock;
+}
+
+
+/* Function: al_get_bitmap_lock_region
+ */
+ALLEGRO_LOCKED_REGION *al_get_bitmap_lock_region(ALLEGRO_BITMAP_LOCK *lock)
+{
+   ASSERT(lock);
+   return &lock->region;
+}
+
+
+/* Function: al_unlock_bitmap_region_concurrent
+ */
+void al_unlock_bitmap_region_concurrent(ALLEGRO_BITMAP_LOCK *lock)
+{
+   ALLEGRO_BITMAP *bitmap;
+   ALLEGRO_BITMAP_LOCK **link;
+
+   if (!lock)
+      return;
+
+   bitmap = lock->bitmap;
+
+   if (lock->converted && lock->region.data) {
+      if (!(lock->flags & ALLEGRO_LOCK_READONLY)) {
+         _al_convert_bitmap_data(
+            lock->region.data, lock->region.format, lock->region.pitch,
+            bitmap->memory, al_get_bitmap_format(bitmap), bitmap->pitch,
+            0, 0, lock->x, lock->y, lock->w, lock->h);
+      }
+      _al_free_lock_buffer(lock->region.data);
+   }
+
+   _al_mutex_lock(&concurrent_lock_mutex);
+   for (link = &bitmap->concurrent_locks; *link != lock; link = &(*link)->next)
+      ASSERT(*link);
+   *link = lock->next;
+   _al_mutex_unlock(&concurrent_lock_mutex);
+
+   al_free(lock);
 }
 
 /* Function: al_lock_bitmap_blocked
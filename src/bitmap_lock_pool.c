@@ -0,0 +1,240 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Pool of staging buffers for bitmap locks.
+ *
+ *      Locking a bitmap in a format other than its own, or locking a
+ *      video bitmap, needs a temporary buffer for the pixels. Programs
+ *      which lock every frame would allocate and free the same few
+ *      megabytes over and over, so freed buffers are kept here, binned
+ *      by size, up to a configurable number of bytes.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_exitfunc.h"
+#include "allegro5/internal/aintern_thread.h"
+
+
+/* Bucket sizes go up in quarter octaves from 4 KiB, so a buffer
+ * is at most 25% larger than requested. Larger requests are not pooled.
+ */
+#define MIN_BUCKET_SHIFT   12
+#define MAX_BUCKET_SHIFT   28
+#define STEPS_PER_OCTAVE   4
+#define NUM_BUCKETS        ((MAX_BUCKET_SHIFT - MIN_BUCKET_SHIFT) * STEPS_PER_OCTAVE)
+#define NO_BUCKET          -1
+
+#define DEFAULT_POOL_SIZE  (32 << 20)
+
+/* Every buffer is preceded by a header remembering its bucket, padded so
+ * the pixels stay as aligned as al_malloc made them.
+ */
+typedef union BUFFER_HEADER
+{
+   struct {
+      int bucket;
+      union BUFFER_HEADER *next;
+   } h;
+   double align[2];
+} BUFFER_HEADER;
+
+static _AL_MUTEX pool_mutex = _AL_MUTEX_UNINITED;
+
+static struct {
+   size_t bucket_size[NUM_BUCKETS];
+   BUFFER_HEADER *free_list[NUM_BUCKETS];
+   size_t max_bytes;
+   ALLEGRO_LOCK_BUFFER_POOL_STATS stats;
+} pool;
+
+
+/* find_bucket:
+ *  Returns the smallest bucket holding at least size bytes, or NO_BUCKET.
+ */
+static int find_bucket(size_t size)
+{
+   int lo = 0;
+   int hi = NUM_BUCKETS;
+
+   if (size > pool.bucket_size[NUM_BUCKETS - 1])
+      return NO_BUCKET;
+
+   while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (pool.bucket_size[mid] < size)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+
+/* trim_pool:
+ *  Frees cached buffers, largest first, until the pool is within its size.
+ *  The pool mutex must be held.
+ */
+static void trim_pool(void)
+{
+   int i;
+
+   for (i = NUM_BUCKETS - 1; i >= 0; i--) {
+      while (pool.free_list[i] && pool.stats.cached_bytes > pool.max_bytes) {
+         BUFFER_HEADER *header = pool.free_list[i];
+         pool.free_list[i] = header->h.next;
+         pool.stats.cached_bytes -= pool.bucket_size[i];
+         pool.stats.cached_buffers--;
+         pool.stats.releases++;
+         al_free(header);
+      }
+   }
+}
+
+
+static void shutdown_lock_buffer_pool(void)
+{
+   _al_mutex_lock(&pool_mutex);
+   pool.max_bytes = 0;
+   trim_pool();
+   _al_mutex_unlock(&pool_mutex);
+   _al_mutex_destroy(&pool_mutex);
+}
+
+
+/* _al_init_lock_buffer_pool:
+ *  Sets up the pool. Its size comes from the lock_buffer_pool_size option
+ *  in the [graphics] section of the system config.
+ */
+void _al_init_lock_buffer_pool(void)
+{
+   const char *value = al_get_config_value(al_get_system_config(),
+      "graphics", "lock_buffer_pool_size");
+   int i;
+
+   for (i = 0; i < NUM_BUCKETS; i++) {
+      int octave = MIN_BUCKET_SHIFT + i / STEPS_PER_OCTAVE;
+      int step = i % STEPS_PER_OCTAVE;
+      pool.bucket_size[i] = ((size_t)1 << octave) / STEPS_PER_OCTAVE *
+         (STEPS_PER_OCTAVE + step);
+   }
+
+   memset(&pool.stats, 0, sizeof pool.stats);
+   pool.max_bytes = value ? (size_t)strtoul(value, NULL, 10) : DEFAULT_POOL_SIZE;
+   _al_mutex_init(&pool_mutex);
+   _al_add_exit_func(shutdown_lock_buffer_pool, "shutdown_lock_buffer_pool");
+}
+
+
+/* _al_alloc_lock_buffer:
+ *  Returns a buffer of at least size bytes, to be freed with
+ *  _al_free_lock_buffer.
+ */
+void *_al_alloc_lock_buffer(size_t size)
+{
+   BUFFER_HEADER *header = NULL;
+   int bucket = find_bucket(size);
+
+   if (bucket != NO_BUCKET) {
+      _al_mutex_lock(&pool_mutex);
+      header = pool.free_list[bucket];
+      if (header) {
+         pool.free_list[bucket] = header->h.next;
+         pool.stats.cached_bytes -= pool.bucket_size[bucket];
+         pool.stats.cached_buffers--;
+         pool.stats.hits++;
+      }
+      else {
+         pool.stats.misses++;
+      }
+      _al_mutex_unlock(&pool_mutex);
+      size = pool.bucket_size[bucket];
+   }
+
+   if (!header) {
+      header = al_malloc(sizeof *header + size);
+      if (!header)
+         return NULL;
+   }
+
+   header->h.bucket = bucket;
+   return header + 1;
+}
+
+
+/* _al_free_lock_buffer:
+ *  Returns a buffer from _al_alloc_lock_buffer to the pool, or frees it if
+ *  the pool is full. Does nothing if buf is NULL.
+ */
+void _al_free_lock_buffer(void *buf)
+{
+   BUFFER_HEADER *header;
+   int bucket;
+
+   if (!buf)
+      return;
+
+   header = (BUFFER_HEADER *)buf - 1;
+   bucket = header->h.bucket;
+
+   if (bucket != NO_BUCKET) {
+      _al_mutex_lock(&pool_mutex);
+      if (pool.stats.cached_bytes + pool.bucket_size[bucket] <= pool.max_bytes) {
+         header->h.next = pool.free_list[bucket];
+         pool.free_list[bucket] = header;
+         pool.stats.cached_bytes += pool.bucket_size[bucket];
+         pool.stats.cached_buffers++;
+         header = NULL;
+      }
+      else {
+         pool.stats.releases++;
+      }
+      _al_mutex_unlock(&pool_mutex);
+   }
+
+   al_free(header);
+}
+
+
+/* Function: al_set_lock_buffer_pool_size
+ */
+void al_set_lock_buffer_pool_size(size_t max_bytes)
+{
+   _al_mutex_lock(&pool_mutex);
+   pool.max_bytes = max_bytes;
+   trim_pool();
+   _al_mutex_unlock(&pool_mutex);
+}
+
+
+/* Function: al_get_lock_buffer_pool_size
+ */
+size_t al_get_lock_buffer_pool_size(void)
+{
+   return pool.max_bytes;
+}
+
+
+/* Function: al_get_lock_buffer_pool_stats
+ */
+void al_get_lock_buffer_pool_stats(ALLEGRO_LOCK_BUFFER_POOL_STATS *stats)
+{
+   ASSERT(stats);
+
+   _al_mutex_lock(&pool_mutex);
+   *stats = pool.stats;
+   _al_mutex_unlock(&pool_mutex);
+}
+
+/* vim: set sts=3 sw=3 et: */
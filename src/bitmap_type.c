@@ -218,7 +218,12 @@ void al_convert_bitmap(ALLEGRO_BITMAP *bitmap)
       ALLEGRO_BITMAP *target_parent =
          target_bitmap->parent ? target_bitmap->parent : target_bitmap;
       if (bitmap == target_parent || bitmap->parent == target_parent) {
+         bool hold = al_is_bitmap_drawing_held();
+         if (hold)
+            al_hold_bitmap_drawing(false);
          al_set_target_bitmap(target_bitmap);
+         if (hold)
+            al_hold_bitmap_drawing(true);
       }
    }
 
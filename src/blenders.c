@@ -22,6 +22,14 @@
 #include "allegro5/internal/aintern_display.h"
 #include <string.h>
 
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define ALLEGRO_BLEND_SSE2
+      #include <emmintrin.h>
+   #endif
+#endif
+
 void _al_blend_memory(ALLEGRO_COLOR *scol,
    ALLEGRO_BITMAP *dest,
    int dx, int dy, ALLEGRO_COLOR *result)
@@ -40,3 +48,275 @@ void _al_blend_memory(ALLEGRO_COLOR *scol,
                     &constcol, result);
    (void) _al_blend_alpha_inline; // silence compiler
 }
+
+
+/* Integer blending of whole spans of 32-bit pixels which keep alpha in the
+ * top byte (ARGB_8888, ABGR_8888 and, on little endian, ABGR_8888_LE).  The
+ * other three channels are treated alike, so one blender serves all those
+ * formats as long as source and destination use the same red/blue order.
+ */
+
+/* Internal function: _al_get_int_blender
+ *  Translates a blender into the factors for _al_blend_span_int.  Returns
+ *  false if the blender cannot be done with integers, which is anything
+ *  besides ALLEGRO_ADD with a source factor of ONE or ALPHA and a destination
+ *  factor of ZERO, ONE or INVERSE_ALPHA (separately for colour and alpha).
+ */
+bool _al_get_int_blender(int op, int src_mode, int dst_mode,
+   int op_alpha, int src_alpha, int dst_alpha, int factors[4])
+{
+   int i;
+
+   if (op != ALLEGRO_ADD || op_alpha != ALLEGRO_ADD)
+      return false;
+
+   factors[0] = src_mode;
+   factors[1] = dst_mode;
+   factors[2] = src_alpha;
+   factors[3] = dst_alpha;
+
+   for (i = 0; i < 4; i++) {
+      switch (factors[i]) {
+         case ALLEGRO_ZERO:
+            factors[i] = _AL_INT_BLEND_ZERO;
+            break;
+         case ALLEGRO_ONE:
+            factors[i] = _AL_INT_BLEND_ONE;
+            break;
+         case ALLEGRO_ALPHA:
+            factors[i] = _AL_INT_BLEND_ALPHA;
+            break;
+         case ALLEGRO_INVERSE_ALPHA:
+            factors[i] = _AL_INT_BLEND_INVERSE_ALPHA;
+            break;
+         default:
+            return false;
+      }
+   }
+
+   if (factors[0] != _AL_INT_BLEND_ONE && factors[0] != _AL_INT_BLEND_ALPHA)
+      return false;
+   if (factors[2] != _AL_INT_BLEND_ONE && factors[2] != _AL_INT_BLEND_ALPHA)
+      return false;
+   if (factors[1] == _AL_INT_BLEND_ALPHA || factors[3] == _AL_INT_BLEND_ALPHA)
+      return false;
+
+   return true;
+}
+
+
+static _AL_ALWAYS_INLINE uint32_t get_int_factor(int factor, uint32_t a)
+{
+   switch (factor) {
+      case _AL_INT_BLEND_ZERO: return 0;
+      case _AL_INT_BLEND_ONE: return 255;
+      case _AL_INT_BLEND_ALPHA: return a;
+      default: return 255 - a;
+   }
+}
+
+
+/* Computes min(255, (s * sf + d * df) / 255) for one channel. */
+#define INT_BLEND(c, shift, sf, df)                                          \
+   do {                                                                      \
+      uint32_t v_ = (((s >> (shift)) & 0xff) * (sf) +                        \
+         ((d >> (shift)) & 0xff) * (df)) / 255;                              \
+      c |= (v_ > 255 ? 255 : v_) << (shift);                                 \
+   } while (0)
+
+
+static _AL_ALWAYS_INLINE void blend_span_int(uint32_t *dst,
+   const uint32_t *src, int w, bool swap_rb, bool tinted,
+   const uint32_t *tint, int src_c, int dst_c, int src_a, int dst_a)
+{
+   int x;
+
+   for (x = 0; x < w; x++) {
+      uint32_t s = src[x];
+      uint32_t d = dst[x];
+      uint32_t a, sf, df, asf, adf, result = 0;
+
+      if (swap_rb) {
+         s = (s & 0xff00ff00) | ((s >> 16) & 0xff) | ((s & 0xff) << 16);
+      }
+
+      if (tinted) {
+         s = ((((s      ) & 0xff) * tint[0] + 127) / 255)
+           | ((((s >>  8) & 0xff) * tint[1] + 127) / 255) << 8
+           | ((((s >> 16) & 0xff) * tint[2] + 127) / 255) << 16
+           | ((((s >> 24)       ) * tint[3] + 127) / 255) << 24;
+      }
+
+      a = s >> 24;
+
+      /* Fully transparent and fully opaque sources are by far the most
+       * common, so handle those without doing any arithmetic.
+       */
+      if (a == 0 && src_c == _AL_INT_BLEND_ALPHA &&
+            src_a == _AL_INT_BLEND_ALPHA &&
+            dst_c != _AL_INT_BLEND_ZERO && dst_a != _AL_INT_BLEND_ZERO) {
+         continue;
+      }
+      if (a == 0 && s == 0 && dst_c != _AL_INT_BLEND_ZERO &&
+            dst_a != _AL_INT_BLEND_ZERO) {
+         continue;
+      }
+      if (a == 255 && dst_c == _AL_INT_BLEND_INVERSE_ALPHA &&
+            dst_a == _AL_INT_BLEND_INVERSE_ALPHA) {
+         dst[x] = s;
+         continue;
+      }
+
+      sf = get_int_factor(src_c, a);
+      df = get_int_factor(dst_c, a);
+      asf = get_int_factor(src_a, a);
+      adf = get_int_factor(dst_a, a);
+
+      INT_BLEND(result, 0, sf, df);
+      INT_BLEND(result, 8, sf, df);
+      INT_BLEND(result, 16, sf, df);
+      INT_BLEND(result, 24, asf, adf);
+
+      dst[x] = result;
+   }
+}
+
+#undef INT_BLEND
+
+
+/* The common blenders get their own instance of blend_span_int, with the
+ * factors known at compile time.  Everything else goes through the generic
+ * instance.
+ */
+static _AL_ALWAYS_INLINE void blend_span(uint32_t *dst,
+   const uint32_t *src, int w, bool swap_rb, bool tinted,
+   const uint32_t *tint, int src_c, int dst_c, int src_a, int dst_a)
+{
+#define IS_BLENDER(sc, dc) \
+   (src_c == (sc) && src_a == (sc) && dst_c == (dc) && dst_a == (dc))
+#define SPAN(sc, dc) \
+   blend_span_int(dst, src, w, swap_rb, tinted, tint, sc, dc, sc, dc)
+
+   if (IS_BLENDER(_AL_INT_BLEND_ONE, _AL_INT_BLEND_INVERSE_ALPHA))
+      SPAN(_AL_INT_BLEND_ONE, _AL_INT_BLEND_INVERSE_ALPHA);
+   else if (IS_BLENDER(_AL_INT_BLEND_ALPHA, _AL_INT_BLEND_INVERSE_ALPHA))
+      SPAN(_AL_INT_BLEND_ALPHA, _AL_INT_BLEND_INVERSE_ALPHA);
+   else if (IS_BLENDER(_AL_INT_BLEND_ONE, _AL_INT_BLEND_ONE))
+      SPAN(_AL_INT_BLEND_ONE, _AL_INT_BLEND_ONE);
+   else if (IS_BLENDER(_AL_INT_BLEND_ALPHA, _AL_INT_BLEND_ONE))
+      SPAN(_AL_INT_BLEND_ALPHA, _AL_INT_BLEND_ONE);
+   else
+      blend_span_int(dst, src, w, swap_rb, tinted, tint,
+         src_c, dst_c, src_a, dst_a);
+
+#undef SPAN
+#undef IS_BLENDER
+}
+
+
+#ifdef ALLEGRO_BLEND_SSE2
+/* Blends four pixels at a time with each channel widened to 16 bits.  Every
+ * factor is a * mul + add with mul being 0, 1 or -1 and add being 0 or 255,
+ * so the factors of all four channels come out of a single multiply.  The
+ * results are identical to blend_span_int: the shortcuts taken there give
+ * the same values as the full calculation, a saturated sum still divides to
+ * at least 255, and (x * 0x8081) >> 23 is x / 255 for any 16-bit x.
+ */
+static int blend_span_sse2(uint32_t *dst, const uint32_t *src, int w,
+   bool swap_rb, const uint32_t *tint, const int factors[4])
+{
+   static const short mul[4] = {0, 0, 1, -1};
+   static const short add[4] = {0, 255, 0, 255};
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i div = _mm_set1_epi16((short)0x8081);
+   const __m128i sm = _mm_set_epi16(mul[factors[2]], mul[factors[0]],
+      mul[factors[0]], mul[factors[0]], mul[factors[2]], mul[factors[0]],
+      mul[factors[0]], mul[factors[0]]);
+   const __m128i sa = _mm_set_epi16(add[factors[2]], add[factors[0]],
+      add[factors[0]], add[factors[0]], add[factors[2]], add[factors[0]],
+      add[factors[0]], add[factors[0]]);
+   const __m128i dm = _mm_set_epi16(mul[factors[3]], mul[factors[1]],
+      mul[factors[1]], mul[factors[1]], mul[factors[3]], mul[factors[1]],
+      mul[factors[1]], mul[factors[1]]);
+   const __m128i da = _mm_set_epi16(add[factors[3]], add[factors[1]],
+      add[factors[1]], add[factors[1]], add[factors[3]], add[factors[1]],
+      add[factors[1]], add[factors[1]]);
+   __m128i t = zero;
+   int x;
+
+   if (tint) {
+      t = _mm_set_epi16(tint[3], tint[2], tint[1], tint[0],
+         tint[3], tint[2], tint[1], tint[0]);
+   }
+
+#define BLEND_HALF(s, d)                                                     \
+   do {                                                                      \
+      __m128i a_;                                                            \
+      if (swap_rb) {                                                         \
+         s = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 0, 1, 2));                \
+         s = _mm_shufflehi_epi16(s, _MM_SHUFFLE(3, 0, 1, 2));                \
+      }                                                                      \
+      if (tint) {                                                            \
+         s = _mm_add_epi16(_mm_mullo_epi16(s, t), _mm_set1_epi16(127));      \
+         s = _mm_srli_epi16(_mm_mulhi_epu16(s, div), 7);                     \
+      }                                                                      \
+      a_ = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));                  \
+      a_ = _mm_shufflehi_epi16(a_, _MM_SHUFFLE(3, 3, 3, 3));                 \
+      s = _mm_mullo_epi16(s, _mm_add_epi16(_mm_mullo_epi16(a_, sm), sa));    \
+      d = _mm_mullo_epi16(d, _mm_add_epi16(_mm_mullo_epi16(a_, dm), da));    \
+      d = _mm_adds_epu16(s, d);                                              \
+      d = _mm_srli_epi16(_mm_mulhi_epu16(d, div), 7);                        \
+   } while (0)
+
+   for (x = 0; x + 4 <= w; x += 4) {
+      __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+      __m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+      __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+      __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+      __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+      __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+      BLEND_HALF(s_lo, d_lo);
+      BLEND_HALF(s_hi, d_hi);
+      _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(d_lo, d_hi));
+   }
+
+#undef BLEND_HALF
+
+   return x;
+}
+#endif
+
+
+/* Internal function: _al_blend_span_int
+ *  Blends w source pixels onto w destination pixels with the factors from
+ *  _al_get_int_blender.  If swap_rb is true the red and blue channels of the
+ *  source are swapped first.  If tint is not NULL the source channels are
+ *  multiplied by tint[i] / 255, in the order of the channels from the lowest
+ *  byte up.
+ */
+void _al_blend_span_int(uint32_t *dst, const uint32_t *src, int w,
+   bool swap_rb, const uint32_t *tint, const int factors[4])
+{
+#ifdef ALLEGRO_BLEND_SSE2
+   int done = blend_span_sse2(dst, src, w, swap_rb, tint, factors);
+   dst += done;
+   src += done;
+   w -= done;
+#endif
+
+   if (tint) {
+      blend_span(dst, src, w, swap_rb, true, tint,
+         factors[0], factors[1], factors[2], factors[3]);
+   }
+   else if (swap_rb) {
+      blend_span(dst, src, w, true, false, NULL,
+         factors[0], factors[1], factors[2], factors[3]);
+   }
+   else {
+      blend_span(dst, src, w, false, false, NULL,
+         factors[0], factors[1], factors[2], factors[3]);
+   }
+}
+
+
+/* vim: set sts=3 sw=3 et: */
@@ -2,6 +2,8 @@
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_cpu.h"
+#include <string.h>
 static void argb_8888_to_rgba_8888(const void *src, int src_pitch,
    void *dst, int dst_pitch,
    int sx, int sy, int dx, int dy, int width, int height)
@@ -8482,4 +8484,6030 @@ void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
    {NULL},
 };
 
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define ALLEGRO_CONVERT_SSE2
+      #include <emmintrin.h>
+   #endif
+   #if (defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__)) && \
+         (defined(__x86_64__) || defined(__i386__))) || \
+      (defined(_MSC_VER) && _MSC_VER >= 1700 && \
+         (defined(_M_X64) || defined(_M_IX86)))
+      #define ALLEGRO_CONVERT_AVX2
+      #include <immintrin.h>
+      #ifdef __GNUC__
+         #define _AL_TARGET_AVX2 __attribute__((target("avx2")))
+      #else
+         #define _AL_TARGET_AVX2
+      #endif
+   #endif
+   #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+      #define ALLEGRO_CONVERT_NEON
+      #include <arm_neon.h>
+   #endif
+#endif
+#define VCONVERT_ARGB_8888_TO_RGBA_8888(x) \
+   VOR(VSHR(VAND(x, 0xff000000), 24), \
+   VSHL(VAND(x, 0x00ffffff), 8))
+#define VCONVERT_ARGB_8888_TO_ARGB_4444(x) \
+   VOR(VSHR(VAND(x, 0xf0000000), 16), \
+   VOR(VSHR(VAND(x, 0x000000f0), 4), \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VSHR(VAND(x, 0x00f00000), 12))))
+#define VCONVERT_ARGB_8888_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x000000f8), 3), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x00f80000), 8)))
+#define VCONVERT_ARGB_8888_TO_ABGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VAND(x, 0xff00ff00)))
+#define VCONVERT_ARGB_8888_TO_XBGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VSHR(VAND(x, 0x00ff0000), 16)))
+#define VCONVERT_ARGB_8888_TO_BGR_565(x) \
+   VOR(VSHL(VAND(x, 0x000000f8), 8), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x00f80000), 19)))
+#define VCONVERT_ARGB_8888_TO_RGBX_8888(x) \
+   VSHL(VAND(x, 0x00ffffff), 8)
+#define VCONVERT_ARGB_8888_TO_XRGB_8888(x) \
+   VAND(x, 0x00ffffff)
+#define VCONVERT_ARGB_8888_TO_ABGR_8888_LE(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VAND(x, 0xff00ff00)))
+#define VCONVERT_ARGB_8888_TO_RGBA_4444(x) \
+   VOR(VSHR(VAND(x, 0xf0000000), 28), \
+   VOR(VAND(x, 0x000000f0), \
+   VOR(VSHR(VAND(x, 0x0000f000), 4), \
+   VSHR(VAND(x, 0x00f00000), 8))))
+#define VCONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(x) \
+   VAND(VSHR(x, 16), 0x000000ff)
+#define VCONVERT_RGBA_8888_TO_ARGB_8888(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 24), \
+   VSHR(VAND(x, 0xffffff00), 8))
+#define VCONVERT_RGBA_8888_TO_ARGB_4444(x) \
+   VOR(VSHL(VAND(x, 0x000000f0), 8), \
+   VOR(VSHR(VAND(x, 0x0000f000), 12), \
+   VOR(VSHR(VAND(x, 0x00f00000), 16), \
+   VSHR(VAND(x, 0xf0000000), 20))))
+#define VCONVERT_RGBA_8888_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x0000f800), 11), \
+   VOR(VSHR(VAND(x, 0x00fc0000), 13), \
+   VSHR(VAND(x, 0xf8000000), 16)))
+#define VCONVERT_RGBA_8888_TO_ABGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 24), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VSHR(VAND(x, 0xff000000), 24))))
+#define VCONVERT_RGBA_8888_TO_XBGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VSHR(VAND(x, 0xff000000), 24)))
+#define VCONVERT_RGBA_8888_TO_BGR_565(x) \
+   VOR(VAND(x, 0x0000f800), \
+   VOR(VSHR(VAND(x, 0x00fc0000), 13), \
+   VSHR(VAND(x, 0xf8000000), 27)))
+#define VCONVERT_RGBA_8888_TO_RGBX_8888(x) \
+   VAND(x, 0xffffff00)
+#define VCONVERT_RGBA_8888_TO_XRGB_8888(x) \
+   VSHR(VAND(x, 0xffffff00), 8)
+#define VCONVERT_RGBA_8888_TO_ABGR_8888_LE(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 24), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VSHR(VAND(x, 0xff000000), 24))))
+#define VCONVERT_RGBA_8888_TO_RGBA_4444(x) \
+   VOR(VSHR(VAND(x, 0x000000f0), 4), \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VOR(VSHR(VAND(x, 0x00f00000), 12), \
+   VSHR(VAND(x, 0xf0000000), 16))))
+#define VCONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(x) \
+   VAND(VSHR(x, 24), 0x000000ff)
+#define VCONVERT_ABGR_8888_TO_ARGB_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VAND(x, 0xff00ff00)))
+#define VCONVERT_ABGR_8888_TO_RGBA_8888(x) \
+   VOR(VSHR(VAND(x, 0xff000000), 24), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VSHL(VAND(x, 0x000000ff), 24))))
+#define VCONVERT_ABGR_8888_TO_ARGB_4444(x) \
+   VOR(VSHR(VAND(x, 0xf0000000), 16), \
+   VOR(VSHR(VAND(x, 0x00f00000), 20), \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VSHL(VAND(x, 0x000000f0), 4))))
+#define VCONVERT_ABGR_8888_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x00f80000), 19), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHL(VAND(x, 0x000000f8), 8)))
+#define VCONVERT_ABGR_8888_TO_XBGR_8888(x) \
+   VAND(x, 0x00ffffff)
+#define VCONVERT_ABGR_8888_TO_BGR_565(x) \
+   VOR(VSHR(VAND(x, 0x00f80000), 8), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x000000f8), 3)))
+#define VCONVERT_ABGR_8888_TO_RGBX_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VSHL(VAND(x, 0x000000ff), 24)))
+#define VCONVERT_ABGR_8888_TO_XRGB_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VSHL(VAND(x, 0x000000ff), 16)))
+#define VCONVERT_ABGR_8888_TO_ABGR_8888_LE(x) \
+   VAND(x, 0xffffffff)
+#define VCONVERT_ABGR_8888_TO_RGBA_4444(x) \
+   VOR(VSHR(VAND(x, 0xf0000000), 28), \
+   VOR(VSHR(VAND(x, 0x00f00000), 16), \
+   VOR(VSHR(VAND(x, 0x0000f000), 4), \
+   VSHL(VAND(x, 0x000000f0), 8))))
+#define VCONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(x) \
+   VAND(x, 0x000000ff)
+#define VCONVERT_XBGR_8888_TO_ARGB_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VSET(0xff000000))))
+#define VCONVERT_XBGR_8888_TO_RGBA_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHL(VAND(x, 0x000000ff), 24), \
+   VSET(0x000000ff))))
+#define VCONVERT_XBGR_8888_TO_ARGB_4444(x) \
+   VOR(VSHR(VAND(x, 0x00f00000), 20), \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VOR(VSHL(VAND(x, 0x000000f0), 4), \
+   VSET(0x0000f000))))
+#define VCONVERT_XBGR_8888_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x00f80000), 19), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHL(VAND(x, 0x000000f8), 8)))
+#define VCONVERT_XBGR_8888_TO_ABGR_8888(x) \
+   VOR(VAND(x, 0x00ffffff), \
+   VSET(0xff000000))
+#define VCONVERT_XBGR_8888_TO_BGR_565(x) \
+   VOR(VSHR(VAND(x, 0x00f80000), 8), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x000000f8), 3)))
+#define VCONVERT_XBGR_8888_TO_RGBX_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VSHL(VAND(x, 0x000000ff), 24)))
+#define VCONVERT_XBGR_8888_TO_XRGB_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VSHL(VAND(x, 0x000000ff), 16)))
+#define VCONVERT_XBGR_8888_TO_ABGR_8888_LE(x) \
+   VOR(VAND(x, 0x00ffffff), \
+   VSET(0xff000000))
+#define VCONVERT_XBGR_8888_TO_RGBA_4444(x) \
+   VOR(VSHR(VAND(x, 0x00f00000), 16), \
+   VOR(VSHR(VAND(x, 0x0000f000), 4), \
+   VOR(VSHL(VAND(x, 0x000000f0), 8), \
+   VSET(0x0000000f))))
+#define VCONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(x) \
+   VAND(x, 0x000000ff)
+#define VCONVERT_RGBX_8888_TO_ARGB_8888(x) \
+   VOR(VSHR(VAND(x, 0xffffff00), 8), \
+   VSET(0xff000000))
+#define VCONVERT_RGBX_8888_TO_RGBA_8888(x) \
+   VOR(VAND(x, 0xffffff00), \
+   VSET(0x000000ff))
+#define VCONVERT_RGBX_8888_TO_ARGB_4444(x) \
+   VOR(VSHR(VAND(x, 0x0000f000), 12), \
+   VOR(VSHR(VAND(x, 0x00f00000), 16), \
+   VOR(VSHR(VAND(x, 0xf0000000), 20), \
+   VSET(0x0000f000))))
+#define VCONVERT_RGBX_8888_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x0000f800), 11), \
+   VOR(VSHR(VAND(x, 0x00fc0000), 13), \
+   VSHR(VAND(x, 0xf8000000), 16)))
+#define VCONVERT_RGBX_8888_TO_ABGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHR(VAND(x, 0xff000000), 24), \
+   VSET(0xff000000))))
+#define VCONVERT_RGBX_8888_TO_XBGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VSHR(VAND(x, 0xff000000), 24)))
+#define VCONVERT_RGBX_8888_TO_BGR_565(x) \
+   VOR(VAND(x, 0x0000f800), \
+   VOR(VSHR(VAND(x, 0x00fc0000), 13), \
+   VSHR(VAND(x, 0xf8000000), 27)))
+#define VCONVERT_RGBX_8888_TO_XRGB_8888(x) \
+   VSHR(VAND(x, 0xffffff00), 8)
+#define VCONVERT_RGBX_8888_TO_ABGR_8888_LE(x) \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHR(VAND(x, 0xff000000), 24), \
+   VSET(0xff000000))))
+#define VCONVERT_RGBX_8888_TO_RGBA_4444(x) \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VOR(VSHR(VAND(x, 0x00f00000), 12), \
+   VOR(VSHR(VAND(x, 0xf0000000), 16), \
+   VSET(0x0000000f))))
+#define VCONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(x) \
+   VAND(VSHR(x, 24), 0x000000ff)
+#define VCONVERT_XRGB_8888_TO_ARGB_8888(x) \
+   VOR(VAND(x, 0x00ffffff), \
+   VSET(0xff000000))
+#define VCONVERT_XRGB_8888_TO_RGBA_8888(x) \
+   VOR(VSHL(VAND(x, 0x00ffffff), 8), \
+   VSET(0x000000ff))
+#define VCONVERT_XRGB_8888_TO_ARGB_4444(x) \
+   VOR(VSHR(VAND(x, 0x000000f0), 4), \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VOR(VSHR(VAND(x, 0x00f00000), 12), \
+   VSET(0x0000f000))))
+#define VCONVERT_XRGB_8888_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x000000f8), 3), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x00f80000), 8)))
+#define VCONVERT_XRGB_8888_TO_ABGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VSET(0xff000000))))
+#define VCONVERT_XRGB_8888_TO_XBGR_8888(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VSHR(VAND(x, 0x00ff0000), 16)))
+#define VCONVERT_XRGB_8888_TO_BGR_565(x) \
+   VOR(VSHL(VAND(x, 0x000000f8), 8), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x00f80000), 19)))
+#define VCONVERT_XRGB_8888_TO_RGBX_8888(x) \
+   VSHL(VAND(x, 0x00ffffff), 8)
+#define VCONVERT_XRGB_8888_TO_ABGR_8888_LE(x) \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VSET(0xff000000))))
+#define VCONVERT_XRGB_8888_TO_RGBA_4444(x) \
+   VOR(VAND(x, 0x000000f0), \
+   VOR(VSHR(VAND(x, 0x0000f000), 4), \
+   VOR(VSHR(VAND(x, 0x00f00000), 8), \
+   VSET(0x0000000f))))
+#define VCONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(x) \
+   VAND(VSHR(x, 16), 0x000000ff)
+#define VCONVERT_ABGR_8888_LE_TO_ARGB_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VOR(VSHL(VAND(x, 0x000000ff), 16), \
+   VAND(x, 0xff00ff00)))
+#define VCONVERT_ABGR_8888_LE_TO_RGBA_8888(x) \
+   VOR(VSHR(VAND(x, 0xff000000), 24), \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VSHL(VAND(x, 0x000000ff), 24))))
+#define VCONVERT_ABGR_8888_LE_TO_ARGB_4444(x) \
+   VOR(VSHR(VAND(x, 0xf0000000), 16), \
+   VOR(VSHR(VAND(x, 0x00f00000), 20), \
+   VOR(VSHR(VAND(x, 0x0000f000), 8), \
+   VSHL(VAND(x, 0x000000f0), 4))))
+#define VCONVERT_ABGR_8888_LE_TO_RGB_565(x) \
+   VOR(VSHR(VAND(x, 0x00f80000), 19), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHL(VAND(x, 0x000000f8), 8)))
+#define VCONVERT_ABGR_8888_LE_TO_ABGR_8888(x) \
+   VAND(x, 0xffffffff)
+#define VCONVERT_ABGR_8888_LE_TO_XBGR_8888(x) \
+   VAND(x, 0x00ffffff)
+#define VCONVERT_ABGR_8888_LE_TO_BGR_565(x) \
+   VOR(VSHR(VAND(x, 0x00f80000), 8), \
+   VOR(VSHR(VAND(x, 0x0000fc00), 5), \
+   VSHR(VAND(x, 0x000000f8), 3)))
+#define VCONVERT_ABGR_8888_LE_TO_RGBX_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 8), \
+   VOR(VSHL(VAND(x, 0x0000ff00), 8), \
+   VSHL(VAND(x, 0x000000ff), 24)))
+#define VCONVERT_ABGR_8888_LE_TO_XRGB_8888(x) \
+   VOR(VSHR(VAND(x, 0x00ff0000), 16), \
+   VOR(VAND(x, 0x0000ff00), \
+   VSHL(VAND(x, 0x000000ff), 16)))
+#define VCONVERT_ABGR_8888_LE_TO_RGBA_4444(x) \
+   VOR(VSHR(VAND(x, 0xf0000000), 28), \
+   VOR(VSHR(VAND(x, 0x00f00000), 16), \
+   VOR(VSHR(VAND(x, 0x0000f000), 4), \
+   VSHL(VAND(x, 0x000000f0), 8))))
+#define VCONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(x) \
+   VAND(x, 0x000000ff)
+#define VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(x) \
+   VOR(VAND(VSHL(x, 16), 0x00ff0000), \
+   VSET(0xff000000))
+#define VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(x) \
+   VOR(VAND(VSHL(x, 24), 0xff000000), \
+   VSET(0x000000ff))
+#define VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(x) \
+   VOR(VAND(VSHL(x, 4), 0x00000f00), \
+   VSET(0x0000f000))
+#define VCONVERT_SINGLE_CHANNEL_8_TO_RGB_565(x) \
+   VAND(VSHL(x, 8), 0x0000f800)
+#define VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(x) \
+   VOR(VAND(x, 0x000000ff), \
+   VSET(0xff000000))
+#define VCONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(x) \
+   VAND(x, 0x000000ff)
+#define VCONVERT_SINGLE_CHANNEL_8_TO_BGR_565(x) \
+   VAND(VSHR(x, 3), 0x0000001f)
+#define VCONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(x) \
+   VAND(VSHL(x, 24), 0xff000000)
+#define VCONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(x) \
+   VAND(VSHL(x, 16), 0x00ff0000)
+#define VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(x) \
+   VOR(VAND(x, 0x000000ff), \
+   VSET(0xff000000))
+#define VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(x) \
+   VOR(VAND(VSHL(x, 8), 0x0000f000), \
+   VSET(0x0000000f))
+#ifdef ALLEGRO_CONVERT_SSE2
+#define VEC __m128i
+#define VAND(x, m) _mm_and_si128(x, _mm_set1_epi32((int)(m)))
+#define VOR(x, y) _mm_or_si128(x, y)
+#define VSHL(x, n) _mm_slli_epi32(x, n)
+#define VSHR(x, n) _mm_srli_epi32(x, n)
+#define VSET(c) _mm_set1_epi32((int)(c))
+static INLINE __m128i sse2_load32(const uint32_t *p)
+{
+   return _mm_loadu_si128((const __m128i *)p);
+}
+static INLINE __m128i sse2_load8(const uint8_t *p)
+{
+   int32_t t;
+   __m128i zero = _mm_setzero_si128();
+   memcpy(&t, p, 4);
+   return _mm_unpacklo_epi16(
+      _mm_unpacklo_epi8(_mm_cvtsi32_si128(t), zero), zero);
+}
+static INLINE void sse2_store32(uint32_t *p, __m128i v)
+{
+   _mm_storeu_si128((__m128i *)p, v);
+}
+static INLINE void sse2_store16(uint16_t *p, __m128i v)
+{
+   /* Sign extend so that the saturating pack keeps all 16 bits. */
+   v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+   _mm_storel_epi64((__m128i *)p, _mm_packs_epi32(v, v));
+}
+static INLINE void sse2_store8(uint8_t *p, __m128i v)
+{
+   int32_t t;
+   v = _mm_packs_epi32(v, v);
+   t = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+   memcpy(p, &t, 4);
+}
+static void argb_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_single_channel_8_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load32(src_ptr + x);
+         sse2_store8(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = sse2_load8(src_ptr + x);
+         sse2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+#undef VEC
+#undef VAND
+#undef VOR
+#undef VSHL
+#undef VSHR
+#undef VSET
+#endif
+#ifdef ALLEGRO_CONVERT_AVX2
+#define VEC __m256i
+#define VAND(x, m) _mm256_and_si256(x, _mm256_set1_epi32((int)(m)))
+#define VOR(x, y) _mm256_or_si256(x, y)
+#define VSHL(x, n) _mm256_slli_epi32(x, n)
+#define VSHR(x, n) _mm256_srli_epi32(x, n)
+#define VSET(c) _mm256_set1_epi32((int)(c))
+static INLINE _AL_TARGET_AVX2 __m256i avx2_load32(const uint32_t *p)
+{
+   return _mm256_loadu_si256((const __m256i *)p);
+}
+static INLINE _AL_TARGET_AVX2 __m256i avx2_load8(const uint8_t *p)
+{
+   return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p));
+}
+static INLINE _AL_TARGET_AVX2 void avx2_store32(uint32_t *p, __m256i v)
+{
+   _mm256_storeu_si256((__m256i *)p, v);
+}
+static INLINE _AL_TARGET_AVX2 __m128i avx2_pack16(__m256i v)
+{
+   /* Sign extend so that the saturating pack keeps all 16 bits. */
+   v = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+   return _mm_packs_epi32(_mm256_castsi256_si128(v),
+      _mm256_extracti128_si256(v, 1));
+}
+static INLINE _AL_TARGET_AVX2 void avx2_store16(uint16_t *p, __m256i v)
+{
+   _mm_storeu_si128((__m128i *)p, avx2_pack16(v));
+}
+static INLINE _AL_TARGET_AVX2 void avx2_store8(uint8_t *p, __m256i v)
+{
+   __m128i w = avx2_pack16(v);
+   _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(w, w));
+}
+static _AL_TARGET_AVX2 void argb_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void argb_8888_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgba_8888_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xbgr_8888_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void rgbx_8888_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void xrgb_8888_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void abgr_8888_le_to_single_channel_8_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load32(src_ptr + x);
+         avx2_store8(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static _AL_TARGET_AVX2 void single_channel_8_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 8 <= width; x += 8) {
+         VEC v = avx2_load8(src_ptr + x);
+         avx2_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+#undef VEC
+#undef VAND
+#undef VOR
+#undef VSHL
+#undef VSHR
+#undef VSET
+#endif
+#ifdef ALLEGRO_CONVERT_NEON
+#define VEC uint32x4_t
+#define VAND(x, m) vandq_u32(x, vdupq_n_u32(m))
+#define VOR(x, y) vorrq_u32(x, y)
+#define VSHL(x, n) vshlq_n_u32(x, n)
+#define VSHR(x, n) vshrq_n_u32(x, n)
+#define VSET(c) vdupq_n_u32(c)
+static INLINE uint32x4_t neon_load32(const uint32_t *p)
+{
+   return vld1q_u32(p);
+}
+static INLINE uint32x4_t neon_load8(const uint8_t *p)
+{
+   uint32_t t;
+   memcpy(&t, p, 4);
+   return vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(t)))));
+}
+static INLINE void neon_store32(uint32_t *p, uint32x4_t v)
+{
+   vst1q_u32(p, v);
+}
+static INLINE void neon_store16(uint16_t *p, uint32x4_t v)
+{
+   vst1_u16(p, vmovn_u32(v));
+}
+static INLINE void neon_store8(uint8_t *p, uint32x4_t v)
+{
+   uint16x4_t h = vmovn_u32(v);
+   uint32_t t = vget_lane_u32(
+      vreinterpret_u32_u8(vmovn_u16(vcombine_u16(h, h))), 0);
+   memcpy(p, &t, 4);
+}
+static void argb_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ARGB_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ARGB_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void argb_8888_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBA_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBA_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgba_8888_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XBGR_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XBGR_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xbgr_8888_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_RGBX_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_RGBX_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void rgbx_8888_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_XRGB_8888_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_XRGB_8888_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void xrgb_8888_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void abgr_8888_le_to_single_channel_8_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint32_t *src_ptr = (const uint32_t *)((const char *)src + sy * src_pitch) + sx;
+   uint8_t *dst_ptr = (uint8_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load32(src_ptr + x);
+         neon_store8(dst_ptr + x, VCONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_SINGLE_CHANNEL_8(src_ptr[x]);
+      }
+      src_ptr = (const uint32_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint8_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ARGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBA_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ARGB_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGB_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGB_565(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_XBGR_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_BGR_565(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_BGR_565(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBX_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_XRGB_8888(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint32_t *dst_ptr = (uint32_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store32(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint32_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+static void single_channel_8_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   const uint8_t *src_ptr = (const uint8_t *)((const char *)src + sy * src_pitch) + sx;
+   uint16_t *dst_ptr = (uint16_t *)((char *)dst + dy * dst_pitch) + dx;
+   for (y = 0; y < height; y++) {
+      for (x = 0; x + 4 <= width; x += 4) {
+         VEC v = neon_load8(src_ptr + x);
+         neon_store16(dst_ptr + x, VCONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(v));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_SINGLE_CHANNEL_8_TO_RGBA_4444(src_ptr[x]);
+      }
+      src_ptr = (const uint8_t *)((const char *)src_ptr + src_pitch);
+      dst_ptr = (uint16_t *)((char *)dst_ptr + dst_pitch);
+   }
+}
+#undef VEC
+#undef VAND
+#undef VOR
+#undef VSHL
+#undef VSHR
+#undef VSET
+#endif
+void _al_init_convert_funcs(void)
+{
+   int caps = _al_get_cpu_capabilities();
+   (void)caps;
+#ifdef ALLEGRO_CONVERT_SSE2
+   if (caps & _AL_CPU_SSE2) {
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         argb_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         argb_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         argb_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         argb_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         argb_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         argb_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         argb_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         argb_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         argb_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         argb_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         argb_8888_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         rgba_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         rgba_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         rgba_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         rgba_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         rgba_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         rgba_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         rgba_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         rgba_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         rgba_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         rgba_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         rgba_8888_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         abgr_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         abgr_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         abgr_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         abgr_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         abgr_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         abgr_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         abgr_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         abgr_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         abgr_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         abgr_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         abgr_8888_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         xbgr_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         xbgr_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         xbgr_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         xbgr_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         xbgr_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         xbgr_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         xbgr_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         xbgr_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         xbgr_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         xbgr_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         xbgr_8888_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         rgbx_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         rgbx_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         rgbx_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         rgbx_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         rgbx_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         rgbx_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         rgbx_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         rgbx_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         rgbx_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         rgbx_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         rgbx_8888_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         xrgb_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         xrgb_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         xrgb_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         xrgb_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         xrgb_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         xrgb_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         xrgb_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         xrgb_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         xrgb_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         xrgb_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         xrgb_8888_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         abgr_8888_le_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         abgr_8888_le_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         abgr_8888_le_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         abgr_8888_le_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         abgr_8888_le_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         abgr_8888_le_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         abgr_8888_le_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         abgr_8888_le_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         abgr_8888_le_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         abgr_8888_le_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         abgr_8888_le_to_single_channel_8_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         single_channel_8_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         single_channel_8_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         single_channel_8_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         single_channel_8_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         single_channel_8_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         single_channel_8_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         single_channel_8_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         single_channel_8_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         single_channel_8_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         single_channel_8_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         single_channel_8_to_rgba_4444_sse2;
+   }
+#endif
+#ifdef ALLEGRO_CONVERT_AVX2
+   if (caps & _AL_CPU_AVX2) {
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         argb_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         argb_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         argb_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         argb_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         argb_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         argb_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         argb_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         argb_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         argb_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         argb_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         argb_8888_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         rgba_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         rgba_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         rgba_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         rgba_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         rgba_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         rgba_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         rgba_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         rgba_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         rgba_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         rgba_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         rgba_8888_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         abgr_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         abgr_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         abgr_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         abgr_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         abgr_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         abgr_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         abgr_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         abgr_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         abgr_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         abgr_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         abgr_8888_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         xbgr_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         xbgr_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         xbgr_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         xbgr_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         xbgr_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         xbgr_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         xbgr_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         xbgr_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         xbgr_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         xbgr_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         xbgr_8888_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         rgbx_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         rgbx_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         rgbx_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         rgbx_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         rgbx_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         rgbx_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         rgbx_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         rgbx_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         rgbx_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         rgbx_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         rgbx_8888_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         xrgb_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         xrgb_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         xrgb_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         xrgb_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         xrgb_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         xrgb_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         xrgb_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         xrgb_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         xrgb_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         xrgb_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         xrgb_8888_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         abgr_8888_le_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         abgr_8888_le_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         abgr_8888_le_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         abgr_8888_le_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         abgr_8888_le_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         abgr_8888_le_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         abgr_8888_le_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         abgr_8888_le_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         abgr_8888_le_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         abgr_8888_le_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         abgr_8888_le_to_single_channel_8_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         single_channel_8_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         single_channel_8_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         single_channel_8_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         single_channel_8_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         single_channel_8_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         single_channel_8_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         single_channel_8_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         single_channel_8_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         single_channel_8_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         single_channel_8_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         single_channel_8_to_rgba_4444_avx2;
+   }
+#endif
+#ifdef ALLEGRO_CONVERT_NEON
+   if (caps & _AL_CPU_NEON) {
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         argb_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         argb_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         argb_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         argb_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         argb_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         argb_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         argb_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         argb_8888_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         argb_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         argb_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         argb_8888_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         rgba_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         rgba_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         rgba_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         rgba_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         rgba_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         rgba_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         rgba_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         rgba_8888_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         rgba_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         rgba_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         rgba_8888_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         abgr_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         abgr_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         abgr_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         abgr_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         abgr_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         abgr_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         abgr_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         abgr_8888_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         abgr_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         abgr_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         abgr_8888_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         xbgr_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         xbgr_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         xbgr_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         xbgr_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         xbgr_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         xbgr_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         xbgr_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         xbgr_8888_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         xbgr_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         xbgr_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         xbgr_8888_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         rgbx_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         rgbx_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         rgbx_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         rgbx_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         rgbx_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         rgbx_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         rgbx_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         rgbx_8888_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         rgbx_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         rgbx_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         rgbx_8888_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         xrgb_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         xrgb_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         xrgb_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         xrgb_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         xrgb_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         xrgb_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         xrgb_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         xrgb_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         xrgb_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         xrgb_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         xrgb_8888_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         abgr_8888_le_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         abgr_8888_le_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         abgr_8888_le_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         abgr_8888_le_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         abgr_8888_le_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         abgr_8888_le_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         abgr_8888_le_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         abgr_8888_le_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         abgr_8888_le_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         abgr_8888_le_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE][ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8] =
+         abgr_8888_le_to_single_channel_8_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ARGB_8888] =
+         single_channel_8_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBA_8888] =
+         single_channel_8_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ARGB_4444] =
+         single_channel_8_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGB_565] =
+         single_channel_8_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ABGR_8888] =
+         single_channel_8_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_XBGR_8888] =
+         single_channel_8_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_BGR_565] =
+         single_channel_8_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBX_8888] =
+         single_channel_8_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_XRGB_8888] =
+         single_channel_8_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] =
+         single_channel_8_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_SINGLE_CHANNEL_8][ALLEGRO_PIXEL_FORMAT_RGBA_4444] =
+         single_channel_8_to_rgba_4444_neon;
+   }
+#endif
+}
 // Warning: This file was created by make_converters.py - do not edit.
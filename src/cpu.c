@@ -18,6 +18,7 @@
 #include "allegro5/allegro.h"
 #include "allegro5/cpu.h"
 #include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_cpu.h"
 
 /*
 * The CPU and pysical memory detection functions below use
@@ -44,6 +45,10 @@
 #include <windows.h>
 #endif
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
 
 /* Function: al_get_cpu_count
  */
@@ -107,5 +112,51 @@ int al_get_ram_size(void)
 }
 
 
+/* Internal function: _al_get_cpu_capabilities
+ *  Returns the _AL_CPU_* flags for the instruction set extensions which
+ *  can be used on this machine.  Only checks for the extensions that
+ *  Allegro has code paths for.
+ */
+int _al_get_cpu_capabilities(void)
+{
+   static int caps = -1;
+   int c = 0;
+
+   if (caps >= 0)
+      return caps;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("sse2"))
+      c |= _AL_CPU_SSE2;
+   if (__builtin_cpu_supports("avx2"))
+      c |= _AL_CPU_AVX2;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+   {
+      int info[4];
+      int max_id;
+
+      __cpuid(info, 0);
+      max_id = info[0];
+      __cpuid(info, 1);
+      if (info[3] & (1 << 26))
+         c |= _AL_CPU_SSE2;
+      /* AVX2 also needs OSXSAVE and the OS saving the YMM registers. */
+      if (max_id >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+            (_xgetbv(0) & 6) == 6) {
+         __cpuidex(info, 7, 0);
+         if (info[1] & (1 << 5))
+            c |= _AL_CPU_AVX2;
+      }
+   }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+   c |= _AL_CPU_NEON;
+#endif
+
+   caps = c;
+   return caps;
+}
+
+
 /* vi: set ts=4 sw=4 expandtab: */
 
@@ -26,6 +26,7 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_display.h"
+#include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_shader.h"
 #include "allegro5/internal/aintern_system.h"
 
@@ -33,6 +34,23 @@
 ALLEGRO_DEBUG_CHANNEL("display")
 
 
+/* use_headless_driver:
+ *  Whether displays should be created by the headless driver instead of the
+ *  system's own, either because of the ALLEGRO_HEADLESS flag or because the
+ *  configuration says so.
+ */
+static bool use_headless_driver(void)
+{
+   const char *s;
+
+   if (al_get_new_display_flags() & ALLEGRO_HEADLESS)
+      return true;
+
+   s = al_get_config_value(al_get_system_config(), "graphics", "driver");
+   return s && !_al_stricmp(s, "headless");
+}
+
+
 /* Function: al_create_display
  */
 ALLEGRO_DISPLAY *al_create_display(int w, int h)
@@ -44,7 +62,10 @@ ALLEGRO_DISPLAY *al_create_display(int w, int h)
    int64_t flags;
 
    system = al_get_system_driver();
-   driver = system->vt->get_display_driver();
+   if (use_headless_driver())
+      driver = _al_display_headless_driver();
+   else
+      driver = system->vt->get_display_driver();
    if (!driver) {
       ALLEGRO_ERROR("Failed to create display (no display driver)\n");
       return NULL;
@@ -124,7 +145,11 @@ ALLEGRO_DISPLAY *al_create_display(int w, int h)
 #endif
    }
 
-   if (settings->settings[ALLEGRO_AUTO_CONVERT_BITMAPS]) {
+   /* Displays without video bitmaps of their own would only turn the
+    * memory bitmaps into memory bitmaps again.
+    */
+   if (settings->settings[ALLEGRO_AUTO_CONVERT_BITMAPS] &&
+         display->vt->create_bitmap) {
       /* We convert video bitmaps to memory bitmaps when the display is
        * destroyed, so seems only fair to re-convertt hem when the
        * display is re-created again.
@@ -510,6 +535,8 @@ void al_hold_bitmap_drawing(bool hold)
 {
    ALLEGRO_DISPLAY *current_display = al_get_current_display();
 
+   _al_hold_memory_drawing(hold);
+
    if (current_display) {
       if (hold && !current_display->cache_enabled) {
          /*
@@ -546,10 +573,10 @@ bool al_is_bitmap_drawing_held(void)
 {
    ALLEGRO_DISPLAY *current_display = al_get_current_display();
 
-   if (current_display)
-      return current_display->cache_enabled;
+   if (current_display && current_display->cache_enabled)
+      return true;
    else
-      return false;
+      return _al_is_memory_drawing_held();
 }
 
 void _al_add_display_invalidated_callback(ALLEGRO_DISPLAY* display, void (*display_invalidated)(ALLEGRO_DISPLAY*))
@@ -692,6 +719,16 @@ void al_backup_dirty_bitmaps(ALLEGRO_DISPLAY *display)
    }
 }
 
+/* Function: al_acknowledge_display_frame
+ */
+void al_acknowledge_display_frame(ALLEGRO_DISPLAY *display, int64_t number)
+{
+   ASSERT(display);
+
+   if (display->vt->acknowledge_frame)
+      display->vt->acknowledge_frame(display, number);
+}
+
 /* Function: al_apply_window_constraints
  */
 void al_apply_window_constraints(ALLEGRO_DISPLAY *display, bool onoff)
@@ -0,0 +1,438 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Headless display driver.
+ *
+ *      The backbuffer is a memory bitmap and the display has no video
+ *      bitmaps, so everything is drawn by the software primitives and
+ *      the memory blitter. Flips hand the finished frame to whoever
+ *      listens on the display's event source, and drawing continues in
+ *      another buffer until the frame is acknowledged.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_display.h"
+#include "allegro5/internal/aintern_dtor.h"
+#include "allegro5/internal/aintern_events.h"
+#include "allegro5/internal/aintern_pixels.h"
+#include "allegro5/internal/aintern_system.h"
+#include "allegro5/internal/aintern_thread.h"
+
+ALLEGRO_DEBUG_CHANNEL("headless")
+
+#define DEFAULT_FRAME_BUFFERS 3
+#define MAX_FRAME_BUFFERS     16
+
+
+typedef struct HEADLESS_BUFFER
+{
+   unsigned char *memory;
+   bool in_flight;
+   int64_t number;
+} HEADLESS_BUFFER;
+
+typedef struct ALLEGRO_DISPLAY_HEADLESS
+{
+   ALLEGRO_DISPLAY display; /* This must be the first member. */
+
+   ALLEGRO_BITMAP *backbuffer;
+   _AL_LIST_ITEM *dtor_item;
+
+   /* Protects the in_flight flags, which are cleared by
+    * al_acknowledge_display_frame from any thread.
+    */
+   _AL_MUTEX mutex;
+   HEADLESS_BUFFER buffers[MAX_FRAME_BUFFERS];
+   int num_buffers;
+   int current;
+   int64_t frame_number;
+} ALLEGRO_DISPLAY_HEADLESS;
+
+
+static ALLEGRO_DISPLAY_INTERFACE headless_vt;
+
+
+static int get_num_buffers(void)
+{
+   const char *value = al_get_config_value(al_get_system_config(),
+      "graphics", "headless_frame_buffers");
+   int n = value ? atoi(value) : 0;
+
+   if (n <= 0)
+      return DEFAULT_FRAME_BUFFERS;
+   return _ALLEGRO_CLAMP(2, n, MAX_FRAME_BUFFERS);
+}
+
+
+static void free_buffers(ALLEGRO_DISPLAY_HEADLESS *hd)
+{
+   int i;
+
+   /* The backbuffer draws into one of them. */
+   hd->backbuffer->memory = NULL;
+   for (i = 0; i < hd->num_buffers; i++) {
+      al_free(hd->buffers[i].memory);
+      hd->buffers[i].memory = NULL;
+   }
+}
+
+
+/* alloc_buffers:
+ *  Allocates the frame buffers for the given pitch and height, and makes
+ *  the backbuffer draw into the first one. On failure, the old buffers are
+ *  left alone.
+ */
+static bool alloc_buffers(ALLEGRO_DISPLAY_HEADLESS *hd, int pitch, int h)
+{
+   unsigned char *memory[MAX_FRAME_BUFFERS];
+   int i, j;
+
+   for (i = 0; i < hd->num_buffers; i++) {
+      memory[i] = al_malloc(pitch * h);
+      if (!memory[i]) {
+         for (j = 0; j < i; j++)
+            al_free(memory[j]);
+         return false;
+      }
+   }
+
+   free_buffers(hd);
+   for (i = 0; i < hd->num_buffers; i++) {
+      hd->buffers[i].memory = memory[i];
+      hd->buffers[i].in_flight = false;
+   }
+   hd->current = 0;
+   hd->backbuffer->memory = memory[0];
+   return true;
+}
+
+
+static ALLEGRO_DISPLAY *headless_create_display(int w, int h)
+{
+   ALLEGRO_DISPLAY_HEADLESS *hd;
+   ALLEGRO_DISPLAY *d;
+   ALLEGRO_BITMAP *b;
+   int format;
+
+   if (w <= 0 || h <= 0) {
+      ALLEGRO_ERROR("Invalid display size %dx%d.\n", w, h);
+      return NULL;
+   }
+
+   hd = al_calloc(1, sizeof *hd);
+   if (!hd)
+      return NULL;
+   d = &hd->display;
+
+   /* There is no graphics API to pick. */
+   d->vt = &headless_vt;
+   d->flags = al_get_new_display_flags() | ALLEGRO_HEADLESS;
+   d->flags &= ~(ALLEGRO_OPENGL | ALLEGRO_OPENGL_3_0 |
+      ALLEGRO_OPENGL_FORWARD_COMPATIBLE | ALLEGRO_OPENGL_ES_PROFILE |
+      ALLEGRO_OPENGL_CORE_PROFILE | ALLEGRO_DIRECT3D_INTERNAL |
+      ALLEGRO_PROGRAMMABLE_PIPELINE);
+   d->w = w;
+   d->h = h;
+   d->refresh_rate = 0;
+   d->extra_settings = *_al_get_new_display_settings();
+   d->extra_settings.settings[ALLEGRO_COMPATIBLE_DISPLAY] = 1;
+   d->extra_settings.settings[ALLEGRO_RENDER_METHOD] = 0;
+
+   format = al_get_new_bitmap_format();
+   if (_al_pixel_format_is_compressed(format))
+      format = ALLEGRO_PIXEL_FORMAT_ANY_32_WITH_ALPHA;
+   b = _al_create_bitmap_params(NULL, w, h, format, ALLEGRO_MEMORY_BITMAP,
+      0, 0);
+   if (!b) {
+      ALLEGRO_ERROR("Unable to create the backbuffer.\n");
+      al_free(hd);
+      return NULL;
+   }
+   /* Targeting the backbuffer makes the display current, see
+    * al_set_target_bitmap.
+    */
+   b->_display = d;
+   hd->backbuffer = b;
+   d->backbuffer_format = al_get_bitmap_format(b);
+
+   /* The memory of the bitmap is replaced by the frame buffers. */
+   al_free(b->memory);
+   b->memory = NULL;
+   hd->num_buffers = get_num_buffers();
+   if (!alloc_buffers(hd, b->pitch, h)) {
+      ALLEGRO_ERROR("Unable to allocate %d frame buffers.\n", hd->num_buffers);
+      al_destroy_bitmap(b);
+      al_free(hd);
+      return NULL;
+   }
+   _al_mutex_init(&hd->mutex);
+
+   _al_event_source_init(&d->es);
+
+   /* Not in the system's list of displays, which belong to the system
+    * driver, so the display is cleaned up like other objects instead.
+    */
+   hd->dtor_item = _al_register_destructor(_al_dtor_list, "display", d,
+      (void (*)(void *))al_destroy_display);
+
+   ALLEGRO_INFO("Created a %dx%d headless display with %d frame buffers.\n",
+      w, h, hd->num_buffers);
+   return d;
+}
+
+
+static void headless_destroy_display(ALLEGRO_DISPLAY *d)
+{
+   ALLEGRO_DISPLAY_HEADLESS *hd = (void *)d;
+
+   _al_unregister_destructor(_al_dtor_list, hd->dtor_item);
+
+   free_buffers(hd);
+   al_destroy_bitmap(hd->backbuffer);
+
+   _al_vector_free(&d->bitmaps);
+   _al_vector_free(&d->display_invalidated_callbacks);
+   _al_vector_free(&d->display_validated_callbacks);
+   _al_event_source_free(&d->es);
+   _al_mutex_destroy(&hd->mutex);
+   al_free(hd);
+}
+
+
+static bool headless_set_current_display(ALLEGRO_DISPLAY *d)
+{
+   (void)d;
+   return true;
+}
+
+
+static void headless_unset_current_display(ALLEGRO_DISPLAY *d)
+{
+   (void)d;
+}
+
+
+/* find_free_buffer:
+ *  Returns the buffer to draw the next frame into, or -1 if all others are
+ *  still waiting to be acknowledged. Must be called with the mutex held.
+ */
+static int find_free_buffer(ALLEGRO_DISPLAY_HEADLESS *hd)
+{
+   int i;
+
+   for (i = 1; i < hd->num_buffers; i++) {
+      int j = (hd->current + i) % hd->num_buffers;
+      if (!hd->buffers[j].in_flight)
+         return j;
+   }
+   return -1;
+}
+
+
+static void headless_flip_display(ALLEGRO_DISPLAY *d)
+{
+   ALLEGRO_DISPLAY_HEADLESS *hd = (void *)d;
+   ALLEGRO_BITMAP *b = hd->backbuffer;
+   HEADLESS_BUFFER *done = NULL;
+   int next;
+
+   ASSERT(!b->locked);
+
+   hd->frame_number++;
+
+   /* Without listeners the frame is simply done with. */
+   _al_event_source_lock(&d->es);
+   if (_al_event_source_needs_to_generate_event(&d->es)) {
+      _al_mutex_lock(&hd->mutex);
+      next = find_free_buffer(hd);
+      if (next >= 0) {
+         done = &hd->buffers[hd->current];
+         done->in_flight = true;
+         done->number = hd->frame_number;
+         hd->current = next;
+         b->memory = hd->buffers[next].memory;
+      }
+      _al_mutex_unlock(&hd->mutex);
+
+      if (done) {
+         ALLEGRO_EVENT event;
+         event.frame.type = ALLEGRO_EVENT_DISPLAY_FRAME;
+         event.frame.timestamp = al_get_time();
+         event.frame.data = done->memory;
+         event.frame.pitch = b->pitch;
+         event.frame.format = al_get_bitmap_format(b);
+         event.frame.width = b->w;
+         event.frame.height = b->h;
+         event.frame.number = done->number;
+         _al_event_source_emit_event(&d->es, &event);
+      }
+      else {
+         ALLEGRO_DEBUG("Dropped frame %d, all buffers are in flight.\n",
+            (int)hd->frame_number);
+      }
+   }
+   _al_event_source_unlock(&d->es);
+}
+
+
+static void headless_update_display_region(ALLEGRO_DISPLAY *d, int x, int y,
+   int width, int height)
+{
+   (void)x;
+   (void)y;
+   (void)width;
+   (void)height;
+   headless_flip_display(d);
+}
+
+
+static void headless_acknowledge_frame(ALLEGRO_DISPLAY *d, int64_t number)
+{
+   ALLEGRO_DISPLAY_HEADLESS *hd = (void *)d;
+   int i;
+
+   _al_mutex_lock(&hd->mutex);
+   for (i = 0; i < hd->num_buffers; i++) {
+      if (hd->buffers[i].in_flight && hd->buffers[i].number == number) {
+         hd->buffers[i].in_flight = false;
+         break;
+      }
+   }
+   _al_mutex_unlock(&hd->mutex);
+}
+
+
+static bool headless_acknowledge_resize(ALLEGRO_DISPLAY *d)
+{
+   (void)d;
+   return true;
+}
+
+
+static bool headless_resize_display(ALLEGRO_DISPLAY *d, int w, int h)
+{
+   ALLEGRO_DISPLAY_HEADLESS *hd = (void *)d;
+   ALLEGRO_BITMAP *b = hd->backbuffer;
+   int pitch = w * al_get_pixel_size(al_get_bitmap_format(b));
+   int i;
+
+   if (w <= 0 || h <= 0 || b->locked)
+      return false;
+
+   _al_mutex_lock(&hd->mutex);
+
+   /* Frames which were not acknowledged must stay valid. */
+   for (i = 0; i < hd->num_buffers; i++) {
+      if (hd->buffers[i].in_flight) {
+         ALLEGRO_WARN("Cannot resize while frames are in flight.\n");
+         _al_mutex_unlock(&hd->mutex);
+         return false;
+      }
+   }
+
+   if (!alloc_buffers(hd, pitch, h)) {
+      ALLEGRO_ERROR("Unable to allocate %d frame buffers.\n", hd->num_buffers);
+      _al_mutex_unlock(&hd->mutex);
+      return false;
+   }
+
+   b->w = w;
+   b->h = h;
+   b->pitch = pitch;
+   b->cl = 0;
+   b->ct = 0;
+   b->cr_excl = w;
+   b->cb_excl = h;
+   al_identity_transform(&b->proj_transform);
+   al_orthographic_transform(&b->proj_transform, 0, 0, -1.0, w, h, 1.0);
+
+   _al_mutex_unlock(&hd->mutex);
+
+   d->w = w;
+   d->h = h;
+   return true;
+}
+
+
+static ALLEGRO_BITMAP *headless_get_backbuffer(ALLEGRO_DISPLAY *d)
+{
+   ALLEGRO_DISPLAY_HEADLESS *hd = (void *)d;
+   return hd->backbuffer;
+}
+
+
+static bool headless_is_compatible_bitmap(ALLEGRO_DISPLAY *d,
+   ALLEGRO_BITMAP *bitmap)
+{
+   (void)d;
+   (void)bitmap;
+   return true;
+}
+
+
+static void headless_flush_vertex_cache(ALLEGRO_DISPLAY *d)
+{
+   (void)d;
+}
+
+
+/* Memory bitmaps apply their transformation in software. */
+static void headless_update_transformation(ALLEGRO_DISPLAY *d,
+   ALLEGRO_BITMAP *target)
+{
+   (void)d;
+   (void)target;
+}
+
+
+static bool headless_set_display_flag(ALLEGRO_DISPLAY *d, int flag,
+   bool onoff)
+{
+   (void)d;
+   (void)flag;
+   (void)onoff;
+   return false;
+}
+
+
+/* Internal function: _al_display_headless_driver
+ *  Returns the headless display driver, which is used instead of the
+ *  system's own for ALLEGRO_HEADLESS or with driver=headless in the
+ *  [graphics] section of the configuration.
+ */
+ALLEGRO_DISPLAY_INTERFACE *_al_display_headless_driver(void)
+{
+   if (headless_vt.create_display)
+      return &headless_vt;
+
+   headless_vt.id = AL_ID('H', 'D', 'L', 'S');
+   headless_vt.create_display = headless_create_display;
+   headless_vt.destroy_display = headless_destroy_display;
+   headless_vt.set_current_display = headless_set_current_display;
+   headless_vt.unset_current_display = headless_unset_current_display;
+   headless_vt.flip_display = headless_flip_display;
+   headless_vt.update_display_region = headless_update_display_region;
+   headless_vt.acknowledge_resize = headless_acknowledge_resize;
+   headless_vt.resize_display = headless_resize_display;
+   headless_vt.get_backbuffer = headless_get_backbuffer;
+   headless_vt.is_compatible_bitmap = headless_is_compatible_bitmap;
+   headless_vt.flush_vertex_cache = headless_flush_vertex_cache;
+   headless_vt.update_transformation = headless_update_transformation;
+   headless_vt.set_display_flag = headless_set_display_flag;
+   headless_vt.acknowledge_frame = headless_acknowledge_frame;
+
+   return &headless_vt;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -26,6 +26,7 @@
 
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_atomicops.h"
 #include "allegro5/internal/aintern_dtor.h"
 #include "allegro5/internal/aintern_exitfunc.h"
 #include "allegro5/internal/aintern_events.h"
@@ -33,9 +34,56 @@
 
 
 
+/* A slot of the ring used by bounded queues.  Slot i starts with sequence
+ * number i.  A producer may fill the slot when the sequence number equals
+ * the position it claimed, and publishes the event by setting it to
+ * position + 1.  The consumer releases the slot again by advancing the
+ * sequence number by the ring size.
+ */
+typedef struct RING_SLOT
+{
+   volatile _AL_ATOMIC seq;
+   bool discarded;
+   ALLEGRO_EVENT event;
+} RING_SLOT;
+
+
+/* Broadcast registrations let any number of queues read the events of a
+ * source from one shared buffer.  The source (holding its lock) is the
+ * only writer; it never waits for readers and overwrites the oldest event
+ * when the buffer is full.  A slot is being rewritten while head equals
+ * its position plus the buffer size, which is how readers detect that a
+ * copy they made may be torn.
+ */
+#define BROADCAST_SIZE  512
+#define BROADCAST_MASK  (BROADCAST_SIZE - 1)
+
+typedef struct BROADCAST_SLOT
+{
+   bool used;
+   ALLEGRO_EVENT event;
+} BROADCAST_SLOT;
+
+struct _AL_EVENT_BROADCAST
+{
+   volatile _AL_ATOMIC head;  /* position of the next event to publish */
+   _AL_VECTOR readers;        /* vector of (ALLEGRO_EVENT_QUEUE *) */
+   BROADCAST_SLOT slots[BROADCAST_SIZE];
+};
+
+/* What a queue knows about a broadcast source it reads from. */
+typedef struct BROADCAST_READER
+{
+   ALLEGRO_EVENT_SOURCE *source;
+   _AL_EVENT_BROADCAST *broadcast;
+   unsigned int cursor;       /* position of the next event to read */
+} BROADCAST_READER;
+
+
 struct ALLEGRO_EVENT_QUEUE
 {
    _AL_VECTOR sources;  /* vector of (ALLEGRO_EVENT_SOURCE *) */
+   _AL_VECTOR broadcasts;  /* vector of BROADCAST_READER */
    _AL_VECTOR events;   /* vector of ALLEGRO_EVENT, used as circular array */
    unsigned int events_head;  /* write end of circular array */
    unsigned int events_tail;  /* read end of circular array */
@@ -43,6 +91,18 @@ struct ALLEGRO_EVENT_QUEUE
    _AL_MUTEX mutex;
    _AL_COND cond;
    _AL_LIST_ITEM *dtor_item;
+
+   /* Bounded queues use a fixed size ring instead of the events vector.
+    * Producers claim slots without taking the mutex; the consumer side
+    * still runs with the mutex held.
+    */
+   RING_SLOT *ring;
+   unsigned int ring_mask;
+   volatile _AL_ATOMIC ring_head;   /* next position to be claimed */
+   unsigned int ring_tail;          /* next position to be read */
+
+   /* Set by threads about to block on the condition variable. */
+   volatile _AL_ATOMIC sleeping;
 };
 
 
@@ -56,11 +116,16 @@ static _AL_MUTEX user_event_refcount_mutex = _AL_MUTEX_UNINITED;
 static void shutdown_events(void);
 static bool do_wait_for_event(ALLEGRO_EVENT_QUEUE *queue,
    ALLEGRO_EVENT *ret_event, ALLEGRO_TIMEOUT *timeout);
+static bool wait_while_empty(ALLEGRO_EVENT_QUEUE *queue,
+   ALLEGRO_TIMEOUT *timeout);
 static void copy_event(ALLEGRO_EVENT *dest, const ALLEGRO_EVENT *src);
 static void ref_if_user_event(ALLEGRO_EVENT *event);
 static void unref_if_user_event(ALLEGRO_EVENT *event);
 static void discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
    const ALLEGRO_EVENT_SOURCE *source);
+static void pull_broadcast_events(ALLEGRO_EVENT_QUEUE *queue);
+static void skip_broadcast_events(ALLEGRO_EVENT_QUEUE *queue);
+static ALLEGRO_EVENT *alloc_event(ALLEGRO_EVENT_QUEUE *queue);
 
 
 
@@ -95,12 +160,18 @@ ALLEGRO_EVENT_QUEUE *al_create_event_queue(void)
 
    if (queue) {
       _al_vector_init(&queue->sources, sizeof(ALLEGRO_EVENT_SOURCE *));
+      _al_vector_init(&queue->broadcasts, sizeof(BROADCAST_READER));
 
       _al_vector_init(&queue->events, sizeof(ALLEGRO_EVENT));
       _al_vector_alloc_back(&queue->events);
       queue->events_head = 0;
       queue->events_tail = 0;
       queue->paused = false;
+      queue->ring = NULL;
+      queue->ring_mask = 0;
+      queue->ring_head = 0;
+      queue->ring_tail = 0;
+      queue->sleeping = 0;
 
       _AL_MARK_MUTEX_UNINITED(queue->mutex);
       _al_mutex_init(&queue->mutex);
@@ -115,6 +186,134 @@ ALLEGRO_EVENT_QUEUE *al_create_event_queue(void)
 
 
 
+/* Helper to get smallest fitting power of two. */
+static int pot(int x)
+{
+   int y = 1;
+   while (y < x) y *= 2;
+   return y;
+}
+
+
+
+/* Function: al_create_bounded_event_queue
+ */
+ALLEGRO_EVENT_QUEUE *al_create_bounded_event_queue(int capacity)
+{
+   ALLEGRO_EVENT_QUEUE *queue;
+   unsigned int size;
+   unsigned int i;
+
+   ASSERT(capacity > 0);
+
+   /* The sequence numbers need at least two slots to tell a filled slot
+    * from a free one.
+    */
+   size = pot(_ALLEGRO_MAX(capacity, 2));
+
+   queue = al_create_event_queue();
+   if (!queue)
+      return NULL;
+
+   queue->ring = al_malloc(size * sizeof(RING_SLOT));
+   if (!queue->ring) {
+      al_destroy_event_queue(queue);
+      return NULL;
+   }
+
+   for (i = 0; i < size; i++) {
+      queue->ring[i].seq = i;
+      queue->ring[i].discarded = false;
+   }
+   queue->ring_mask = size - 1;
+
+   return queue;
+}
+
+
+
+/* ring_seq_diff:
+ *  Compare a slot sequence number with a position, allowing both to wrap
+ *  around.
+ */
+static int ring_seq_diff(_AL_ATOMIC seq, unsigned int pos)
+{
+   return (int)((unsigned int)seq - pos);
+}
+
+
+
+/* ring_push: [runs in background threads]
+ *  Copy an event into the next free slot of the ring, taking a reference
+ *  to user events if REF is set.  Returns false if the ring is full.  Any
+ *  number of threads may call this concurrently.
+ */
+static bool ring_push(ALLEGRO_EVENT_QUEUE *queue, const ALLEGRO_EVENT *event,
+   bool ref)
+{
+   RING_SLOT *slot;
+   unsigned int pos;
+   int diff;
+
+   for (;;) {
+      pos = _al_atomic_load(&queue->ring_head);
+      slot = &queue->ring[pos & queue->ring_mask];
+      diff = ring_seq_diff(_al_atomic_load(&slot->seq), pos);
+
+      if (diff == 0) {
+         if (_al_compare_and_swap(&queue->ring_head, pos, pos + 1))
+            break;
+      }
+      else if (diff < 0) {
+         /* The slot still holds an event from the previous lap. */
+         return false;
+      }
+      /* Otherwise another producer claimed the position first. */
+   }
+
+   copy_event(&slot->event, event);
+   if (ref)
+      ref_if_user_event(&slot->event);
+   slot->discarded = false;
+   _al_atomic_store(&slot->seq, pos + 1);
+   return true;
+}
+
+
+
+/* ring_release:
+ *  Hand the slot at the read end of the ring back to the producers.
+ *  The queue must be locked.
+ */
+static void ring_release(ALLEGRO_EVENT_QUEUE *queue, RING_SLOT *slot)
+{
+   _al_atomic_store(&slot->seq, queue->ring_tail + queue->ring_mask + 1);
+   queue->ring_tail++;
+}
+
+
+
+/* ring_peek:
+ *  Return the slot holding the next event in the ring, or NULL if no
+ *  event has been published yet.  Slots of discarded events are released
+ *  on the way.  The queue must be locked.
+ */
+static RING_SLOT *ring_peek(ALLEGRO_EVENT_QUEUE *queue)
+{
+   RING_SLOT *slot;
+
+   for (;;) {
+      slot = &queue->ring[queue->ring_tail & queue->ring_mask];
+      if (ring_seq_diff(_al_atomic_load(&slot->seq), queue->ring_tail + 1) != 0)
+         return NULL;
+      if (!slot->discarded)
+         return slot;
+      ring_release(queue, slot);
+   }
+}
+
+
+
 /* Function: al_destroy_event_queue
  */
 void al_destroy_event_queue(ALLEGRO_EVENT_QUEUE *queue)
@@ -131,9 +330,17 @@ void al_destroy_event_queue(ALLEGRO_EVENT_QUEUE *queue)
       ASSERT(_al_vector_is_empty(&queue->sources));
       _al_vector_free(&queue->sources);
 
+      ASSERT(_al_vector_is_empty(&queue->broadcasts));
+      _al_vector_free(&queue->broadcasts);
+
       ASSERT(queue->events_head == queue->events_tail);
       _al_vector_free(&queue->events);
 
+      if (queue->ring) {
+         ASSERT(!ring_peek(queue));
+         al_free(queue->ring);
+      }
+
       _al_cond_destroy(&queue->cond);
       _al_mutex_destroy(&queue->mutex);
 
@@ -176,6 +383,56 @@ void al_register_event_source(ALLEGRO_EVENT_QUEUE *queue,
 
 
 
+/* Function: al_register_broadcast_event_source
+ */
+void al_register_broadcast_event_source(ALLEGRO_EVENT_QUEUE *queue,
+   ALLEGRO_EVENT_SOURCE *source)
+{
+   ALLEGRO_EVENT_SOURCE_REAL *rsrc = (ALLEGRO_EVENT_SOURCE_REAL *)source;
+   _AL_EVENT_BROADCAST *broadcast;
+   ALLEGRO_EVENT_SOURCE **slot;
+   ALLEGRO_EVENT_QUEUE **reader_slot;
+   BROADCAST_READER *reader;
+   unsigned int cursor;
+   ASSERT(queue);
+   ASSERT(source);
+
+   if (_al_vector_contains(&queue->sources, &source))
+      return;
+
+   _al_event_source_lock(source);
+   {
+      if (!rsrc->broadcast) {
+         rsrc->broadcast = al_calloc(1, sizeof(_AL_EVENT_BROADCAST));
+         if (!rsrc->broadcast) {
+            _al_event_source_unlock(source);
+            return;
+         }
+         _al_vector_init(&rsrc->broadcast->readers,
+            sizeof(ALLEGRO_EVENT_QUEUE *));
+      }
+      broadcast = rsrc->broadcast;
+
+      reader_slot = _al_vector_alloc_back(&broadcast->readers);
+      *reader_slot = queue;
+
+      /* Only events published from now on are of interest. */
+      cursor = broadcast->head;
+   }
+   _al_event_source_unlock(source);
+
+   _al_mutex_lock(&queue->mutex);
+   slot = _al_vector_alloc_back(&queue->sources);
+   *slot = source;
+   reader = _al_vector_alloc_back(&queue->broadcasts);
+   reader->source = source;
+   reader->broadcast = broadcast;
+   reader->cursor = cursor;
+   _al_mutex_unlock(&queue->mutex);
+}
+
+
+
 /* Function: al_unregister_event_source
  */
 void al_unregister_event_source(ALLEGRO_EVENT_QUEUE *queue,
@@ -196,7 +453,17 @@ void al_unregister_event_source(ALLEGRO_EVENT_QUEUE *queue,
 
       /* Drop all the events in the queue that belonged to the source. */
       _al_mutex_lock(&queue->mutex);
-      discard_events_of_source(queue, source);
+      {
+         unsigned int i;
+         for (i = 0; i < _al_vector_size(&queue->broadcasts); i++) {
+            BROADCAST_READER *reader = _al_vector_ref(&queue->broadcasts, i);
+            if (reader->source == source) {
+               _al_vector_delete_at(&queue->broadcasts, i);
+               break;
+            }
+         }
+         discard_events_of_source(queue, source);
+      }
       _al_mutex_unlock(&queue->mutex);
    }
 }
@@ -210,6 +477,13 @@ void al_pause_event_queue(ALLEGRO_EVENT_QUEUE *queue, bool pause)
    ASSERT(queue);
 
    _al_mutex_lock(&queue->mutex);
+   /* Take the broadcast events emitted before pausing, and skip those
+    * emitted while paused.
+    */
+   if (pause)
+      pull_broadcast_events(queue);
+   else
+      skip_broadcast_events(queue);
    queue->paused = pause;
    _al_mutex_unlock(&queue->mutex);
 }
@@ -238,11 +512,31 @@ static void heartbeat(void)
 
 static bool is_event_queue_empty(ALLEGRO_EVENT_QUEUE *queue)
 {
+   pull_broadcast_events(queue);
+
+   if (queue->ring)
+      return !ring_peek(queue);
+
    return (queue->events_head == queue->events_tail);
 }
 
 
 
+/* should_sleep:
+ *  Announce that the calling thread is about to block on the condition
+ *  variable, then check that there is still nothing to read.  Producers
+ *  only signal the condition variable after seeing the announcement, i.e.
+ *  when the queue goes from empty to non-empty with someone waiting.
+ *  The queue must be locked.
+ */
+static bool should_sleep(ALLEGRO_EVENT_QUEUE *queue)
+{
+   _al_atomic_store(&queue->sleeping, 1);
+   return is_event_queue_empty(queue);
+}
+
+
+
 /* Function: al_is_event_queue_empty
  */
 bool al_is_event_queue_empty(ALLEGRO_EVENT_QUEUE *queue)
@@ -270,26 +564,41 @@ static unsigned int circ_array_next(const _AL_VECTOR *vector, unsigned int i)
 
 
 /* get_next_event_if_any: [primary thread]
- *  Helper function.  It returns a pointer to the next event in the
- *  queue, or NULL.  Optionally the event is removed from the queue.
- *  However, the event is _not released_ (which is the caller's
- *  responsibility).  The event queue must be locked before entering
- *  this function.
+ *  Helper function.  It copies the next event in the queue into
+ *  RET_EVENT and returns true, or returns false if the queue is empty.
+ *  Optionally the event is removed from the queue.  However, the event
+ *  is _not released_ (which is the caller's responsibility).  The event
+ *  queue must be locked before entering this function.
  */
-static ALLEGRO_EVENT *get_next_event_if_any(ALLEGRO_EVENT_QUEUE *queue,
-   bool delete)
+static bool get_next_event_if_any(ALLEGRO_EVENT_QUEUE *queue,
+   ALLEGRO_EVENT *ret_event, bool delete)
 {
-   ALLEGRO_EVENT *event;
+   if (queue->ring) {
+      RING_SLOT *slot;
+
+      pull_broadcast_events(queue);
+      slot = ring_peek(queue);
+      if (!slot) {
+         return false;
+      }
+
+      /* Copy before releasing, the slot may be reused immediately. */
+      copy_event(ret_event, &slot->event);
+      if (delete) {
+         ring_release(queue, slot);
+      }
+      return true;
+   }
 
    if (is_event_queue_empty(queue)) {
-      return NULL;
+      return false;
    }
 
-   event = _al_vector_ref(&queue->events, queue->events_tail);
+   copy_event(ret_event, _al_vector_ref(&queue->events, queue->events_tail));
    if (delete) {
       queue->events_tail = circ_array_next(&queue->events, queue->events_tail);
    }
-   return event;
+   return true;
 }
 
 
@@ -298,7 +607,7 @@ static ALLEGRO_EVENT *get_next_event_if_any(ALLEGRO_EVENT_QUEUE *queue,
  */
 bool al_get_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 {
-   ALLEGRO_EVENT *next_event;
+   bool found;
    ASSERT(queue);
    ASSERT(ret_event);
 
@@ -306,15 +615,55 @@ bool al_get_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 
    _al_mutex_lock(&queue->mutex);
 
-   next_event = get_next_event_if_any(queue, true);
-   if (next_event) {
-      copy_event(ret_event, next_event);
-      /* Don't increment reference count on user events. */
+   /* Don't increment reference count on user events. */
+   found = get_next_event_if_any(queue, ret_event, true);
+
+   _al_mutex_unlock(&queue->mutex);
+
+   return found;
+}
+
+
+
+/* get_next_events:
+ *  Move up to MAX events from the queue into RET_EVENTS, returning the
+ *  number of events moved.  The queue must be locked.
+ */
+static int get_next_events(ALLEGRO_EVENT_QUEUE *queue,
+   ALLEGRO_EVENT *ret_events, int max)
+{
+   int count = 0;
+
+   while (count < max && get_next_event_if_any(queue, &ret_events[count],
+         true)) {
+      count++;
    }
 
+   return count;
+}
+
+
+
+/* Function: al_get_next_events
+ */
+int al_get_next_events(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_events,
+   int max)
+{
+   int count;
+   ASSERT(queue);
+   ASSERT(ret_events);
+   ASSERT(max >= 0);
+
+   heartbeat();
+
+   _al_mutex_lock(&queue->mutex);
+
+   /* Don't increment reference count on user events. */
+   count = get_next_events(queue, ret_events, max);
+
    _al_mutex_unlock(&queue->mutex);
 
-   return (next_event ? true : false);
+   return count;
 }
 
 
@@ -323,7 +672,7 @@ bool al_get_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
  */
 bool al_peek_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 {
-   ALLEGRO_EVENT *next_event;
+   bool found;
    ASSERT(queue);
    ASSERT(ret_event);
 
@@ -331,15 +680,14 @@ bool al_peek_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 
    _al_mutex_lock(&queue->mutex);
 
-   next_event = get_next_event_if_any(queue, false);
-   if (next_event) {
-      copy_event(ret_event, next_event);
+   found = get_next_event_if_any(queue, ret_event, false);
+   if (found) {
       ref_if_user_event(ret_event);
    }
 
    _al_mutex_unlock(&queue->mutex);
 
-   return (next_event ? true : false);
+   return found;
 }
 
 
@@ -348,21 +696,22 @@ bool al_peek_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
  */
 bool al_drop_next_event(ALLEGRO_EVENT_QUEUE *queue)
 {
-   ALLEGRO_EVENT *next_event;
+   ALLEGRO_EVENT next_event;
+   bool found;
    ASSERT(queue);
 
    heartbeat();
 
    _al_mutex_lock(&queue->mutex);
 
-   next_event = get_next_event_if_any(queue, true);
-   if (next_event) {
-      unref_if_user_event(next_event);
+   found = get_next_event_if_any(queue, &next_event, true);
+   if (found) {
+      unref_if_user_event(&next_event);
    }
 
    _al_mutex_unlock(&queue->mutex);
 
-   return (next_event ? true : false);
+   return found;
 }
 
 
@@ -378,6 +727,24 @@ void al_flush_event_queue(ALLEGRO_EVENT_QUEUE *queue)
 
    _al_mutex_lock(&queue->mutex);
 
+   skip_broadcast_events(queue);
+
+   if (queue->ring) {
+      /* Stop at the head as it was on entry, producers may keep adding
+       * events while we are flushing.
+       */
+      unsigned int head = _al_atomic_load(&queue->ring_head);
+      RING_SLOT *slot;
+
+      while (queue->ring_tail != head && (slot = ring_peek(queue))) {
+         unref_if_user_event(&slot->event);
+         ring_release(queue, slot);
+      }
+
+      _al_mutex_unlock(&queue->mutex);
+      return;
+   }
+
    /* Decrement reference counts on all user events. */
    i = queue->events_tail;
    while (i != queue->events_head) {
@@ -397,26 +764,25 @@ void al_flush_event_queue(ALLEGRO_EVENT_QUEUE *queue)
  */
 void al_wait_for_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 {
-   ALLEGRO_EVENT *next_event = NULL;
-
    ASSERT(queue);
 
    heartbeat();
 
    _al_mutex_lock(&queue->mutex);
    {
+      #ifdef ALLEGRO_WAIT_EVENT_SLEEP
       while (is_event_queue_empty(queue)) {
-         #ifdef ALLEGRO_WAIT_EVENT_SLEEP
          al_rest(0.001);
          heartbeat();
-         #else
+      }
+      #else
+      while (should_sleep(queue)) {
          _al_cond_wait(&queue->cond, &queue->mutex);
-         #endif
       }
+      #endif
 
       if (ret_event) {
-         next_event = get_next_event_if_any(queue, true);
-         copy_event(ret_event, next_event);
+         get_next_event_if_any(queue, ret_event, true);
       }
    }
    _al_mutex_unlock(&queue->mutex);
@@ -461,29 +827,72 @@ bool al_wait_for_event_until(ALLEGRO_EVENT_QUEUE *queue,
 
 
 
+/* Function: al_wait_for_events_timed
+ */
+int al_wait_for_events_timed(ALLEGRO_EVENT_QUEUE *queue,
+   ALLEGRO_EVENT *ret_events, int max, float secs)
+{
+   ALLEGRO_TIMEOUT timeout;
+   int count = 0;
+
+   ASSERT(queue);
+   ASSERT(ret_events);
+   ASSERT(max > 0);
+   ASSERT(secs >= 0);
+
+   heartbeat();
+
+   if (secs < 0.0)
+      al_init_timeout(&timeout, 0);
+   else
+      al_init_timeout(&timeout, secs);
+
+   _al_mutex_lock(&queue->mutex);
+   {
+      if (wait_while_empty(queue, &timeout)) {
+         count = get_next_events(queue, ret_events, max);
+      }
+   }
+   _al_mutex_unlock(&queue->mutex);
+
+   return count;
+}
+
+
+
+/* wait_while_empty:
+ *  Block until the queue is non-empty.  Returns false if the timeout
+ *  expired first.  The queue must be locked.
+ */
+static bool wait_while_empty(ALLEGRO_EVENT_QUEUE *queue,
+   ALLEGRO_TIMEOUT *timeout)
+{
+   int result = 0;
+
+   /* Is the queue is non-empty?  If not, block on a condition
+    * variable, which will be signaled when an event is placed into
+    * the queue.
+    */
+   while ((result != -1) && should_sleep(queue)) {
+      result = _al_cond_timedwait(&queue->cond, &queue->mutex, timeout);
+   }
+
+   return (result != -1);
+}
+
+
+
 static bool do_wait_for_event(ALLEGRO_EVENT_QUEUE *queue,
    ALLEGRO_EVENT *ret_event, ALLEGRO_TIMEOUT *timeout)
 {
    bool timed_out = false;
-   ALLEGRO_EVENT *next_event = NULL;
 
    _al_mutex_lock(&queue->mutex);
    {
-      int result = 0;
-
-      /* Is the queue is non-empty?  If not, block on a condition
-       * variable, which will be signaled when an event is placed into
-       * the queue.
-       */
-      while (is_event_queue_empty(queue) && (result != -1)) {
-         result = _al_cond_timedwait(&queue->cond, &queue->mutex, timeout);
-      }
-
-      if (result == -1)
+      if (!wait_while_empty(queue, timeout))
          timed_out = true;
       else if (ret_event) {
-         next_event = get_next_event_if_any(queue, true);
-         copy_event(ret_event, next_event);
+         get_next_event_if_any(queue, ret_event, true);
       }
    }
    _al_mutex_unlock(&queue->mutex);
@@ -595,6 +1004,8 @@ static void unref_if_user_event(ALLEGRO_EVENT *event)
  *
  *  If no event queues can accept the event, the event should be
  *  returned to the event source's list of recyclable events.
+ *
+ *  Bounded queues drop the event if they are full.
  */
 void _al_event_queue_push_event(ALLEGRO_EVENT_QUEUE *queue,
    const ALLEGRO_EVENT *orig_event)
@@ -606,16 +1017,46 @@ void _al_event_queue_push_event(ALLEGRO_EVENT_QUEUE *queue,
    if (queue->paused)
       return;
 
+#ifndef _AL_ATOMICOPS_EMULATED
+   if (queue->ring) {
+      if (!ring_push(queue, orig_event, true))
+         return;
+
+      /* Only take the lock if a consumer went to sleep on the (then)
+       * empty queue.  The first producer to clear the flag wakes it.
+       */
+      if (_al_atomic_load(&queue->sleeping) &&
+            _al_compare_and_swap(&queue->sleeping, 1, 0)) {
+         _al_mutex_lock(&queue->mutex);
+         _al_cond_broadcast(&queue->cond);
+         _al_mutex_unlock(&queue->mutex);
+      }
+      return;
+   }
+#endif
+
    _al_mutex_lock(&queue->mutex);
    {
-      new_event = alloc_event(queue);
-      copy_event(new_event, orig_event);
-      ref_if_user_event(new_event);
+      if (queue->ring) {
+         /* Without real atomic operations the ring relies on the lock. */
+         if (!ring_push(queue, orig_event, true)) {
+            _al_mutex_unlock(&queue->mutex);
+            return;
+         }
+      }
+      else {
+         new_event = alloc_event(queue);
+         copy_event(new_event, orig_event);
+         ref_if_user_event(new_event);
+      }
 
       /* Wake up threads that are waiting for an event to be placed in
        * the queue.
        */
-      _al_cond_broadcast(&queue->cond);
+      if (queue->sleeping) {
+         queue->sleeping = 0;
+         _al_cond_broadcast(&queue->cond);
+      }
    }
    _al_mutex_unlock(&queue->mutex);
 }
@@ -646,16 +1087,6 @@ static bool contains_event_of_source(const ALLEGRO_EVENT_QUEUE *queue,
 
 
 
-/* Helper to get smallest fitting power of two. */
-static int pot(int x)
-{
-   int y = 1;
-   while (y < x) y *= 2;
-   return y;
-}
-
-
-
 /* discard_events_of_source:
  *  Discard all the events in the queue that belong to the source.
  *  The queue must be locked.
@@ -670,6 +1101,26 @@ static void discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
    size_t new_size;
    unsigned int i;
 
+   if (queue->ring) {
+      /* Producers may still be filling slots for other sources, so mark
+       * the events instead of moving them.  The source is no longer
+       * registered, so none of its events can be in flight.
+       */
+      unsigned int head = _al_atomic_load(&queue->ring_head);
+      RING_SLOT *slot;
+
+      for (i = queue->ring_tail; i != head; i++) {
+         slot = &queue->ring[i & queue->ring_mask];
+         if (ring_seq_diff(_al_atomic_load(&slot->seq), i + 1) != 0)
+            continue;
+         if (!slot->discarded && slot->event.any.source == source) {
+            unref_if_user_event(&slot->event);
+            slot->discarded = true;
+         }
+      }
+      return;
+   }
+
    if (!contains_event_of_source(queue, source)) {
       return;
    }
@@ -706,6 +1157,188 @@ static void discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
 
 
 
+/* Internal function: _al_event_broadcast_has_readers
+ *  Return true if any queue reads from the broadcast buffer.
+ *  The event source must be locked.
+ */
+bool _al_event_broadcast_has_readers(_AL_EVENT_BROADCAST *broadcast)
+{
+   return !_al_vector_is_empty(&broadcast->readers);
+}
+
+
+
+/* Internal function: _al_event_broadcast_remove_reader
+ *  Forget that the queue reads from the broadcast buffer.
+ *  The event source must be locked.
+ */
+bool _al_event_broadcast_remove_reader(_AL_EVENT_BROADCAST *broadcast,
+   ALLEGRO_EVENT_QUEUE *queue)
+{
+   return _al_vector_find_and_delete(&broadcast->readers, &queue);
+}
+
+
+
+/* Internal function: _al_event_broadcast_publish
+ *  Store the event in the broadcast buffer, once for all the queues
+ *  reading it, and wake up those which are waiting for events.
+ *  The event source must be locked.
+ *
+ *  [runs in background threads]
+ */
+void _al_event_broadcast_publish(_AL_EVENT_BROADCAST *broadcast,
+   const ALLEGRO_EVENT *event)
+{
+   const unsigned int pos = broadcast->head;
+   BROADCAST_SLOT *slot = &broadcast->slots[pos & BROADCAST_MASK];
+   unsigned int i;
+
+   /* The buffer holds a reference to user events until the slot is
+    * reused.  Readers take their own reference, see claim_broadcast_event.
+    */
+   if (slot->used)
+      unref_if_user_event(&slot->event);
+   copy_event(&slot->event, event);
+   ref_if_user_event(&slot->event);
+   slot->used = true;
+
+   _al_atomic_store(&broadcast->head, pos + 1);
+
+   /* Only queues with a sleeping consumer need to be told. */
+   for (i = 0; i < _al_vector_size(&broadcast->readers); i++) {
+      ALLEGRO_EVENT_QUEUE **reader = _al_vector_ref(&broadcast->readers, i);
+      ALLEGRO_EVENT_QUEUE *queue = *reader;
+
+      if (_al_atomic_load(&queue->sleeping) &&
+            _al_compare_and_swap(&queue->sleeping, 1, 0)) {
+         _al_mutex_lock(&queue->mutex);
+         _al_cond_broadcast(&queue->cond);
+         _al_mutex_unlock(&queue->mutex);
+      }
+   }
+}
+
+
+
+/* Internal function: _al_event_broadcast_free
+ *  Unregister the event source from all queues reading its broadcast
+ *  buffer and free the buffer.
+ */
+void _al_event_broadcast_free(ALLEGRO_EVENT_SOURCE *es)
+{
+   ALLEGRO_EVENT_SOURCE_REAL *rsrc = (ALLEGRO_EVENT_SOURCE_REAL *)es;
+   _AL_EVENT_BROADCAST *broadcast = rsrc->broadcast;
+   unsigned int i;
+
+   while (!_al_vector_is_empty(&broadcast->readers)) {
+      ALLEGRO_EVENT_QUEUE **slot = _al_vector_ref_back(&broadcast->readers);
+      al_unregister_event_source(*slot, es);
+   }
+   _al_vector_free(&broadcast->readers);
+
+   for (i = 0; i < BROADCAST_SIZE; i++) {
+      if (broadcast->slots[i].used)
+         unref_if_user_event(&broadcast->slots[i].event);
+   }
+
+   al_free(broadcast);
+   rsrc->broadcast = NULL;
+}
+
+
+
+/* claim_broadcast_event:
+ *  Check that EVENT, copied from position POS of the broadcast buffer,
+ *  was not being overwritten while it was copied.  If it is a user event
+ *  the caller gets a reference to it; this has to happen before the
+ *  writer drops the reference held by the buffer.
+ */
+static bool claim_broadcast_event(_AL_EVENT_BROADCAST *broadcast,
+   unsigned int pos, ALLEGRO_EVENT *event)
+{
+   bool valid;
+
+   if (ALLEGRO_EVENT_TYPE_IS_USER(event->type) &&
+         event->user.__internal__descr) {
+      _al_mutex_lock(&user_event_refcount_mutex);
+      valid = (unsigned int)_al_atomic_load(&broadcast->head) - pos <
+         BROADCAST_SIZE;
+      if (valid)
+         event->user.__internal__descr->refcount++;
+      _al_mutex_unlock(&user_event_refcount_mutex);
+      return valid;
+   }
+
+   return (unsigned int)_al_atomic_load(&broadcast->head) - pos <
+      BROADCAST_SIZE;
+}
+
+
+
+/* pull_broadcast_events:
+ *  Move the events published since the last call from the broadcast
+ *  buffers of the sources into the queue.  Events which were overwritten
+ *  before this queue got to them are lost.  They are appended after the
+ *  events already queued, so the queue is not in timestamp order across
+ *  sources (documented for al_register_broadcast_event_source).
+ *  The queue must be locked.
+ */
+static void pull_broadcast_events(ALLEGRO_EVENT_QUEUE *queue)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&queue->broadcasts); i++) {
+      BROADCAST_READER *reader = _al_vector_ref(&queue->broadcasts, i);
+      _AL_EVENT_BROADCAST *broadcast = reader->broadcast;
+      unsigned int head = _al_atomic_load(&broadcast->head);
+
+      if (queue->paused) {
+         reader->cursor = head;
+         continue;
+      }
+
+      if (head - reader->cursor > BROADCAST_SIZE)
+         reader->cursor = head - BROADCAST_SIZE;
+
+      for (; reader->cursor != head; reader->cursor++) {
+         BROADCAST_SLOT *slot =
+            &broadcast->slots[reader->cursor & BROADCAST_MASK];
+         ALLEGRO_EVENT event;
+
+         copy_event(&event, &slot->event);
+         if (!claim_broadcast_event(broadcast, reader->cursor, &event))
+            continue;
+
+         if (queue->ring) {
+            if (!ring_push(queue, &event, false))
+               unref_if_user_event(&event);
+         }
+         else {
+            copy_event(alloc_event(queue), &event);
+         }
+      }
+   }
+}
+
+
+
+/* skip_broadcast_events:
+ *  Ignore the events currently in the broadcast buffers.
+ *  The queue must be locked.
+ */
+static void skip_broadcast_events(ALLEGRO_EVENT_QUEUE *queue)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&queue->broadcasts); i++) {
+      BROADCAST_READER *reader = _al_vector_ref(&queue->broadcasts, i);
+      reader->cursor = _al_atomic_load(&reader->broadcast->head);
+   }
+}
+
+
+
 /* Function: al_unref_user_event
  */
 void al_unref_user_event(ALLEGRO_USER_EVENT *event)
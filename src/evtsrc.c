@@ -43,6 +43,7 @@ void _al_event_source_init(ALLEGRO_EVENT_SOURCE *es)
    _al_mutex_init(&this->mutex);
    _al_vector_init(&this->queues, sizeof(ALLEGRO_EVENT_QUEUE *));
    this->data = 0;
+   this->broadcast = NULL;
 }
 
 
@@ -62,6 +63,10 @@ void _al_event_source_free(ALLEGRO_EVENT_SOURCE *es)
       al_unregister_event_source(*slot, es);
    }
 
+   /* This also unregisters from the queues reading the broadcast buffer. */
+   if (this->broadcast)
+      _al_event_broadcast_free(es);
+
    _al_vector_free(&this->queues);
 
    _al_mutex_destroy(&this->mutex);
@@ -126,7 +131,10 @@ void _al_event_source_on_unregistration_from_queue(ALLEGRO_EVENT_SOURCE *es,
    {
       ALLEGRO_EVENT_SOURCE_REAL *this = (ALLEGRO_EVENT_SOURCE_REAL *)es;
 
-      _al_vector_find_and_delete(&this->queues, &queue);
+      if (!_al_vector_find_and_delete(&this->queues, &queue) &&
+            this->broadcast) {
+         _al_event_broadcast_remove_reader(this->broadcast, queue);
+      }
    }
    _al_event_source_unlock(es);
 }
@@ -152,7 +160,10 @@ bool _al_event_source_needs_to_generate_event(ALLEGRO_EVENT_SOURCE *es)
    /* We don't consider pausing of event queues, but it does not seem worth
     * optimising for.
     */
-   return !_al_vector_is_empty(&this->queues);
+   if (!_al_vector_is_empty(&this->queues))
+      return true;
+
+   return this->broadcast && _al_event_broadcast_has_readers(this->broadcast);
 }
 
 
@@ -186,6 +197,13 @@ void _al_event_source_emit_event(ALLEGRO_EVENT_SOURCE *es, ALLEGRO_EVENT *event)
          _al_event_queue_push_event(*slot, event);
       }
    }
+
+   /* Queues registered with al_register_broadcast_event_source share a
+    * single copy of the event.
+    */
+   if (this->broadcast && _al_event_broadcast_has_readers(this->broadcast)) {
+      _al_event_broadcast_publish(this->broadcast, event);
+   }
 }
 
 
@@ -217,7 +235,6 @@ void al_destroy_user_event_source(ALLEGRO_EVENT_SOURCE *src)
 bool al_emit_user_event(ALLEGRO_EVENT_SOURCE *src,
    ALLEGRO_EVENT *event, void (*dtor)(ALLEGRO_USER_EVENT *))
 {
-   size_t num_queues;
    bool rc;
 
    ASSERT(src);
@@ -225,7 +242,10 @@ bool al_emit_user_event(ALLEGRO_EVENT_SOURCE *src,
 
    if (dtor) {
       ALLEGRO_USER_EVENT_DESCRIPTOR *descr = al_malloc(sizeof(*descr));
-      descr->refcount = 0;
+      /* Hold a reference while emitting, otherwise a consumer of the first
+       * queue could release the event before it reaches the other queues.
+       */
+      descr->refcount = 1;
       descr->dtor = dtor;
       event->user.__internal__descr = descr;
    }
@@ -235,10 +255,7 @@ bool al_emit_user_event(ALLEGRO_EVENT_SOURCE *src,
 
    _al_event_source_lock(src);
    {
-      ALLEGRO_EVENT_SOURCE_REAL *rsrc = (ALLEGRO_EVENT_SOURCE_REAL *)src;
-
-      num_queues = _al_vector_size(&rsrc->queues);
-      if (num_queues > 0) {
+      if (_al_event_source_needs_to_generate_event(src)) {
          event->any.timestamp = al_get_time();
          _al_event_source_emit_event(src, event);
          rc = true;
@@ -249,9 +266,9 @@ bool al_emit_user_event(ALLEGRO_EVENT_SOURCE *src,
    }
    _al_event_source_unlock(src);
 
-   if (dtor && !rc) {
-      dtor(&event->user);
-      al_free(event->user.__internal__descr);
+   /* This calls the destructor if no queue took the event. */
+   if (dtor) {
+      al_unref_user_event(&event->user);
    }
 
    return rc;
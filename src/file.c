@@ -538,6 +538,28 @@ void *al_get_file_userdata(ALLEGRO_FILE *f)
 }
 
 
+/* Function: al_get_file_mapping
+ */
+const void *al_get_file_mapping(ALLEGRO_FILE *f, int64_t *size)
+{
+   int64_t dummy;
+   ASSERT(f != NULL);
+
+   if (!size)
+      size = &dummy;
+
+   if (f->vtable == &_al_file_interface_mmap)
+      return _al_get_mmap_file_data(f, size);
+   if (f->vtable == &_al_file_interface_slice)
+      return _al_get_slice_file_data(f, size);
+   if (f->vtable == &_al_file_interface_pack)
+      return _al_get_pack_file_data(f, size);
+
+   *size = 0;
+   return NULL;
+}
+
+
 /* Function: al_vfprintf
  */
 int al_vfprintf(ALLEGRO_FILE *pfile, const char *format, va_list args)
@@ -0,0 +1,383 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Memory mapped file I/O.
+ *
+ *      Files are mapped read-only as a whole when opened, so reads are a
+ *      single copy out of the page cache and loaders can get at the
+ *      contents directly with al_get_file_mapping. Platforms without
+ *      mmap read the whole file into memory instead.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
+
+#if defined ALLEGRO_WINDOWS
+   #include <windows.h>
+   #include "allegro5/internal/aintern_wunicode.h"
+#elif defined ALLEGRO_HAVE_MMAP
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+#endif
+
+ALLEGRO_DEBUG_CHANNEL("mmap")
+
+
+typedef struct
+{
+   const char *data;
+   int64_t size;
+   int64_t pos;
+   bool eof;
+#if defined ALLEGRO_WINDOWS
+   HANDLE mapping;
+#endif
+} USERDATA;
+
+
+/* map_file:
+ *  Maps the whole file at path into memory. Empty files get no mapping,
+ *  and unmap_file is only called for files which are not empty.
+ */
+#if defined ALLEGRO_WINDOWS
+
+static bool map_file(USERDATA *userdata, const char *path)
+{
+   wchar_t *wpath = _al_win_utf8_to_utf16(path);
+   HANDLE file;
+   LARGE_INTEGER size;
+
+   if (!wpath)
+      return false;
+   file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   al_free(wpath);
+   if (file == INVALID_HANDLE_VALUE) {
+      al_set_errno(ENOENT);
+      return false;
+   }
+
+   if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      al_set_errno(EIO);
+      return false;
+   }
+   userdata->size = size.QuadPart;
+
+   if (userdata->size > 0) {
+      userdata->mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0,
+         NULL);
+      if (userdata->mapping) {
+         userdata->data = MapViewOfFile(userdata->mapping, FILE_MAP_READ,
+            0, 0, 0);
+         if (!userdata->data)
+            CloseHandle(userdata->mapping);
+      }
+   }
+   CloseHandle(file);
+
+   if (userdata->size > 0 && !userdata->data) {
+      al_set_errno(ENOMEM);
+      return false;
+   }
+   return true;
+}
+
+
+static void unmap_file(USERDATA *userdata)
+{
+   UnmapViewOfFile(userdata->data);
+   CloseHandle(userdata->mapping);
+}
+
+#elif defined ALLEGRO_HAVE_MMAP
+
+static bool map_file(USERDATA *userdata, const char *path)
+{
+   struct stat st;
+   void *data;
+   int fd;
+
+   fd = open(path, O_RDONLY);
+   if (fd == -1) {
+      al_set_errno(errno);
+      return false;
+   }
+
+   if (fstat(fd, &st) == -1) {
+      al_set_errno(errno);
+      close(fd);
+      return false;
+   }
+   userdata->size = st.st_size;
+
+   if (userdata->size > 0) {
+      data = mmap(NULL, userdata->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+         al_set_errno(errno);
+         close(fd);
+         return false;
+      }
+      userdata->data = data;
+   }
+
+   /* The mapping stays valid after the descriptor is closed. */
+   close(fd);
+   return true;
+}
+
+
+static void unmap_file(USERDATA *userdata)
+{
+   munmap((void *)userdata->data, userdata->size);
+}
+
+#else
+
+static bool map_file(USERDATA *userdata, const char *path)
+{
+   ALLEGRO_FILE *f = al_fopen_interface(&_al_file_interface_stdio, path, "rb");
+   char *data;
+
+   if (!f)
+      return false;
+
+   userdata->size = al_fsize(f);
+   if (userdata->size < 0) {
+      al_fclose(f);
+      return false;
+   }
+
+   if (userdata->size > 0) {
+      data = al_malloc(userdata->size);
+      if (!data || al_fread(f, data, userdata->size) != (size_t)userdata->size) {
+         al_free(data);
+         al_fclose(f);
+         return false;
+      }
+      userdata->data = data;
+   }
+
+   al_fclose(f);
+   return true;
+}
+
+
+static void unmap_file(USERDATA *userdata)
+{
+   al_free((void *)userdata->data);
+}
+
+#endif
+
+
+static void *file_mmap_fopen(const char *path, const char *mode)
+{
+   USERDATA *userdata;
+
+   ALLEGRO_DEBUG("opening %s %s\n", path, mode);
+
+   if (strpbrk(mode, "wa+")) {
+      ALLEGRO_ERROR("Memory mapped files are read-only.\n");
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+
+   userdata = al_calloc(1, sizeof(USERDATA));
+   if (!userdata) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+
+   if (!map_file(userdata, path)) {
+      al_free(userdata);
+      return NULL;
+   }
+
+   /* Empty files still have a (zero length) mapping. */
+   if (userdata->size == 0)
+      userdata->data = "";
+
+   return userdata;
+}
+
+
+static bool file_mmap_fclose(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   if (userdata->size > 0)
+      unmap_file(userdata);
+   al_free(userdata);
+
+   return true;
+}
+
+
+static size_t file_mmap_fread(ALLEGRO_FILE *f, void *ptr, size_t size)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+   int64_t left = userdata->size - userdata->pos;
+
+   if (left < (int64_t)size) {
+      size = left > 0 ? (size_t)left : 0;
+      userdata->eof = true;
+   }
+
+   if (size > 0) {
+      memcpy(ptr, userdata->data + userdata->pos, size);
+      userdata->pos += size;
+   }
+
+   return size;
+}
+
+
+static size_t file_mmap_fwrite(ALLEGRO_FILE *f, const void *ptr, size_t size)
+{
+   (void)f;
+   (void)ptr;
+   (void)size;
+
+   al_set_errno(EPERM);
+   return 0;
+}
+
+
+static bool file_mmap_fflush(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return true;
+}
+
+
+static int64_t file_mmap_ftell(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   return userdata->pos;
+}
+
+
+static bool file_mmap_fseek(ALLEGRO_FILE *f, int64_t offset, int whence)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+   int64_t pos;
+
+   switch (whence) {
+      case ALLEGRO_SEEK_SET: pos = offset; break;
+      case ALLEGRO_SEEK_CUR: pos = userdata->pos + offset; break;
+      case ALLEGRO_SEEK_END: pos = userdata->size + offset; break;
+      default:
+         al_set_errno(EINVAL);
+         return false;
+   }
+
+   if (pos < 0) {
+      al_set_errno(EINVAL);
+      return false;
+   }
+
+   userdata->pos = pos;
+   userdata->eof = false;
+
+   return true;
+}
+
+
+static bool file_mmap_feof(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   return userdata->eof;
+}
+
+
+static int file_mmap_ferror(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return 0;
+}
+
+
+static const char *file_mmap_ferrmsg(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return "";
+}
+
+
+static void file_mmap_fclearerr(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   userdata->eof = false;
+}
+
+
+static off_t file_mmap_fsize(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   return userdata->size;
+}
+
+
+const struct ALLEGRO_FILE_INTERFACE _al_file_interface_mmap =
+{
+   file_mmap_fopen,
+   file_mmap_fclose,
+   file_mmap_fread,
+   file_mmap_fwrite,
+   file_mmap_fflush,
+   file_mmap_ftell,
+   file_mmap_fseek,
+   file_mmap_feof,
+   file_mmap_ferror,
+   file_mmap_ferrmsg,
+   file_mmap_fclearerr,
+   NULL,
+   file_mmap_fsize
+};
+
+
+/* _al_get_mmap_file_data:
+ *  Returns the contents of a file opened with the mmap interface.
+ */
+const void *_al_get_mmap_file_data(ALLEGRO_FILE *f, int64_t *size)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   *size = userdata->size;
+   return userdata->data;
+}
+
+
+/* Function: al_fopen_mmap
+ */
+ALLEGRO_FILE *al_fopen_mmap(const char *path, const char *mode)
+{
+   return al_fopen_interface(&_al_file_interface_mmap, path, mode);
+}
+
+
+/* Function: al_get_mmap_file_interface
+ */
+const ALLEGRO_FILE_INTERFACE *al_get_mmap_file_interface(void)
+{
+   return &_al_file_interface_mmap;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,726 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Pack files.
+ *
+ *      A pack is a single file holding many others, so opening one of
+ *      them is a lookup in an index kept in memory instead of an open and
+ *      stat on the file system. The pack is memory mapped, and stored
+ *      entries are read straight out of the mapping.
+ *
+ *      All numbers are little endian. The file starts with a header:
+ *
+ *         0  "ALPK"
+ *         4  uint32   version (1)
+ *         8  uint32   number of entries
+ *        12  uint32   flags (0)
+ *        16  uint64   offset of the index
+ *        24  uint64   offset of the name table
+ *        32  uint64   size of the name table
+ *
+ *      The contents of the entries follow, each aligned to 16 bytes. The
+ *      name table holds the names of the entries, relative to the root of
+ *      the pack and separated with slashes, without terminators. The
+ *      index is an array of 40 byte entries sorted by hash and then name:
+ *
+ *         0  uint32   FNV-1a hash of the name
+ *         4  uint32   offset of the name in the name table
+ *         8  uint32   length of the name
+ *        12  uint32   0 = stored, 1 = LZ4 block
+ *        16  uint64   offset of the contents
+ *        24  uint64   size of the contents in the pack
+ *        32  uint64   size of the contents when read
+ *
+ *      It is followed by one uint32 per entry, giving the entries in the
+ *      order of their names, which is used to list directories.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include <string.h>
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
+#include "allegro5/internal/aintern_tls.h"
+
+ALLEGRO_DEBUG_CHANNEL("pack")
+
+
+typedef struct
+{
+   ALLEGRO_PACK *pack;
+   const unsigned char *data;
+   int64_t size;
+   int64_t pos;
+   bool eof;
+   unsigned char *buffer;  /* decompressed contents */
+} USERDATA;
+
+
+static uint32_t read32(const unsigned char *p)
+{
+   return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+      ((uint32_t)p[3] << 24);
+}
+
+
+static uint64_t read64(const unsigned char *p)
+{
+   return (uint64_t)read32(p) | ((uint64_t)read32(p + 4) << 32);
+}
+
+
+/* _al_pack_hash:
+ *  32-bit FNV-1a hash of an entry name.
+ */
+uint32_t _al_pack_hash(const char *name, size_t len)
+{
+   uint32_t h = 2166136261u;
+   size_t i;
+
+   for (i = 0; i < len; i++) {
+      h ^= (unsigned char)name[i];
+      h *= 16777619u;
+   }
+   return h;
+}
+
+
+/* _al_pack_compare_names:
+ *  Compares names byte by byte, like strcmp.
+ */
+int _al_pack_compare_names(const char *a, size_t a_len,
+   const char *b, size_t b_len)
+{
+   int c = memcmp(a, b, _ALLEGRO_MIN(a_len, b_len));
+
+   if (c != 0)
+      return c;
+   if (a_len != b_len)
+      return a_len < b_len ? -1 : 1;
+   return 0;
+}
+
+
+static int compare_entries(const _AL_PACK_ENTRY *a, const _AL_PACK_ENTRY *b)
+{
+   if (a->hash != b->hash)
+      return a->hash < b->hash ? -1 : 1;
+   return _al_pack_compare_names(a->name, a->name_len, b->name, b->name_len);
+}
+
+
+/* read_index:
+ *  Decodes and checks the index, so that the entries can be trusted
+ *  afterwards.
+ */
+static bool read_index(ALLEGRO_PACK *pack)
+{
+   const unsigned char *h = pack->data;
+   uint64_t index_offset, names_offset, names_size;
+   uint64_t size = pack->size;
+   const char *names;
+   uint32_t n, i;
+
+   if (size < _AL_PACK_HEADER_SIZE || memcmp(h, _AL_PACK_MAGIC, 4) != 0) {
+      ALLEGRO_ERROR("Not a pack file.\n");
+      return false;
+   }
+   if (read32(h + 4) != _AL_PACK_VERSION) {
+      ALLEGRO_ERROR("Unsupported pack version %u.\n", read32(h + 4));
+      return false;
+   }
+
+   n = read32(h + 8);
+   index_offset = read64(h + 16);
+   names_offset = read64(h + 24);
+   names_size = read64(h + 32);
+
+   if (index_offset > size ||
+         (size - index_offset) / (_AL_PACK_ENTRY_SIZE + 4) < n ||
+         names_offset > size || names_size > size - names_offset) {
+      ALLEGRO_ERROR("Pack index out of bounds.\n");
+      return false;
+   }
+   names = (const char *)pack->data + names_offset;
+
+   pack->num_entries = n;
+   pack->entries = al_malloc(_ALLEGRO_MAX(n, 1) * sizeof(_AL_PACK_ENTRY));
+   pack->by_name = al_malloc(_ALLEGRO_MAX(n, 1) * sizeof(uint32_t));
+   if (!pack->entries || !pack->by_name)
+      return false;
+
+   for (i = 0; i < n; i++) {
+      const unsigned char *p = pack->data + index_offset +
+         (uint64_t)i * _AL_PACK_ENTRY_SIZE;
+      _AL_PACK_ENTRY *e = &pack->entries[i];
+      uint32_t name_offset = read32(p + 4);
+
+      e->hash = read32(p);
+      e->name_len = read32(p + 8);
+      e->method = read32(p + 12);
+      e->offset = read64(p + 16);
+      e->size = read64(p + 24);
+      e->raw_size = read64(p + 32);
+
+      if (name_offset > names_size || e->name_len > names_size - name_offset ||
+            e->offset > size || e->size > size - e->offset) {
+         ALLEGRO_ERROR("Pack entry %u out of bounds.\n", i);
+         return false;
+      }
+      if (e->method != _AL_PACK_STORED && e->method != _AL_PACK_LZ4) {
+         ALLEGRO_ERROR("Pack entry %u has an unknown method %u.\n", i,
+            e->method);
+         return false;
+      }
+      /* The contents are read into memory whole, and LZ4 can't expand
+       * data more than 255 times.
+       */
+      if (e->raw_size > SIZE_MAX ||
+            (e->method == _AL_PACK_STORED ? e->raw_size != e->size :
+               e->raw_size / 255 > e->size)) {
+         ALLEGRO_ERROR("Pack entry %u has a bad size.\n", i);
+         return false;
+      }
+      e->name = names + name_offset;
+      if (e->hash != _al_pack_hash(e->name, e->name_len) ||
+            (i > 0 && compare_entries(e - 1, e) >= 0)) {
+         ALLEGRO_ERROR("Pack index is not sorted.\n");
+         return false;
+      }
+   }
+
+   for (i = 0; i < n; i++) {
+      const unsigned char *p = pack->data + index_offset +
+         (uint64_t)n * _AL_PACK_ENTRY_SIZE + i * 4;
+      pack->by_name[i] = read32(p);
+      if (pack->by_name[i] >= n) {
+         ALLEGRO_ERROR("Pack name order out of bounds.\n");
+         return false;
+      }
+      /* Strictly increasing names also make this a permutation. */
+      if (i > 0) {
+         _AL_PACK_ENTRY *a = &pack->entries[pack->by_name[i - 1]];
+         _AL_PACK_ENTRY *b = &pack->entries[pack->by_name[i]];
+         if (_al_pack_compare_names(a->name, a->name_len,
+               b->name, b->name_len) >= 0) {
+            ALLEGRO_ERROR("Pack name order is not sorted.\n");
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+
+/* Function: al_open_pack
+ */
+ALLEGRO_PACK *al_open_pack(const char *path)
+{
+   ALLEGRO_PACK *pack;
+
+   ASSERT(path);
+
+   pack = al_calloc(1, sizeof *pack);
+   if (!pack)
+      return NULL;
+
+   pack->fp = al_fopen_mmap(path, "rb");
+   if (!pack->fp) {
+      al_free(pack);
+      return NULL;
+   }
+   pack->data = al_get_file_mapping(pack->fp, &pack->size);
+   pack->cwd = al_ustr_new("");
+
+   if (!pack->data || !pack->cwd || !read_index(pack)) {
+      al_close_pack(pack);
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+
+   ALLEGRO_DEBUG("Opened %s with %u entries.\n", path, pack->num_entries);
+   return pack;
+}
+
+
+/* Function: al_close_pack
+ */
+void al_close_pack(ALLEGRO_PACK *pack)
+{
+   ALLEGRO_PACK **current = _al_tls_get_pack();
+
+   if (!pack)
+      return;
+
+   if (current && *current == pack) {
+      *current = NULL;
+      if (al_get_new_file_interface() == &_al_file_interface_pack)
+         al_set_standard_file_interface();
+      if (al_get_fs_interface() == &_al_fs_interface_pack)
+         al_set_standard_fs_interface();
+   }
+
+   al_ustr_free(pack->cwd);
+   al_free(pack->entries);
+   al_free(pack->by_name);
+   al_fclose(pack->fp);
+   al_free(pack);
+}
+
+
+/* _al_pack_resolve_path:
+ *  Turns a path into an entry name, relative to the current directory of
+ *  the pack unless it starts with a slash. Fails if the path leaves the
+ *  root of the pack.
+ */
+bool _al_pack_resolve_path(ALLEGRO_PACK *pack, const char *path,
+   ALLEGRO_USTR *out)
+{
+   const char *p = path;
+
+   if (*p == '/' || *p == '\\')
+      al_ustr_truncate(out, 0);
+   else
+      al_ustr_assign(out, pack->cwd);
+
+   while (*p) {
+      const char *end = p;
+      size_t len;
+
+      while (*end && *end != '/' && *end != '\\')
+         end++;
+      len = end - p;
+
+      if (len == 0 || (len == 1 && p[0] == '.')) {
+         /* Nothing to do. */
+      }
+      else if (len == 2 && p[0] == '.' && p[1] == '.') {
+         int slash = al_ustr_rfind_chr(out, al_ustr_size(out), '/');
+         if (al_ustr_size(out) == 0)
+            return false;
+         al_ustr_truncate(out, slash < 0 ? 0 : slash);
+      }
+      else {
+         ALLEGRO_USTR_INFO info;
+         if (al_ustr_size(out) > 0)
+            al_ustr_append_chr(out, '/');
+         al_ustr_append(out, al_ref_buffer(&info, p, len));
+      }
+
+      p = *end ? end + 1 : end;
+   }
+
+   return true;
+}
+
+
+/* _al_pack_find_entry:
+ *  Returns the entry with the given name, or NULL.
+ */
+_AL_PACK_ENTRY *_al_pack_find_entry(ALLEGRO_PACK *pack, const char *name,
+   size_t len)
+{
+   _AL_PACK_ENTRY key;
+   uint32_t lo = 0, hi = pack->num_entries;
+
+   key.hash = _al_pack_hash(name, len);
+   key.name = name;
+   key.name_len = len;
+
+   while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      int c = compare_entries(&pack->entries[mid], &key);
+      if (c == 0)
+         return &pack->entries[mid];
+      if (c < 0)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return NULL;
+}
+
+
+/* _al_pack_find_prefix:
+ *  Returns the position in the name order of the first name not less than
+ *  prefix. All names starting with prefix follow from there.
+ */
+uint32_t _al_pack_find_prefix(ALLEGRO_PACK *pack, const char *prefix,
+   size_t len)
+{
+   uint32_t lo = 0, hi = pack->num_entries;
+
+   while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      _AL_PACK_ENTRY *e = &pack->entries[pack->by_name[mid]];
+      if (_al_pack_compare_names(e->name, e->name_len, prefix, len) < 0)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return lo;
+}
+
+
+/* lz4_decompress:
+ *  Decodes an LZ4 block which must expand to exactly dst_size bytes.
+ */
+static bool lz4_decompress(const unsigned char *src, uint64_t src_size,
+   unsigned char *dst, uint64_t dst_size)
+{
+   const unsigned char *ip = src;
+   const unsigned char *iend = src + src_size;
+   unsigned char *op = dst;
+   unsigned char *oend = dst + dst_size;
+
+   for (;;) {
+      const unsigned char *match;
+      unsigned int token, b;
+      size_t len, offset;
+
+      if (ip >= iend)
+         return false;
+      token = *ip++;
+
+      /* Literals. */
+      len = token >> 4;
+      if (len == 15) {
+         do {
+            if (ip >= iend)
+               return false;
+            b = *ip++;
+            len += b;
+         } while (b == 255);
+      }
+      if ((size_t)(iend - ip) < len || (size_t)(oend - op) < len)
+         return false;
+      memcpy(op, ip, len);
+      ip += len;
+      op += len;
+
+      /* The last sequence has no match. */
+      if (ip == iend)
+         break;
+
+      /* Match. */
+      if (iend - ip < 2)
+         return false;
+      offset = ip[0] | (ip[1] << 8);
+      ip += 2;
+      if (offset == 0 || offset > (size_t)(op - dst))
+         return false;
+
+      len = token & 15;
+      if (len == 15) {
+         do {
+            if (ip >= iend)
+               return false;
+            b = *ip++;
+            len += b;
+         } while (b == 255);
+      }
+      len += 4;
+      if ((size_t)(oend - op) < len)
+         return false;
+
+      /* Overlapping matches repeat the last offset bytes, so the part
+       * already copied can be copied again, doubling each time.
+       */
+      match = op - offset;
+      while (len > 0) {
+         size_t n = _ALLEGRO_MIN(len, (size_t)(op - match));
+         memcpy(op, match, n);
+         op += n;
+         len -= n;
+      }
+   }
+
+   return op == oend;
+}
+
+
+static USERDATA *open_entry(ALLEGRO_PACK *pack, _AL_PACK_ENTRY *e)
+{
+   USERDATA *userdata = al_calloc(1, sizeof(USERDATA));
+
+   if (!userdata) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+   userdata->pack = pack;
+   userdata->size = e->raw_size;
+
+   if (e->method == _AL_PACK_STORED) {
+      userdata->data = pack->data + e->offset;
+      return userdata;
+   }
+
+   userdata->buffer = al_malloc(_ALLEGRO_MAX(e->raw_size, 1));
+   if (!userdata->buffer) {
+      al_free(userdata);
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+   if (!lz4_decompress(pack->data + e->offset, e->size, userdata->buffer,
+         e->raw_size)) {
+      ALLEGRO_ERROR("Corrupt pack entry %.*s.\n", (int)e->name_len, e->name);
+      al_free(userdata->buffer);
+      al_free(userdata);
+      al_set_errno(EIO);
+      return NULL;
+   }
+   userdata->data = userdata->buffer;
+   return userdata;
+}
+
+
+/* _al_pack_open_entry:
+ *  Opens an entry of the pack for reading.
+ */
+ALLEGRO_FILE *_al_pack_open_entry(ALLEGRO_PACK *pack, _AL_PACK_ENTRY *e)
+{
+   USERDATA *userdata = open_entry(pack, e);
+   ALLEGRO_FILE *f;
+
+   if (!userdata)
+      return NULL;
+
+   f = al_create_file_handle(&_al_file_interface_pack, userdata);
+   if (!f) {
+      al_free(userdata->buffer);
+      al_free(userdata);
+   }
+   return f;
+}
+
+
+static void *file_pack_fopen(const char *path, const char *mode)
+{
+   ALLEGRO_PACK **pack = _al_tls_get_pack();
+   ALLEGRO_USTR *name;
+   _AL_PACK_ENTRY *e = NULL;
+
+   if (strpbrk(mode, "wa+")) {
+      ALLEGRO_ERROR("Pack files are read-only.\n");
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+   if (!pack || !*pack) {
+      ALLEGRO_ERROR("No pack set for this thread.\n");
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+
+   name = al_ustr_new("");
+   if (name && _al_pack_resolve_path(*pack, path, name))
+      e = _al_pack_find_entry(*pack, al_cstr(name), al_ustr_size(name));
+   al_ustr_free(name);
+
+   if (!e) {
+      al_set_errno(ENOENT);
+      return NULL;
+   }
+   return open_entry(*pack, e);
+}
+
+
+static bool file_pack_fclose(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   al_free(userdata->buffer);
+   al_free(userdata);
+
+   return true;
+}
+
+
+static size_t file_pack_fread(ALLEGRO_FILE *f, void *ptr, size_t size)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+   int64_t left = userdata->size - userdata->pos;
+
+   if (left < (int64_t)size) {
+      size = left > 0 ? (size_t)left : 0;
+      userdata->eof = true;
+   }
+
+   if (size > 0) {
+      memcpy(ptr, userdata->data + userdata->pos, size);
+      userdata->pos += size;
+   }
+
+   return size;
+}
+
+
+static size_t file_pack_fwrite(ALLEGRO_FILE *f, const void *ptr, size_t size)
+{
+   (void)f;
+   (void)ptr;
+   (void)size;
+
+   al_set_errno(EPERM);
+   return 0;
+}
+
+
+static bool file_pack_fflush(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return true;
+}
+
+
+static int64_t file_pack_ftell(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   return userdata->pos;
+}
+
+
+static bool file_pack_fseek(ALLEGRO_FILE *f, int64_t offset, int whence)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+   int64_t pos;
+
+   switch (whence) {
+      case ALLEGRO_SEEK_SET: pos = offset; break;
+      case ALLEGRO_SEEK_CUR: pos = userdata->pos + offset; break;
+      case ALLEGRO_SEEK_END: pos = userdata->size + offset; break;
+      default:
+         al_set_errno(EINVAL);
+         return false;
+   }
+
+   if (pos < 0) {
+      al_set_errno(EINVAL);
+      return false;
+   }
+
+   userdata->pos = pos;
+   userdata->eof = false;
+
+   return true;
+}
+
+
+static bool file_pack_feof(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   return userdata->eof;
+}
+
+
+static int file_pack_ferror(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return 0;
+}
+
+
+static const char *file_pack_ferrmsg(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return "";
+}
+
+
+static void file_pack_fclearerr(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   userdata->eof = false;
+}
+
+
+static off_t file_pack_fsize(ALLEGRO_FILE *f)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   return userdata->size;
+}
+
+
+const struct ALLEGRO_FILE_INTERFACE _al_file_interface_pack =
+{
+   file_pack_fopen,
+   file_pack_fclose,
+   file_pack_fread,
+   file_pack_fwrite,
+   file_pack_fflush,
+   file_pack_ftell,
+   file_pack_fseek,
+   file_pack_feof,
+   file_pack_ferror,
+   file_pack_ferrmsg,
+   file_pack_fclearerr,
+   NULL,
+   file_pack_fsize
+};
+
+
+/* _al_get_pack_file_data:
+ *  Returns the contents of an entry opened from a pack.
+ */
+const void *_al_get_pack_file_data(ALLEGRO_FILE *f, int64_t *size)
+{
+   USERDATA *userdata = al_get_file_userdata(f);
+
+   *size = userdata->size;
+   return userdata->data;
+}
+
+
+/* Function: al_fopen_pack_entry
+ */
+ALLEGRO_FILE *al_fopen_pack_entry(ALLEGRO_PACK *pack, const char *name)
+{
+   ALLEGRO_USTR *us;
+   _AL_PACK_ENTRY *e = NULL;
+
+   ASSERT(pack);
+   ASSERT(name);
+
+   us = al_ustr_new("");
+   if (us && _al_pack_resolve_path(pack, name, us))
+      e = _al_pack_find_entry(pack, al_cstr(us), al_ustr_size(us));
+   al_ustr_free(us);
+
+   if (!e) {
+      al_set_errno(ENOENT);
+      return NULL;
+   }
+   return _al_pack_open_entry(pack, e);
+}
+
+
+/* Function: al_set_pack_file_interface
+ */
+void al_set_pack_file_interface(ALLEGRO_PACK *pack)
+{
+   ALLEGRO_PACK **current = _al_tls_get_pack();
+
+   ASSERT(pack);
+
+   if (!current)
+      return;
+   *current = pack;
+   al_set_new_file_interface(&_al_file_interface_pack);
+   al_set_fs_interface(&_al_fs_interface_pack);
+}
+
+/* vim: set sts=3 sw=3 et: */
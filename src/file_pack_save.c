@@ -0,0 +1,402 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Pack file writer and LZ4 block compressor.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
+#include "allegro5/internal/aintern_vector.h"
+
+ALLEGRO_DEBUG_CHANNEL("pack")
+
+
+/* LZ4 block format limits: the last 5 bytes are always literals and the
+ * last match must start at least 12 bytes before the end.
+ */
+#define LZ4_MIN_MATCH      4
+#define LZ4_LAST_LITERALS  5
+#define LZ4_MF_LIMIT       12
+#define LZ4_MAX_OFFSET     65535
+#define LZ4_HASH_LOG       12
+
+
+static uint32_t read32(const unsigned char *p)
+{
+   uint32_t v;
+   memcpy(&v, p, 4);
+   return v;
+}
+
+
+static int lz4_hash(uint32_t v)
+{
+   return (v * 2654435761u) >> (32 - LZ4_HASH_LOG);
+}
+
+
+static unsigned char *put_length(unsigned char *op, int len)
+{
+   while (len >= 255) {
+      *op++ = 255;
+      len -= 255;
+   }
+   *op++ = len;
+   return op;
+}
+
+
+/* _al_lz4_compress:
+ *  Greedy LZ4 block compressor. Returns the compressed size, or 0 if the
+ *  result does not fit in dst_capacity bytes.
+ */
+int _al_lz4_compress(const unsigned char *src, int src_size,
+   unsigned char *dst, int dst_capacity)
+{
+   int table[1 << LZ4_HASH_LOG];
+   unsigned char *op = dst;
+   unsigned char *oend = dst + dst_capacity;
+   int ip = 0;
+   int anchor = 0;
+   int lit;
+   int i;
+
+   for (i = 0; i < (1 << LZ4_HASH_LOG); i++)
+      table[i] = -1;
+
+   if (src_size > LZ4_MF_LIMIT) {
+      int match_limit = src_size - LZ4_LAST_LITERALS;
+
+      while (ip <= src_size - LZ4_MF_LIMIT) {
+         uint32_t seq = read32(src + ip);
+         int h = lz4_hash(seq);
+         int ref = table[h];
+         int len;
+
+         table[h] = ip;
+         if (ref < 0 || ip - ref > LZ4_MAX_OFFSET || read32(src + ref) != seq) {
+            ip++;
+            continue;
+         }
+
+         len = LZ4_MIN_MATCH;
+         while (ip + len < match_limit && src[ref + len] == src[ip + len])
+            len++;
+         while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+            ip--;
+            ref--;
+            len++;
+         }
+
+         lit = ip - anchor;
+         if (oend - op < 1 + lit / 255 + 1 + lit + 2 +
+               (len - LZ4_MIN_MATCH) / 255 + 1)
+            return 0;
+
+         *op++ = (_ALLEGRO_MIN(lit, 15) << 4) |
+            _ALLEGRO_MIN(len - LZ4_MIN_MATCH, 15);
+         if (lit >= 15)
+            op = put_length(op, lit - 15);
+         memcpy(op, src + anchor, lit);
+         op += lit;
+         *op++ = (ip - ref) & 0xff;
+         *op++ = (ip - ref) >> 8;
+         if (len - LZ4_MIN_MATCH >= 15)
+            op = put_length(op, len - LZ4_MIN_MATCH - 15);
+
+         ip += len;
+         anchor = ip;
+         if (ip - 2 <= src_size - LZ4_MF_LIMIT)
+            table[lz4_hash(read32(src + ip - 2))] = ip - 2;
+      }
+   }
+
+   lit = src_size - anchor;
+   if (oend - op < 1 + lit / 255 + 1 + lit)
+      return 0;
+   *op++ = _ALLEGRO_MIN(lit, 15) << 4;
+   if (lit >= 15)
+      op = put_length(op, lit - 15);
+   memcpy(op, src + anchor, lit);
+   op += lit;
+
+   return op - dst;
+}
+
+
+typedef struct PACK_ITEM
+{
+   ALLEGRO_USTR *name;
+   ALLEGRO_USTR *path;
+   uint32_t hash;
+   uint32_t index;
+   uint32_t name_offset;
+   uint32_t method;
+   uint64_t offset;
+   uint64_t size;
+   uint64_t raw_size;
+} PACK_ITEM;
+
+
+typedef struct PACK_SCAN
+{
+   const char *root;
+   size_t root_len;
+   _AL_VECTOR items;
+} PACK_SCAN;
+
+
+static int add_item(ALLEGRO_FS_ENTRY *entry, void *extra)
+{
+   PACK_SCAN *scan = extra;
+   const char *path = al_get_fs_entry_name(entry);
+   PACK_ITEM *item;
+   const char *name;
+   int i;
+
+   if (!(al_get_fs_entry_mode(entry) & ALLEGRO_FILEMODE_ISFILE))
+      return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+
+   if (strncmp(path, scan->root, scan->root_len) != 0) {
+      ALLEGRO_ERROR("%s is not below %s.\n", path, scan->root);
+      return ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+   }
+   name = path + scan->root_len;
+   while (*name == '/' || *name == ALLEGRO_NATIVE_PATH_SEP)
+      name++;
+
+   item = _al_vector_alloc_back(&scan->items);
+   if (!item)
+      return ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+   memset(item, 0, sizeof *item);
+   item->path = al_ustr_new(path);
+   item->name = al_ustr_new(name);
+   for (i = 0; i < (int)al_ustr_size(item->name); i++) {
+      if (al_cstr(item->name)[i] == ALLEGRO_NATIVE_PATH_SEP)
+         al_ustr_set_chr(item->name, i, '/');
+   }
+   item->hash = _al_pack_hash(al_cstr(item->name), al_ustr_size(item->name));
+
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+
+static int compare_by_name(const void *a, const void *b)
+{
+   const PACK_ITEM *x = a;
+   const PACK_ITEM *y = b;
+
+   return _al_pack_compare_names(al_cstr(x->name), al_ustr_size(x->name),
+      al_cstr(y->name), al_ustr_size(y->name));
+}
+
+
+static int compare_by_hash(const void *a, const void *b)
+{
+   const PACK_ITEM *x = *(PACK_ITEM * const *)a;
+   const PACK_ITEM *y = *(PACK_ITEM * const *)b;
+
+   if (x->hash != y->hash)
+      return x->hash < y->hash ? -1 : 1;
+   return compare_by_name(x, y);
+}
+
+
+static void write64(ALLEGRO_FILE *f, uint64_t v)
+{
+   al_fwrite32le(f, (int32_t)(v & 0xffffffff));
+   al_fwrite32le(f, (int32_t)(v >> 32));
+}
+
+
+static uint64_t pad(ALLEGRO_FILE *f, uint64_t pos)
+{
+   while (pos % _AL_PACK_ALIGN) {
+      al_fputc(f, 0);
+      pos++;
+   }
+   return pos;
+}
+
+
+/* write_item:
+ *  Copies a file into the pack, compressed if that makes it smaller.
+ */
+static bool write_item(ALLEGRO_FILE *f, PACK_ITEM *item, int flags)
+{
+   ALLEGRO_FILE *in;
+   unsigned char *data = NULL;
+   unsigned char *packed = NULL;
+   int64_t size;
+   int packed_size = 0;
+   bool ret = false;
+
+   in = al_fopen(al_cstr(item->path), "rb");
+   if (!in) {
+      ALLEGRO_ERROR("Unable to open %s.\n", al_cstr(item->path));
+      return false;
+   }
+   size = al_fsize(in);
+   if (size < 0)
+      goto done;
+
+   data = al_malloc(_ALLEGRO_MAX(size, 1));
+   if (!data || al_fread(in, data, size) != (size_t)size)
+      goto done;
+
+   if ((flags & ALLEGRO_PACK_COMPRESS) && size > 1 && size <= INT32_MAX) {
+      packed = al_malloc(size - 1);
+      if (packed)
+         packed_size = _al_lz4_compress(data, size, packed, size - 1);
+   }
+
+   item->raw_size = size;
+   if (packed_size > 0) {
+      item->method = _AL_PACK_LZ4;
+      item->size = packed_size;
+      ret = al_fwrite(f, packed, packed_size) == (size_t)packed_size;
+   }
+   else {
+      item->method = _AL_PACK_STORED;
+      item->size = size;
+      ret = al_fwrite(f, data, size) == (size_t)size;
+   }
+
+done:
+   if (!ret)
+      ALLEGRO_ERROR("Unable to copy %s.\n", al_cstr(item->path));
+   al_free(packed);
+   al_free(data);
+   al_fclose(in);
+   return ret;
+}
+
+
+/* Function: al_save_pack
+ */
+bool al_save_pack(const char *path, const char *dir, int flags)
+{
+   PACK_SCAN scan;
+   PACK_ITEM **by_hash = NULL;
+   ALLEGRO_FS_ENTRY *root;
+   ALLEGRO_FILE *f = NULL;
+   uint64_t pos, names_offset, names_size = 0, index_offset;
+   unsigned int n = 0, i;
+   bool ret = false;
+
+   ASSERT(path);
+   ASSERT(dir);
+
+   _al_vector_init(&scan.items, sizeof(PACK_ITEM));
+
+   root = al_create_fs_entry(dir);
+   if (!root)
+      return false;
+   scan.root = al_get_fs_entry_name(root);
+   scan.root_len = strlen(scan.root);
+   if (al_for_each_fs_entry(root, add_item, &scan) ==
+         ALLEGRO_FOR_EACH_FS_ENTRY_ERROR)
+      goto done;
+
+   n = _al_vector_size(&scan.items);
+   if (n > 0) {
+      qsort(_al_vector_ref_front(&scan.items), n, sizeof(PACK_ITEM),
+         compare_by_name);
+      by_hash = al_malloc(n * sizeof *by_hash);
+      if (!by_hash)
+         goto done;
+      for (i = 0; i < n; i++)
+         by_hash[i] = _al_vector_ref(&scan.items, i);
+      qsort(by_hash, n, sizeof *by_hash, compare_by_hash);
+      for (i = 0; i < n; i++)
+         by_hash[i]->index = i;
+   }
+
+   f = al_fopen(path, "wb");
+   if (!f)
+      goto done;
+
+   /* The header is written last, once the offsets are known. */
+   for (pos = 0; pos < _AL_PACK_HEADER_SIZE; pos++)
+      al_fputc(f, 0);
+
+   for (i = 0; i < n; i++) {
+      PACK_ITEM *item = _al_vector_ref(&scan.items, i);
+      pos = pad(f, pos);
+      item->offset = pos;
+      if (!write_item(f, item, flags))
+         goto done;
+      pos += item->size;
+   }
+
+   names_offset = pos;
+   for (i = 0; i < n; i++) {
+      PACK_ITEM *item = _al_vector_ref(&scan.items, i);
+      size_t len = al_ustr_size(item->name);
+      if (names_size + len > UINT32_MAX) {
+         ALLEGRO_ERROR("Too many names for a pack.\n");
+         goto done;
+      }
+      item->name_offset = names_size;
+      al_fwrite(f, al_cstr(item->name), len);
+      names_size += len;
+   }
+   pos = pad(f, names_offset + names_size);
+
+   index_offset = pos;
+   for (i = 0; i < n; i++) {
+      PACK_ITEM *item = by_hash[i];
+      al_fwrite32le(f, item->hash);
+      al_fwrite32le(f, item->name_offset);
+      al_fwrite32le(f, al_ustr_size(item->name));
+      al_fwrite32le(f, item->method);
+      write64(f, item->offset);
+      write64(f, item->size);
+      write64(f, item->raw_size);
+   }
+   for (i = 0; i < n; i++) {
+      PACK_ITEM *item = _al_vector_ref(&scan.items, i);
+      al_fwrite32le(f, item->index);
+   }
+
+   al_fseek(f, 0, ALLEGRO_SEEK_SET);
+   al_fwrite(f, _AL_PACK_MAGIC, 4);
+   al_fwrite32le(f, _AL_PACK_VERSION);
+   al_fwrite32le(f, n);
+   al_fwrite32le(f, 0);
+   write64(f, index_offset);
+   write64(f, names_offset);
+   write64(f, names_size);
+
+   ret = !al_ferror(f);
+
+done:
+   if (f && !al_fclose(f))
+      ret = false;
+   for (i = 0; i < _al_vector_size(&scan.items); i++) {
+      PACK_ITEM *item = _al_vector_ref(&scan.items, i);
+      al_ustr_free(item->name);
+      al_ustr_free(item->path);
+   }
+   _al_vector_free(&scan.items);
+   al_free(by_hash);
+   al_destroy_fs_entry(root);
+
+   if (ret)
+      ALLEGRO_DEBUG("Saved %u entries to %s.\n", n, path);
+   return ret;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -15,6 +15,8 @@
  */
 
 #include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
 
 typedef struct SLICE_DATA SLICE_DATA;
 
@@ -187,7 +189,7 @@ static off_t slice_fsize(ALLEGRO_FILE *f)
    return slice->size;
 }
 
-static const ALLEGRO_FILE_INTERFACE fi =
+const ALLEGRO_FILE_INTERFACE _al_file_interface_slice =
 {
    NULL,
    slice_fclose,
@@ -239,6 +241,24 @@ ALLEGRO_FILE *al_fopen_slice(ALLEGRO_FILE *fp, size_t initial_size, const char *
    userdata->anchor = al_ftell(fp);
    userdata->size = initial_size;
 
-   return al_create_file_handle(&fi, userdata);
+   return al_create_file_handle(&_al_file_interface_slice, userdata);
+}
+
+/* _al_get_slice_file_data:
+ *  Returns the part of the parent's mapping covered by the slice, or NULL
+ *  if the parent is not mapped.
+ */
+const void *_al_get_slice_file_data(ALLEGRO_FILE *f, int64_t *size)
+{
+   SLICE_DATA *slice = al_get_file_userdata(f);
+   const char *data;
+   int64_t parent_size;
+
+   data = al_get_file_mapping(slice->fp, &parent_size);
+   if (!data || (int64_t)slice->anchor > parent_size)
+      return NULL;
+
+   *size = _ALLEGRO_MIN((int64_t)slice->size, parent_size - (int64_t)slice->anchor);
+   return data + slice->anchor;
 }
 
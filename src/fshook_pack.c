@@ -0,0 +1,422 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      File System Hook for pack files.
+ *
+ *      Directories are not stored in a pack, a name is a directory if
+ *      some entry name starts with it followed by a slash. Entry names
+ *      are absolute within the pack, so they don't depend on the current
+ *      directory.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include <string.h>
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
+#include "allegro5/internal/aintern_tls.h"
+
+ALLEGRO_DEBUG_CHANNEL("pack")
+
+
+typedef struct ALLEGRO_FS_ENTRY_PACK ALLEGRO_FS_ENTRY_PACK;
+
+struct ALLEGRO_FS_ENTRY_PACK
+{
+   ALLEGRO_FS_ENTRY fs_entry; /* must be first */
+   ALLEGRO_PACK *pack;
+   ALLEGRO_USTR *path;        /* "/" followed by the name */
+   _AL_PACK_ENTRY *entry;     /* NULL for directories */
+   bool is_dir;
+
+   /* For directory listing. */
+   bool is_dir_open;
+   uint32_t dir_pos;
+   ALLEGRO_USTR *last_child;
+};
+
+
+static ALLEGRO_PACK *current_pack(void)
+{
+   ALLEGRO_PACK **pack = _al_tls_get_pack();
+
+   if (!pack || !*pack) {
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+   return *pack;
+}
+
+
+static const char *name_of(ALLEGRO_FS_ENTRY_PACK *e)
+{
+   return al_cstr(e->path) + 1;
+}
+
+
+static size_t name_size(ALLEGRO_FS_ENTRY_PACK *e)
+{
+   return al_ustr_size(e->path) - 1;
+}
+
+
+/* is_directory:
+ *  Returns true if name, which has no trailing slash, is the root or a
+ *  prefix of some entry name followed by a slash.
+ */
+static bool is_directory(ALLEGRO_PACK *pack, const char *name, size_t len)
+{
+   ALLEGRO_USTR *prefix;
+   _AL_PACK_ENTRY *e;
+   uint32_t pos;
+
+   if (len == 0)
+      return true;
+
+   prefix = al_ustr_new_from_buffer(name, len);
+   al_ustr_append_chr(prefix, '/');
+   pos = _al_pack_find_prefix(pack, al_cstr(prefix), len + 1);
+   al_ustr_free(prefix);
+
+   if (pos == pack->num_entries)
+      return false;
+   e = &pack->entries[pack->by_name[pos]];
+   return e->name_len > len + 1 && memcmp(e->name, name, len) == 0 &&
+      e->name[len] == '/';
+}
+
+
+static ALLEGRO_FS_ENTRY *create_entry(ALLEGRO_PACK *pack, const char *path);
+
+
+static ALLEGRO_FS_ENTRY *fs_pack_create_entry(const char *path)
+{
+   ALLEGRO_PACK *pack = current_pack();
+
+   if (!pack)
+      return NULL;
+   return create_entry(pack, path);
+}
+
+
+static ALLEGRO_FS_ENTRY *create_entry(ALLEGRO_PACK *pack, const char *path)
+{
+   ALLEGRO_FS_ENTRY_PACK *e;
+   ALLEGRO_USTR *name;
+
+   name = al_ustr_new("");
+   if (!name)
+      return NULL;
+   if (!_al_pack_resolve_path(pack, path, name)) {
+      al_ustr_free(name);
+      al_set_errno(ENOENT);
+      return NULL;
+   }
+
+   e = al_calloc(1, sizeof *e);
+   if (!e) {
+      al_ustr_free(name);
+      return NULL;
+   }
+   e->fs_entry.vtable = &_al_fs_interface_pack;
+   e->pack = pack;
+   e->path = al_ustr_newf("/%s", al_cstr(name));
+   al_ustr_free(name);
+
+   e->entry = _al_pack_find_entry(pack, name_of(e), name_size(e));
+   e->is_dir = !e->entry && is_directory(pack, name_of(e), name_size(e));
+
+   return &e->fs_entry;
+}
+
+
+static char *fs_pack_get_current_directory(void)
+{
+   ALLEGRO_PACK *pack = current_pack();
+   ALLEGRO_USTR *us;
+   char *s;
+
+   if (!pack)
+      return NULL;
+
+   us = al_ustr_new("/");
+   if (al_ustr_size(pack->cwd) > 0) {
+      al_ustr_append(us, pack->cwd);
+      al_ustr_append_chr(us, '/');
+   }
+   s = al_malloc(al_ustr_size(us) + 1);
+   if (s)
+      al_ustr_to_buffer(us, s, al_ustr_size(us) + 1);
+   al_ustr_free(us);
+
+   return s;
+}
+
+
+static bool fs_pack_change_directory(const char *path)
+{
+   ALLEGRO_PACK *pack = current_pack();
+   ALLEGRO_USTR *name;
+   bool ret = false;
+
+   if (!pack)
+      return false;
+
+   name = al_ustr_new("");
+   if (_al_pack_resolve_path(pack, path, name) &&
+         is_directory(pack, al_cstr(name), al_ustr_size(name))) {
+      al_ustr_assign(pack->cwd, name);
+      ret = true;
+   }
+   else {
+      al_set_errno(ENOENT);
+   }
+   al_ustr_free(name);
+
+   return ret;
+}
+
+
+static bool fs_pack_filename_exists(const char *path)
+{
+   ALLEGRO_PACK *pack = current_pack();
+   ALLEGRO_USTR *name;
+   bool ret = false;
+
+   if (!pack)
+      return false;
+
+   name = al_ustr_new("");
+   if (_al_pack_resolve_path(pack, path, name)) {
+      ret = _al_pack_find_entry(pack, al_cstr(name), al_ustr_size(name)) ||
+         is_directory(pack, al_cstr(name), al_ustr_size(name));
+   }
+   al_ustr_free(name);
+
+   return ret;
+}
+
+
+static bool fs_pack_remove_filename(const char *path)
+{
+   (void)path;
+
+   al_set_errno(EPERM);
+   return false;
+}
+
+
+static bool fs_pack_make_directory(const char *path)
+{
+   (void)path;
+
+   al_set_errno(EPERM);
+   return false;
+}
+
+
+static const char *fs_pack_entry_name(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   return al_cstr(e->path);
+}
+
+
+static bool fs_pack_update_entry(ALLEGRO_FS_ENTRY *fse)
+{
+   /* Packs don't change while they are open. */
+   (void)fse;
+   return true;
+}
+
+
+static off_t fs_pack_entry_size(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   return e->entry ? (off_t)e->entry->raw_size : 0;
+}
+
+
+static uint32_t fs_pack_entry_mode(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   if (e->entry)
+      return ALLEGRO_FILEMODE_READ | ALLEGRO_FILEMODE_ISFILE;
+   if (e->is_dir)
+      return ALLEGRO_FILEMODE_READ | ALLEGRO_FILEMODE_ISDIR |
+         ALLEGRO_FILEMODE_EXECUTE;
+   return 0;
+}
+
+
+static time_t fs_pack_entry_time(ALLEGRO_FS_ENTRY *fse)
+{
+   /* Packs don't keep times. */
+   (void)fse;
+   return 0;
+}
+
+
+static bool fs_pack_entry_exists(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   return e->entry || e->is_dir;
+}
+
+
+static bool fs_pack_remove_entry(ALLEGRO_FS_ENTRY *fse)
+{
+   (void)fse;
+
+   al_set_errno(EPERM);
+   return false;
+}
+
+
+static bool fs_pack_open_directory(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   ALLEGRO_USTR *prefix;
+
+   if (!e->is_dir) {
+      al_set_errno(ENOTDIR);
+      return false;
+   }
+
+   prefix = al_ustr_new(name_of(e));
+   if (al_ustr_size(prefix) > 0)
+      al_ustr_append_chr(prefix, '/');
+   e->dir_pos = _al_pack_find_prefix(e->pack, al_cstr(prefix),
+      al_ustr_size(prefix));
+   al_ustr_free(prefix);
+
+   e->last_child = al_ustr_new("");
+   e->is_dir_open = true;
+   return true;
+}
+
+
+static ALLEGRO_FS_ENTRY *fs_pack_read_directory(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   ALLEGRO_PACK *pack = e->pack;
+   const char *dir = name_of(e);
+   size_t dir_len = name_size(e);
+   size_t skip = dir_len > 0 ? dir_len + 1 : 0;
+   ALLEGRO_USTR_INFO info;
+   ALLEGRO_FS_ENTRY *next;
+   ALLEGRO_USTR *path;
+
+   if (!e->is_dir_open)
+      return NULL;
+
+   /* The names below the directory are contiguous in the name order, and
+    * so are the names below each subdirectory, which are listed once.
+    */
+   while (e->dir_pos < pack->num_entries) {
+      _AL_PACK_ENTRY *child = &pack->entries[pack->by_name[e->dir_pos]];
+      const char *slash;
+      size_t len;
+
+      if (child->name_len <= skip || memcmp(child->name, dir, dir_len) != 0 ||
+            (skip > 0 && child->name[dir_len] != '/'))
+         break;
+      e->dir_pos++;
+
+      slash = memchr(child->name + skip, '/', child->name_len - skip);
+      len = slash ? (size_t)(slash - child->name) : child->name_len;
+      if (al_ustr_size(e->last_child) == len &&
+            memcmp(al_cstr(e->last_child), child->name, len) == 0)
+         continue;
+
+      al_ustr_truncate(e->last_child, 0);
+      al_ustr_append(e->last_child, al_ref_buffer(&info, child->name, len));
+      path = al_ustr_newf("/%s", al_cstr(e->last_child));
+      next = create_entry(pack, al_cstr(path));
+      al_ustr_free(path);
+      return next;
+   }
+
+   return NULL;
+}
+
+
+static bool fs_pack_close_directory(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   al_ustr_free(e->last_child);
+   e->last_child = NULL;
+   e->is_dir_open = false;
+   return true;
+}
+
+
+static void fs_pack_destroy_entry(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   if (e->is_dir_open)
+      fs_pack_close_directory(fse);
+   al_ustr_free(e->path);
+   al_free(e);
+}
+
+
+static ALLEGRO_FILE *fs_pack_open_file(ALLEGRO_FS_ENTRY *fse, const char *mode)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+
+   if (strpbrk(mode, "wa+")) {
+      ALLEGRO_ERROR("Pack files are read-only.\n");
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+   if (!e->entry) {
+      al_set_errno(ENOENT);
+      return NULL;
+   }
+   return _al_pack_open_entry(e->pack, e->entry);
+}
+
+
+const ALLEGRO_FS_INTERFACE _al_fs_interface_pack =
+{
+   fs_pack_create_entry,
+   fs_pack_destroy_entry,
+   fs_pack_entry_name,
+   fs_pack_update_entry,
+   fs_pack_entry_mode,
+   fs_pack_entry_time,
+   fs_pack_entry_time,
+   fs_pack_entry_time,
+   fs_pack_entry_size,
+   fs_pack_entry_exists,
+   fs_pack_remove_entry,
+
+   fs_pack_open_directory,
+   fs_pack_read_directory,
+   fs_pack_close_directory,
+
+   fs_pack_filename_exists,
+   fs_pack_remove_filename,
+   fs_pack_get_current_directory,
+   fs_pack_change_directory,
+   fs_pack_make_directory,
+
+   fs_pack_open_file
+};
+
+/* vim: set sts=3 sw=3 et: */
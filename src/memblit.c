@@ -21,6 +21,7 @@
 #include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_transform.h"
 #include "allegro5/internal/aintern_primitives.h"
+#include "allegro5/internal/aintern_tls.h"
 #include "allegro5/internal/aintern_tri_soft.h"
 #include <math.h>
 
@@ -30,10 +31,13 @@
 static void _al_draw_transformed_scaled_bitmap_memory(
    ALLEGRO_BITMAP *src, ALLEGRO_COLOR tint,
    int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh,
-   int flags);
+   const ALLEGRO_TRANSFORM *trans, int flags);
 static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
    int sx, int sy, int sw, int sh,
    int dx, int dy, int flags);
+static bool _al_draw_bitmap_region_memory_blend(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh,
+   float dx, float dy, int flags);
 
 
 /* The CLIPPER macro takes pre-clipped coordinates for both the source
@@ -131,10 +135,10 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
 }
 
 
-void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *src,
+static void draw_region_memory(ALLEGRO_BITMAP *src,
    ALLEGRO_COLOR tint,
    int sx, int sy, int sw, int sh,
-   int dx, int dy, int flags)
+   int dx, int dy, const ALLEGRO_TRANSFORM *trans, int flags)
 {
    int op, src_mode, dst_mode;
    int op_alpha, src_alpha, dst_alpha;
@@ -146,33 +150,50 @@ void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *src,
       &src_mode, &dst_mode, &op_alpha, &src_alpha, &dst_alpha);
 
    if (_AL_DEST_IS_ZERO && _AL_SRC_NOT_MODIFIED_TINT_WHITE &&
-      _al_transform_is_translation(al_get_current_transform(), &xtrans, &ytrans))
+      _al_transform_is_translation(trans, &xtrans, &ytrans))
    {
       _al_draw_bitmap_region_memory_fast(src, sx, sy, sw, sh,
          dx + xtrans, dy + ytrans, flags);
       return;
    }
 
+   if (_al_transform_is_translation(trans, &xtrans, &ytrans) &&
+      _al_draw_bitmap_region_memory_blend(src, tint, sx, sy, sw, sh,
+         dx + xtrans, dy + ytrans, flags))
+   {
+      return;
+   }
+
    /* We used to have special cases for translation/scaling only, but the
     * general version received much more optimisation and ended up being
     * faster.
     */
    _al_draw_transformed_scaled_bitmap_memory(src, tint, sx, sy,
-      sw, sh, dx, dy, sw, sh, flags);
+      sw, sh, dx, dy, sw, sh, trans, flags);
 }
 
 
-static void _al_draw_transformed_bitmap_memory(ALLEGRO_BITMAP *src,
+void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *src,
    ALLEGRO_COLOR tint,
+   int sx, int sy, int sw, int sh,
+   int dx, int dy, int flags)
+{
+   draw_region_memory(src, tint, sx, sy, sw, sh, dx, dy,
+      al_get_current_transform(), flags);
+}
+
+
+/* Fills v with the two triangles covering the quad, in the order they are
+ * drawn.
+ */
+static void get_quad_triangles(ALLEGRO_COLOR tint,
    int sx, int sy, int sw, int sh, int dw, int dh,
-   ALLEGRO_TRANSFORM* local_trans, int flags)
+   const ALLEGRO_TRANSFORM* local_trans, int flags, ALLEGRO_VERTEX v[6])
 {
    float xsf[4], ysf[4];
    int tl = 0, tr = 1, bl = 3, br = 2;
    int tmp;
-   ALLEGRO_VERTEX v[4];
-
-   ASSERT(_al_pixel_format_is_real(al_get_bitmap_format(src)));
+   ALLEGRO_VERTEX q[4];
 
    /* Decide what order to take corners in. */
    if (flags & ALLEGRO_FLIP_VERTICAL) {
@@ -209,38 +230,58 @@ static void _al_draw_transformed_bitmap_memory(ALLEGRO_BITMAP *src,
    al_transform_coordinates(local_trans, &xsf[1], &ysf[1]);
    al_transform_coordinates(local_trans, &xsf[2], &ysf[2]);
 
-   v[tl].x = xsf[0];
-   v[tl].y = ysf[0];
-   v[tl].z = 0;
-   v[tl].u = sx;
-   v[tl].v = sy;
-   v[tl].color = tint;
-
-   v[tr].x = xsf[1];
-   v[tr].y = ysf[1];
-   v[tr].z = 0;
-   v[tr].u = sx + sw;
-   v[tr].v = sy;
-   v[tr].color = tint;
-
-   v[br].x = xsf[2] + xsf[1] - xsf[0];
-   v[br].y = ysf[2] + ysf[1] - ysf[0];
-   v[br].z = 0;
-   v[br].u = sx + sw;
-   v[br].v = sy + sh;
-   v[br].color = tint;
-
-   v[bl].x = xsf[2];
-   v[bl].y = ysf[2];
-   v[bl].z = 0;
-   v[bl].u = sx;
-   v[bl].v = sy + sh;
-   v[bl].color = tint;
+   q[tl].x = xsf[0];
+   q[tl].y = ysf[0];
+   q[tl].z = 0;
+   q[tl].u = sx;
+   q[tl].v = sy;
+   q[tl].color = tint;
+
+   q[tr].x = xsf[1];
+   q[tr].y = ysf[1];
+   q[tr].z = 0;
+   q[tr].u = sx + sw;
+   q[tr].v = sy;
+   q[tr].color = tint;
+
+   q[br].x = xsf[2] + xsf[1] - xsf[0];
+   q[br].y = ysf[2] + ysf[1] - ysf[0];
+   q[br].z = 0;
+   q[br].u = sx + sw;
+   q[br].v = sy + sh;
+   q[br].color = tint;
+
+   q[bl].x = xsf[2];
+   q[bl].y = ysf[2];
+   q[bl].z = 0;
+   q[bl].u = sx;
+   q[bl].v = sy + sh;
+   q[bl].color = tint;
+
+   v[0] = q[tl];
+   v[1] = q[tr];
+   v[2] = q[br];
+   v[3] = q[tl];
+   v[4] = q[br];
+   v[5] = q[bl];
+}
+
+
+static void _al_draw_transformed_bitmap_memory(ALLEGRO_BITMAP *src,
+   ALLEGRO_COLOR tint,
+   int sx, int sy, int sw, int sh, int dw, int dh,
+   ALLEGRO_TRANSFORM* local_trans, int flags)
+{
+   ALLEGRO_VERTEX v[6];
+
+   ASSERT(_al_pixel_format_is_real(al_get_bitmap_format(src)));
+
+   get_quad_triangles(tint, sx, sy, sw, sh, dw, dh, local_trans, flags, v);
 
    al_lock_bitmap(src, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
 
-   _al_triangle_2d(src, &v[tl], &v[tr], &v[br]);
-   _al_triangle_2d(src, &v[tl], &v[br], &v[bl]);
+   _al_triangle_2d(src, &v[0], &v[1], &v[2]);
+   _al_triangle_2d(src, &v[3], &v[4], &v[5]);
 
    al_unlock_bitmap(src);
 }
@@ -248,13 +289,14 @@ static void _al_draw_transformed_bitmap_memory(ALLEGRO_BITMAP *src,
 
 static void _al_draw_transformed_scaled_bitmap_memory(
    ALLEGRO_BITMAP *src, ALLEGRO_COLOR tint,
-   int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, int flags)
+   int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh,
+   const ALLEGRO_TRANSFORM *trans, int flags)
 {
    ALLEGRO_TRANSFORM local_trans;
 
    al_identity_transform(&local_trans);
    al_translate_transform(&local_trans, dx, dy);
-   al_compose_transform(&local_trans, al_get_current_transform());
+   al_compose_transform(&local_trans, trans);
 
    _al_draw_transformed_bitmap_memory(src, tint, sx, sy, sw, sh, dw, dh,
       &local_trans, flags);
@@ -304,4 +346,377 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
 }
 
 
+/* Integer blitter for translated draws using the blenders supported by
+ * _al_blend_span_int.  Both bitmaps must be ARGB_8888 or ABGR_8888.  Those
+ * two formats keep alpha in the top byte and differ only by the red/blue
+ * order, so the blender works on the channel positions and swaps red and
+ * blue of the source if needed.
+ */
+
+static bool is_int_blend_format(int format)
+{
+   return format == ALLEGRO_PIXEL_FORMAT_ARGB_8888 ||
+      format == ALLEGRO_PIXEL_FORMAT_ABGR_8888;
+}
+
+
+static bool get_int_tint(ALLEGRO_COLOR tint, int format, uint32_t int_tint[4])
+{
+   float c[4];
+   int i;
+
+   if (format == ALLEGRO_PIXEL_FORMAT_ARGB_8888) {
+      c[0] = tint.b;
+      c[2] = tint.r;
+   }
+   else {
+      c[0] = tint.r;
+      c[2] = tint.b;
+   }
+   c[1] = tint.g;
+   c[3] = tint.a;
+
+   for (i = 0; i < 4; i++) {
+      if (!(c[i] >= 0.0f && c[i] <= 1.0f))
+         return false;
+      int_tint[i] = (uint32_t)(c[i] * 255.0f + 0.5f);
+   }
+   return true;
+}
+
+
+static void draw_blended_region(ALLEGRO_BITMAP *bitmap,
+   const uint32_t *tint, const int factors[4],
+   int sx, int sy, int sw, int sh, int dx, int dy)
+{
+   ALLEGRO_LOCKED_REGION *src_region;
+   ALLEGRO_LOCKED_REGION *dst_region;
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   int dw = sw, dh = sh;
+   bool swap_rb;
+   int y;
+
+   CLIPPER(bitmap, sx, sy, sw, sh, dest, dx, dy, dw, dh, 1, 1, 0)
+
+   if (!(src_region = al_lock_bitmap_region(bitmap, sx, sy, sw, sh,
+         ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY))) {
+      return;
+   }
+
+   if (!(dst_region = al_lock_bitmap_region(dest, dx, dy, sw, sh,
+         ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READWRITE))) {
+      al_unlock_bitmap(bitmap);
+      return;
+   }
+
+   swap_rb = (src_region->format != dst_region->format);
+
+   for (y = 0; y < sh; y++) {
+      const uint32_t *src = (const uint32_t *)
+         ((const char *)src_region->data + y * src_region->pitch);
+      uint32_t *dst = (uint32_t *)
+         ((char *)dst_region->data + y * dst_region->pitch);
+
+      _al_blend_span_int(dst, src, sw, swap_rb, tint, factors);
+   }
+
+   al_unlock_bitmap(bitmap);
+   al_unlock_bitmap(dest);
+}
+
+
+/* Returns false if the blit could not be handled, in which case the caller
+ * should use the generic path.
+ */
+static bool _al_draw_bitmap_region_memory_blend(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh,
+   float dx, float dy, int flags)
+{
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   int op, src_mode, dst_mode;
+   int op_alpha, src_alpha, dst_alpha;
+   int factors[4];
+   int dst_format = al_get_bitmap_format(dest);
+   uint32_t int_tint[4] = {255, 255, 255, 255};
+   bool tinted;
+
+   ASSERT(bitmap->parent == NULL);
+
+   if (flags != 0)
+      return false;
+
+   if (!is_int_blend_format(al_get_bitmap_format(bitmap)) ||
+         !is_int_blend_format(dst_format))
+      return false;
+
+   al_get_separate_bitmap_blender(&op,
+      &src_mode, &dst_mode, &op_alpha, &src_alpha, &dst_alpha);
+
+   if (!_al_get_int_blender(op, src_mode, dst_mode,
+         op_alpha, src_alpha, dst_alpha, factors))
+      return false;
+
+   tinted = !(tint.r == 1.0f && tint.g == 1.0f && tint.b == 1.0f &&
+      tint.a == 1.0f);
+   if (tinted && !get_int_tint(tint, dst_format, int_tint))
+      return false;
+
+   /* Match the pixel coverage of the triangle rasteriser: a destination
+    * pixel is drawn if its centre lies inside the rectangle.
+    */
+   draw_blended_region(bitmap, tinted ? int_tint : NULL, factors,
+      sx, sy, sw, sh, (int)ceilf(dx - 0.5f), (int)ceilf(dy - 0.5f));
+   return true;
+}
+
+
+/* Held drawing to memory bitmaps.  While bitmap drawing is held the draws are
+ * only recorded, together with the transformation in effect.  Releasing the
+ * hold draws them in order, except that transformed draws of the same bitmap
+ * are gathered into a single triangle batch when nothing drawn in between
+ * overlaps them.  Each batch locks the source and the target only once.
+ */
+
+/* How many draws ahead to look for draws of the same bitmap, and how many
+ * skipped draws they are checked against.
+ */
+#define HELD_LOOKAHEAD  64
+#define HELD_BLOCKERS   16
+
+typedef struct _AL_HELD_DRAW
+{
+   ALLEGRO_BITMAP *bitmap;
+   ALLEGRO_COLOR tint;
+   int sx, sy, sw, sh;
+   int flags;
+   ALLEGRO_TRANSFORM trans;
+   bool translation;
+   bool done;
+   /* Conservative bounding box of the touched pixels. */
+   int x1, y1, x2, y2;
+} _AL_HELD_DRAW;
+
+
+static bool held_overlap(const _AL_HELD_DRAW *a, const _AL_HELD_DRAW *b)
+{
+   return a->x1 < b->x2 && b->x1 < a->x2 && a->y1 < b->y2 && b->y1 < a->y2;
+}
+
+
+static void set_held_bounds(_AL_HELD_DRAW *draw)
+{
+   float xs[4] = {0, draw->sw, 0, draw->sw};
+   float ys[4] = {0, 0, draw->sh, draw->sh};
+   float x1, y1, x2, y2;
+   int i;
+
+   for (i = 0; i < 4; i++)
+      al_transform_coordinates(&draw->trans, &xs[i], &ys[i]);
+
+   x1 = x2 = xs[0];
+   y1 = y2 = ys[0];
+   for (i = 1; i < 4; i++) {
+      x1 = MIN(x1, xs[i]);
+      y1 = MIN(y1, ys[i]);
+      x2 = MAX(x2, xs[i]);
+      y2 = MAX(y2, ys[i]);
+   }
+
+   draw->x1 = (int)floorf(x1) - 1;
+   draw->y1 = (int)floorf(y1) - 1;
+   draw->x2 = (int)ceilf(x2) + 1;
+   draw->y2 = (int)ceilf(y2) + 1;
+}
+
+
+/* Internal function: _al_hold_bitmap_region_memory
+ *  Records a draw to the current memory target if drawing is held.  Returns
+ *  false if the draw should be done immediately.
+ */
+bool _al_hold_bitmap_region_memory(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh, int flags)
+{
+   _AL_HELD_DRAWS *held = _al_tls_get_held_draws();
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   _AL_HELD_DRAW *draw;
+   float xtrans, ytrans;
+
+   if (!held || !held->held)
+      return false;
+   if (!(al_get_bitmap_flags(dest) & ALLEGRO_MEMORY_BITMAP) ||
+         _al_pixel_format_is_compressed(al_get_bitmap_format(dest)))
+      return false;
+   if (sw <= 0 || sh <= 0)
+      return true;
+
+   if (held->num_draws == held->max_draws) {
+      int new_max = MAX(64, held->max_draws * 2);
+      _AL_HELD_DRAW *draws = al_realloc(held->draws,
+         new_max * sizeof(*draws));
+      if (!draws)
+         return false;
+      held->draws = draws;
+      held->max_draws = new_max;
+   }
+
+   draw = &held->draws[held->num_draws++];
+   draw->bitmap = bitmap;
+   draw->tint = tint;
+   draw->sx = sx;
+   draw->sy = sy;
+   draw->sw = sw;
+   draw->sh = sh;
+   draw->flags = flags;
+   al_copy_transform(&draw->trans, al_get_current_transform());
+   draw->translation = _al_transform_is_translation(&draw->trans,
+      &xtrans, &ytrans);
+   draw->done = false;
+   set_held_bounds(draw);
+   return true;
+}
+
+
+static ALLEGRO_VERTEX *held_vertices(_AL_HELD_DRAWS *held, int num)
+{
+   if (num > held->max_vtxs) {
+      int new_max = MAX(num, held->max_vtxs * 2);
+      ALLEGRO_VERTEX *vtxs = al_realloc(held->vtxs,
+         new_max * sizeof(*vtxs));
+      if (!vtxs)
+         return NULL;
+      held->vtxs = vtxs;
+      held->max_vtxs = new_max;
+   }
+   return held->vtxs;
+}
+
+
+/* Draws the draw at first together with the later transformed draws of the
+ * same bitmap which can be moved before the draws they skip over.
+ */
+static void draw_held_batch(_AL_HELD_DRAWS *held, int first)
+{
+   _AL_HELD_DRAW *draw = &held->draws[first];
+   ALLEGRO_BITMAP *bitmap = draw->bitmap;
+   _AL_HELD_DRAW *blockers[HELD_BLOCKERS];
+   int num_blockers = 0;
+   int batch[HELD_LOOKAHEAD + 1];
+   int num_batch = 0;
+   int end = MIN(held->num_draws, first + 1 + HELD_LOOKAHEAD);
+   ALLEGRO_VERTEX *v;
+   bool locked;
+   int i, j;
+
+   batch[num_batch++] = first;
+   draw->done = true;
+
+   for (i = first + 1; i < end; i++) {
+      _AL_HELD_DRAW *other = &held->draws[i];
+
+      if (other->done)
+         continue;
+
+      if (other->bitmap == bitmap && !other->translation) {
+         for (j = 0; j < num_blockers; j++) {
+            if (held_overlap(other, blockers[j]))
+               break;
+         }
+         if (j == num_blockers) {
+            batch[num_batch++] = i;
+            other->done = true;
+            continue;
+         }
+      }
+
+      if (num_blockers == HELD_BLOCKERS)
+         break;
+      blockers[num_blockers++] = other;
+   }
+
+   v = held_vertices(held, num_batch * 6);
+   if (!v) {
+      for (i = 0; i < num_batch; i++) {
+         draw = &held->draws[batch[i]];
+         draw_region_memory(draw->bitmap, draw->tint, draw->sx, draw->sy,
+            draw->sw, draw->sh, 0, 0, &draw->trans, draw->flags);
+      }
+      return;
+   }
+
+   for (i = 0; i < num_batch; i++) {
+      draw = &held->draws[batch[i]];
+      get_quad_triangles(draw->tint, draw->sx, draw->sy, draw->sw, draw->sh,
+         draw->sw, draw->sh, &draw->trans, draw->flags, v + 6 * i);
+   }
+
+   locked = al_lock_bitmap(bitmap, ALLEGRO_PIXEL_FORMAT_ANY,
+      ALLEGRO_LOCK_READONLY) != NULL;
+   _al_draw_soft_triangle_batch(bitmap, v, num_batch * 2);
+   if (locked)
+      al_unlock_bitmap(bitmap);
+}
+
+
+static void flush_held_draws(_AL_HELD_DRAWS *held)
+{
+   int i;
+
+   for (i = 0; i < held->num_draws; i++) {
+      _AL_HELD_DRAW *draw = &held->draws[i];
+
+      if (draw->done)
+         continue;
+
+      if (draw->translation) {
+         draw_region_memory(draw->bitmap, draw->tint, draw->sx, draw->sy,
+            draw->sw, draw->sh, 0, 0, &draw->trans, draw->flags);
+         draw->done = true;
+      }
+      else {
+         ASSERT(_al_pixel_format_is_real(al_get_bitmap_format(draw->bitmap)));
+         draw_held_batch(held, i);
+      }
+   }
+
+   held->num_draws = 0;
+}
+
+
+/* Internal function: _al_hold_memory_drawing
+ *  Called by al_hold_bitmap_drawing.  Releasing the hold draws everything
+ *  recorded for the current target.
+ */
+void _al_hold_memory_drawing(bool hold)
+{
+   _AL_HELD_DRAWS *held = _al_tls_get_held_draws();
+
+   if (!held || held->held == hold)
+      return;
+
+   held->held = hold;
+   if (hold)
+      return;
+
+   if (held->num_draws > 0)
+      flush_held_draws(held);
+
+   al_free(held->draws);
+   al_free(held->vtxs);
+   held->draws = NULL;
+   held->vtxs = NULL;
+   held->max_draws = 0;
+   held->max_vtxs = 0;
+}
+
+
+/* Internal function: _al_is_memory_drawing_held
+ */
+bool _al_is_memory_drawing_held(void)
+{
+   _AL_HELD_DRAWS *held = _al_tls_get_held_draws();
+
+   return held && held->held;
+}
+
+
 /* vim: set sts=3 sw=3 et: */
@@ -407,6 +407,132 @@ static GLint ogl_bitmap_wrap(ALLEGRO_BITMAP_WRAP wrap)
 
 
 
+/* _al_ogl_update_mipmaps:
+ *  Brings the mipmaps of the bound texture up to date by uploading the
+ *  stored levels from first_level on, or by generating all levels from
+ *  level 0 if the bitmap has none.
+ */
+void _al_ogl_update_mipmaps(ALLEGRO_BITMAP *bitmap, int first_level)
+{
+   ALLEGRO_BITMAP_EXTRA_OPENGL *ogl_bitmap = bitmap->extra;
+   int format = al_get_bitmap_format(bitmap);
+   bool compressed = _al_pixel_format_is_compressed(format);
+   bool use_stored = bitmap->num_mipmaps > 0;
+   int previous_alignment;
+   int level;
+   GLenum e;
+
+   if (!(al_get_bitmap_flags(bitmap) & ALLEGRO_MIPMAP))
+      return;
+
+   /* Stored levels don't fit a texture padded to a power of two, and
+    * OpenGL ES can't be told to stop at the last stored level.
+    */
+   if (ogl_bitmap->true_w != bitmap->w || ogl_bitmap->true_h != bitmap->h)
+      use_stored = false;
+   if (IS_OPENGLES &&
+         (_ALLEGRO_MAX(bitmap->w, bitmap->h) >> (bitmap->num_mipmaps + 1)) != 0)
+      use_stored = false;
+#if defined ALLEGRO_CFG_OPENGLES
+   if (compressed)
+      use_stored = false;
+#endif
+
+   if (!use_stored && compressed) {
+      /* Compressed textures can't generate their levels, so only the
+       * first one can be sampled.
+       */
+#if !defined ALLEGRO_CFG_OPENGLES
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+#endif
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+         (al_get_bitmap_flags(bitmap) & ALLEGRO_MIN_LINEAR) ?
+         GL_LINEAR : GL_NEAREST);
+      return;
+   }
+
+   if (!use_stored) {
+#if !defined ALLEGRO_CFG_OPENGLES
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+#endif
+      /* Without FBOs GL_GENERATE_MIPMAP takes care of it, see
+       * ogl_upload_bitmap.
+       */
+      if (al_get_opengl_extension_list()->ALLEGRO_GL_EXT_framebuffer_object ||
+          al_get_opengl_extension_list()->ALLEGRO_GL_OES_framebuffer_object ||
+          IS_OPENGLES /* FIXME */) {
+         glGenerateMipmapEXT(GL_TEXTURE_2D);
+         e = glGetError();
+         if (e) {
+            ALLEGRO_ERROR("glGenerateMipmapEXT for texture %d failed (%s).\n",
+               ogl_bitmap->texture, _al_gl_error_string(e));
+         }
+      }
+      return;
+   }
+
+   glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous_alignment);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+   for (level = first_level; level <= bitmap->num_mipmaps; level++) {
+      int w, h, row_bytes, rows;
+      _al_get_mipmap_level_size(bitmap, level, &w, &h, &row_bytes, &rows);
+#if !defined ALLEGRO_CFG_OPENGLES
+      if (compressed) {
+         glCompressedTexImage2D(GL_TEXTURE_2D, level, get_glformat(format, 0),
+            w, h, 0, row_bytes * rows, bitmap->mipmaps[level - 1]);
+      }
+      else
+#endif
+      {
+         glTexImage2D(GL_TEXTURE_2D, level, get_glformat(format, 0), w, h, 0,
+            get_glformat(format, 2), get_glformat(format, 1),
+            bitmap->mipmaps[level - 1]);
+      }
+      e = glGetError();
+      if (e) {
+         ALLEGRO_ERROR("Uploading mipmap level %d of texture %d failed (%s).\n",
+            level, ogl_bitmap->texture, _al_gl_error_string(e));
+         break;
+      }
+   }
+
+#if !defined ALLEGRO_CFG_OPENGLES
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, bitmap->num_mipmaps);
+#endif
+   glPixelStorei(GL_UNPACK_ALIGNMENT, previous_alignment);
+}
+
+
+
+static void ogl_update_mipmaps(ALLEGRO_BITMAP *bitmap, int first_level)
+{
+   ALLEGRO_BITMAP_EXTRA_OPENGL *ogl_bitmap = bitmap->extra;
+   ALLEGRO_DISPLAY *disp;
+   ALLEGRO_DISPLAY *old_disp = NULL;
+
+   if (!(al_get_bitmap_flags(bitmap) & ALLEGRO_MIPMAP))
+      return;
+
+   disp = al_get_current_display();
+   if (!disp ||
+      (_al_get_bitmap_display(bitmap)->ogl_extras->is_shared == false &&
+       _al_get_bitmap_display(bitmap) != disp))
+   {
+      old_disp = disp;
+      _al_set_current_display_only(_al_get_bitmap_display(bitmap));
+   }
+
+   glBindTexture(GL_TEXTURE_2D, ogl_bitmap->texture);
+   _al_ogl_update_mipmaps(bitmap, first_level);
+
+   if (old_disp) {
+      _al_set_current_display_only(old_disp);
+   }
+}
+
+
+
 // FIXME: need to do all the logic AllegroGL does, checking extensions,
 // proxy textures, formats, limits ...
 static bool ogl_upload_bitmap(ALLEGRO_BITMAP *bitmap)
@@ -548,12 +674,7 @@ static bool ogl_upload_bitmap(ALLEGRO_BITMAP *bitmap)
    }
 
    if (post_generate_mipmap) {
-      glGenerateMipmapEXT(GL_TEXTURE_2D);
-      e = glGetError();
-      if (e) {
-         ALLEGRO_ERROR("glGenerateMipmapEXT for texture %d failed (%s).\n",
-            ogl_bitmap->texture, _al_gl_error_string(e));
-      }
+      _al_ogl_update_mipmaps(bitmap, 1);
    }
 
    ogl_bitmap->left = 0;
@@ -771,7 +892,7 @@ static ALLEGRO_LOCKED_REGION *ogl_lock_compressed_region(ALLEGRO_BITMAP *bitmap,
 
    if (flags & ALLEGRO_LOCK_WRITEONLY) {
       int pitch = wc * block_size;
-      ogl_bitmap->lock_buffer = al_malloc(pitch * hc);
+      ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * hc);
       if (ogl_bitmap->lock_buffer == NULL) {
          return NULL;
       }
@@ -812,7 +933,7 @@ static ALLEGRO_LOCKED_REGION *ogl_lock_compressed_region(ALLEGRO_BITMAP *bitmap,
    }
 
    if (ok) {
-      ogl_bitmap->lock_buffer = al_malloc(true_wc * true_hc * block_size);
+      ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(true_wc * true_hc * block_size);
 
       if (ogl_bitmap->lock_buffer != NULL) {
          glBindTexture(GL_TEXTURE_2D, ogl_bitmap->texture);
@@ -821,7 +942,7 @@ static ALLEGRO_LOCKED_REGION *ogl_lock_compressed_region(ALLEGRO_BITMAP *bitmap,
          if (e) {
             ALLEGRO_ERROR("glGetCompressedTexImage for format %s failed (%s).\n",
                _al_pixel_format_name(bitmap_format), _al_gl_error_string(e));
-            al_free(ogl_bitmap->lock_buffer);
+            _al_free_lock_buffer(ogl_bitmap->lock_buffer);
             ogl_bitmap->lock_buffer = NULL;
             ok = false;
          }
@@ -951,6 +1072,10 @@ static void ogl_unlock_compressed_region(ALLEGRO_BITMAP *bitmap)
          _al_pixel_format_name(lock_format), _al_gl_error_string(e));
    }
 
+   /* Compressed textures only get the mipmaps they were given. */
+   if (bitmap->num_mipmaps > 0)
+      _al_ogl_update_mipmaps(bitmap, 1);
+
    if (previous_alignment != 1) {
       glPixelStorei(GL_UNPACK_ALIGNMENT, previous_alignment);
    }
@@ -960,7 +1085,7 @@ static void ogl_unlock_compressed_region(ALLEGRO_BITMAP *bitmap)
    }
 
 EXIT:
-   al_free(ogl_bitmap->lock_buffer);
+   _al_free_lock_buffer(ogl_bitmap->lock_buffer);
    ogl_bitmap->lock_buffer = NULL;
 #else
    (void)bitmap;
@@ -1029,6 +1154,7 @@ static ALLEGRO_BITMAP_INTERFACE *ogl_bitmap_driver(void)
    glbmp_vt.lock_compressed_region = ogl_lock_compressed_region;
    glbmp_vt.unlock_compressed_region = ogl_unlock_compressed_region;
    glbmp_vt.backup_dirty_bitmap = ogl_backup_dirty_bitmap;
+   glbmp_vt.update_mipmaps = ogl_update_mipmaps;
 
    return &glbmp_vt;
 }
@@ -214,7 +214,7 @@ static bool ogl_lock_region_backbuffer(
    const int pitch = ogl_pitch(w, pixel_size);
    GLenum e;
 
-   ogl_bitmap->lock_buffer = al_malloc(pitch * h);
+   ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * h);
    if (ogl_bitmap->lock_buffer == NULL) {
       return false;
    }
@@ -228,7 +228,7 @@ static bool ogl_lock_region_backbuffer(
       if (e) {
          ALLEGRO_ERROR("glReadPixels for format %s failed (%s).\n",
             _al_pixel_format_name(format), _al_gl_error_string(e));
-         al_free(ogl_bitmap->lock_buffer);
+         _al_free_lock_buffer(ogl_bitmap->lock_buffer);
          ogl_bitmap->lock_buffer = NULL;
          return false;
       }
@@ -251,7 +251,7 @@ static bool ogl_lock_region_nonbb_writeonly(
    (void) x;
    (void) gl_y;
 
-   ogl_bitmap->lock_buffer = al_malloc(pitch * h);
+   ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * h);
    if (ogl_bitmap->lock_buffer == NULL) {
       return false;
    }
@@ -322,7 +322,7 @@ static bool ogl_lock_region_nonbb_readwrite_fbo(
    }
 
    if (ok) {
-      ogl_bitmap->lock_buffer = al_malloc(pitch * h);
+      ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * h);
       if (ogl_bitmap->lock_buffer == NULL) {
          ok = false;
       }
@@ -350,7 +350,7 @@ static bool ogl_lock_region_nonbb_readwrite_fbo(
       return true;
    }
 
-   al_free(ogl_bitmap->lock_buffer);
+   _al_free_lock_buffer(ogl_bitmap->lock_buffer);
    ogl_bitmap->lock_buffer = NULL;
    return ok;
 }
@@ -367,7 +367,7 @@ static bool ogl_lock_region_nonbb_readwrite_nonfbo(
    bool ok;
    (void) w;
 
-   ogl_bitmap->lock_buffer = al_malloc(pitch * ogl_bitmap->true_h);
+   ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * ogl_bitmap->true_h);
    if (ogl_bitmap->lock_buffer == NULL) {
       return false;
    }
@@ -384,7 +384,7 @@ static bool ogl_lock_region_nonbb_readwrite_nonfbo(
    if (e) {
       ALLEGRO_ERROR("glGetTexImage for format %s failed (%s).\n",
          _al_pixel_format_name(format), _al_gl_error_string(e));
-      al_free(ogl_bitmap->lock_buffer);
+      _al_free_lock_buffer(ogl_bitmap->lock_buffer);
       ogl_bitmap->lock_buffer = NULL;
       ok = false;
    }
@@ -431,7 +431,7 @@ void _al_ogl_unlock_region_new(ALLEGRO_BITMAP *bitmap)
       ogl_unlock_region_non_readonly(bitmap, ogl_bitmap);
    }
 
-   al_free(ogl_bitmap->lock_buffer);
+   _al_free_lock_buffer(ogl_bitmap->lock_buffer);
    ogl_bitmap->lock_buffer = NULL;
 }
 
@@ -502,14 +502,10 @@ static void ogl_unlock_region_non_readonly(ALLEGRO_BITMAP *bitmap,
       /* If using FBOs, we need to regenerate mipmaps explicitly now. */
       /* XXX why don't we check ogl_bitmap->fbo_info? */
       if ((al_get_bitmap_flags(bitmap) & ALLEGRO_MIPMAP) &&
-         al_get_opengl_extension_list()->ALLEGRO_GL_EXT_framebuffer_object)
+         (al_get_opengl_extension_list()->ALLEGRO_GL_EXT_framebuffer_object ||
+          bitmap->num_mipmaps > 0))
       {
-         glGenerateMipmapEXT(GL_TEXTURE_2D);
-         e = glGetError();
-         if (e) {
-            ALLEGRO_ERROR("glGenerateMipmapEXT for texture %d failed (%s).\n",
-               ogl_bitmap->texture, _al_gl_error_string(e));
-         }
+         _al_ogl_update_mipmaps(bitmap, 1);
       }
    }
 
@@ -608,7 +604,7 @@ static void ogl_unlock_region_nonbb_fbo_writeonly(ALLEGRO_BITMAP *bitmap,
    const int lock_format = bitmap->locked_region.format;
    const int orig_pixel_size = al_get_pixel_size(orig_format);
    const int dst_pitch = bitmap->lock_w * orig_pixel_size;
-   unsigned char * const tmpbuf = al_malloc(dst_pitch * bitmap->lock_h);
+   unsigned char * const tmpbuf = _al_alloc_lock_buffer(dst_pitch * bitmap->lock_h);
    GLenum e;
 
    _al_convert_bitmap_data(
@@ -633,7 +629,7 @@ static void ogl_unlock_region_nonbb_fbo_writeonly(ALLEGRO_BITMAP *bitmap,
          lock_format, _al_gl_error_string(e));
    }
 
-   al_free(tmpbuf);
+   _al_free_lock_buffer(tmpbuf);
 }
 
 
@@ -135,7 +135,7 @@ static ALLEGRO_LOCKED_REGION *ogl_lock_region_bb_readonly(
    const int gl_y = bitmap->h - y - h;
    GLenum e;
 
-   ogl_bitmap->lock_buffer = al_malloc(pitch * h);
+   ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * h);
    if (ogl_bitmap->lock_buffer == NULL) {
       ALLEGRO_ERROR("Out of memory\n");
       return false;
@@ -151,7 +151,7 @@ static ALLEGRO_LOCKED_REGION *ogl_lock_region_bb_readonly(
    if (e) {
       ALLEGRO_ERROR("glReadPixels for format %s failed (%s).\n",
          _al_pixel_format_name(ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE), _al_gl_error_string(e));
-      al_free(ogl_bitmap->lock_buffer);
+      _al_free_lock_buffer(ogl_bitmap->lock_buffer);
       ogl_bitmap->lock_buffer = NULL;
       return false;
    }
@@ -346,7 +346,7 @@ static bool ogl_lock_region_nonbb_writeonly(
    (void) x;
    (void) gl_y;
 
-   ogl_bitmap->lock_buffer = al_malloc(pitch * h);
+   ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(pitch * h);
    if (ogl_bitmap->lock_buffer == NULL) {
       return false;
    }
@@ -422,7 +422,7 @@ static bool ogl_lock_region_nonbb_readwrite_fbo(
     */
    if (ok) {
       size_t size = _ALLEGRO_MAX(pitch * h, ogl_pitch(w, 4) * h);
-      ogl_bitmap->lock_buffer = al_malloc(size);
+      ogl_bitmap->lock_buffer = _al_alloc_lock_buffer(size);
       if (ogl_bitmap->lock_buffer == NULL) {
          ok = false;
       }
@@ -439,7 +439,7 @@ static bool ogl_lock_region_nonbb_readwrite_fbo(
       if (e) {
          ALLEGRO_ERROR("glReadPixels for format %s failed (%s).\n",
             _al_pixel_format_name(ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE), _al_gl_error_string(e));
-         al_free(ogl_bitmap->lock_buffer);
+         _al_free_lock_buffer(ogl_bitmap->lock_buffer);
          ogl_bitmap->lock_buffer = NULL;
          ok = false;
       }
@@ -506,7 +506,7 @@ void _al_ogl_unlock_region_gles(ALLEGRO_BITMAP *bitmap)
       ogl_unlock_region_nonbb(bitmap, ogl_bitmap);
    }
 
-   al_free(ogl_bitmap->lock_buffer);
+   _al_free_lock_buffer(ogl_bitmap->lock_buffer);
    ogl_bitmap->lock_buffer = NULL;
 }
 
@@ -588,12 +588,7 @@ static void ogl_unlock_region_nonbb(ALLEGRO_BITMAP *bitmap,
        (al_get_opengl_extension_list()->ALLEGRO_GL_OES_framebuffer_object ||
         IS_OPENGLES) /* FIXME */)
    {
-      glGenerateMipmapEXT(GL_TEXTURE_2D);
-      e = glGetError();
-      if (e) {
-         ALLEGRO_ERROR("glGenerateMipmapEXT for texture %d failed (%s).\n",
-            ogl_bitmap->texture, _al_gl_error_string(e));
-      }
+      _al_ogl_update_mipmaps(bitmap, 1);
    }
 
    if (old_disp) {
@@ -652,7 +647,7 @@ static void ogl_unlock_region_nonbb_nonfbo_conv(ALLEGRO_BITMAP *bitmap,
    const int lock_format = bitmap->locked_region.format;
    const int orig_pixel_size = al_get_pixel_size(orig_format);
    const int dst_pitch = bitmap->lock_w * orig_pixel_size;
-   unsigned char * const tmpbuf = al_malloc(dst_pitch * bitmap->lock_h);
+   unsigned char * const tmpbuf = _al_alloc_lock_buffer(dst_pitch * bitmap->lock_h);
    GLenum e;
 
    _al_convert_bitmap_data(
@@ -679,7 +674,7 @@ static void ogl_unlock_region_nonbb_nonfbo_conv(ALLEGRO_BITMAP *bitmap,
          lock_format, _al_gl_error_string(e));
    }
 
-   al_free(tmpbuf);
+   _al_free_lock_buffer(tmpbuf);
 }
 
 
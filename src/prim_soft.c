@@ -23,12 +23,51 @@
 #include "allegro5/internal/aintern_prim_soft.h"
 #include "allegro5/internal/aintern_primitives.h"
 #include "allegro5/internal/aintern_tri_soft.h"
+#include "allegro5/internal/aintern_vector.h"
 
 /*
 The vertex cache allows for bulk transformation of vertices, for faster run speeds
 */
 #define LOCAL_VERTEX_CACHE  ALLEGRO_VERTEX vertex_cache[ALLEGRO_VERTEX_CACHE_SIZE]
 
+/*
+Triangles are either drawn right away, or collected into a batch for
+_al_draw_soft_triangle_batch if that is what the target wants.
+*/
+#define TRIANGLE_2D(v1, v2, v3)                                        \
+   do {                                                                \
+      if (use_batch)                                                   \
+         add_batch_triangle(&batch, v1, v2, v3);                       \
+      else                                                             \
+         _al_triangle_2d(texture, v1, v2, v3);                         \
+   } while (0)
+
+static void add_batch_triangle(_AL_VECTOR *batch, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   ALLEGRO_VERTEX *v = _al_vector_alloc_back(batch);
+   *v = *v1;
+   v = _al_vector_alloc_back(batch);
+   *v = *v2;
+   v = _al_vector_alloc_back(batch);
+   *v = *v3;
+}
+
+static bool is_triangle_type(int type)
+{
+   return type == ALLEGRO_PRIM_TRIANGLE_LIST ||
+      type == ALLEGRO_PRIM_TRIANGLE_STRIP ||
+      type == ALLEGRO_PRIM_TRIANGLE_FAN;
+}
+
+static void draw_batch(ALLEGRO_BITMAP* texture, _AL_VECTOR *batch)
+{
+   if (_al_vector_is_nonempty(batch)) {
+      _al_draw_soft_triangle_batch(texture, _al_vector_ref_front(batch),
+         _al_vector_size(batch) / 3);
+   }
+   _al_vector_free(batch);
+}
+
 static void convert_vtx(ALLEGRO_BITMAP* texture, const char* src, ALLEGRO_VERTEX* dest, const ALLEGRO_VERTEX_DECL* decl)
 {
    ALLEGRO_VERTEX_ELEMENT* e;
@@ -106,6 +145,8 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
    int use_cache;
    int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
    const ALLEGRO_TRANSFORM* global_trans = al_get_current_transform();
+   _AL_VECTOR batch = _AL_VECTOR_INITIALIZER(ALLEGRO_VERTEX);
+   bool use_batch = is_triangle_type(type) && _al_want_soft_triangle_batch();
 
    num_primitives = 0;
    num_vtx = end - start;
@@ -197,7 +238,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 0; ii < num_vtx - 2; ii += 3) {
-               _al_triangle_2d(texture, &vertex_cache[ii], &vertex_cache[ii + 1], &vertex_cache[ii + 2]);
+               TRIANGLE_2D(&vertex_cache[ii], &vertex_cache[ii + 1], &vertex_cache[ii + 2]);
             }
          } else {
             int ii;
@@ -207,7 +248,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
                SET_VERTEX(v2, ii + 1);
                SET_VERTEX(v3, ii + 2);
 
-               _al_triangle_2d(texture, &v1, &v2, &v3);
+               TRIANGLE_2D(&v1, &v2, &v3);
             }
          }
          num_primitives = num_vtx / 3;
@@ -217,7 +258,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 2; ii < num_vtx; ii++) {
-               _al_triangle_2d(texture, &vertex_cache[ii - 2], &vertex_cache[ii - 1], &vertex_cache[ii]);
+               TRIANGLE_2D(&vertex_cache[ii - 2], &vertex_cache[ii - 1], &vertex_cache[ii]);
             }
          } else {
             int ii;
@@ -228,7 +269,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
             for (ii = start + 2; ii < end; ii++) {
                SET_VERTEX(vtx[idx], ii);
 
-               _al_triangle_2d(texture, &vtx[0], &vtx[1], &vtx[2]);
+               TRIANGLE_2D(&vtx[0], &vtx[1], &vtx[2]);
                idx = (idx + 1) % 3;
             }
          }
@@ -239,7 +280,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 1; ii < num_vtx; ii++) {
-               _al_triangle_2d(texture, &vertex_cache[0], &vertex_cache[ii], &vertex_cache[ii - 1]);
+               TRIANGLE_2D(&vertex_cache[0], &vertex_cache[ii], &vertex_cache[ii - 1]);
             }
          } else {
             int ii;
@@ -250,7 +291,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
             SET_VERTEX(vtx[0], start + 1);
             for (ii = start + 1; ii < end; ii++) {
                SET_VERTEX(vtx[idx], ii)
-               _al_triangle_2d(texture, &v0, &vtx[0], &vtx[1]);
+               TRIANGLE_2D(&v0, &vtx[0], &vtx[1]);
                idx = 1 - idx;
             }
          }
@@ -277,6 +318,9 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
       };
    }
 
+   if (use_batch)
+      draw_batch(texture, &batch);
+
    if(texture)
        al_unlock_bitmap(texture);
 
@@ -294,6 +338,8 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
    int ii;
    int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
    const ALLEGRO_TRANSFORM* global_trans = al_get_current_transform();
+   _AL_VECTOR batch = _AL_VECTOR_INITIALIZER(ALLEGRO_VERTEX);
+   bool use_batch = is_triangle_type(type) && _al_want_soft_triangle_batch();
 
    num_primitives = 0;
    use_cache = 1;
@@ -417,7 +463,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                int idx1 = indices[ii] - min_idx;
                int idx2 = indices[ii + 1] - min_idx;
                int idx3 = indices[ii + 2] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
+               TRIANGLE_2D(&vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
             }
          } else {
             int ii;
@@ -431,7 +477,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                SET_VERTEX(v2, idx2);
                SET_VERTEX(v3, idx3);
 
-               _al_triangle_2d(texture, &v1, &v2, &v3);
+               TRIANGLE_2D(&v1, &v2, &v3);
             }
          }
          num_primitives = num_vtx / 3;
@@ -444,7 +490,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                int idx1 = indices[ii - 2] - min_idx;
                int idx2 = indices[ii - 1] - min_idx;
                int idx3 = indices[ii] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
+               TRIANGLE_2D(&vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
             }
          } else {
             int ii;
@@ -455,7 +501,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             for (ii = 2; ii < num_vtx; ii ++) {
                SET_VERTEX(vtx[idx], indices[ii]);
 
-               _al_triangle_2d(texture, &vtx[0], &vtx[1], &vtx[2]);
+               TRIANGLE_2D(&vtx[0], &vtx[1], &vtx[2]);
                idx = (idx + 1) % 3;
             }
          }
@@ -469,7 +515,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             for (ii = 1; ii < num_vtx; ii++) {
                int idx1 = indices[ii] - min_idx;
                int idx2 = indices[ii - 1] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx0], &vertex_cache[idx1], &vertex_cache[idx2]);
+               TRIANGLE_2D(&vertex_cache[idx0], &vertex_cache[idx1], &vertex_cache[idx2]);
             }
          } else {
             int ii;
@@ -480,7 +526,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             SET_VERTEX(vtx[0], indices[1]);
             for (ii = 2; ii < num_vtx; ii ++) {
                SET_VERTEX(vtx[idx], indices[ii])
-               _al_triangle_2d(texture, &v0, &vtx[0], &vtx[1]);
+               TRIANGLE_2D(&v0, &vtx[0], &vtx[1]);
                idx = 1 - idx;
             }
          }
@@ -508,6 +554,9 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
       };
    }
 
+   if (use_batch)
+      draw_batch(texture, &batch);
+
    if(texture)
        al_unlock_bitmap(texture);
 
@@ -35,6 +35,7 @@
 #include "allegro5/internal/aintern_thread.h"
 #include "allegro5/internal/aintern_timer.h"
 #include "allegro5/internal/aintern_tls.h"
+#include "allegro5/internal/aintern_tri_soft.h"
 #include "allegro5/internal/aintern_vector.h"
 
 ALLEGRO_DEBUG_CHANNEL("system")
@@ -281,12 +282,20 @@ bool al_install_system(int version, int (*atexit_ptr)(void (*)(void)))
 
    _al_init_events();
 
+   _al_init_bitmap_locks();
+
+   _al_init_lock_buffer_pool();
+
    _al_init_iio_table();
 
    _al_init_convert_bitmap_list();
 
+   _al_init_convert_funcs();
+
    _al_init_timers();
 
+   _al_init_soft_rasterizer();
+
 #ifdef ALLEGRO_CFG_SHADER_GLSL
    _al_glsl_init_shaders();
 #endif
@@ -34,7 +34,7 @@
 
 
 /* forward declarations */
-static void timer_handle_tick(ALLEGRO_TIMER *timer);
+static void timer_handle_tick(ALLEGRO_TIMER *timer, double error);
 
 
 struct ALLEGRO_TIMER
@@ -43,7 +43,9 @@ struct ALLEGRO_TIMER
    bool started;
    double speed_secs;
    int64_t count;
-   double counter;                /* counts down to zero=blastoff */
+   double counter;                /* time left when the timer was stopped */
+   double deadline;               /* timer_clock value of the next tick */
+   unsigned int heap_index;       /* position in active_timers */
    _AL_LIST_ITEM *dtor_item;
 };
 
@@ -53,12 +55,23 @@ struct ALLEGRO_TIMER
  * The timer thread that runs in the background to drive the timers.
  */
 
+/* Never advance the timers by more than this in one go. */
+#define MAX_INTERVAL    10.0
+
 static ALLEGRO_MUTEX *timers_mutex;
 static _AL_VECTOR active_timers = _AL_VECTOR_INITIALIZER(ALLEGRO_TIMER *);
 static _AL_THREAD * volatile timer_thread = NULL;
 static ALLEGRO_COND *timer_cond = NULL;
 static bool destroy_thread = false;
 
+/* The deadlines of the active timers are measured on timer_clock, which
+ * the timer thread advances by the (bounded) time elapsed between ticks.
+ * timer_clock_time is the uptime at which it was last advanced, or
+ * negative if the timer thread isn't driving the clock.
+ */
+static double timer_clock = 0.0;
+static double timer_clock_time = -1.0;
+
 // Allegro's al_get_time measures "the time since Allegro started", and so does
 // not ignore time spent in a suspended state. Further, some implementations
 // currently use a calendar clock, which changes based on the system clock.
@@ -99,6 +112,117 @@ static double _al_get_uptime(void)
 }
 
 
+/*
+ * active_timers is a binary min-heap ordered by deadline, so the timer
+ * thread only needs to look at the timers that are due.
+ */
+
+static ALLEGRO_TIMER *heap_get(unsigned int i)
+{
+   ALLEGRO_TIMER **slot = _al_vector_ref(&active_timers, i);
+   return *slot;
+}
+
+
+
+static void heap_set(unsigned int i, ALLEGRO_TIMER *timer)
+{
+   ALLEGRO_TIMER **slot = _al_vector_ref(&active_timers, i);
+   *slot = timer;
+   timer->heap_index = i;
+}
+
+
+
+static void heap_sift_up(unsigned int i)
+{
+   ALLEGRO_TIMER *timer = heap_get(i);
+
+   while (i > 0) {
+      unsigned int parent = (i - 1) / 2;
+      ALLEGRO_TIMER *p = heap_get(parent);
+      if (p->deadline <= timer->deadline)
+         break;
+      heap_set(i, p);
+      i = parent;
+   }
+   heap_set(i, timer);
+}
+
+
+
+static void heap_sift_down(unsigned int i)
+{
+   const unsigned int size = _al_vector_size(&active_timers);
+   ALLEGRO_TIMER *timer = heap_get(i);
+
+   for (;;) {
+      unsigned int child = 2 * i + 1;
+      ALLEGRO_TIMER *c;
+      if (child >= size)
+         break;
+      c = heap_get(child);
+      if (child + 1 < size && heap_get(child + 1)->deadline < c->deadline) {
+         child++;
+         c = heap_get(child);
+      }
+      if (timer->deadline <= c->deadline)
+         break;
+      heap_set(i, c);
+      i = child;
+   }
+   heap_set(i, timer);
+}
+
+
+
+static void heap_insert(ALLEGRO_TIMER *timer)
+{
+   ALLEGRO_TIMER **slot = _al_vector_alloc_back(&active_timers);
+   *slot = timer;
+   heap_sift_up(_al_vector_size(&active_timers) - 1);
+}
+
+
+
+static void heap_remove(ALLEGRO_TIMER *timer)
+{
+   const unsigned int i = timer->heap_index;
+   const unsigned int last = _al_vector_size(&active_timers) - 1;
+   ALLEGRO_TIMER *moved;
+
+   ASSERT(heap_get(i) == timer);
+
+   moved = heap_get(last);
+   _al_vector_delete_at(&active_timers, last);
+
+   if (i != last) {
+      heap_set(i, moved);
+      heap_sift_up(i);
+      heap_sift_down(moved->heap_index);
+   }
+}
+
+
+
+/* advance_timer_clock:
+ *  Bring timer_clock up to date, e.g. before computing a new deadline
+ *  while the timer thread is asleep.  timers_mutex must be locked.
+ */
+static void advance_timer_clock(void)
+{
+   double now;
+
+   if (timer_clock_time < 0)
+      return;
+
+   now = _al_get_uptime();
+   timer_clock += _ALLEGRO_CLAMP(0, now - timer_clock_time, MAX_INTERVAL);
+   timer_clock_time = now;
+}
+
+
+
 /* timer_thread_proc: [timer thread]
  *  The timer thread procedure itself.
  */
@@ -119,70 +243,79 @@ static void timer_thread_proc(_AL_THREAD *self, void *unused)
 #endif
 
    _init_get_uptime();
-   double old_time = _al_get_uptime();
-   double new_time;
-   double interval = 0.032768;
 
-   while (!_al_get_thread_should_stop(self)) {
-      al_lock_mutex(timers_mutex);
-      while (_al_vector_size(&active_timers) == 0 && !destroy_thread) {
+   al_lock_mutex(timers_mutex);
+   timer_clock_time = _al_get_uptime();
+
+   while (!_al_get_thread_should_stop(self) && !destroy_thread) {
+      double new_time;
+      double interval;
+
+      /* Sleep until the earliest deadline.  Starting a timer or changing
+       * its speed signals the condition, as the deadline may have moved.
+       */
+      if (_al_vector_is_empty(&active_timers)) {
          al_wait_cond(timer_cond, timers_mutex);
-         old_time = _al_get_uptime() - interval;
       }
-      al_unlock_mutex(timers_mutex);
-
-      al_rest(interval);
+      else {
+         ALLEGRO_TIMEOUT timeout;
+         double delay = heap_get(0)->deadline - timer_clock;
+         delay -= _al_get_uptime() - timer_clock_time;
+         if (delay > 0) {
+            al_init_timeout(&timeout, _ALLEGRO_MIN(delay, MAX_INTERVAL));
+            al_wait_cond_until(timer_cond, timers_mutex, &timeout);
+         }
+      }
 
-      al_lock_mutex(timers_mutex);
-      {
-         /* Calculate actual time elapsed.  */
-         new_time = _al_get_uptime();
-         interval = new_time - old_time;
-         old_time = new_time;
+      /* Calculate actual time elapsed.  */
+      new_time = _al_get_uptime();
+      interval = new_time - timer_clock_time;
+      timer_clock_time = new_time;
 
-         /* Handle a tick.  */
-         interval = _al_timer_thread_handle_tick(interval);
-      }
-      al_unlock_mutex(timers_mutex);
+      /* Handle a tick.  */
+      _al_timer_thread_handle_tick(interval);
    }
 
+   timer_clock_time = -1.0;
+   al_unlock_mutex(timers_mutex);
+
    (void)unused;
 }
 
 
 
 /* timer_thread_handle_tick: [timer thread]
- *  Call handle_tick() method of every timer in active_timers, and
- *  returns the duration that the timer thread should try to sleep
- *  next time.
+ *  Advance the timer clock by the given interval and call handle_tick()
+ *  for every timer in active_timers which is due.  Returns the duration
+ *  until the next deadline.  timers_mutex must be locked.
  */
 double _al_timer_thread_handle_tick(double interval)
 {
-   double new_delay = 0.032768;
-   unsigned int i;
-
    /* Never allow negative time, or greater than 10 seconds delta.
     * This is to handle clock changes on platforms not using a monotonic,
     * suspense-free clock.
     */
-   interval = _ALLEGRO_CLAMP(0, interval, 10.0);
+   interval = _ALLEGRO_CLAMP(0, interval, MAX_INTERVAL);
+   timer_clock += interval;
 
-   for (i = 0; i < _al_vector_size(&active_timers); i++) {
-      ALLEGRO_TIMER **slot = _al_vector_ref(&active_timers, i);
-      ALLEGRO_TIMER *timer = *slot;
+   while (!_al_vector_is_empty(&active_timers)) {
+      ALLEGRO_TIMER *timer = heap_get(0);
 
-      timer->counter -= interval;
+      if (timer->deadline > timer_clock)
+         break;
 
-      while (timer->counter <= 0) {
-         timer_handle_tick(timer);
-         timer->counter += timer->speed_secs;
+      while (timer->deadline <= timer_clock) {
+         timer_handle_tick(timer, timer_clock - timer->deadline);
+         timer->deadline += timer->speed_secs;
       }
 
-      if ((timer->counter > 0) && (timer->counter < new_delay))
-         new_delay = timer->counter;
+      heap_sift_down(0);
    }
 
-   return new_delay;
+   if (_al_vector_is_empty(&active_timers))
+      return MAX_INTERVAL;
+
+   return heap_get(0)->deadline - timer_clock;
 }
 
 
@@ -226,17 +359,18 @@ static void enable_timer(ALLEGRO_TIMER *timer, bool reset_counter)
 
       al_lock_mutex(timers_mutex);
       {
-         ALLEGRO_TIMER **slot;
-
          timer->started = true;
 
          if (reset_counter)
             timer->counter = timer->speed_secs;
 
-         slot = _al_vector_alloc_back(&active_timers);
-         *slot = timer;
+         advance_timer_clock();
+         timer->deadline = timer_clock + timer->counter;
+         heap_insert(timer);
 
-         al_signal_cond(timer_cond);
+         /* Wake the timer thread if this is now the earliest deadline. */
+         if (timer->heap_index == 0)
+            al_signal_cond(timer_cond);
       }
       al_unlock_mutex(timers_mutex);
 
@@ -286,6 +420,8 @@ ALLEGRO_TIMER *al_create_timer(double speed_secs)
          timer->count = 0;
          timer->speed_secs = speed_secs;
          timer->counter = 0;
+         timer->deadline = 0;
+         timer->heap_index = 0;
 
          timer->dtor_item = _al_register_destructor(_al_dtor_list, "timer", timer,
             (void (*)(void *)) al_destroy_timer);
@@ -342,7 +478,10 @@ void al_stop_timer(ALLEGRO_TIMER *timer)
 
       al_lock_mutex(timers_mutex);
       {
-         _al_vector_find_and_delete(&active_timers, &timer);
+         /* Remember the time left for al_resume_timer. */
+         advance_timer_clock();
+         timer->counter = timer->deadline - timer_clock;
+         heap_remove(timer);
          timer->started = false;
       }
       al_unlock_mutex(timers_mutex);
@@ -383,8 +522,12 @@ void al_set_timer_speed(ALLEGRO_TIMER *timer, double new_speed_secs)
    al_lock_mutex(timers_mutex);
    {
       if (timer->started) {
-         timer->counter -= timer->speed_secs;
-         timer->counter += new_speed_secs;
+         timer->deadline -= timer->speed_secs;
+         timer->deadline += new_speed_secs;
+         heap_sift_up(timer->heap_index);
+         heap_sift_down(timer->heap_index);
+         if (timer->heap_index == 0)
+            al_signal_cond(timer_cond);
       }
 
       timer->speed_secs = new_speed_secs;
@@ -437,7 +580,7 @@ void al_add_timer_count(ALLEGRO_TIMER *timer, int64_t diff)
 /* timer_handle_tick: [timer thread]
  *  Handle a single tick.
  */
-static void timer_handle_tick(ALLEGRO_TIMER *timer)
+static void timer_handle_tick(ALLEGRO_TIMER *timer, double error)
 {
    /* Lock out event source helper functions (e.g. the release hook
     * could be invoked simultaneously with this function).
@@ -453,7 +596,7 @@ static void timer_handle_tick(ALLEGRO_TIMER *timer)
          event.timer.type = ALLEGRO_EVENT_TIMER;
          event.timer.timestamp = al_get_time();
          event.timer.count = timer->count;
-         event.timer.error = -timer->counter;
+         event.timer.error = error;
          _al_event_source_emit_event(&timer->es, &event);
       }
    }
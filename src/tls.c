@@ -42,6 +42,7 @@
 #include "allegro5/internal/aintern_display.h"
 #include "allegro5/internal/aintern_file.h"
 #include "allegro5/internal/aintern_fshook.h"
+#include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_shader.h"
 #include "allegro5/internal/aintern_tls.h"
 
@@ -94,6 +95,7 @@ typedef struct thread_local_state {
    /* Files */
    const ALLEGRO_FILE_INTERFACE *new_file_interface;
    const ALLEGRO_FS_INTERFACE *fs_interface;
+   ALLEGRO_PACK *pack;
 
    /* Error code */
    int allegro_errno;
@@ -109,6 +111,9 @@ typedef struct thread_local_state {
 
    /* Destructor ownership count */
    int dtor_owner_count;
+
+   /* Bitmap drawing held on memory bitmaps, see memblit.c */
+   _AL_HELD_DRAWS held_draws;
 } thread_local_state;
 
 
@@ -433,8 +438,12 @@ void al_set_target_bitmap(ALLEGRO_BITMAP *bitmap)
       new_shader = NULL;
    }
    else if (bitmap_flags & ALLEGRO_MEMORY_BITMAP) {
-      /* Setting a memory bitmap doesn't change the rendering context. */
-      new_display = old_display;
+      /* Setting a memory bitmap doesn't change the rendering context, unless
+       * it is the backbuffer of a headless display.
+       */
+      new_display = _al_get_bitmap_display(bitmap);
+      if (!new_display)
+         new_display = old_display;
       new_shader = NULL;
    }
    else {
@@ -735,6 +744,7 @@ void al_store_state(ALLEGRO_STATE *state, int flags)
    if (flags & ALLEGRO_STATE_NEW_FILE_INTERFACE) {
       _STORE(new_file_interface);
       _STORE(fs_interface);
+      _STORE(pack);
    }
 
    if (flags & ALLEGRO_STATE_TRANSFORM) {
@@ -812,6 +822,7 @@ void al_restore_state(ALLEGRO_STATE const *state)
    if (flags & ALLEGRO_STATE_NEW_FILE_INTERFACE) {
       _RESTORE(new_file_interface);
       _RESTORE(fs_interface);
+      _RESTORE(pack);
    }
 
    if (flags & ALLEGRO_STATE_TRANSFORM) {
@@ -997,4 +1008,24 @@ int *_al_tls_get_dtor_owner_count(void)
 }
 
 
+_AL_HELD_DRAWS *_al_tls_get_held_draws(void)
+{
+   thread_local_state *tls;
+
+   if ((tls = tls_get()) == NULL)
+      return NULL;
+   return &tls->held_draws;
+}
+
+
+ALLEGRO_PACK **_al_tls_get_pack(void)
+{
+   thread_local_state *tls;
+
+   if ((tls = tls_get()) == NULL)
+      return NULL;
+   return &tls->pack;
+}
+
+
 /* vim: set sts=3 sw=3 et: */
@@ -21,11 +21,22 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_blend.h"
+#include "allegro5/internal/aintern_exitfunc.h"
 #include "allegro5/internal/aintern_pixels.h"
 #include "allegro5/internal/aintern_primitives.h"
+#include "allegro5/internal/aintern_thread.h"
 #include "allegro5/internal/aintern_tri_soft.h"
+#include <limits.h>
 #include <math.h>
 
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define ALLEGRO_TRI_SOFT_SSE2
+      #include <emmintrin.h>
+   #endif
+#endif
+
 ALLEGRO_DEBUG_CHANNEL("tri_soft")
 
 #define MIN _ALLEGRO_MIN
@@ -405,14 +416,160 @@ static void shader_texture_grad_any_step(uintptr_t state, int minor)
    }
 }
 
+/*========================== Integer Span Helpers ============================*/
+
+/*
+The scanline drawers have integer versions for the ARGB_8888, ABGR_8888 and
+(on little endian machines) ABGR_8888_LE formats, which are used unless the
+blender is one _al_blend_span_int can't do. Those formats keep alpha in the top
+byte of a 32-bit pixel and differ only in the red/blue order, so pixels are
+copied and blended whole. Colours are kept as 16.16 fixed point channels in
+the order of the destination pixel, from the lowest byte up.
+*/
+
+#define INT_SPAN_SIZE 256
+
+#define INT_SPAN_SWAP_RB(p) \
+   (((p) & 0xff00ff00) | (((p) >> 16) & 0xff) | (((p) & 0xff) << 16))
+
+static bool int_span_format(int format)
+{
+   switch (format) {
+      case ALLEGRO_PIXEL_FORMAT_ARGB_8888:
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888:
+         return true;
+#ifdef ALLEGRO_LITTLE_ENDIAN
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE:
+         return true;
+#endif
+      default:
+         return false;
+   }
+}
+
+static bool int_span_swap_rb(int src_format, int dst_format)
+{
+   return (src_format == ALLEGRO_PIXEL_FORMAT_ARGB_8888) !=
+      (dst_format == ALLEGRO_PIXEL_FORMAT_ARGB_8888);
+}
+
+/*
+Checks that a colour stepped n times by dc stays in a range where the fixed
+point channels can't overflow. Colours outside of it are left to the float
+drawers.
+*/
+static bool int_span_color_ok(const ALLEGRO_COLOR *c, const ALLEGRO_COLOR *dc,
+   int n)
+{
+   ALLEGRO_COLOR e = *c;
+
+   if (dc) {
+      e.r += dc->r * n;
+      e.g += dc->g * n;
+      e.b += dc->b * n;
+      e.a += dc->a * n;
+   }
+
+   #define IN_RANGE(x) ((x) >= -1.0f && (x) <= 2.0f)
+   return IN_RANGE(c->r) && IN_RANGE(c->g) && IN_RANGE(c->b) && IN_RANGE(c->a)
+      && IN_RANGE(e.r) && IN_RANGE(e.g) && IN_RANGE(e.b) && IN_RANGE(e.a);
+   #undef IN_RANGE
+}
+
+/*
+Converts c multiplied by scale to 16.16 fixed point channels. Multiplying by
+the scale first truncates the same way as _AL_INLINE_PUT_PIXEL does.
+*/
+static _AL_ALWAYS_INLINE void int_span_channels(int format,
+   const ALLEGRO_COLOR *c, float scale, int32_t channels[4])
+{
+   float r = c->r * scale;
+   float b = c->b * scale;
+
+   if (format == ALLEGRO_PIXEL_FORMAT_ARGB_8888) {
+      float t = r;
+      r = b;
+      b = t;
+   }
+   channels[0] = (int32_t)(r * 65536.0f);
+   channels[1] = (int32_t)(c->g * scale * 65536.0f);
+   channels[2] = (int32_t)(b * 65536.0f);
+   channels[3] = (int32_t)(c->a * scale * 65536.0f);
+}
+
+static _AL_ALWAYS_INLINE uint32_t int_span_clamp(int32_t c)
+{
+   /* Written so that compilers use conditional moves. */
+   c = (c < 0 ? 0 : c) >> 16;
+   return c > 255 ? 255 : c;
+}
+
+#ifdef ALLEGRO_TRI_SOFT_SSE2
+
+/* The saturating packs clamp the channels just like int_span_clamp. */
+static _AL_ALWAYS_INLINE uint32_t int_span_pack_sse2(__m128i c)
+{
+   c = _mm_packs_epi32(_mm_srai_epi32(c, 16), _mm_setzero_si128());
+   return _mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+}
+
+static _AL_ALWAYS_INLINE uint32_t int_span_pack(const int32_t color[4])
+{
+   return int_span_pack_sse2(_mm_loadu_si128((const __m128i *)color));
+}
+
+static _AL_ALWAYS_INLINE uint32_t int_span_tint(uint32_t p,
+   const int32_t tint[4])
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i t = _mm_loadu_si128((const __m128i *)tint);
+   __m128i c = _mm_cvtsi32_si128(p);
+   __m128i even, odd;
+
+   c = _mm_unpacklo_epi16(_mm_unpacklo_epi8(c, zero), zero);
+   /* The low halves of the unsigned products are the signed products. */
+   even = _mm_mul_epu32(c, t);
+   odd = _mm_mul_epu32(_mm_srli_epi64(c, 32), _mm_srli_epi64(t, 32));
+   c = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+      _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+   return int_span_pack_sse2(c);
+}
+
+#else
+
+static _AL_ALWAYS_INLINE uint32_t int_span_pack(const int32_t color[4])
+{
+   return int_span_clamp(color[0])
+      | int_span_clamp(color[1]) << 8
+      | int_span_clamp(color[2]) << 16
+      | int_span_clamp(color[3]) << 24;
+}
+
+static _AL_ALWAYS_INLINE uint32_t int_span_tint(uint32_t p,
+   const int32_t tint[4])
+{
+   return int_span_clamp((int32_t)(p & 0xff) * tint[0])
+      | int_span_clamp((int32_t)((p >> 8) & 0xff) * tint[1]) << 8
+      | int_span_clamp((int32_t)((p >> 16) & 0xff) * tint[2]) << 16
+      | int_span_clamp((int32_t)(p >> 24) * tint[3]) << 24;
+}
+
+#endif
+
 
 /* Include generated routines. */
 #include "scanline_drawers.inc"
 
 
+/*
+Only the rows with min_row <= cur_y < max_row are drawn. The triangle is
+always stepped from its top, so the spans come out the same no matter which
+rows are drawn.
+*/
 static void triangle_stepper(uintptr_t state,
    shader_init init, shader_first first, shader_step step, shader_draw draw,
-   ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3)
+   ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3,
+   int min_row, int max_row)
 {
    float Coords[6] = {vtx1->x - 0.5f, vtx1->y + 0.5f, vtx2->x - 0.5f, vtx2->y + 0.5f, vtx3->x - 0.5f, vtx3->y + 0.5f};
    float *V1 = Coords, *V2 = &Coords[2], *V3 = &Coords[4], *s;
@@ -466,6 +623,14 @@ static void triangle_stepper(uintptr_t state,
    if (cur_y == end_y)
       return;
 
+   if (end_y > max_row) {
+      end_y = max_row;
+      if (mid_y > end_y)
+         mid_y = end_y;
+      if (cur_y >= end_y)
+         return;
+   }
+
    /*
    As per definition, we take the ceiling
    */
@@ -556,7 +721,7 @@ static void triangle_stepper(uintptr_t state,
 
          first(state, left_x, cur_y, left_step, left_step - 1);
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y >= min_row) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -592,7 +757,7 @@ static void triangle_stepper(uintptr_t state,
             right_x -= 1;
          }
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y >= min_row) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -646,7 +811,7 @@ static void triangle_stepper(uintptr_t state,
 
          first(state, left_x, cur_y, left_step, left_step - 1);
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y >= min_row) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -674,7 +839,7 @@ static void triangle_stepper(uintptr_t state,
             right_x -= 1;
          }
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y >= min_row) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -685,11 +850,17 @@ static void triangle_stepper(uintptr_t state,
    }
 }
 
+static void draw_soft_triangle(
+   ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
+   shader_init init, shader_first first, shader_step step, shader_draw draw,
+   int min_row, int max_row);
+
 /*
 This one will check to see what exactly we need to draw...
 I.e. this will call all of the actual renderers and set the appropriate callbacks
 */
-void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+static void triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3,
+   int min_row, int max_row)
 {
    int shade = 1;
    int grad = 1;
@@ -729,9 +900,9 @@ void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX
          state.solid.texture = texture;
 
          if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_shade);
+            draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_shade, min_row, max_row);
          } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_opaque);
+            draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_opaque, min_row, max_row);
          }
       } else {
          int white = 0;
@@ -744,22 +915,22 @@ void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX
          if (shade) {
             if (white) {
                if (repeat) {
-                  _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_white_repeat);
+                  draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_white_repeat, min_row, max_row);
                } else {
-                  _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_white);
+                  draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_white, min_row, max_row);
                }
             } else {
                if (repeat) {
-                  _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_repeat);
+                  draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_repeat, min_row, max_row);
                } else {
-                  _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade);
+                  draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade, min_row, max_row);
                }
             }
          } else {
             if (white) {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque_white);
+               draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque_white, min_row, max_row);
             } else {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque);
+               draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque, min_row, max_row);
             }
          }
       }
@@ -767,21 +938,26 @@ void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX
       if (grad) {
          state_grad_any_2d state;
          if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_shade);
+            draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_shade, min_row, max_row);
          } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_opaque);
+            draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_opaque, min_row, max_row);
          }
       } else {
          state_solid_any_2d state;
          if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_shade);
+            draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_shade, min_row, max_row);
          } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_opaque);
+            draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_opaque, min_row, max_row);
          }
       }
    }
 }
 
+void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   triangle_2d(texture, v1, v2, v3, INT_MIN, INT_MAX);
+}
+
 static int bitmap_region_is_locked(ALLEGRO_BITMAP* bmp, int x1, int y1, int w, int h)
 {
    ASSERT(bmp);
@@ -793,12 +969,10 @@ static int bitmap_region_is_locked(ALLEGRO_BITMAP* bmp, int x1, int y1, int w, i
    return 0;
 }
 
-void _al_draw_soft_triangle(
+static void draw_soft_triangle(
    ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
-   void (*init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*),
-   void (*first)(uintptr_t, int, int, int, int),
-   void (*step)(uintptr_t, int),
-   void (*draw)(uintptr_t, int, int, int))
+   shader_init init, shader_first first, shader_step step, shader_draw draw,
+   int min_row, int max_row)
 {
    /*
    ALLEGRO_VERTEX copy_v1, copy_v2; <- may be needed for clipping later on
@@ -853,16 +1027,382 @@ void _al_draw_soft_triangle(
       if (!bitmap_region_is_locked(target, min_x, min_y, max_x - min_x, max_y - min_y) ||
           _al_pixel_format_is_video_only(target->locked_region.format))
          return;
+   } else if (target->parent && al_is_bitmap_locked(target->parent)) {
+      /* Locking a sub-bitmap locks its parent, as batches do. */
+      ALLEGRO_BITMAP *parent = target->parent;
+      if (!bitmap_region_is_locked(parent, min_x + target->xofs, min_y + target->yofs, max_x - min_x, max_y - min_y) ||
+          _al_pixel_format_is_video_only(parent->locked_region.format))
+         return;
    } else {
       if (!(lr = al_lock_bitmap_region(target, min_x, min_y, max_x - min_x, max_y - min_y, ALLEGRO_PIXEL_FORMAT_ANY, 0)))
          return;
       need_unlock = 1;
    }
 
-   triangle_stepper(state, init, first, step, draw, v1, v2, v3);
+   triangle_stepper(state, init, first, step, draw, v1, v2, v3, min_row, max_row);
 
    if (need_unlock)
       al_unlock_bitmap(target);
 }
 
+void _al_draw_soft_triangle(
+   ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
+   void (*init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*),
+   void (*first)(uintptr_t, int, int, int, int),
+   void (*step)(uintptr_t, int),
+   void (*draw)(uintptr_t, int, int, int))
+{
+   draw_soft_triangle(v1, v2, v3, state, init, first, step, draw,
+      INT_MIN, INT_MAX);
+}
+
+/*=========================== Multithreaded Batches ==========================*/
+
+/*
+Triangle batches drawn to memory bitmaps can be spread over several threads,
+if the soft_rasterizer_threads option in the [graphics] section of the system
+config asks for it. The target is locked once for the whole batch and its rows
+are divided into bands. Each thread takes a band at a time and draws all the
+triangles which touch it, in the order they were submitted, but only the rows
+inside the band. Since every triangle is still stepped from its top and no
+pixel is touched by two threads, the result is the same as drawing the
+triangles one after another.
+*/
+
+#define MT_MAX_THREADS      64
+#define MT_BANDS_PER_THREAD 4
+#define MT_MIN_BAND_HEIGHT  16
+#define MT_MIN_AREA         (256 * 256)
+
+typedef struct MT_JOB {
+   ALLEGRO_BITMAP *texture;
+   ALLEGRO_VERTEX *vtxs;
+   ALLEGRO_STATE state;
+   int y;
+   int band_h;
+   int num_bands;
+   int *band_start;
+   int *band_tris;
+   int next_band;
+} MT_JOB;
+
+static struct {
+   _AL_MUTEX mutex;
+   _AL_COND work_cond;
+   _AL_COND done_cond;
+   _AL_THREAD *threads;
+   int num_threads;
+   int max_threads;
+   MT_JOB *job;
+   unsigned int generation;
+   int busy;
+   bool quit;
+} pool;
+
+
+/* get_num_threads:
+ *  Returns the number of threads a batch may use.  The config is only read
+ *  the first time, so that checking every triangle draw stays cheap.
+ */
+static int get_num_threads(void)
+{
+   if (pool.max_threads < 0) {
+      const char *value = al_get_config_value(al_get_system_config(),
+         "graphics", "soft_rasterizer_threads");
+      int n = value ? atoi(value) : 0;
+      pool.max_threads = MAX(0, MIN(n, MT_MAX_THREADS));
+   }
+
+   return pool.max_threads;
+}
+
+/* The caller and the workers all draw bands until none are left. */
+static void draw_bands(MT_JOB *job)
+{
+   for (;;) {
+      int band, min_row, i;
+
+      _al_mutex_lock(&pool.mutex);
+      band = job->next_band++;
+      _al_mutex_unlock(&pool.mutex);
+
+      if (band >= job->num_bands)
+         break;
+
+      /* The stepper passes the row below the one being drawn. */
+      min_row = job->y + band * job->band_h + 1;
+      for (i = job->band_start[band]; i < job->band_start[band + 1]; i++) {
+         ALLEGRO_VERTEX *v = job->vtxs + 3 * job->band_tris[i];
+         triangle_2d(job->texture, &v[0], &v[1], &v[2],
+            min_row, min_row + job->band_h);
+      }
+   }
+}
+
+static void worker_proc(_AL_THREAD *self, void *arg)
+{
+   /* Workers are started before the job they are meant for is posted. */
+   unsigned int generation = (unsigned int)(uintptr_t)arg;
+   (void)self;
+
+   _al_mutex_lock(&pool.mutex);
+   for (;;) {
+      MT_JOB *job;
+
+      while (!pool.quit && pool.generation == generation)
+         _al_cond_wait(&pool.work_cond, &pool.mutex);
+      if (pool.quit)
+         break;
+      generation = pool.generation;
+      job = pool.job;
+      _al_mutex_unlock(&pool.mutex);
+
+      /* Drawing needs the target and blender of the calling thread. */
+      al_restore_state(&job->state);
+      draw_bands(job);
+      al_set_target_bitmap(NULL);
+
+      _al_mutex_lock(&pool.mutex);
+      if (--pool.busy == 0)
+         _al_cond_broadcast(&pool.done_cond);
+   }
+   _al_mutex_unlock(&pool.mutex);
+}
+
+static void stop_workers(void)
+{
+   int i;
+
+   _al_mutex_lock(&pool.mutex);
+   pool.quit = true;
+   _al_cond_broadcast(&pool.work_cond);
+   _al_mutex_unlock(&pool.mutex);
+
+   for (i = 0; i < pool.num_threads; i++)
+      _al_thread_join(&pool.threads[i]);
+
+   al_free(pool.threads);
+   pool.threads = NULL;
+   pool.num_threads = 0;
+   pool.quit = false;
+}
+
+static void start_workers(int num_threads)
+{
+   int i;
+
+   pool.threads = al_malloc(num_threads * sizeof(*pool.threads));
+   if (!pool.threads)
+      return;
+   for (i = 0; i < num_threads; i++)
+      _al_thread_create(&pool.threads[i], worker_proc,
+         (void *)(uintptr_t)pool.generation);
+   pool.num_threads = num_threads;
+   ALLEGRO_INFO("Started %d soft rasterizer threads.\n", num_threads);
+}
+
+/* Runs the job on the pool plus the calling thread.  Returns false if the
+ * pool is busy with a job from another thread.
+ */
+static bool run_job(MT_JOB *job, int num_threads)
+{
+   _al_mutex_lock(&pool.mutex);
+   if (pool.job) {
+      _al_mutex_unlock(&pool.mutex);
+      return false;
+   }
+   pool.job = job;
+   _al_mutex_unlock(&pool.mutex);
+
+   if (pool.num_threads != num_threads - 1) {
+      if (pool.threads)
+         stop_workers();
+      start_workers(num_threads - 1);
+   }
+
+   _al_mutex_lock(&pool.mutex);
+   pool.busy = pool.num_threads;
+   pool.generation++;
+   _al_cond_broadcast(&pool.work_cond);
+   _al_mutex_unlock(&pool.mutex);
+
+   draw_bands(job);
+
+   _al_mutex_lock(&pool.mutex);
+   while (pool.busy > 0)
+      _al_cond_wait(&pool.done_cond, &pool.mutex);
+   pool.job = NULL;
+   _al_mutex_unlock(&pool.mutex);
+
+   return true;
+}
+
+/* Sorts the triangles into bands.  Returns false if it's not worth the
+ * trouble or there is no memory for it.
+ */
+static bool bin_triangles(MT_JOB *job, int num_triangles, int num_threads,
+   int clip_x, int clip_y, int clip_w, int clip_h)
+{
+   int *first_band;
+   int *last_band;
+   double area = 0;
+   int i, b;
+
+   job->y = clip_y;
+   job->band_h = (clip_h + num_threads * MT_BANDS_PER_THREAD - 1) /
+      (num_threads * MT_BANDS_PER_THREAD);
+   job->band_h = MAX(job->band_h, MT_MIN_BAND_HEIGHT);
+   job->num_bands = (clip_h + job->band_h - 1) / job->band_h;
+   job->next_band = 0;
+   job->band_tris = NULL;
+   job->band_start = al_calloc(job->num_bands + 1, sizeof(int));
+   first_band = al_malloc(2 * num_triangles * sizeof(int));
+   if (!job->band_start || !first_band) {
+      al_free(job->band_start);
+      al_free(first_band);
+      return false;
+   }
+   last_band = first_band + num_triangles;
+
+   /* The rows are the same the serial drawer would lock. */
+   for (i = 0; i < num_triangles; i++) {
+      ALLEGRO_VERTEX *v = job->vtxs + 3 * i;
+      float top = floorf(MIN(v[0].y, MIN(v[1].y, v[2].y))) - 1;
+      float bottom = ceilf(MAX(v[0].y, MAX(v[1].y, v[2].y))) + 1;
+      float left = floorf(MIN(v[0].x, MIN(v[1].x, v[2].x))) - 1;
+      float right = ceilf(MAX(v[0].x, MAX(v[1].x, v[2].x))) + 1;
+
+      if (!(top < clip_y + clip_h && bottom >= clip_y &&
+            left < clip_x + clip_w && right >= clip_x)) {
+         first_band[i] = 0;
+         last_band[i] = -1;
+         continue;
+      }
+      top = MAX(top, clip_y);
+      bottom = MIN(bottom, clip_y + clip_h - 1);
+      area += (bottom - top + 1) *
+         (MIN(right, clip_x + clip_w - 1) - MAX(left, clip_x) + 1);
+
+      first_band[i] = ((int)top - clip_y) / job->band_h;
+      last_band[i] = ((int)bottom - clip_y) / job->band_h;
+      for (b = first_band[i]; b <= last_band[i]; b++)
+         job->band_start[b + 1]++;
+   }
+
+   if (area < MT_MIN_AREA) {
+      al_free(job->band_start);
+      al_free(first_band);
+      return false;
+   }
+
+   for (b = 0; b < job->num_bands; b++)
+      job->band_start[b + 1] += job->band_start[b];
+
+   job->band_tris = al_malloc(MAX(job->band_start[job->num_bands], 1) *
+      sizeof(int));
+   if (!job->band_tris) {
+      al_free(job->band_start);
+      al_free(first_band);
+      return false;
+   }
+
+   /* Fill the bands in submission order, using band_start as the cursor
+    * and shifting it back afterwards.
+    */
+   for (i = 0; i < num_triangles; i++) {
+      for (b = first_band[i]; b <= last_band[i]; b++)
+         job->band_tris[job->band_start[b]++] = i;
+   }
+   for (b = job->num_bands; b > 0; b--)
+      job->band_start[b] = job->band_start[b - 1];
+   job->band_start[0] = 0;
+
+   al_free(first_band);
+   return true;
+}
+
+/* Internal function: _al_want_soft_triangle_batch
+ *  Returns true if triangles drawn to the current target should be collected
+ *  and passed to _al_draw_soft_triangle_batch.
+ */
+bool _al_want_soft_triangle_batch(void)
+{
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+
+   return target && (al_get_bitmap_flags(target) & ALLEGRO_MEMORY_BITMAP) &&
+      get_num_threads() > 1;
+}
+
+/* Internal function: _al_draw_soft_triangle_batch
+ *  Draws num_triangles triangles, three vertices each, like calling
+ *  _al_triangle_2d for each of them in turn.
+ */
+void _al_draw_soft_triangle_batch(ALLEGRO_BITMAP *texture,
+   ALLEGRO_VERTEX *vtxs, int num_triangles)
+{
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+   int clip_x, clip_y, clip_w, clip_h;
+   int num_threads = get_num_threads();
+   bool need_unlock = false;
+   bool done = false;
+   MT_JOB job;
+   int i;
+
+   al_get_clipping_rectangle(&clip_x, &clip_y, &clip_w, &clip_h);
+   if (clip_w <= 0 || clip_h <= 0)
+      return;
+
+   if (!al_is_bitmap_locked(target)) {
+      if (!al_lock_bitmap_region(target, clip_x, clip_y, clip_w, clip_h,
+            ALLEGRO_PIXEL_FORMAT_ANY, 0))
+         return;
+      need_unlock = true;
+   }
+
+   job.texture = texture;
+   job.vtxs = vtxs;
+   if (num_threads > 1 && bin_triangles(&job, num_triangles, num_threads,
+         clip_x, clip_y, clip_w, clip_h)) {
+      al_store_state(&job.state,
+         ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+      done = run_job(&job, num_threads);
+      al_free(job.band_start);
+      al_free(job.band_tris);
+   }
+
+   if (!done) {
+      for (i = 0; i < num_triangles; i++) {
+         ALLEGRO_VERTEX *v = vtxs + 3 * i;
+         triangle_2d(texture, &v[0], &v[1], &v[2], INT_MIN, INT_MAX);
+      }
+   }
+
+   if (need_unlock)
+      al_unlock_bitmap(target);
+}
+
+static void shutdown_soft_rasterizer(void)
+{
+   if (pool.threads)
+      stop_workers();
+   _al_cond_destroy(&pool.done_cond);
+   _al_cond_destroy(&pool.work_cond);
+   _al_mutex_destroy(&pool.mutex);
+}
+
+/* Internal function: _al_init_soft_rasterizer
+ *  Sets up the thread pool used by _al_draw_soft_triangle_batch.  The
+ *  threads themselves are only started on first use, and the
+ *  soft_rasterizer_threads option is read the first time a triangle is
+ *  drawn to a memory bitmap.
+ */
+void _al_init_soft_rasterizer(void)
+{
+   pool.max_threads = -1;
+   _al_mutex_init(&pool.mutex);
+   _al_cond_init(&pool.work_cond);
+   _al_cond_init(&pool.done_cond);
+   _al_add_exit_func(shutdown_soft_rasterizer, "shutdown_soft_rasterizer");
+}
+
 /* vim: set sts=3 sw=3 et: */
@@ -892,7 +892,7 @@ static ALLEGRO_LOCKED_REGION *d3d_lock_region(ALLEGRO_BITMAP *bitmap,
    }
    else {
       bitmap->locked_region.pitch = al_get_pixel_size(f) * w;
-      bitmap->locked_region.data = al_malloc(bitmap->locked_region.pitch*h);
+      bitmap->locked_region.data = _al_alloc_lock_buffer(bitmap->locked_region.pitch*h);
       bitmap->locked_region.format = f;
       bitmap->locked_region.pixel_size = al_get_pixel_size(f);
       if (!(bitmap->lock_flags & ALLEGRO_LOCK_WRITEONLY)) {
@@ -918,7 +918,7 @@ static void d3d_unlock_region(ALLEGRO_BITMAP *bitmap)
             d3d_bmp->locked_rect.pBits, system_format, d3d_bmp->locked_rect.Pitch,
             0, 0, 0, 0, bitmap->lock_w, bitmap->lock_h);
       }
-      al_free(bitmap->locked_region.data);
+      _al_free_lock_buffer(bitmap->locked_region.data);
    }
 
    if (d3d_bmp->is_backbuffer) {
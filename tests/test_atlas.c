@@ -0,0 +1,207 @@
+/*
+ *    Tests for bitmap atlases: packing, page overflow and removal.
+ */
+
+#undef NDEBUG
+#include <assert.h>
+#include <string.h>
+
+#define ALLEGRO_UNSTABLE
+#include "allegro5/allegro.h"
+
+#define PAGE_SIZE 64
+#define PADDING   1
+#define BMP_SIZE  20
+/* Bitmaps of BMP_SIZE plus padding fit three to a row. */
+#define PER_PAGE  9
+
+static ALLEGRO_COLOR color(int i)
+{
+   return al_map_rgba(i * 10, 255 - i * 10, i * 5, 255);
+}
+
+static bool same_color(ALLEGRO_COLOR a, ALLEGRO_COLOR b)
+{
+   return memcmp(&a, &b, sizeof a) == 0;
+}
+
+static ALLEGRO_BITMAP *create_filled(int w, int h, ALLEGRO_COLOR c)
+{
+   ALLEGRO_BITMAP *bmp = al_create_bitmap(w, h);
+   ALLEGRO_STATE state;
+
+   assert(bmp);
+   al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP);
+   al_set_target_bitmap(bmp);
+   al_clear_to_color(c);
+   al_restore_state(&state);
+   return bmp;
+}
+
+static void check_filled(ALLEGRO_BITMAP *bmp, ALLEGRO_COLOR c)
+{
+   int x, y;
+
+   for (y = 0; y < al_get_bitmap_height(bmp); y++)
+      for (x = 0; x < al_get_bitmap_width(bmp); x++)
+         assert(same_color(al_get_pixel(bmp, x, y), c));
+}
+
+static void check_separate(ALLEGRO_BITMAP *a, ALLEGRO_BITMAP *b)
+{
+   if (al_get_parent_bitmap(a) != al_get_parent_bitmap(b))
+      return;
+   assert(al_get_bitmap_x(a) + al_get_bitmap_width(a) + PADDING <=
+         al_get_bitmap_x(b) ||
+      al_get_bitmap_x(b) + al_get_bitmap_width(b) + PADDING <=
+         al_get_bitmap_x(a) ||
+      al_get_bitmap_y(a) + al_get_bitmap_height(a) + PADDING <=
+         al_get_bitmap_y(b) ||
+      al_get_bitmap_y(b) + al_get_bitmap_height(b) + PADDING <=
+         al_get_bitmap_y(a));
+}
+
+static void test_overflow(void)
+{
+   ALLEGRO_BITMAP_ATLAS *atlas;
+   ALLEGRO_BITMAP_ATLAS_STATS stats;
+   ALLEGRO_BITMAP *bmp, *subs[PER_PAGE + 1];
+   int i, j;
+
+   atlas = al_create_bitmap_atlas(PAGE_SIZE, PAGE_SIZE, PADDING);
+   assert(atlas);
+
+   for (i = 0; i < PER_PAGE + 1; i++) {
+      bmp = create_filled(BMP_SIZE, BMP_SIZE, color(i));
+      subs[i] = al_add_bitmap_to_atlas(atlas, bmp);
+      al_destroy_bitmap(bmp);
+      assert(subs[i]);
+
+      al_get_bitmap_atlas_stats(atlas, &stats);
+      assert(stats.num_pages == (i < PER_PAGE ? 1 : 2));
+      assert(stats.num_bitmaps == i + 1);
+   }
+
+   for (i = 0; i < PER_PAGE + 1; i++) {
+      check_filled(subs[i], color(i));
+      for (j = 0; j < i; j++)
+         check_separate(subs[i], subs[j]);
+   }
+   assert(al_get_parent_bitmap(subs[PER_PAGE]) !=
+      al_get_parent_bitmap(subs[0]));
+   /* The padding stays transparent. */
+   assert(same_color(al_get_pixel(al_get_parent_bitmap(subs[0]), 0, 0),
+      al_map_rgba(0, 0, 0, 0)));
+
+   /* Too large for a page once padded. */
+   bmp = create_filled(PAGE_SIZE - PADDING, BMP_SIZE, color(0));
+   assert(!al_add_bitmap_to_atlas(atlas, bmp));
+   al_destroy_bitmap(bmp);
+
+   /* The space of a removed bitmap is reused, and empty pages go away. */
+   assert(al_remove_bitmap_from_atlas(atlas, subs[4]));
+   assert(!al_remove_bitmap_from_atlas(atlas, subs[4]));
+   bmp = create_filled(BMP_SIZE, BMP_SIZE, color(20));
+   subs[4] = al_add_bitmap_to_atlas(atlas, bmp);
+   al_destroy_bitmap(bmp);
+   assert(al_get_parent_bitmap(subs[4]) == al_get_parent_bitmap(subs[0]));
+   check_filled(subs[4], color(20));
+   check_filled(subs[3], color(3));
+   check_filled(subs[5], color(5));
+
+   assert(al_remove_bitmap_from_atlas(atlas, subs[PER_PAGE]));
+   al_get_bitmap_atlas_stats(atlas, &stats);
+   assert(stats.num_pages == 1);
+   assert(stats.num_bitmaps == PER_PAGE);
+   assert(stats.used_pixels == PER_PAGE * BMP_SIZE * BMP_SIZE);
+   assert(stats.total_pixels == PAGE_SIZE * PAGE_SIZE);
+
+   al_destroy_bitmap_atlas(atlas);
+}
+
+static void test_add_many(void)
+{
+   static const int sizes[][2] = {
+      {5, 7}, {40, 10}, {12, 30}, {60, 3}, {8, 8}, {25, 25}, {70, 1}
+   };
+   enum { NUM = sizeof(sizes) / sizeof(sizes[0]) };
+   ALLEGRO_BITMAP_ATLAS *atlas;
+   ALLEGRO_BITMAP *bitmaps[NUM], *subs[NUM];
+   int i, j;
+
+   atlas = al_create_bitmap_atlas(PAGE_SIZE, PAGE_SIZE, PADDING);
+   assert(atlas);
+
+   for (i = 0; i < NUM; i++)
+      bitmaps[i] = create_filled(sizes[i][0], sizes[i][1], color(i));
+   assert(al_add_bitmaps_to_atlas(atlas, NUM, bitmaps, subs) == NUM - 1);
+
+   for (i = 0; i < NUM; i++) {
+      if (sizes[i][0] > PAGE_SIZE - 2 * PADDING) {
+         assert(!subs[i]);
+         continue;
+      }
+      assert(subs[i]);
+      assert(al_get_bitmap_width(subs[i]) == sizes[i][0]);
+      assert(al_get_bitmap_height(subs[i]) == sizes[i][1]);
+      check_filled(subs[i], color(i));
+      for (j = 0; j < i; j++) {
+         if (subs[j])
+            check_separate(subs[i], subs[j]);
+      }
+      al_destroy_bitmap(bitmaps[i]);
+   }
+   al_destroy_bitmap(bitmaps[NUM - 1]);
+
+   al_destroy_bitmap_atlas(atlas);
+}
+
+static void test_held_drawing(void)
+{
+   ALLEGRO_BITMAP_ATLAS *atlas;
+   ALLEGRO_BITMAP *target, *bmp, *sub, *other;
+
+   atlas = al_create_bitmap_atlas(PAGE_SIZE, PAGE_SIZE, PADDING);
+   assert(atlas);
+   target = create_filled(BMP_SIZE, BMP_SIZE, al_map_rgba(0, 0, 0, 0));
+   bmp = create_filled(BMP_SIZE, BMP_SIZE, color(1));
+
+   /* Adding and removing bitmaps, including one which needs a new page,
+    * doesn't change the hold or lose held drawing.
+    */
+   al_set_target_bitmap(target);
+   al_hold_bitmap_drawing(true);
+   al_draw_bitmap(bmp, 0, 0, 0);
+   sub = al_add_bitmap_to_atlas(atlas, bmp);
+   assert(sub);
+   assert(al_is_bitmap_drawing_held());
+   assert(al_get_target_bitmap() == target);
+   other = al_add_bitmap_to_atlas(atlas, bmp);
+   assert(other);
+   assert(al_remove_bitmap_from_atlas(atlas, other));
+   assert(al_is_bitmap_drawing_held());
+   assert(al_get_target_bitmap() == target);
+   al_hold_bitmap_drawing(false);
+
+   check_filled(target, color(1));
+   check_filled(sub, color(1));
+
+   al_destroy_bitmap(bmp);
+   al_destroy_bitmap(target);
+   al_destroy_bitmap_atlas(atlas);
+}
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+   (void)argv;
+
+   assert(al_init());
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+   test_overflow();
+   test_add_many();
+   test_held_drawing();
+
+   return 0;
+}
@@ -413,6 +413,7 @@ static int get_bitmap_flags(char const *v)
 {
    return streq(v, "ALLEGRO_MEMORY_BITMAP") ? ALLEGRO_MEMORY_BITMAP
       : streq(v, "ALLEGRO_VIDEO_BITMAP") ? ALLEGRO_VIDEO_BITMAP
+      : streq(v, "ALLEGRO_MIPMAP") ? ALLEGRO_MIPMAP
       : atoi(v);
 }
 
@@ -1777,6 +1778,8 @@ const char* help_str =
 " -h, --help            display this message\n"
 " -n, --no-display      do not create a display (hardware drawing is disabled)\n"
 " -s, --save            save the output of each test in the current directory\n"
+" --soft-rasterizer-threads N\n"
+"                       draw triangles to memory bitmaps with N threads\n"
 " --use-shaders         use the programmable pipeline for drawing\n"
 " -v, --verbose         show additional information after each test\n"
 " -q, --quiet           do not draw test output to the display\n"
@@ -1848,6 +1851,11 @@ int main(int _argc, char *_argv[])
       else if (streq(opt, "--use-shaders")) {
          display_flags |= ALLEGRO_PROGRAMMABLE_PIPELINE;
       }
+      else if (streq(opt, "--soft-rasterizer-threads") && argc > 1) {
+         ALLEGRO_CONFIG *cfg = al_get_system_config();
+         argc--, argv++;
+         al_set_config_value(cfg, "graphics", "soft_rasterizer_threads", argv[0]);
+      }
       else if (streq(opt, "-h") || streq(opt, "--help")) {
          printf("Usage:\n%s%s", _argv[0], help_str);
          return 0;
@@ -0,0 +1,166 @@
+/*
+ *    Tests for headless displays: frame events, acknowledgement, dropped
+ *    frames and resizing.
+ */
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdio.h>
+
+#define ALLEGRO_UNSTABLE
+#include "allegro5/allegro.h"
+
+#define WIDTH  32
+#define HEIGHT 16
+
+static uint32_t pixel(const ALLEGRO_EVENT *ev, int x, int y)
+{
+   const char *row = (const char *)ev->frame.data + ev->frame.pitch * y;
+   return ((const uint32_t *)row)[x];
+}
+
+/* ABGR_8888 is stored as one 32 bit value per pixel. */
+static uint32_t rgb(int r, int g, int b)
+{
+   return 0xff000000u | (b << 16) | (g << 8) | r;
+}
+
+static void flip(ALLEGRO_COLOR c)
+{
+   al_clear_to_color(c);
+   al_flip_display();
+}
+
+static void check_frame(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ev,
+   int64_t number, int w, int h, uint32_t color)
+{
+   assert(al_get_next_event(queue, ev));
+   assert(ev->type == ALLEGRO_EVENT_DISPLAY_FRAME);
+   assert(ev->frame.number == number);
+   assert(ev->frame.width == w);
+   assert(ev->frame.height == h);
+   assert(ev->frame.pitch == w * 4);
+   assert(ev->frame.format == ALLEGRO_PIXEL_FORMAT_ABGR_8888);
+   assert(pixel(ev, 0, 0) == color);
+   assert(pixel(ev, w - 1, h - 1) == color);
+}
+
+static ALLEGRO_DISPLAY *create_display(void)
+{
+   ALLEGRO_DISPLAY *display;
+   ALLEGRO_BITMAP *bmp;
+
+   display = al_create_display(WIDTH, HEIGHT);
+   assert(display);
+   assert(al_get_display_flags(display) & ALLEGRO_HEADLESS);
+   assert(al_get_display_width(display) == WIDTH);
+   assert(al_get_display_height(display) == HEIGHT);
+   assert(al_get_bitmap_flags(al_get_backbuffer(display)) &
+      ALLEGRO_MEMORY_BITMAP);
+
+   /* There are no video bitmaps. */
+   bmp = al_create_bitmap(8, 8);
+   assert(bmp);
+   assert(al_get_bitmap_flags(bmp) & ALLEGRO_MEMORY_BITMAP);
+   al_destroy_bitmap(bmp);
+
+   return display;
+}
+
+static void test_frames(int num_buffers)
+{
+   ALLEGRO_DISPLAY *display;
+   ALLEGRO_EVENT_QUEUE *queue;
+   ALLEGRO_EVENT ev, first;
+   char value[16];
+   int64_t number = 0;
+   int i;
+
+   snprintf(value, sizeof value, "%d", num_buffers);
+   al_set_config_value(al_get_system_config(), "graphics",
+      "headless_frame_buffers", value);
+   al_set_new_display_flags(ALLEGRO_HEADLESS);
+   display = create_display();
+
+   /* Nobody is listening, so the frame is just done with. */
+   flip(al_map_rgb(1, 2, 3));
+   number++;
+
+   queue = al_create_event_queue();
+   al_register_event_source(queue, al_get_display_event_source(display));
+
+   /* Frames keep their pixels until acknowledged, while drawing goes on in
+    * the other buffers.
+    */
+   for (i = 0; i < num_buffers - 1; i++) {
+      flip(al_map_rgb(i, 100, 200));
+      check_frame(queue, &ev, ++number, WIDTH, HEIGHT, rgb(i, 100, 200));
+      if (i == 0)
+         first = ev;
+      else
+         assert(ev.frame.data != first.frame.data);
+   }
+   assert(pixel(&first, 0, 0) == rgb(0, 100, 200));
+
+   /* With every other buffer in flight, flips are dropped. */
+   flip(al_map_rgb(255, 0, 0));
+   number++;
+   flip(al_map_rgb(255, 0, 0));
+   number++;
+   assert(!al_get_next_event(queue, &ev));
+   assert(pixel(&first, 0, 0) == rgb(0, 100, 200));
+
+   /* Frames in flight can't be resized away. */
+   assert(!al_resize_display(display, WIDTH * 2, HEIGHT));
+   assert(al_get_display_width(display) == WIDTH);
+
+   /* One acknowledgement is enough to deliver frames again. */
+   al_acknowledge_display_frame(display, first.frame.number);
+   flip(al_map_rgb(0, 255, 0));
+   check_frame(queue, &ev, ++number, WIDTH, HEIGHT, rgb(0, 255, 0));
+   assert(!al_resize_display(display, WIDTH * 2, HEIGHT));
+
+   /* Once all are acknowledged, the display can be resized. */
+   for (i = 1; i <= number; i++)
+      al_acknowledge_display_frame(display, i);
+   assert(al_resize_display(display, WIDTH * 2, HEIGHT + 1));
+   assert(al_get_display_width(display) == WIDTH * 2);
+   assert(al_get_display_height(display) == HEIGHT + 1);
+   assert(al_get_bitmap_width(al_get_backbuffer(display)) == WIDTH * 2);
+
+   flip(al_map_rgb(0, 0, 255));
+   check_frame(queue, &ev, ++number, WIDTH * 2, HEIGHT + 1, rgb(0, 0, 255));
+
+   /* Destroying the display frees the frame still in flight. */
+   al_destroy_display(display);
+   al_destroy_event_queue(queue);
+   al_remove_config_key(al_get_system_config(), "graphics",
+      "headless_frame_buffers");
+}
+
+static void test_driver_config(void)
+{
+   ALLEGRO_DISPLAY *display;
+
+   al_set_config_value(al_get_system_config(), "graphics", "driver",
+      "headless");
+   al_set_new_display_flags(0);
+   display = create_display();
+   al_destroy_display(display);
+   al_remove_config_key(al_get_system_config(), "graphics", "driver");
+}
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+   (void)argv;
+
+   assert(al_init());
+   al_set_new_bitmap_format(ALLEGRO_PIXEL_FORMAT_ABGR_8888);
+
+   test_frames(3);
+   test_frames(2);
+   test_driver_config();
+
+   return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ *    Tests for the offline audio driver: rendering with the manual clock
+ *    and the WAV files it writes.
+ */
+
+#undef NDEBUG
+#include <assert.h>
+#include <string.h>
+
+#define ALLEGRO_UNSTABLE
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_audio.h"
+
+#define OUTPUT_FILE "tmp_offline.wav"
+#define FREQUENCY   44100
+#define CHANNELS    2
+#define SAMPLE_LEN  3000
+#define FIRST_PART  1000
+#define PAUSE_LEN   500
+#define RENDER_LEN  4096
+
+static void fill_sample(void *data, ALLEGRO_AUDIO_DEPTH depth)
+{
+   int i;
+
+   for (i = 0; i < SAMPLE_LEN; i++) {
+      if (depth == ALLEGRO_AUDIO_DEPTH_INT16) {
+         int16_t *p = data;
+         p[i * 2 + 0] = (i * 7 % 20000) - 10000;
+         p[i * 2 + 1] = 10000 - (i * 7 % 20000);
+      }
+      else {
+         float *p = data;
+         p[i * 2 + 0] = (i % 200) / 200.0f - 0.5f;
+         p[i * 2 + 1] = 0.5f - (i % 200) / 200.0f;
+      }
+   }
+}
+
+/* What the voice should play: the first part of the sample, silence while
+ * it is stopped, the rest of the sample, then silence.
+ */
+static void fill_expected(char *expected, const char *sample,
+   size_t frame_size)
+{
+   memset(expected, 0, RENDER_LEN * frame_size);
+   memcpy(expected, sample, FIRST_PART * frame_size);
+   memcpy(expected + (FIRST_PART + PAUSE_LEN) * frame_size,
+      sample + FIRST_PART * frame_size, (SAMPLE_LEN - FIRST_PART) * frame_size);
+}
+
+static void check_wav(const char *expected, ALLEGRO_AUDIO_DEPTH depth)
+{
+   bool is_float = (depth == ALLEGRO_AUDIO_DEPTH_FLOAT32);
+   int bits = is_float ? 32 : 16;
+   int frame_size = CHANNELS * bits / 8;
+   uint32_t data_size = RENDER_LEN * frame_size;
+   uint32_t header_size = is_float ? 58 : 44;
+   char id[4];
+   ALLEGRO_FILE *f;
+   int i;
+
+   f = al_fopen(OUTPUT_FILE, "rb");
+   assert(f);
+   assert(al_fsize(f) == (int64_t)(header_size + data_size));
+
+   assert(al_fread(f, id, 4) == 4 && memcmp(id, "RIFF", 4) == 0);
+   assert((uint32_t)al_fread32le(f) == header_size - 8 + data_size);
+   assert(al_fread(f, id, 4) == 4 && memcmp(id, "WAVE", 4) == 0);
+
+   assert(al_fread(f, id, 4) == 4 && memcmp(id, "fmt ", 4) == 0);
+   assert(al_fread32le(f) == (is_float ? 18 : 16));
+   assert(al_fread16le(f) == (is_float ? 3 : 1));
+   assert(al_fread16le(f) == CHANNELS);
+   assert(al_fread32le(f) == FREQUENCY);
+   assert(al_fread32le(f) == FREQUENCY * frame_size);
+   assert(al_fread16le(f) == frame_size);
+   assert(al_fread16le(f) == bits);
+   if (is_float) {
+      assert(al_fread16le(f) == 0);
+      assert(al_fread(f, id, 4) == 4 && memcmp(id, "fact", 4) == 0);
+      assert(al_fread32le(f) == 4);
+      assert(al_fread32le(f) == RENDER_LEN);
+   }
+
+   assert(al_fread(f, id, 4) == 4 && memcmp(id, "data", 4) == 0);
+   assert((uint32_t)al_fread32le(f) == data_size);
+   for (i = 0; i < RENDER_LEN * CHANNELS; i++) {
+      if (is_float) {
+         int32_t bits32 = al_fread32le(f);
+         float x;
+         memcpy(&x, &bits32, sizeof x);
+         assert(x == ((const float *)expected)[i]);
+      }
+      else {
+         assert(al_fread16le(f) == ((const int16_t *)expected)[i]);
+      }
+   }
+   assert(al_fgetc(f) == EOF);
+
+   al_fclose(f);
+}
+
+static void test_voice(ALLEGRO_AUDIO_DEPTH depth)
+{
+   size_t frame_size = CHANNELS * al_get_audio_depth_size(depth);
+   ALLEGRO_VOICE *voice;
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_SAMPLE *sample;
+   ALLEGRO_SAMPLE_INSTANCE *inst;
+   char *data, *expected, *rendered;
+   unsigned int i;
+
+   al_set_config_value(al_get_system_config(), "offline", "output",
+      OUTPUT_FILE);
+
+   data = al_malloc(SAMPLE_LEN * frame_size);
+   fill_sample(data, depth);
+   sample = al_create_sample(data, SAMPLE_LEN, FREQUENCY, depth,
+      ALLEGRO_CHANNEL_CONF_2, false);
+   assert(sample);
+   inst = al_create_sample_instance(sample);
+   assert(inst);
+   /* Centre panning would scale both channels by 1/sqrt(2). */
+   assert(al_set_sample_instance_pan(inst, ALLEGRO_AUDIO_PAN_NONE));
+
+   voice = al_create_voice(FREQUENCY, depth, ALLEGRO_CHANNEL_CONF_2);
+   assert(voice);
+   mixer = al_create_mixer(FREQUENCY, depth, ALLEGRO_CHANNEL_CONF_2);
+   assert(mixer);
+   assert(al_attach_mixer_to_voice(mixer, voice));
+   assert(al_attach_sample_instance_to_mixer(inst, mixer));
+   assert(al_play_sample_instance(inst));
+
+   expected = al_malloc(RENDER_LEN * frame_size);
+   rendered = al_malloc(RENDER_LEN * frame_size);
+   fill_expected(expected, data, frame_size);
+   memset(rendered, 0x55, RENDER_LEN * frame_size);
+
+   /* The mixer provides every sample while the voice plays. */
+   assert(al_render_voice(voice, rendered, FIRST_PART) == FIRST_PART);
+   assert(al_get_sample_instance_position(inst) == FIRST_PART);
+
+   /* A stopped voice renders silence and doesn't move the sample on. */
+   assert(al_set_voice_playing(voice, false));
+   assert(al_render_voice(voice, rendered + FIRST_PART * frame_size,
+      PAUSE_LEN) == 0);
+   assert(al_get_sample_instance_position(inst) == FIRST_PART);
+
+   assert(al_set_voice_playing(voice, true));
+   i = RENDER_LEN - FIRST_PART - PAUSE_LEN;
+   assert(al_render_voice(voice,
+      rendered + (FIRST_PART + PAUSE_LEN) * frame_size, i) == i);
+   assert(!al_get_sample_instance_playing(inst));
+
+   assert(memcmp(rendered, expected, RENDER_LEN * frame_size) == 0);
+
+   /* The WAV file is finished when the voice is destroyed. */
+   al_destroy_voice(voice);
+   check_wav(expected, depth);
+   al_remove_filename(OUTPUT_FILE);
+
+   al_destroy_mixer(mixer);
+   al_destroy_sample_instance(inst);
+   al_destroy_sample(sample);
+   al_free(rendered);
+   al_free(expected);
+   al_free(data);
+}
+
+int main(int argc, char *argv[])
+{
+   ALLEGRO_CONFIG *config;
+   (void)argc;
+   (void)argv;
+
+   assert(al_init());
+   config = al_get_system_config();
+   al_set_config_value(config, "audio", "driver", "offline");
+   al_set_config_value(config, "offline", "clock", "manual");
+   assert(al_install_audio());
+
+   test_voice(ALLEGRO_AUDIO_DEPTH_INT16);
+   test_voice(ALLEGRO_AUDIO_DEPTH_FLOAT32);
+
+   al_uninstall_audio();
+   return 0;
+}
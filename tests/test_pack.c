@@ -0,0 +1,173 @@
+/*
+ *    Tests for pack files: writing, reading back and the file system hook.
+ *
+ *    Run from the build's tests directory, like the test driver.
+ */
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ALLEGRO_UNSTABLE
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_image.h"
+
+#define DATA_DIR  "../examples/data"
+#define PACK_FILE "tmp.pack"
+
+static const char *files[] = {
+   "mysha.pcx",
+   "welcome.wav",
+   "exconfig.ini",
+   "haiku/air_effect.png",
+   "haiku/air_0.ogg"
+};
+
+static void *read_all(ALLEGRO_FILE *f, int64_t *size)
+{
+   void *data;
+
+   *size = al_fsize(f);
+   assert(*size >= 0);
+   data = al_malloc(*size + 1);
+   assert(al_fread(f, data, *size) == (size_t)*size);
+   assert(al_fgetc(f) == EOF);
+   al_fclose(f);
+   return data;
+}
+
+static void compare_file(ALLEGRO_PACK *pack, const char *name)
+{
+   char path[256];
+   int64_t size, packed_size;
+   void *data, *packed;
+
+   snprintf(path, sizeof path, "%s/%s", DATA_DIR, name);
+   data = read_all(al_fopen(path, "rb"), &size);
+   packed = read_all(al_fopen_pack_entry(pack, name), &packed_size);
+
+   assert(size == packed_size);
+   assert(memcmp(data, packed, size) == 0);
+
+   al_free(data);
+   al_free(packed);
+}
+
+static void compare_bitmaps(ALLEGRO_BITMAP *a, ALLEGRO_BITMAP *b)
+{
+   int x, y;
+
+   assert(al_get_bitmap_width(a) == al_get_bitmap_width(b));
+   assert(al_get_bitmap_height(a) == al_get_bitmap_height(b));
+   for (y = 0; y < al_get_bitmap_height(a); y++) {
+      for (x = 0; x < al_get_bitmap_width(a); x++) {
+         ALLEGRO_COLOR ca = al_get_pixel(a, x, y);
+         ALLEGRO_COLOR cb = al_get_pixel(b, x, y);
+         assert(memcmp(&ca, &cb, sizeof ca) == 0);
+      }
+   }
+}
+
+static int count_entry(ALLEGRO_FS_ENTRY *e, void *extra)
+{
+   (void)e;
+   (*(int *)extra)++;
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+static int count_entries(const char *dir)
+{
+   ALLEGRO_FS_ENTRY *e = al_create_fs_entry(dir);
+   int n = 0;
+
+   assert(e);
+   assert(al_for_each_fs_entry(e, count_entry, &n) ==
+      ALLEGRO_FOR_EACH_FS_ENTRY_OK);
+   al_destroy_fs_entry(e);
+   return n;
+}
+
+static void test_pack(int flags)
+{
+   ALLEGRO_BITMAP *expected, *loaded;
+   ALLEGRO_PACK *pack;
+   ALLEGRO_STATE state;
+   ALLEGRO_FILE *f;
+   int num_entries;
+   char *cwd;
+   unsigned i;
+
+   num_entries = count_entries(DATA_DIR);
+   expected = al_load_bitmap(DATA_DIR "/mysha.pcx");
+   assert(expected);
+
+   assert(al_save_pack(PACK_FILE, DATA_DIR, flags));
+   pack = al_open_pack(PACK_FILE);
+   assert(pack);
+
+   for (i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+      compare_file(pack, files[i]);
+   assert(!al_fopen_pack_entry(pack, "haiku"));
+   assert(!al_fopen_pack_entry(pack, "../mysha.pcx"));
+
+   al_store_state(&state, ALLEGRO_STATE_NEW_FILE_INTERFACE);
+   al_set_pack_file_interface(pack);
+
+   loaded = al_load_bitmap("mysha.pcx");
+   assert(loaded);
+   compare_bitmaps(expected, loaded);
+   al_destroy_bitmap(loaded);
+
+   assert(count_entries("/") == num_entries);
+   assert(al_filename_exists("haiku"));
+   assert(!al_filename_exists("nothing"));
+   assert(!al_fopen("mysha.pcx", "wb"));
+
+   assert(al_change_directory("haiku"));
+   cwd = al_get_current_directory();
+   assert(strcmp(cwd, "/haiku/") == 0);
+   al_free(cwd);
+   f = al_fopen("../haiku/./air_effect.png", "rb");
+   assert(f);
+   al_fclose(f);
+   assert(!al_change_directory("air_effect.png"));
+   assert(al_change_directory(".."));
+
+   al_restore_state(&state);
+   assert(al_filename_exists(DATA_DIR "/mysha.pcx"));
+
+   al_close_pack(pack);
+   al_destroy_bitmap(expected);
+   al_remove_filename(PACK_FILE);
+}
+
+static void test_bad_pack(void)
+{
+   ALLEGRO_FILE *f;
+
+   assert(!al_open_pack(DATA_DIR "/mysha.pcx"));
+
+   f = al_fopen(PACK_FILE, "wb");
+   assert(f);
+   al_fputs(f, "ALPK");
+   al_fclose(f);
+   assert(!al_open_pack(PACK_FILE));
+   al_remove_filename(PACK_FILE);
+}
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+   (void)argv;
+
+   assert(al_init());
+   assert(al_init_image_addon());
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+   test_pack(0);
+   test_pack(ALLEGRO_PACK_COMPRESS);
+   test_bad_pack();
+
+   return 0;
+}